@@ -117,5 +117,45 @@ BENCHMARK_DEFINE_F(InfillTest, Infill_generate_connect)(benchmark::State& st)
 }
 
 BENCHMARK_REGISTER_F(InfillTest, Infill_generate_connect)->ArgsProduct({{true, false}, {400, 800, 1200}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(InfillTest, Infill_generate_pattern)(benchmark::State& st)
+{
+    pattern = static_cast<EFillMethod>(st.range(2));
+    zig_zagify = st.range(3); // Without zig-zagging, the lines aren't connected by connectLines but cut to the outline one by one.
+    Infill infill(pattern,
+                  zig_zagify,
+                  connect_polygons,
+                  outline_polygons,
+                  INFILL_LINE_WIDTH,
+                  line_distance,
+                  INFILL_OVERLAP,
+                  INFILL_MULTIPLIER,
+                  FILL_ANGLE,
+                  Z,
+                  SHIFT,
+                  MAX_RESOLUTION,
+                  MAX_DEVIATION);
+
+    for (auto _ : st)
+    {
+        std::vector<VariableWidthLines> result_paths;
+        Polygons result_polygons;
+        Polygons result_lines;
+        infill.generate(result_paths, result_polygons, result_lines, settings, 0, SectionType::INFILL, nullptr, nullptr);
+    }
+}
+
+// The patterns that consist of lines in multiple directions.
+BENCHMARK_REGISTER_F(InfillTest, Infill_generate_pattern)
+    ->ArgsProduct({ { true, false },
+                    { 400, 1200 },
+                    { static_cast<int64_t>(EFillMethod::GRID),
+                      static_cast<int64_t>(EFillMethod::TRIANGLES),
+                      static_cast<int64_t>(EFillMethod::TRIHEXAGON),
+                      static_cast<int64_t>(EFillMethod::CUBIC),
+                      static_cast<int64_t>(EFillMethod::TETRAHEDRAL),
+                      static_cast<int64_t>(EFillMethod::QUARTER_CUBIC) },
+                    { true, false } })
+    ->Unit(benchmark::kMillisecond);
 } // namespace cura
 #endif // CURAENGINE_INFILL_BENCHMARK_H
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_LIGHTNING_BENCHMARK_H
+#define CURAENGINE_LIGHTNING_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include "infill/LightningLayer.h"
+
+namespace cura
+{
+class LightningTest : public benchmark::Fixture
+{
+public:
+    Polygons outline;
+    coord_t supporting_radius{ 400 };
+    coord_t wall_supporting_radius{ 200 };
+    coord_t prune_length{ 200 };
+    coord_t straightening_max_distance{ 200 };
+    size_t layer_count{ 50 };
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        outline.clear();
+        outline.emplace_back();
+        outline.back().emplace_back(0, 0);
+        outline.back().emplace_back(MM2INT(100), 0);
+        outline.back().emplace_back(MM2INT(100), MM2INT(100));
+        outline.back().emplace_back(0, MM2INT(100));
+
+        // A few holes, so trees have to be re-rooted and reconnected while propagating.
+        for (coord_t x = MM2INT(20); x < MM2INT(100); x += MM2INT(30))
+        {
+            outline.emplace_back();
+            outline.back().emplace_back(x, MM2INT(40));
+            outline.back().emplace_back(x, MM2INT(60));
+            outline.back().emplace_back(x + MM2INT(10), MM2INT(60));
+            outline.back().emplace_back(x + MM2INT(10), MM2INT(40));
+        }
+
+        supporting_radius = state.range(0) / 2;
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+};
+
+// Generates dense trees supporting the top of a prism and propagates them all the way down, like LightningGenerator::generateTrees.
+BENCHMARK_DEFINE_F(LightningTest, Lightning_generate_and_propagate)(benchmark::State& st)
+{
+    const auto outline_locator = PolygonUtils::createLocToLineGrid(outline, locator_cell_size);
+    const Polygons no_overhang;
+    size_t node_count = 0;
+    size_t memory_usage = 0;
+
+    for (auto _ : st)
+    {
+        std::vector<LightningLayer> layers(layer_count);
+        for (int layer_idx = layer_count - 1; layer_idx >= 0; layer_idx--)
+        {
+            LightningLayer& layer = layers[layer_idx];
+            std::vector<LightningTreeNodeIdx> to_be_reconnected_tree_roots = layer.tree_roots;
+            layer.generateNewTrees(layer_idx == static_cast<int>(layer_count) - 1 ? outline : no_overhang, outline, *outline_locator, supporting_radius, wall_supporting_radius);
+            layer.reconnectRoots(to_be_reconnected_tree_roots, outline, *outline_locator, supporting_radius, wall_supporting_radius);
+            layer.compact();
+            if (layer_idx == 0)
+            {
+                break;
+            }
+
+            LightningLayer& lower_layer = layers[layer_idx - 1];
+            for (const LightningTreeNodeIdx tree : layer.tree_roots)
+            {
+                layer.tree_nodes.propagateToNextLayer(
+                    tree,
+                    lower_layer.tree_nodes,
+                    lower_layer.tree_roots,
+                    outline,
+                    *outline_locator,
+                    prune_length,
+                    straightening_max_distance,
+                    locator_cell_size / 2);
+            }
+        }
+
+        node_count = 0;
+        memory_usage = 0;
+        for (const LightningLayer& layer : layers)
+        {
+            node_count += layer.tree_nodes.size();
+            memory_usage += layer.tree_nodes.getMemoryUsage() + layer.tree_roots.capacity() * sizeof(LightningTreeNodeIdx);
+        }
+        benchmark::DoNotOptimize(layers);
+    }
+
+    st.counters["nodes"] = static_cast<double>(node_count);
+    st.counters["tree_bytes"] = benchmark::Counter(static_cast<double>(memory_usage), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+
+BENCHMARK_REGISTER_F(LightningTest, Lightning_generate_and_propagate)->Arg(2000)->Arg(4000)->Unit(benchmark::kMillisecond);
+} // namespace cura
+#endif // CURAENGINE_LIGHTNING_BENCHMARK_H
@@ -2,8 +2,14 @@
 // Copyright (c) 2023 UltiMaker
 // CuraEngine is released under the terms of the AGPLv3 or higher
 #include "infill_benchmark.h"
+#include "lightning_benchmark.h"
+#include "path_order_monotonic_benchmark.h"
+#include "prepared_polygons_benchmark.h"
 #include "wall_benchmark.h"
 #include "simplify_benchmark.h"
+#include "support_benchmark.h"
+#include "time_estimate_benchmark.h"
+#include "union_benchmark.h"
 #include <benchmark/benchmark.h>
 
 // Run the benchmark
@@ -0,0 +1,77 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_PATH_ORDER_MONOTONIC_BENCHMARK_H
+#define CURAENGINE_PATH_ORDER_MONOTONIC_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+#include <numbers>
+#include <random>
+
+#include "PathOrderMonotonic.h"
+#include "utils/polygon.h"
+
+namespace cura
+{
+class PathOrderMonotonicTestFixture : public benchmark::Fixture
+{
+public:
+    Polygons lines;
+    AngleRadians monotonic_direction{ 0 };
+
+    coord_t LINE_DISTANCE = 400;
+    coord_t MAX_ADJACENT_DISTANCE = LINE_DISTANCE + 1;
+    coord_t AREA_SIZE = MM2INT(200);
+
+    /*!
+     * Fill a square with parallel lines that are chopped up at random, like
+     * the monotonic skin of a large area with many small holes.
+     */
+    void SetUp(const ::benchmark::State& state)
+    {
+        const coord_t max_piece_length = state.range(0);
+        const double angle = AngleRadians(AngleDegrees(state.range(1)));
+        const Point2LL direction(std::llrint(std::cos(angle) * 1000), std::llrint(std::sin(angle) * 1000));
+        const Point2LL perpendicular = turn90CCW(direction);
+        monotonic_direction = AngleRadians(0.5 * std::numbers::pi - angle); // Rotates clockwise, so this points the monotonic vector along the perpendicular.
+
+        std::mt19937 generator(0);
+        std::uniform_int_distribution<coord_t> piece_length(200, max_piece_length);
+        std::uniform_int_distribution<coord_t> gap_length(100, 3000);
+        lines.clear();
+        for (coord_t across = 0; across < AREA_SIZE; across += LINE_DISTANCE)
+        {
+            for (coord_t along = gap_length(generator); along < AREA_SIZE; along += gap_length(generator))
+            {
+                const coord_t end = std::min(along + piece_length(generator), AREA_SIZE);
+                PolygonRef line = lines.newPoly();
+                line.add((direction * along + perpendicular * across) / 1000);
+                line.add((direction * end + perpendicular * across) / 1000);
+                along = end;
+            }
+        }
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+};
+
+BENCHMARK_DEFINE_F(PathOrderMonotonicTestFixture, PathOrderMonotonic_optimize)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        PathOrderMonotonic<ConstPolygonPointer> order(monotonic_direction, MAX_ADJACENT_DISTANCE, Point2LL(0, 0));
+        for (const auto& line : lines)
+        {
+            order.addPolyline(ConstPolygonPointer(line));
+        }
+        order.optimize();
+        benchmark::DoNotOptimize(order.paths_);
+    }
+    st.counters["lines"] = lines.size();
+}
+
+BENCHMARK_REGISTER_F(PathOrderMonotonicTestFixture, PathOrderMonotonic_optimize)->ArgsProduct({ { 2000, 20000, 200000 }, { 0, 45 } })->Unit(benchmark::kMillisecond);
+} // namespace cura
+#endif // CURAENGINE_PATH_ORDER_MONOTONIC_BENCHMARK_H
@@ -0,0 +1,157 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_PREPARED_POLYGONS_BENCHMARK_H
+#define CURAENGINE_PREPARED_POLYGONS_BENCHMARK_H
+
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utils/PreparedPolygons.h"
+#include "utils/polygon.h"
+#include "utils/polygonUtils.h"
+
+namespace cura
+{
+class PreparedPolygonsTest : public benchmark::Fixture
+{
+public:
+    Polygons polygons;
+    std::vector<Point2LL> points;
+    std::vector<std::pair<Point2LL, Point2LL>> segments;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        // A wobbly disc with a number of holes, like a detailed layer of a model. The vertex count is split between the outline and the holes.
+        const size_t vertex_count = state.range(0);
+        const coord_t radius = MM2INT(50);
+        polygons.clear();
+        PolygonRef outline = polygons.newPoly();
+        for (size_t vertex_idx = 0; vertex_idx < vertex_count / 2; vertex_idx++)
+        {
+            const double angle = 2 * std::numbers::pi * static_cast<double>(vertex_idx) / static_cast<double>(vertex_count / 2);
+            const double wobble = 1.0 + 0.05 * std::sin(angle * 40);
+            outline.emplace_back(std::llrint(radius * wobble * std::cos(angle)), std::llrint(radius * wobble * std::sin(angle)));
+        }
+        constexpr size_t hole_count = 16;
+        for (size_t hole_idx = 0; hole_idx < hole_count; hole_idx++)
+        {
+            const Point2LL center(
+                std::llrint(radius / 2 * std::cos(2 * std::numbers::pi * hole_idx / hole_count)),
+                std::llrint(radius / 2 * std::sin(2 * std::numbers::pi * hole_idx / hole_count)));
+            PolygonRef hole = polygons.newPoly();
+            const size_t hole_vertex_count = std::max(size_t(3), vertex_count / 2 / hole_count);
+            for (size_t vertex_idx = 0; vertex_idx < hole_vertex_count; vertex_idx++)
+            {
+                const double angle = -2 * std::numbers::pi * static_cast<double>(vertex_idx) / static_cast<double>(hole_vertex_count);
+                hole.emplace_back(center + Point2LL(std::llrint(MM2INT(5) * std::cos(angle)), std::llrint(MM2INT(5) * std::sin(angle))));
+            }
+        }
+
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<coord_t> distribution(-radius * 11 / 10, radius * 11 / 10);
+        std::uniform_int_distribution<coord_t> length_distribution(-MM2INT(2), MM2INT(2));
+        points.clear();
+        segments.clear();
+        for (size_t point_idx = 0; point_idx < 10000; point_idx++)
+        {
+            points.emplace_back(distribution(generator), distribution(generator));
+            segments.emplace_back(points.back(), points.back() + Point2LL(length_distribution(generator), length_distribution(generator)));
+        }
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+};
+
+BENCHMARK_DEFINE_F(PreparedPolygonsTest, Polygons_inside)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        size_t inside_count = 0;
+        for (const Point2LL& p : points)
+        {
+            inside_count += polygons.inside(p, true);
+        }
+        benchmark::DoNotOptimize(inside_count);
+    }
+}
+
+BENCHMARK_REGISTER_F(PreparedPolygonsTest, Polygons_inside)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(PreparedPolygonsTest, PreparedPolygons_build)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        PreparedPolygons prepared(polygons);
+        benchmark::DoNotOptimize(prepared);
+    }
+}
+
+BENCHMARK_REGISTER_F(PreparedPolygonsTest, PreparedPolygons_build)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Includes building the index, as the callers do.
+BENCHMARK_DEFINE_F(PreparedPolygonsTest, PreparedPolygons_inside)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        const PreparedPolygons prepared(polygons);
+        size_t inside_count = 0;
+        for (const Point2LL& p : points)
+        {
+            inside_count += prepared.inside(p, true);
+        }
+        benchmark::DoNotOptimize(inside_count);
+    }
+}
+
+BENCHMARK_REGISTER_F(PreparedPolygonsTest, PreparedPolygons_inside)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(PreparedPolygonsTest, PreparedPolygons_inside_batch)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        const PreparedPolygons prepared(polygons);
+        std::vector<bool> inside = prepared.inside(points, true);
+        benchmark::DoNotOptimize(inside);
+    }
+}
+
+BENCHMARK_REGISTER_F(PreparedPolygonsTest, PreparedPolygons_inside_batch)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(PreparedPolygonsTest, Polygons_collides_with_segment)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        size_t collision_count = 0;
+        for (const auto& [from, to] : segments)
+        {
+            collision_count += PolygonUtils::polygonCollidesWithLineSegment(polygons, from, to);
+        }
+        benchmark::DoNotOptimize(collision_count);
+    }
+}
+
+BENCHMARK_REGISTER_F(PreparedPolygonsTest, Polygons_collides_with_segment)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(PreparedPolygonsTest, PreparedPolygons_intersects_segment)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        const PreparedPolygons prepared(polygons);
+        size_t collision_count = 0;
+        for (const auto& [from, to] : segments)
+        {
+            collision_count += prepared.intersectsSegment(from, to);
+        }
+        benchmark::DoNotOptimize(collision_count);
+    }
+}
+
+BENCHMARK_REGISTER_F(PreparedPolygonsTest, PreparedPolygons_intersects_segment)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+} // namespace cura
+#endif // CURAENGINE_PREPARED_POLYGONS_BENCHMARK_H
@@ -0,0 +1,142 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_SUPPORT_BENCHMARK_H
+#define CURAENGINE_SUPPORT_BENCHMARK_H
+
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "Application.h"
+#include "Slice.h"
+#include "settings/Settings.h"
+#include "sliceDataStorage.h"
+#include "support.h"
+#include "utils/polygon.h"
+
+namespace cura
+{
+class SupportTestFixture : public benchmark::Fixture
+{
+public:
+    std::unique_ptr<SliceDataStorage> storage;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        Application::getInstance().startThreadPool();
+        Application::getInstance().current_slice_ = new Slice(1);
+        Settings& settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
+
+        settings.add("adhesion_type", "none");
+        settings.add("anti_overhang_mesh", "false");
+        settings.add("infill_mesh", "false");
+        settings.add("initial_layer_line_width_factor", "100");
+        settings.add("layer_height", "0.1");
+        settings.add("machine_center_is_zero", "false");
+        settings.add("machine_depth", "250");
+        settings.add("machine_height", "250");
+        settings.add("machine_shape", "rectangular");
+        settings.add("machine_width", "250");
+        settings.add("magic_mesh_surface_mode", "normal");
+        settings.add("meshfix_maximum_deviation", "0.025");
+        settings.add("meshfix_maximum_extrusion_area_deviation", "50000");
+        settings.add("meshfix_maximum_resolution", "0.5");
+        settings.add("min_even_wall_line_width", "0.34");
+        settings.add("minimum_support_area", "0");
+        settings.add("support_angle", "50");
+        settings.add("support_bottom_distance", "0.1");
+        settings.add("support_bottom_enable", "false");
+        settings.add("support_bottom_extruder_nr", "0");
+        settings.add("support_bottom_stair_step_height", "0.3");
+        settings.add("support_bottom_stair_step_min_slope", "10");
+        settings.add("support_bottom_stair_step_width", "5");
+        settings.add("support_conical_angle", "30");
+        settings.add("support_conical_enabled", "false");
+        settings.add("support_conical_min_width", "5");
+        settings.add("support_enable", "true");
+        settings.add("support_infill_extruder_nr", "0");
+        settings.add("support_join_distance", "2");
+        settings.add("support_line_distance", "2.66");
+        settings.add("support_line_width", "0.4");
+        settings.add("support_mesh", "false");
+        settings.add("support_mesh_drop_down", "false");
+        settings.add("support_offset", "0.8");
+        settings.add("support_pattern", "lines");
+        settings.add("support_roof_enable", "false");
+        settings.add("support_roof_extruder_nr", "0");
+        settings.add("support_structure", "normal");
+        settings.add("support_top_distance", "0.2");
+        settings.add("support_tower_diameter", "3");
+        settings.add("support_tower_maximum_supported_diameter", "3");
+        settings.add("support_tower_roof_angle", "65");
+        settings.add("support_type", "everywhere");
+        settings.add("support_use_towers", "false");
+        settings.add("support_wall_count", "1");
+        settings.add("support_xy_distance", "0.7");
+        settings.add("support_xy_distance_overhang", "0.2");
+        settings.add("support_xy_overrides_z", "xy_overrides_z");
+        settings.add("wall_0_extruder_nr", "0");
+        Application::getInstance().current_slice_->scene.extruders.emplace_back(0, &settings);
+
+        std::vector<Mesh>& meshes = Application::getInstance().current_slice_->scene.current_mesh_group->meshes;
+        meshes.emplace_back(settings);
+
+        // An upside-down stepped pyramid on a thin stem, which needs support under almost every layer.
+        const size_t layer_count = state.range(0);
+        storage = std::make_unique<SliceDataStorage>();
+        storage->print_layer_count = layer_count;
+        storage->support.supportLayers.resize(layer_count);
+        auto mesh = std::make_shared<SliceMeshStorage>(&meshes.back(), layer_count);
+        mesh->full_overhang_areas.resize(layer_count);
+        mesh->overhang_areas.resize(layer_count);
+        Polygons previous_outline;
+        for (size_t layer_idx = 0; layer_idx < layer_count; layer_idx++)
+        {
+            const coord_t half_width = MM2INT(2) + MM2INT(40) * layer_idx / layer_count;
+            Polygons outline;
+            PolygonRef square = outline.newPoly();
+            square.emplace_back(MM2INT(125) - half_width, MM2INT(125) - half_width);
+            square.emplace_back(MM2INT(125) + half_width, MM2INT(125) - half_width);
+            square.emplace_back(MM2INT(125) + half_width, MM2INT(125) + half_width);
+            square.emplace_back(MM2INT(125) - half_width, MM2INT(125) + half_width);
+            SliceLayerPart& part = mesh->layers[layer_idx].parts.emplace_back();
+            part.outline.add(outline);
+            part.print_outline = outline;
+            if (layer_idx > 0)
+            {
+                mesh->full_overhang_areas[layer_idx] = outline.difference(previous_outline);
+                mesh->overhang_areas[layer_idx] = mesh->full_overhang_areas[layer_idx];
+            }
+            previous_outline = outline;
+        }
+        mesh->layer_nr_max_filled_layer = layer_count - 1;
+        storage->meshes.push_back(mesh);
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+        storage.reset();
+        delete Application::getInstance().current_slice_;
+        Application::getInstance().current_slice_ = nullptr;
+    }
+};
+
+BENCHMARK_DEFINE_F(SupportTestFixture, generateSupportAreas)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        st.PauseTiming();
+        for (SupportLayer& support_layer : storage->support.supportLayers)
+        {
+            support_layer.support_infill_parts.clear();
+        }
+        st.ResumeTiming();
+        AreaSupport::generateSupportAreas(*storage);
+    }
+}
+
+BENCHMARK_REGISTER_F(SupportTestFixture, generateSupportAreas)->Arg(100)->Arg(500)->Arg(1000)->Unit(benchmark::kMillisecond);
+} // namespace cura
+#endif // CURAENGINE_SUPPORT_BENCHMARK_H
@@ -0,0 +1,105 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_TIME_ESTIMATE_BENCHMARK_H
+#define CURAENGINE_TIME_ESTIMATE_BENCHMARK_H
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "GCodeTimeEstimator.h"
+#include "PrintFeature.h"
+#include "timeEstimate.h"
+
+namespace cura
+{
+class TimeEstimateTestFixture : public benchmark::Fixture
+{
+public:
+    static constexpr size_t moves_per_layer = 5000;
+    std::vector<TimeEstimateCalculator::Position> positions;
+    std::string gcode;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        // A random walk of short extrusion moves with a travel move every now and then, like a layer of infill.
+        const size_t layer_count = state.range(0);
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> step_distribution(-5.0, 5.0);
+        positions.clear();
+        std::ostringstream gcode_stream;
+        double x = 100.0;
+        double y = 100.0;
+        double e = 0.0;
+        for (size_t layer_idx = 0; layer_idx < layer_count; layer_idx++)
+        {
+            const double z = 0.2 * (layer_idx + 1);
+            gcode_stream << ";LAYER:" << layer_idx << "\n;TYPE:FILL\nG0 F6000 Z" << z << "\n";
+            for (size_t move_idx = 0; move_idx < moves_per_layer; move_idx++)
+            {
+                x += step_distribution(generator);
+                y += step_distribution(generator);
+                if (move_idx % 50 == 0)
+                {
+                    gcode_stream << "G0 F6000 X" << x << " Y" << y << "\n";
+                }
+                else
+                {
+                    e += 0.1;
+                    gcode_stream << "G1 F3000 X" << x << " Y" << y << " E" << e << "\n";
+                }
+                positions.emplace_back(x, y, z, e);
+            }
+        }
+        gcode = gcode_stream.str();
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+};
+
+// The planner as used by the g-code writer: plan one layer of moves, then calculate and reset.
+BENCHMARK_DEFINE_F(TimeEstimateTestFixture, TimeEstimateCalculator_plan_and_calculate)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        TimeEstimateCalculator calculator;
+        Duration total = 0.0;
+        for (size_t move_idx = 0; move_idx < positions.size(); move_idx++)
+        {
+            calculator.plan(positions[move_idx], 50.0, PrintFeatureType::Infill);
+            if ((move_idx + 1) % moves_per_layer == 0)
+            {
+                for (const Duration& time : calculator.calculate())
+                {
+                    total += time;
+                }
+                calculator.reset();
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+BENCHMARK_REGISTER_F(TimeEstimateTestFixture, TimeEstimateCalculator_plan_and_calculate)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(TimeEstimateTestFixture, GCodeTimeEstimator_process)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        std::istringstream gcode_stream(gcode);
+        GCodeTimeEstimator estimator;
+        estimator.process(gcode_stream);
+        std::vector<Duration> result = estimator.calculate();
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK_REGISTER_F(TimeEstimateTestFixture, GCodeTimeEstimator_process)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+} // namespace cura
+#endif // CURAENGINE_TIME_ESTIMATE_BENCHMARK_H
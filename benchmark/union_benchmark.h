@@ -0,0 +1,87 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_UNION_BENCHMARK_H
+#define CURAENGINE_UNION_BENCHMARK_H
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Application.h"
+#include "utils/polygon.h"
+#include "utils/polygonUtils.h"
+
+namespace cura
+{
+class UnionTestFixture : public benchmark::Fixture
+{
+public:
+    std::vector<Polygons> inputs;
+
+    /*!
+     * Scatter overlapping circles over an area, like the branches of tree
+     * support on a layer.
+     */
+    void SetUp(const ::benchmark::State& state)
+    {
+        Application::getInstance().startThreadPool();
+
+        const size_t input_count = state.range(0);
+        const coord_t area_size = MM2INT(1) * static_cast<coord_t>(std::sqrt(static_cast<double>(input_count)));
+        std::mt19937 generator(0);
+        std::uniform_int_distribution<coord_t> position(0, area_size);
+        std::uniform_int_distribution<coord_t> radius(MM2INT(0.5), MM2INT(2));
+        inputs.clear();
+        for (size_t i = 0; i < input_count; i++)
+        {
+            Polygons circle;
+            circle.add(PolygonUtils::makeCircle(Point2LL(position(generator), position(generator)), radius(generator)));
+            inputs.push_back(circle);
+        }
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+};
+
+BENCHMARK_DEFINE_F(UnionTestFixture, Union_one_at_a_time)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        Polygons result;
+        for (const Polygons& input : inputs)
+        {
+            result = result.unionPolygons(input);
+        }
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK_REGISTER_F(UnionTestFixture, Union_one_at_a_time)->Arg(64)->Arg(512)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(UnionTestFixture, Union_all)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        Polygons result = Polygons::unionAll(inputs);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK_REGISTER_F(UnionTestFixture, Union_all)->Arg(64)->Arg(512)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(UnionTestFixture, Union_all_parallel)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        Polygons result = Polygons::unionAllParallel(inputs);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK_REGISTER_F(UnionTestFixture, Union_all_parallel)->Arg(64)->Arg(512)->Arg(4096)->Unit(benchmark::kMillisecond);
+} // namespace cura
+#endif // CURAENGINE_UNION_BENCHMARK_H
@@ -116,6 +116,16 @@ protected:
      */
     void slice();
 
+    /*!
+     * \brief Keep slicing jobs that are read from stdin, until stdin closes.
+     *
+     * Each line is a job with the arguments of the slice command. The thread
+     * pool and the parsed definition files are kept between the jobs, so that
+     * a series of small slices doesn't spend most of its time on starting the
+     * process and parsing the definitions.
+     */
+    void daemon();
+
 private:
     /*
      * \brief The number of arguments that the application was called with.
@@ -5,10 +5,14 @@
 #ifndef CONICAL_OVERHANG_H
 #define CONICAL_OVERHANG_H
 
+#include <vector>
+
 namespace cura {
 
 class Mesh;
+class Settings;
 class Slicer;
+class SlicerLayer;
 
 /*!
  * A class for changing the geometry of a model such that it is printable without support -
@@ -24,6 +28,19 @@ public:
      * \param mesh The mesh to get the settings from.
      */
     static void apply(Slicer* slicer, const Mesh& mesh);
+
+    /*!
+     * Change the layers of a mesh such that the model becomes more printable
+     *
+     * Everything that only depends on the original layers, such as splitting
+     * them into parts and finding the holes that are covered by the layer
+     * above, is done for all layers in parallel first. Only what depends on
+     * the changed layer above is done from the top down.
+     *
+     * \param[in,out] layers The layers of the mesh.
+     * \param settings The settings of the mesh.
+     */
+    static void apply(std::vector<SlicerLayer>& layers, const Settings& settings);
 };
 
 }//namespace cura
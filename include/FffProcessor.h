@@ -4,6 +4,8 @@
 #ifndef FFF_PROCESSOR_H
 #define FFF_PROCESSOR_H
 
+#include <memory>
+
 #include "FffGcodeWriter.h"
 #include "FffPolygonGenerator.h"
 #include "utils/gettime.h"
@@ -22,6 +24,8 @@ private:
     static FffProcessor instance;
 
 public:
+    FffProcessor();
+
     /*!
      * Get the instance
      * \return The instance
@@ -33,8 +37,10 @@ public:
 
     /*!
      * The gcode writer, which generates paths in layer plans in a buffer, which converts these paths into gcode commands.
+     *
+     * It keeps state between the mesh groups of a slice, so it's replaced by \ref reset before a next slice in the same process.
      */
-    FffGcodeWriter gcode_writer;
+    std::unique_ptr<FffGcodeWriter> gcode_writer;
 
     /*!
      * The polygon generator, which slices the models and generates all polygons to be printed and areas to be filled.
@@ -85,6 +91,15 @@ public:
      * Add the end gcode and set all temperatures to zero.
      */
     void finalize();
+
+    /*!
+     * Start over with a new gcode writer, as if this were a new process.
+     *
+     * This closes the output file of the previous slice, and forgets the
+     * extruder order, the height of the printed objects and the state of the
+     * printer that the previous slice ended with.
+     */
+    void reset();
 };
 
 }//namespace cura
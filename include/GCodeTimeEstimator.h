@@ -0,0 +1,104 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef GCODE_TIME_ESTIMATOR_H
+#define GCODE_TIME_ESTIMATOR_H
+
+#include <istream>
+#include <string_view>
+#include <vector>
+
+#include "PrintFeature.h"
+#include "settings/types/Duration.h"
+#include "settings/types/Velocity.h"
+#include "timeEstimate.h"
+
+namespace cura
+{
+
+class Settings;
+
+/*!
+ * Estimates the print time of existing g-code, without slicing anything.
+ *
+ * The moves are fed to the same \ref TimeEstimateCalculator that the g-code
+ * writer uses, and the planner is flushed at every layer change like the g-code
+ * writer does. Re-estimating g-code that CuraEngine wrote therefore gives
+ * nearly the same times as those in its header. They only differ due to the
+ * rounding of the numbers in the g-code and the time of the start and end
+ * g-code, which isn't known here. This allows estimating the time of g-code
+ * with different firmware settings, or after post-processing, without slicing
+ * the model again.
+ *
+ * The feature type of extrusion moves is taken from the ";TYPE:" comments. The
+ * E values are taken as millimetres of filament, so volumetric g-code is not
+ * supported.
+ */
+class GCodeTimeEstimator
+{
+public:
+    /*!
+     * Create an estimator with the default firmware settings of the
+     * \ref TimeEstimateCalculator.
+     */
+    GCodeTimeEstimator();
+
+    /*!
+     * Create an estimator for a printer with the given firmware settings.
+     * \param settings Where to get the machine_max_* firmware settings from.
+     */
+    explicit GCodeTimeEstimator(const Settings& settings);
+
+    /*!
+     * Process all lines of g-code in a stream.
+     * \param gcode The g-code to estimate.
+     */
+    void process(std::istream& gcode);
+
+    /*!
+     * Process a single line of g-code.
+     *
+     * Unknown commands are ignored.
+     * \param line The line, without line ending.
+     */
+    void processLine(std::string_view line);
+
+    /*!
+     * Finish the estimate, planning the moves that are still buffered.
+     *
+     * No further lines should be processed after this.
+     * \return The total print time for each feature type.
+     */
+    std::vector<Duration> calculate();
+
+    /*!
+     * Get the print time of each layer, in the order of the ";LAYER:" comments
+     * in the g-code.
+     *
+     * Only complete after \ref calculate has been called.
+     */
+    const std::vector<Duration>& getLayerTimes() const;
+
+private:
+    /*!
+     * Plan the buffered moves and add their times to the totals.
+     * \return The total time of the moves that were buffered.
+     */
+    Duration flush();
+
+    TimeEstimateCalculator calculator_;
+    TimeEstimateCalculator::Position position_;
+    Velocity feedrate_{ 25.0 }; //!< The current feedrate, in mm/s. Until the g-code sets one this is an arbitrary default.
+    bool relative_positioning_{ false }; //!< Whether the X, Y and Z coordinates are relative (G91).
+    bool relative_extrusion_{ false }; //!< Whether the E coordinates are relative (M83).
+    bool is_retracted_{ false }; //!< Whether the filament is currently retracted, making travel moves count as MoveRetraction like in the g-code writer.
+    PrintFeatureType feature_{ PrintFeatureType::NoneType }; //!< The feature type of the current ";TYPE:" section.
+
+    bool in_layer_{ false }; //!< Whether a ";LAYER:" comment has been seen. Moves before the first layer are not part of any layer.
+    std::vector<Duration> total_print_times_;
+    std::vector<Duration> layer_times_;
+};
+
+} // namespace cura
+
+#endif // GCODE_TIME_ESTIMATOR_H
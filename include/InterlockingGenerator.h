@@ -5,9 +5,9 @@
 #define INTERLOCKING_GENERATOR_H
 
 #include <cassert>
-#include <unordered_set>
 #include <vector>
 
+#include "utils/VoxelGrid.h"
 #include "utils/VoxelUtils.h"
 #include "utils/polygon.h"
 
@@ -113,26 +113,28 @@ protected:
      * Expand the meshes into each other where they need it, namely when a thin strip of material needs to be attached.
      * \param has_all_meshes Only do this special handling if there's actually microstructure nearby that needs to be adhered to.
      */
-    void handleThinAreas(const std::unordered_set<GridPoint3>& has_all_meshes) const;
+    void handleThinAreas(const VoxelGrid& has_all_meshes) const;
 
     /*!
-     * Compute the voxels overlapping with the shell of both models.
+     * Compute the voxels overlapping with the shell of both models, before dilating them.
      * This includes the walls, but also top/bottom skin.
      *
-     * \param kernel The dilation kernel to give the returned voxel shell more thickness
-     * \return The shell voxels for mesh a and those for mesh b
+     * \param kernel The dilation kernel which is going to give the voxel shell more thickness
+     * \return The shell voxels for mesh a and those for mesh b. Voxels may occur multiple times.
      */
-    std::vector<std::unordered_set<GridPoint3>> getShellVoxels(const DilationKernel& kernel) const;
+    std::vector<std::vector<GridPoint3>> getShellVoxels(const DilationKernel& kernel) const;
 
     /*!
-     * Compute the voxels overlapping with the shell of some layers.
+     * Compute the voxels overlapping with the shell of some layers, before dilating them.
      * This includes the walls, but also top/bottom skin.
      *
+     * The layers are voxelized in parallel.
+     *
      * \param layers The layer outlines for which to compute the shell voxels
-     * \param kernel The dilation kernel to give the returned voxel shell more thickness
-     * \param[out] cells The output cells which elong to the shell
+     * \param kernel The dilation kernel which is going to give the voxel shell more thickness
+     * \return The cells which belong to the shell. Cells may occur multiple times.
      */
-    void addBoundaryCells(const std::vector<Polygons>& layers, const DilationKernel& kernel, std::unordered_set<GridPoint3>& cells) const;
+    std::vector<GridPoint3> getBoundaryCells(const std::vector<Polygons>& layers, const DilationKernel& kernel) const;
 
     /*!
      * Compute the regions occupied by both models.
@@ -154,7 +156,7 @@ protected:
      * \param cells The cells where we want to apply the interlocking structure.
      * \param layer_regions The total volume of the two meshes combined (and small gaps closed)
      */
-    void applyMicrostructureToOutlines(const std::unordered_set<GridPoint3>& cells, const std::vector<Polygons>& layer_regions) const;
+    void applyMicrostructureToOutlines(const VoxelGrid& cells, const std::vector<Polygons>& layer_regions) const;
 
     static const coord_t ignored_gap_ = 100u; //!< Distance between models to be considered next to each other so that an interlocking structure will be generated there
 
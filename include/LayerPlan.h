@@ -16,6 +16,7 @@
 #include "settings/PathConfigStorage.h"
 #include "settings/types/LayerIndex.h"
 #include "utils/ExtrusionJunction.h"
+#include "utils/PreparedPolygons.h"
 #include "utils/polygon.h"
 
 #ifdef BUILD_TESTS
@@ -91,10 +92,13 @@ private:
     bool is_inside_; //!< Whether the destination of the next planned travel move is inside a layer part
     Polygons comb_boundary_minimum_; //!< The minimum boundary within which to comb, or to move into when performing a retraction.
     Polygons comb_boundary_preferred_; //!< The boundary preferably within which to comb, or to move into when performing a retraction.
+    std::optional<PreparedPolygons> comb_boundary_preferred_index_; //!< Point location index over comb_boundary_preferred_, built when first needed.
     Comb* comb_;
     coord_t comb_move_inside_distance_; //!< Whenever using the minimum boundary for combing it tries to move the coordinates inside by this distance after calculating the combing.
     Polygons bridge_wall_mask_; //!< The regions of a layer part that are not supported, used for bridging
     Polygons overhang_mask_; //!< The regions of a layer part where the walls overhang
+    PreparedPolygons bridge_wall_mask_index_; //!< Point location index over bridge_wall_mask_, since every wall segment is tested against it
+    PreparedPolygons overhang_mask_index_; //!< Point location index over overhang_mask_, since every wall segment is tested against it
 
     const std::vector<FanSpeedLayerTimeSettings> fan_speed_layer_time_settings_per_extruder_;
 
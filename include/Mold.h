@@ -6,6 +6,9 @@
 
 #include <vector>
 
+#include "utils/Coord_t.h"
+#include "utils/polygon.h"
+
 namespace cura
 {
 
@@ -36,7 +39,37 @@ public:
      */
     static void process(std::vector<Slicer*>& slicer_list);
 
+    /*!
+     * \brief Compute the outer outlines of a mold from the top down.
+     *
+     * The outline of each layer is the outline of the layer above, shrunk by
+     * \p inset, plus the part of the mold on that layer itself.
+     *
+     * Though each layer depends on the layer above, the layers are computed in
+     * parallel blocks. Each block is first computed as if there were no mold
+     * above it. Then, from the top down, the top layers of each block are
+     * recomputed with the actual outline above, until that no longer makes a
+     * difference. The result is the same as computing all layers in sequence,
+     * up to differences that are narrower than \ref convergence_tolerance.
+     * \param mold_parts For each layer, the part of the mold that doesn't
+     * depend on the layers above it.
+     * \param inset How much the outline of the mold shrinks per layer.
+     * \return For each layer, the outer outline of the mold.
+     */
+    static std::vector<Polygons> accumulateOutlines(const std::vector<Polygons>& mold_parts, const coord_t inset);
+
+    /*!
+     * The width below which the outlines of a layer are considered to be the
+     * same as the outlines that would have been computed in sequence.
+     */
+    static constexpr coord_t convergence_tolerance = 5;
+
 private:
+    /*!
+     * The number of layers that are computed in sequence by the same thread in
+     * \ref accumulateOutlines.
+     */
+    static constexpr size_t block_size = 32;
 };
 
 } // namespace cura
@@ -4,9 +4,11 @@
 #ifndef PATHORDERMONOTONIC_H
 #define PATHORDERMONOTONIC_H
 
+#include <algorithm> //For std::merge, std::upper_bound and std::stable_sort.
 #include <cmath> //For std::sin() and std::cos().
-#include <unordered_map> //To track monotonic sequences.
-#include <unordered_set> //To track starting points of monotonic sequences.
+#include <deque> //To track strings of polylines.
+#include <limits> //For the invalid position.
+#include <vector> //To track monotonic sequences by position.
 
 #include "PathOrder.h"
 #include "PathOrdering.h"
@@ -101,6 +103,17 @@ public:
 
                 return a_projection < b_projection;
             });
+        // The rest of the bookkeeping is done by the position of each polyline in this sorted list, in flat vectors.
+        std::vector<size_t> position_of_path(this->paths_.size(), no_position_); // For each path, by index in paths_, its position in the sorted polylines.
+        for (size_t position = 0; position < polylines.size(); position++)
+        {
+            position_of_path[polylines[position] - this->paths_.data()] = position;
+        }
+        const auto position_of = [this, &position_of_path](const Path* path)
+        {
+            return position_of_path[path - this->paths_.data()];
+        };
+
         // Create a bucket grid to be able to find adjacent lines quickly.
         SparsePointGridInclusive<Path*> line_bucket_grid(MM2INT(2)); // Grid size of 2mm.
         for (Path* polyline : polylines)
@@ -121,125 +134,129 @@ public:
         //  printed in monotonic order.
         //    - The earlier line is marked as being in sequence with the later line.
         //    - The later line is no longer a starting point, unless there are multiple adjacent lines before it.
-        // The ``starting_lines`` set indicates possible locations to start from. Each starting line represents one "sequence", which is either a set of adjacent line segments or a
-        // string of polylines. The ``connections`` map indicates, starting from each starting segment, the sequence of line segments to print in order. Note that for performance
-        // reasons, the ``connections`` map will sometimes link the end of one segment to the start of the next segment. This link should be ignored.
+        // The ``starting_lines`` indicate possible locations to start from. Each starting line represents one "sequence", which is either a set of adjacent line segments or a
+        // string of polylines. The ``connections`` indicate, starting from each starting segment, the sequence of line segments to print in order. Note that for performance
+        // reasons, the ``connections`` will sometimes link the end of one segment to the start of the next segment. This link should be ignored.
         const Point2LL perpendicular = turn90CCW(monotonic_vector_); // To project on to detect adjacent lines.
+        std::vector<ProjectedLine> projections;
+        projections.reserve(polylines.size());
+        for (const Path* polyline : polylines)
+        {
+            projections.push_back(project(*polyline, perpendicular));
+        }
+        const OverlapIndex overlap_index(projections);
 
-        std::unordered_set<Path*> connected_lines; // Lines that are reachable from one of the starting lines through its connections.
-        std::unordered_set<Path*> starting_lines; // Starting points of a linearly connected segment.
-        std::unordered_map<Path*, Path*> connections; // For each polyline, which polyline it overlaps with, closest in the projected order.
+        std::vector<bool> connected_lines(polylines.size(), false); // Lines that are reachable from one of the starting lines through its connections.
+        std::vector<bool> starting_lines(polylines.size(), false); // Starting points of a linearly connected segment.
+        std::vector<size_t> connections(polylines.size(), no_position_); // For each polyline, which polyline it overlaps with, closest in the projected order.
+        std::vector<size_t> polystring_of(polylines.size(), no_position_); // For polylines in a string of polylines, the position at which that string was found.
 
-        for (auto polyline_it = polylines.begin(); polyline_it != polylines.end(); polyline_it++)
+        for (size_t position = 0; position < polylines.size(); position++)
         {
-            if (connections.contains(*polyline_it)) // Already connected this one through a polyline.
+            if (connections[position] != no_position_) // Already connected this one through a polyline.
             {
                 continue;
             }
             // First find out if this polyline is part of a string of polylines.
-            std::deque<Path*> polystring = findPolylineString(*polyline_it, line_bucket_grid, monotonic_vector_);
+            std::deque<Path*> polystring = findPolylineString(polylines[position], line_bucket_grid, monotonic_vector_);
 
             // If we're part of a string of polylines, connect up the whole string and mark all of them as being connected.
             if (polystring.size() > 1)
             {
-                starting_lines.insert(polystring[0]);
+                for (const Path* path : polystring)
+                {
+                    polystring_of[position_of(path)] = position;
+                }
+                starting_lines[position_of(polystring[0])] = true;
                 for (size_t i = 0; i < polystring.size() - 1; ++i) // Iterate over every pair of adjacent polylines in the string (so skip the last one)!
                 {
-                    connections[polystring[i]] = polystring[i + 1];
-                    connected_lines.insert(polystring[i + 1]);
+                    const size_t current = position_of(polystring[i]);
+                    const size_t next = position_of(polystring[i + 1]);
+                    connections[current] = next;
+                    connected_lines[next] = true;
 
                     // Even though we chain polylines, we still want to find lines that they overlap with.
                     // The strings of polylines may still have weird shapes which interweave with other strings of polylines or loose lines.
                     // So when a polyline string comes into contact with other lines, we still want to guarantee their order.
                     // So here we will look for which lines they come into contact with, and thus mark those as possible starting points, so that they function as a new junction.
-                    const std::vector<Path*> overlapping_lines = getOverlappingLines(std::find(polylines.begin(), polylines.end(), polystring[i]), perpendicular, polylines);
-                    for (Path* overlapping_line : overlapping_lines)
+                    for (const size_t overlapping_line : getOverlappingLines(current, projections, overlap_index))
                     {
-                        if (std::find(polystring.begin(), polystring.end(), overlapping_line)
-                            == polystring.end()) // Mark all overlapping lines not part of the string as possible starting points.
+                        if (polystring_of[overlapping_line] != position) // Mark all overlapping lines not part of the string as possible starting points.
                         {
-                            starting_lines.insert(overlapping_line);
-                            starting_lines.insert(polystring[i + 1]); // Also be able to re-start from this point in the string.
+                            starting_lines[overlapping_line] = true;
+                            starting_lines[next] = true; // Also be able to re-start from this point in the string.
                         }
                     }
                 }
             }
             else // Not a string of polylines, but simply adjacent line segments.
             {
-                if (! connected_lines.contains(*polyline_it)) // Nothing connects to this line yet.
+                if (! connected_lines[position]) // Nothing connects to this line yet.
                 {
-                    starting_lines.insert(*polyline_it); // This is a starting point then.
+                    starting_lines[position] = true; // This is a starting point then.
                 }
-                const std::vector<Path*> overlapping_lines = getOverlappingLines(polyline_it, perpendicular, polylines);
+                const std::vector<size_t> overlapping_lines = getOverlappingLines(position, projections, overlap_index);
                 if (overlapping_lines.size() == 1) // If we're not a string of polylines, but adjacent to only one other polyline, create a sequence of polylines.
                 {
-                    connections[*polyline_it] = overlapping_lines[0];
-                    if (connected_lines.contains(overlapping_lines[0])) // This line was already connected to.
+                    connections[position] = overlapping_lines[0];
+                    if (connected_lines[overlapping_lines[0]]) // This line was already connected to.
                     {
-                        starting_lines.insert(overlapping_lines[0]); // Multiple lines connect to it, so we must be able to start there.
+                        starting_lines[overlapping_lines[0]] = true; // Multiple lines connect to it, so we must be able to start there.
                     }
                     else
                     {
-                        connected_lines.insert(overlapping_lines[0]);
+                        connected_lines[overlapping_lines[0]] = true;
                     }
                 }
                 else // Either 0 (the for loop terminates immediately) or multiple overlapping lines. For multiple lines we need to mark all of them a starting position.
                 {
-                    for (Path* overlapping_line : overlapping_lines)
+                    for (const size_t overlapping_line : overlapping_lines)
                     {
-                        starting_lines.insert(overlapping_line);
+                        starting_lines[overlapping_line] = true;
                     }
                 }
             }
         }
 
         // Order the starting points of each segments monotonically. This is the order in which to print each segment.
-        std::vector<Path*> starting_lines_monotonic;
-        starting_lines_monotonic.resize(starting_lines.size());
-        std::partial_sort_copy(
-            starting_lines.begin(),
-            starting_lines.end(),
+        // The projection of a path is the endpoint furthest back of the two endpoints. But in case of ties, the other endpoint counts too. Important for polylines where
+        // multiple endpoints have the same position! Lines that tie on both stay in their sorted order.
+        std::vector<size_t> starting_lines_monotonic;
+        for (size_t position = 0; position < polylines.size(); position++)
+        {
+            if (starting_lines[position])
+            {
+                starting_lines_monotonic.push_back(position);
+            }
+        }
+        std::stable_sort(
             starting_lines_monotonic.begin(),
             starting_lines_monotonic.end(),
-            [this](Path* a, Path* b)
+            [&projections](const size_t a, const size_t b)
             {
-                const coord_t a_start_projection = dot(a->converted_->front(), monotonic_vector_);
-                const coord_t a_end_projection = dot(a->converted_->back(), monotonic_vector_);
-                const coord_t a_projection_min = std::min(a_start_projection, a_end_projection); // The projection of a path is the endpoint furthest back of the two endpoints.
-                const coord_t a_projection_max = std::max(
-                    a_start_projection,
-                    a_end_projection); // But in case of ties, the other endpoint counts too. Important for polylines where multiple endpoints have the same position!
-
-                const coord_t b_start_projection = dot(b->converted_->front(), monotonic_vector_);
-                const coord_t b_end_projection = dot(b->converted_->back(), monotonic_vector_);
-                const coord_t b_projection_min = std::min(b_start_projection, b_end_projection);
-                const coord_t b_projection_max = std::max(b_start_projection, b_end_projection);
-
-                return a_projection_min < b_projection_min || (a_projection_min == b_projection_min && a_projection_max < b_projection_max);
+                const ProjectedLine& a_projection = projections[a];
+                const ProjectedLine& b_projection = projections[b];
+                return a_projection.monotonic_closest < b_projection.monotonic_closest
+                    || (a_projection.monotonic_closest == b_projection.monotonic_closest && a_projection.monotonic_farthest < b_projection.monotonic_farthest);
             });
 
         // Now that we have the segments of overlapping lines, and know in which order to print the segments, print segments in monotonic order.
         Point2LL current_pos = this->start_point_;
-        for (Path* line : starting_lines_monotonic)
+        std::vector<size_t> continued_in_sequence(polylines.size(), no_position_); // For each line, the last sequence that continued from it to its connection.
+        for (const size_t starting_line : starting_lines_monotonic)
         {
-            optimizeClosestStartPoint(*line, current_pos);
-            reordered.push_back(*line); // Plan the start of the sequence to be printed next!
-            auto connection = connections.find(line);
-
-            std::unordered_map<Path*, Path*> checked_connections; // Which connections have already been iterated over
-            auto checked_connection = checked_connections.find(line);
+            size_t line = starting_line;
+            optimizeClosestStartPoint(*polylines[line], current_pos);
+            reordered.push_back(*polylines[line]); // Plan the start of the sequence to be printed next!
 
-            while (connection != connections.end() // Stop if the sequence ends
-                   && starting_lines.find(connection->second) == starting_lines.end() // or if we hit another starting point.
-                   && (checked_connection == checked_connections.end()
-                       || checked_connection->second != connection->second)) // or if we have already checked the connection (to avoid falling into a cyclical connection)
+            while (connections[line] != no_position_ // Stop if the sequence ends
+                   && ! starting_lines[connections[line]] // or if we hit another starting point.
+                   && continued_in_sequence[line] != starting_line) // or if we have already continued from this line (to avoid falling into a cyclical connection)
             {
-                checked_connections.insert({ connection->first, connection->second });
-                line = connection->second;
-                optimizeClosestStartPoint(*line, current_pos);
-                reordered.push_back(*line); // Plan this line in, to be printed next!
-                connection = connections.find(line);
-                checked_connection = checked_connections.find(line);
+                continued_in_sequence[line] = starting_line;
+                line = connections[line];
+                optimizeClosestStartPoint(*polylines[line], current_pos);
+                reordered.push_back(*polylines[line]); // Plan this line in, to be printed next!
             }
         }
 
@@ -418,66 +435,200 @@ protected:
     }
 
     /*!
-     * Find which lines are overlapping with a certain line.
-     * \param polyline_it The line with which to find overlaps. Given as an
-     * iterator into the sorted polylines list, to cut down on the search space.
-     * If the lines don't have too much overlap, this should result in only a
-     * handful of lines being searched at all.
+     * The extent of a polyline, projected on the monotonic vector and on the
+     * perpendicular vector.
+     *
+     * Only the endpoints of the polyline are projected.
+     */
+    struct ProjectedLine
+    {
+        coord_t monotonic_closest; //!< The endpoint furthest back in the monotonic direction.
+        coord_t monotonic_farthest; //!< The endpoint furthest ahead in the monotonic direction.
+        coord_t perpendicular_closest; //!< Where the line starts in the perpendicular direction.
+        coord_t perpendicular_farthest; //!< Where the line ends in the perpendicular direction.
+    };
+
+    /*!
+     * Project a polyline on the monotonic vector and the perpendicular vector.
+     * \param polyline The polyline to project.
      * \param perpendicular A vector perpendicular to the monotonic vector, pre-
      * calculated.
-     * \param polylines The sorted list of polylines.
      */
-    std::vector<Path*> getOverlappingLines(const typename std::vector<Path*>::iterator polyline_it, const Point2LL perpendicular, const std::vector<Path*>& polylines)
+    ProjectedLine project(const Path& polyline, const Point2LL perpendicular) const
     {
-        const coord_t max_adjacent_projected_distance = max_adjacent_distance_ * monotonic_vector_resolution_;
-        // How far this extends in the monotonic direction, to make sure we only go up to max_adjacent_distance in that direction.
-        const coord_t start_monotonic = dot((*polyline_it)->converted_->front(), monotonic_vector_);
-        const coord_t end_monotonic = dot((*polyline_it)->converted_->back(), monotonic_vector_);
-        const coord_t my_farthest_monotonic = std::max(start_monotonic, end_monotonic);
-        const coord_t my_closest_monotonic = std::min(start_monotonic, end_monotonic);
-        const coord_t my_farthest_monotonic_padded = my_farthest_monotonic + max_adjacent_projected_distance;
-        const coord_t my_closest_monotonic_padded = my_closest_monotonic - max_adjacent_projected_distance;
-        // How far this line reaches in the perpendicular direction -- the range at which the line overlaps other lines.
-        const coord_t my_start = dot((*polyline_it)->converted_->front(), perpendicular);
-        const coord_t my_end = dot((*polyline_it)->converted_->back(), perpendicular);
-        const coord_t my_farthest = std::max(my_start, my_end);
-        const coord_t my_closest = std::min(my_start, my_end);
-        const coord_t my_farthest_padded = my_farthest + max_adjacent_projected_distance;
-        const coord_t my_closest_padded = my_closest - max_adjacent_projected_distance;
-
-        std::vector<Path*> overlapping_lines;
-        for (auto overlapping_line = polyline_it + 1; overlapping_line != polylines.end(); overlapping_line++)
+        const coord_t start_monotonic = dot(polyline.converted_->front(), monotonic_vector_);
+        const coord_t end_monotonic = dot(polyline.converted_->back(), monotonic_vector_);
+        const coord_t start_perpendicular = dot(polyline.converted_->front(), perpendicular);
+        const coord_t end_perpendicular = dot(polyline.converted_->back(), perpendicular);
+        return ProjectedLine{ .monotonic_closest = std::min(start_monotonic, end_monotonic),
+                              .monotonic_farthest = std::max(start_monotonic, end_monotonic),
+                              .perpendicular_closest = std::min(start_perpendicular, end_perpendicular),
+                              .perpendicular_farthest = std::max(start_perpendicular, end_perpendicular) };
+    }
+
+    /*!
+     * Index to find which of a range of the sorted polylines overlap with an
+     * interval in the perpendicular direction.
+     *
+     * This is a static interval tree: A segment tree over the positions of the
+     * sorted polylines, where each node keeps its lines sorted by where they
+     * start in the perpendicular direction, along with the farthest that any of
+     * the lines up to there reaches. A query visits the lines of a node
+     * backwards from the end of the interval, until none of the remaining lines
+     * can reach the interval any more. Since adjacent lines hardly overlap each
+     * other, that only visits a few lines besides the overlapping ones.
+     */
+    class OverlapIndex
+    {
+    public:
+        /*!
+         * Build the index.
+         * \param projections The projections of the polylines, in sorted order.
+         */
+        explicit OverlapIndex(const std::vector<ProjectedLine>& projections)
+            : projections_(projections)
+            , nodes_(2 * projections.size())
         {
-            // Don't go beyond the maximum adjacent distance.
-            const coord_t start_their_projection = dot((*overlapping_line)->converted_->front(), monotonic_vector_);
-            const coord_t end_their_projection = dot((*overlapping_line)->converted_->back(), monotonic_vector_);
-            const coord_t their_farthest_projection = std::max(start_their_projection, end_their_projection);
-            const coord_t their_closest_projection = std::min(start_their_projection, end_their_projection);
-            // Multiply by the length of the vector since we need to compare actual distances here.
-            if (their_closest_projection > my_farthest_monotonic_padded || my_closest_monotonic_padded > their_farthest_projection)
+            const size_t leaf_count = projections.size();
+            for (size_t position = 0; position < leaf_count; position++)
             {
-                break; // Too far. This line and all subsequent lines are not adjacent anymore, even though they might be side-by-side.
+                nodes_[leaf_count + position].push_back(Entry{ projections[position].perpendicular_closest, projections[position].perpendicular_farthest, position });
             }
+            for (size_t node = leaf_count; node-- > 1;)
+            {
+                const std::vector<Entry>& left = nodes_[2 * node];
+                const std::vector<Entry>& right = nodes_[2 * node + 1];
+                std::vector<Entry>& merged = nodes_[node];
+                merged.resize(left.size() + right.size());
+                std::merge(
+                    left.begin(),
+                    left.end(),
+                    right.begin(),
+                    right.end(),
+                    merged.begin(),
+                    [](const Entry& a, const Entry& b)
+                    {
+                        return a.perpendicular_closest < b.perpendicular_closest;
+                    });
+                for (size_t entry_idx = 0; entry_idx < merged.size(); entry_idx++)
+                {
+                    merged[entry_idx].farthest_so_far = projections_[merged[entry_idx].position].perpendicular_farthest;
+                    if (entry_idx > 0)
+                    {
+                        merged[entry_idx].farthest_so_far = std::max(merged[entry_idx].farthest_so_far, merged[entry_idx - 1].farthest_so_far);
+                    }
+                }
+            }
+        }
 
-            // Does this one overlap?
-            const coord_t their_start = dot((*overlapping_line)->converted_->front(), perpendicular);
-            const coord_t their_end = dot((*overlapping_line)->converted_->back(), perpendicular);
-            const coord_t their_farthest = std::max(their_start, their_end);
-            const coord_t their_closest = std::min(their_start, their_end);
-            /*There are 5 possible cases of overlapping:
-            - We are behind them, partially overlapping. my_start is between their_start and their_end.
-            - We are in front of them, partially overlapping. my_end is between their_start and their_end.
-            - We are a smaller line, they completely overlap us. Both my_start and my_end are between their_start and their_end. (Caught with the first 2 conditions already.)
-            - We are a bigger line, and completely overlap them. Both their_start and their_end are between my_start and my_end.
-            - Lines are exactly equal. Start and end are the same. (Caught with the previous condition too.)*/
-            if ((my_closest_padded >= their_closest && my_closest_padded <= their_farthest) || (my_farthest_padded >= their_closest && my_farthest_padded <= their_farthest)
-                || (their_closest >= my_closest_padded && their_farthest <= my_farthest_padded))
+        /*!
+         * Find the lines at a range of positions that overlap with an interval
+         * in the perpendicular direction.
+         * \param begin The first position to search.
+         * \param end The position after the last position to search.
+         * \param closest The start of the interval.
+         * \param farthest The end of the interval.
+         * \return The positions of the overlapping lines, in sorted order.
+         */
+        std::vector<size_t> query(size_t begin, size_t end, const coord_t closest, const coord_t farthest) const
+        {
+            std::vector<size_t> result;
+            const auto query_node = [this, closest, farthest, &result](const size_t node)
+            {
+                const std::vector<Entry>& entries = nodes_[node];
+                auto entry = std::upper_bound(
+                    entries.begin(),
+                    entries.end(),
+                    farthest,
+                    [](const coord_t value, const Entry& other)
+                    {
+                        return value < other.perpendicular_closest;
+                    });
+                while (entry != entries.begin())
+                {
+                    entry--;
+                    if (entry->farthest_so_far < closest)
+                    {
+                        break; // None of the lines before this one reach the interval either.
+                    }
+                    if (projections_[entry->position].perpendicular_farthest >= closest)
+                    {
+                        result.push_back(entry->position);
+                    }
+                }
+            };
+            for (begin += projections_.size(), end += projections_.size(); begin < end; begin /= 2, end /= 2)
             {
-                overlapping_lines.push_back(*overlapping_line);
+                if (begin % 2 == 1)
+                {
+                    query_node(begin++);
+                }
+                if (end % 2 == 1)
+                {
+                    query_node(--end);
+                }
             }
+            std::sort(result.begin(), result.end());
+            return result;
         }
 
-        return overlapping_lines;
+    private:
+        struct Entry
+        {
+            coord_t perpendicular_closest; //!< Where the line starts in the perpendicular direction.
+            coord_t farthest_so_far; //!< The farthest that this line or any line before it in the node reaches in the perpendicular direction.
+            size_t position; //!< The position of the line in the sorted polylines.
+        };
+
+        const std::vector<ProjectedLine>& projections_;
+
+        /*!
+         * The nodes of the segment tree, with the root at index 1 and the leaf
+         * of each position at the number of polylines plus that position.
+         */
+        std::vector<std::vector<Entry>> nodes_;
+    };
+
+    /*!
+     * Find which lines are overlapping with a certain line.
+     *
+     * These are the lines after it in the sorted polylines that are within
+     * the maximum adjacent distance in the monotonic direction, and that
+     * overlap with it in the perpendicular direction, padded by that same
+     * distance.
+     * \param position The position of the line in the sorted polylines.
+     * \param projections The projections of the sorted polylines.
+     * \param overlap_index The index to find perpendicular overlaps with.
+     * \return The positions of the overlapping lines, in sorted order.
+     */
+    std::vector<size_t> getOverlappingLines(const size_t position, const std::vector<ProjectedLine>& projections, const OverlapIndex& overlap_index) const
+    {
+        const coord_t max_adjacent_projected_distance = max_adjacent_distance_ * monotonic_vector_resolution_;
+        const ProjectedLine& line = projections[position];
+
+        // The lines are sorted by the endpoint furthest back in the monotonic direction. So the lines that start within the maximum adjacent distance in that direction
+        // are the ones up to the first line that starts beyond it. All lines from there are not adjacent anymore, even though they might be side-by-side.
+        const auto end = std::upper_bound(
+            projections.begin() + position + 1,
+            projections.end(),
+            line.monotonic_farthest + max_adjacent_projected_distance,
+            [](const coord_t value, const ProjectedLine& other)
+            {
+                return value < other.monotonic_closest;
+            });
+
+        /*There are 5 possible cases of overlapping:
+        - We are behind them, partially overlapping. my_start is between their_start and their_end.
+        - We are in front of them, partially overlapping. my_end is between their_start and their_end.
+        - We are a smaller line, they completely overlap us. Both my_start and my_end are between their_start and their_end. (Caught with the first 2 conditions already.)
+        - We are a bigger line, and completely overlap them. Both their_start and their_end are between my_start and my_end.
+        - Lines are exactly equal. Start and end are the same. (Caught with the previous condition too.)
+        Together, these are all cases where our padded interval intersects theirs.*/
+        return overlap_index.query(
+            position + 1,
+            end - projections.begin(),
+            line.perpendicular_closest - max_adjacent_projected_distance,
+            line.perpendicular_farthest + max_adjacent_projected_distance);
     }
 
 protected:
@@ -491,6 +642,11 @@ protected:
      */
     constexpr static coord_t monotonic_vector_resolution_ = 1000;
 
+    /*!
+     * Marks that a polyline has no position, or has no connection.
+     */
+    constexpr static size_t no_position_ = std::numeric_limits<size_t>::max();
+
 private:
     /*!
      * Predicate to check if a nearby path is okay for polylines to connect
@@ -419,27 +419,24 @@ protected:
         const std::function<std::nullptr_t(const Path, const std::nullptr_t)> handle_node
             = [&current_position, &optimized_order, this](const Path current_node, [[maybe_unused]] const std::nullptr_t state)
         {
-            // We should make map from node <-> path for this stuff
-            for (auto& path : paths_)
+            const auto path_it = vertices_to_paths_.find(current_node);
+            if (path_it == vertices_to_paths_.end())
             {
-                if (path.vertices_ == current_node)
-                {
-                    if (path.is_closed_)
-                    {
-                        current_position = (*path.converted_)[path.start_vertex_]; // We end where we started.
-                    }
-                    else
-                    {
-                        // Pick the other end from where we started.
-                        current_position = path.start_vertex_ == 0 ? path.converted_->back() : path.converted_->front();
-                    }
-
-                    // Add to optimized order
-                    optimized_order.push_back(path);
-
-                    break;
-                }
+                return nullptr; // Not one of the paths to order.
+            }
+            const OrderablePath& path = *path_it->second;
+            if (path.is_closed_)
+            {
+                current_position = (*path.converted_)[path.start_vertex_]; // We end where we started.
             }
+            else
+            {
+                // Pick the other end from where we started.
+                current_position = path.start_vertex_ == 0 ? path.converted_->back() : path.converted_->front();
+            }
+
+            // Add to optimized order
+            optimized_order.push_back(path);
 
             return nullptr;
         };
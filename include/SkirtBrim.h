@@ -54,6 +54,25 @@ private:
         bool is_last_; //!< Whether this is the last planned offset for this extruder.
     };
 
+    /*!
+     * The area of the first layer covered by model or generated brim lines, which grows with every brim line.
+     *
+     * Every brim line has to be removed from the areas where brim lines are allowed. Rather than unioning each line into
+     * the whole covered area and removing all of that from the allowed areas again, only the area around the line itself
+     * is removed from the allowed areas. Those areas are unioned into the covered area all at once, when it's needed.
+     */
+    struct CoveredArea
+    {
+        Polygons area; //!< The covered area, without the \ref added areas.
+        Polygons added; //!< The areas covered by brim lines that are not in \ref area yet. Each of them is unioned by itself.
+        bool excluded{ false }; //!< Whether \ref area is already removed from all allowed areas. If not, the next brim line removes it.
+
+        /*!
+         * Get the complete covered area.
+         */
+        Polygons& get();
+    };
+
     /*!
      * Defines an order on offsets (potentially from different extruders) based on how far the offset is from the original outline.
      */
@@ -122,7 +141,7 @@ private:
      * \param[in,out] allowed_areas_per_extruder The difference between the machine bed area (offsetted by the nozzle offset) and the covered_area.
      * \return The total length of the brim lines added by this method per extruder.
      */
-    std::vector<coord_t> generatePrimaryBrim(std::vector<Offset>& all_brim_offsets, Polygons& covered_area, std::vector<Polygons>& allowed_areas_per_extruder);
+    std::vector<coord_t> generatePrimaryBrim(std::vector<Offset>& all_brim_offsets, CoveredArea& covered_area, std::vector<Polygons>& allowed_areas_per_extruder);
 
     /*!
      * Generate the brim inside the ooze shield and draft shield
@@ -171,7 +190,7 @@ private:
      * \param[out] result Where to store the resulting brim line
      * \return The length of the added lines
      */
-    coord_t generateOffset(const Offset& offset, Polygons& covered_area, std::vector<Polygons>& allowed_areas_per_extruder, SkirtBrimLine& result);
+    coord_t generateOffset(const Offset& offset, CoveredArea& covered_area, std::vector<Polygons>& allowed_areas_per_extruder, SkirtBrimLine& result);
 
     /*!
      * Generate a skirt of extruders which don't yet comply with the minimum length requirement.
@@ -184,7 +203,7 @@ private:
      * \param[in,out] allowed_areas_per_extruder The difference between the machine areas and the \p covered_area
      * \param[in,out] total_length The total length of the brim lines for each extruder.
      */
-    void generateSecondarySkirtBrim(Polygons& covered_area, std::vector<Polygons>& allowed_areas_per_extruder, std::vector<coord_t>& total_length);
+    void generateSecondarySkirtBrim(CoveredArea& covered_area, std::vector<Polygons>& allowed_areas_per_extruder, std::vector<coord_t>& total_length);
 
 public:
     /*!
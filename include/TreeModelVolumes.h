@@ -6,13 +6,16 @@
 
 #include <future>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "TreeModelVolumesDiskCache.h"
 #include "TreeSupportSettings.h"
 #include "settings/EnumSettings.h" //To store whether X/Y or Z distance gets priority.
 #include "settings/types/LayerIndex.h" //Part of the RadiusLayerPair.
 #include "sliceDataStorage.h"
+#include "utils/RadiusLayerPolygonCache.h"
 #include "utils/Simplify.h"
 #include "utils/polygon.h" //For polygon parameters.
 
@@ -147,12 +150,17 @@ public:
      */
     coord_t getRadiusNextCeil(coord_t radius, bool min_xy_dist) const;
 
+    /*!
+     * \brief Write the hit, miss and wait statistics of all area caches to the log.
+     */
+    void logCacheStatistics() const;
+
 
 private:
     /*!
      * \brief Convenience typedef for the keys to the caches
      */
-    using RadiusLayerPair = std::pair<coord_t, LayerIndex>;
+    using RadiusLayerPair = RadiusLayerPolygonCache::RadiusLayerPair;
 
     /*!
      * \brief Round \p radius upwards to either a multiple of radius_sample_resolution_ or a exponentially increasing value
@@ -331,26 +339,25 @@ private:
         calculateWallRestrictions(std::deque<RadiusLayerPair>{ RadiusLayerPair(key) });
     }
 
+    bool checkSettingsEquality(const Settings& me, const Settings& other) const;
+
+    static Polygons calculateMachineBorderCollision(const Polygons&& machine_border);
+
     /*!
-     * \brief Checks a cache for a given RadiusLayerPair and returns it if it is found
-     * \param key RadiusLayerPair of the requested areas. The radius will be calculated up to the provided layer.
-     * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
+     * \brief Get all area caches, in a fixed order.
      */
-    template<typename KEY>
-    const std::optional<std::reference_wrapper<const Polygons>> getArea(const std::unordered_map<KEY, Polygons>& cache, const KEY key) const;
-
-    bool checkSettingsEquality(const Settings& me, const Settings& other) const;
+    std::vector<RadiusLayerPolygonCache*> getCaches() const;
 
     /*!
-     * \brief Get the highest already calculated layer in the cache.
-     * \param radius The radius for which the highest already calculated layer has to be found.
-     * \param map The cache in which the lookup is performed.
+     * \brief Serialize every input of \ref precalculate, to identify its results in the disk cache.
      *
-     * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
+     * This covers the layer outlines, excluded areas and machine border of every layer, the settings that the precalculation reads from every group of meshes and the values
+     * derived from them.
+     * \param config The tree support settings of the mesh that is currently processed.
+     * \param max_layer The layer up to which the precalculation is done.
+     * \return The key of the precalculated areas.
      */
-    LayerIndex getMaxCalculatedLayer(coord_t radius, const std::unordered_map<RadiusLayerPair, Polygons>& map) const;
-
-    static Polygons calculateMachineBorderCollision(const Polygons&& machine_border);
+    std::string getPrecalculationKey(const TreeSupportSettings& config, const LayerIndex max_layer) const;
 
     /*!
      * \brief The maximum distance that the center point of a tree branch may move in consecutive layers if it has to avoid the model.
@@ -466,58 +473,42 @@ private:
      * \brief Caches for the collision, avoidance and areas on the model where support can be placed safely
      * at given radius and layer indices.
      *
-     * These are mutable to allow modification from const function. This is
-     * generally considered OK as the functions are still logically const
-     * (ie there is no difference in behaviour for the user between
-     * calculating the values each time vs caching the results).
+     * Each value is written once and can then be read without locking, see RadiusLayerPolygonCache. These are behind pointers to keep TreeModelVolumes movable.
      */
-    mutable std::unordered_map<RadiusLayerPair, Polygons> collision_cache_;
-    std::unique_ptr<std::mutex> critical_collision_cache_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Polygons> collision_cache_holefree_;
-    std::unique_ptr<std::mutex> critical_collision_cache_holefree_ = std::make_unique<std::mutex>();
+    std::unique_ptr<RadiusLayerPolygonCache> collision_cache_ = std::make_unique<RadiusLayerPolygonCache>("collision");
+    std::unique_ptr<RadiusLayerPolygonCache> collision_cache_holefree_ = std::make_unique<RadiusLayerPolygonCache>("collision holefree");
 
-    mutable std::unordered_map<LayerIndex, Polygons> accumulated_placeables_cache_radius_0_;
-    std::unique_ptr<std::mutex> critical_accumulated_placeables_cache_radius_0_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Polygons> avoidance_cache_collision_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_collision_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Polygons> avoidance_cache_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Polygons> avoidance_cache_slow_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_slow_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Polygons> avoidance_cache_to_model_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_to_model_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Polygons> avoidance_cache_to_model_slow_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_to_model_slow_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Polygons> placeable_areas_cache_;
-    std::unique_ptr<std::mutex> critical_placeable_areas_cache_ = std::make_unique<std::mutex>();
+    /*!
+     * \brief Cache for the accumulated placeable areas. These only exist for radius 0, which is used as key.
+     */
+    std::unique_ptr<RadiusLayerPolygonCache> accumulated_placeables_cache_radius_0_ = std::make_unique<RadiusLayerPolygonCache>("accumulated placeables radius 0");
+    std::unique_ptr<RadiusLayerPolygonCache> avoidance_cache_collision_ = std::make_unique<RadiusLayerPolygonCache>("avoidance collision");
+    std::unique_ptr<RadiusLayerPolygonCache> avoidance_cache_ = std::make_unique<RadiusLayerPolygonCache>("avoidance");
+    std::unique_ptr<RadiusLayerPolygonCache> avoidance_cache_slow_ = std::make_unique<RadiusLayerPolygonCache>("avoidance slow");
+    std::unique_ptr<RadiusLayerPolygonCache> avoidance_cache_to_model_ = std::make_unique<RadiusLayerPolygonCache>("avoidance to model");
+    std::unique_ptr<RadiusLayerPolygonCache> avoidance_cache_to_model_slow_ = std::make_unique<RadiusLayerPolygonCache>("avoidance to model slow");
+    std::unique_ptr<RadiusLayerPolygonCache> placeable_areas_cache_ = std::make_unique<RadiusLayerPolygonCache>("placeable areas");
 
     /*!
      * \brief Caches to avoid holes smaller than the radius until which the radius is always increased, as they are free of holes. Also called safe avoidances, as they are safe
      * regarding not running into holes.
      */
-    mutable std::unordered_map<RadiusLayerPair, Polygons> avoidance_cache_hole_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_holefree_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Polygons> avoidance_cache_hole_to_model_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_holefree_to_model_ = std::make_unique<std::mutex>();
+    std::unique_ptr<RadiusLayerPolygonCache> avoidance_cache_hole_ = std::make_unique<RadiusLayerPolygonCache>("avoidance holefree");
+    std::unique_ptr<RadiusLayerPolygonCache> avoidance_cache_hole_to_model_ = std::make_unique<RadiusLayerPolygonCache>("avoidance holefree to model");
 
     /*!
      * \brief Caches to represent walls not allowed to be passed over.
      */
-    mutable std::unordered_map<RadiusLayerPair, Polygons> wall_restrictions_cache_;
-    std::unique_ptr<std::mutex> critical_wall_restrictions_cache_ = std::make_unique<std::mutex>();
+    std::unique_ptr<RadiusLayerPolygonCache> wall_restrictions_cache_ = std::make_unique<RadiusLayerPolygonCache>("wall restrictions");
 
     // A different cache for min_xy_dist as the maximal safe distance an influence area can be increased(guaranteed overlap of two walls in consecutive layer) is much smaller when
     // min_xy_dist is used. This causes the area of the wall restriction to be thinner and as such just using the min_xy_dist wall restriction would be slower.
-    mutable std::unordered_map<RadiusLayerPair, Polygons> wall_restrictions_cache_min_;
-    std::unique_ptr<std::mutex> critical_wall_restrictions_cache_min_ = std::make_unique<std::mutex>();
+    std::unique_ptr<RadiusLayerPolygonCache> wall_restrictions_cache_min_ = std::make_unique<RadiusLayerPolygonCache>("wall restrictions min xy distance");
+
+    /*!
+     * \brief Optional persistent storage of the precalculated areas, see TreeModelVolumesDiskCache.
+     */
+    std::optional<TreeModelVolumesDiskCache> disk_cache_;
 
     std::unique_ptr<std::mutex> critical_progress_ = std::make_unique<std::mutex>();
 
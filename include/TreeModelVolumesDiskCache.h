@@ -0,0 +1,81 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef TREEMODELVOLUMESDISKCACHE_H
+#define TREEMODELVOLUMESDISKCACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace cura
+{
+
+class RadiusLayerPolygonCache;
+
+/*!
+ * \brief Persistent, content-addressed storage of the areas precalculated by TreeModelVolumes.
+ *
+ * Re-slicing the same model with only non-support settings changed produces the same collision and avoidance areas. When enabled, the contents of all area caches of
+ * TreeModelVolumes are written to a file together with every input of the precalculation, so that a later slice with identical inputs can read them back instead of
+ * recalculating them. The file is named after a hash of the inputs, but only used if the inputs stored in it are exactly the same.
+ *
+ * The cache is opt-in, it is enabled by setting the environment variable CURAENGINE_TREE_SUPPORT_CACHE to a directory. The total size of that directory is limited to
+ * CURAENGINE_TREE_SUPPORT_CACHE_MAX_MB megabytes (1024 by default); the least recently used files are removed first.
+ */
+class TreeModelVolumesDiskCache
+{
+public:
+    /*!
+     * \brief Version of the file format. Files written with another version are ignored and removed.
+     */
+    static constexpr uint32_t FORMAT_VERSION = 2;
+
+    /*!
+     * \brief Create a disk cache as configured by the environment.
+     * \return The disk cache, or an empty optional if it is not enabled.
+     */
+    static std::optional<TreeModelVolumesDiskCache> fromEnvironment();
+
+    /*!
+     * \param directory The directory to store the cache files in. It is created if it doesn't exist.
+     * \param max_size The maximum total size of all files in the directory, in bytes.
+     */
+    TreeModelVolumesDiskCache(std::filesystem::path directory, const uintmax_t max_size);
+
+    /*!
+     * \brief Fill the given (empty) caches with the values stored for \p key.
+     *
+     * \param key All inputs of the precalculation, serialized.
+     * \param caches The caches to fill. Their order has to be the same as when they were stored.
+     * \return Whether a valid file was found and loaded. If not, the caches have not been modified.
+     */
+    bool load(const std::string& key, const std::vector<RadiusLayerPolygonCache*>& caches) const;
+
+    /*!
+     * \brief Write the contents of the given caches to disk, then remove old files until the directory is within its size limit.
+     *
+     * Failures are logged, but otherwise ignored; the disk cache is only an optimization.
+     *
+     * \param key All inputs of the precalculation, serialized.
+     * \param caches The caches to store.
+     */
+    void store(const std::string& key, const std::vector<RadiusLayerPolygonCache*>& caches) const;
+
+private:
+    std::filesystem::path getPath(const std::string& key) const;
+
+    /*!
+     * \brief Remove the least recently used files until the total size of the directory is at most \ref max_size_.
+     */
+    void enforceSizeLimit() const;
+
+    std::filesystem::path directory_;
+    uintmax_t max_size_;
+};
+
+} // namespace cura
+
+#endif // TREEMODELVOLUMESDISKCACHE_H
@@ -4,8 +4,10 @@
 #ifndef COMMANDLINE_H
 #define COMMANDLINE_H
 
+#include <filesystem> //To check whether cached definition files are still up to date.
 #include <rapidjson/document.h> //Loading JSON documents to get settings from them.
 #include <string> //To store the command line arguments.
+#include <unordered_map>
 #include <unordered_set>
 #include <vector> //To store the command line arguments.
 
@@ -15,6 +17,25 @@ namespace cura
 {
 class Settings;
 
+/*
+ * \brief Definition files that were already parsed, kept between slices.
+ *
+ * When slicing many jobs in one process, most of them load the same
+ * definition files with the same inheritance chain. Parsing those is a large
+ * part of the time of a small slice, so they are only parsed again when the
+ * file has been modified since.
+ */
+struct DefinitionCache
+{
+    struct Definition
+    {
+        std::filesystem::file_time_type last_modified;
+        rapidjson::Document document;
+    };
+
+    std::unordered_map<std::string, Definition> definitions; //!< The parsed definitions, by the file name they were loaded from.
+};
+
 /*
  * \brief When slicing via the command line, interprets the command line
  * arguments to initiate a slice.
@@ -26,8 +47,10 @@ public:
      * \brief Construct a new communicator that interprets the command line to
      * start a slice.
      * \param arguments The command line arguments passed to the application.
+     * \param definition_cache Where to keep the parsed definition files for
+     * later slices, or nullptr to parse them for this slice only.
      */
-    CommandLine(const std::vector<std::string>& arguments);
+    CommandLine(const std::vector<std::string>& arguments, DefinitionCache* definition_cache = nullptr);
 
     /*
      * \brief Indicate that we're beginning to send g-code.
@@ -161,6 +184,11 @@ private:
      */
     unsigned int last_shown_progress_;
 
+    /*
+     * \brief The definition files parsed by earlier slices, if they are kept.
+     */
+    DefinitionCache* definition_cache_;
+
     /*
      * \brief Get the default search directories to search for definition files.
      * \return The default search directories to search for definition files.
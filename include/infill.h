@@ -5,6 +5,7 @@
 #define INFILL_H
 
 #include <numbers>
+#include <string>
 
 #include <range/v3/range/concepts.hpp>
 
@@ -368,6 +369,60 @@ private:
      */
     std::vector<std::vector<std::vector<InfillLineSegment*>>> crossings_on_line_;
 
+    /*!
+     * Where a scanline crosses the outline, in the rotated space of the
+     * scanlines. Also keeps track of which polygon line segment it crosses,
+     * so that infill lines made from two crossings know what they connect to.
+     */
+    struct ScanlineCrossing
+    {
+        Point2LL coordinate_;
+        size_t polygon_index_;
+        size_t vertex_index_;
+
+        ScanlineCrossing(Point2LL coordinate, size_t polygon_index, size_t vertex_index)
+            : coordinate_(coordinate)
+            , polygon_index_(polygon_index)
+            , vertex_index_(vertex_index)
+        {
+        }
+
+        bool operator<(const ScanlineCrossing& other) const // Crossings will be ordered by their Y coordinate so that they get ordered along the scanline.
+        {
+            return coordinate_.Y < other.coordinate_.Y;
+        }
+    };
+
+    /*!
+     * One direction of lines of a linear infill pattern.
+     */
+    struct LineInfillDirection
+    {
+        coord_t line_distance; //!< The distance between two lines in this direction.
+        double infill_rotation; //!< The angle of the lines.
+        coord_t extra_shift; //!< Extra shift of the scanlines in the direction perpendicular to the angle.
+    };
+
+    /*!
+     * Whether the result of \ref generate may be stored in the \ref InfillCache.
+     *
+     * This excludes the patterns that depend on more than the outline and the
+     * parameters of the infill, such as on the mesh or on a fill provider.
+     */
+    bool isCacheable() const;
+
+    /*!
+     * Compute the key of the \ref InfillCache for the result of \ref generate.
+     *
+     * This is the outline and all parameters that the result depends on,
+     * serialized. The height of the layer is only included for patterns that
+     * change with it.
+     * \param settings The settings passed to \ref generate.
+     * \param section_type The type of section passed to \ref generate.
+     * \param prevent_small_exposed_to_air The area passed to \ref generate.
+     */
+    std::string getCacheKey(const Settings& settings, const SectionType section_type, const Polygons& prevent_small_exposed_to_air) const;
+
     /*!
      * Generate the infill pattern without the infill_multiplier functionality
      */
@@ -440,14 +495,14 @@ private:
     void generateQuarterCubicInfill(Polygons& result);
 
     /*!
-     * Generate a single shifting square grid of infill lines.
+     * Get the directions of lines of a single shifting square grid of infill lines.
      * This is used in tetrahedral infill (Octet infill) and in Quarter Cubic infill.
      *
      * \param pattern_z_shift The amount by which to shift the whole pattern down
      * \param angle_shift The angle to add to the infill_angle
-     * \param[out] result (output) The resulting lines
+     * \param[out] directions The directions to add the lines of the grid to.
      */
-    void generateHalfTetrahedralInfill(double pattern_z_shift, int angle_shift, Polygons& result);
+    void addHalfTetrahedralDirections(double pattern_z_shift, int angle_shift, std::vector<LineInfillDirection>& directions);
 
     /*!
      * Generate a triangular grid of infill lines
@@ -508,6 +563,27 @@ private:
      */
     void generateLineInfill(Polygons& result, int line_distance, const double& infill_rotation, coord_t extra_shift);
 
+    /*!
+     * Generate lines in several directions at once, such as for grid or triangle infill.
+     *
+     * The result is exactly the same as calling \ref generateLineInfill for each direction in turn. But the outline is only rotated once
+     * for each different angle, and the crossings of the scanlines of all directions with the outline are found in a single pass over its
+     * edges. The rotation rounds in bulk, to the same integers as \ref PointMatrix::apply.
+     *
+     * \param[out] result (output) The resulting lines
+     * \param directions The lines to generate, in the order in which they are added to the result.
+     */
+    void generateLineInfill(Polygons& result, const std::vector<LineInfillDirection>& directions);
+
+    /*!
+     * Turn the crossings of the scanlines with the outline into infill line segments, and store those in \ref crossings_on_line_ for
+     * \ref connectLines.
+     *
+     * \param crossings_per_scanline For each scanline, where it crosses the outline. These are sorted along the scanline.
+     * \param rotation_matrix The rotation matrix (un)applied to enforce the angle of the infill
+     */
+    void addCrossingSegments(std::vector<std::vector<ScanlineCrossing>>& crossings_per_scanline, const PointMatrix& rotation_matrix);
+
     /*!
      * Function for creating linear based infill types (Lines, ZigZag).
      *
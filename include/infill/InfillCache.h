@@ -0,0 +1,144 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef INFILL_INFILLCACHE_H
+#define INFILL_INFILLCACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/ExtrusionLine.h"
+#include "utils/polygon.h"
+
+namespace cura
+{
+
+/*!
+ * \brief Memoizes the results of \ref Infill::generate across layers.
+ *
+ * Prismatic parts have the same cross-section for many layers, and most infill
+ * patterns only depend on the outline and the pattern parameters, not on the
+ * height of the layer. The cache is content-addressed: the key is the outline
+ * and every parameter that the result depends on, serialized, so any layer (or
+ * any mesh) with the same inputs can reuse a result, no matter which thread
+ * computed it.
+ *
+ * The cache is opt-in, it is enabled by setting the environment variable
+ * CURAENGINE_INFILL_CACHE_MB to the maximum amount of memory it may use, in
+ * megabytes. When it's full, the least recently used results are evicted
+ * first. It only lives while slicing a mesh group, at the end of which the
+ * number of hits and misses are logged.
+ */
+class InfillCache
+{
+public:
+    /*!
+     * \brief The output of \ref Infill::generate.
+     */
+    struct Result
+    {
+        std::vector<VariableWidthLines> toolpaths;
+        Polygons result_polygons;
+        Polygons result_lines;
+    };
+
+    /*!
+     * \brief How often results were reused since the last reset.
+     */
+    struct Statistics
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
+
+    /*!
+     * \brief The instance used by \ref Infill::generate.
+     */
+    static InfillCache& getInstance();
+
+    /*!
+     * \brief The maximum size as configured by the environment.
+     * \return The maximum size in bytes, or 0 if the cache is not enabled.
+     */
+    static size_t getMaxSizeFromEnvironment();
+
+    /*!
+     * \param max_size The maximum amount of memory to use for results, in
+     * bytes. If 0, the cache is disabled.
+     */
+    explicit InfillCache(const size_t max_size = 0);
+
+    /*!
+     * \brief Remove all results and reset the statistics.
+     * \param max_size The new maximum amount of memory to use, in bytes. If 0,
+     * the cache is disabled.
+     */
+    void reset(const size_t max_size);
+
+    /*!
+     * \brief Whether results are stored at all.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Find the result stored for a key.
+     *
+     * The whole key is compared, so a result is only found if all inputs are
+     * exactly the same.
+     * \param key All inputs of the infill generation, serialized.
+     * \return The result, or nullptr if it's not in the cache.
+     */
+    std::shared_ptr<const Result> find(const std::string& key);
+
+    /*!
+     * \brief Store a result, then evict the least recently used results until
+     * the cache is within its maximum size.
+     *
+     * A result that is larger than the maximum size by itself is not stored.
+     * \param key All inputs of the infill generation, serialized.
+     * \param result The infill that was generated.
+     */
+    void insert(const std::string& key, Result result);
+
+    /*!
+     * \brief How often the results were reused since the last reset.
+     */
+    Statistics getStatistics() const;
+
+    /*!
+     * \brief Log how often the results were reused since the last reset.
+     */
+    void logStatistics() const;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<const Result> result;
+        size_t size; //!< Estimate of the memory used by the key and the result, in bytes.
+        std::list<const std::string*>::iterator recency; //!< The position of the key in \ref recency_.
+    };
+
+    /*!
+     * \brief Estimate the memory that an entry uses.
+     */
+    static size_t estimateSize(const std::string& key, const Result& result);
+
+    std::atomic<size_t> max_size_; //!< Atomic, so that checking whether the cache is enabled doesn't contend.
+    mutable std::mutex mutex_; //!< Guards everything below. The results themselves are immutable.
+    size_t size_{ 0 }; //!< The total size of all entries.
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<const std::string*> recency_; //!< The keys of all entries, the most recently used first. They point into \ref entries_, whose keys don't move.
+
+    Statistics statistics_;
+};
+
+} // namespace cura
+
+#endif // INFILL_INFILLCACHE_H
@@ -58,6 +58,16 @@ public:
     const LightningLayer& getTreesForLayer(const size_t& layer_id) const;
 
 protected:
+    /*!
+     * Calculate the area inside the infill walls of each layer, in which the
+     * trees are generated.
+     *
+     * The layers are independent, so they are computed in parallel.
+     * \param mesh The mesh to generate infill for.
+     * \return For each layer, the outline of the infill.
+     */
+    std::vector<Polygons> generateInfillOutlines(const SliceMeshStorage& mesh) const;
+
     /*!
      * Calculate the overhangs above the infill areas that need to be supported
      * by infill.
@@ -65,13 +75,19 @@ protected:
      * Normally, overhangs are only generated for the outside of the model and
      * only when support is generated. For this pattern, we also need to
      * generate overhang areas for the inside of the model.
+     * \param infill_outlines For each layer, the outline of the infill.
      */
-    void generateInitialInternalOverhangs(const SliceMeshStorage& mesh);
+    void generateInitialInternalOverhangs(const std::vector<Polygons>& infill_outlines);
 
     /*!
      * Calculate the tree structure of all layers.
+     *
+     * The trees themselves are generated layer by layer from the top down,
+     * but the outline locators are built in parallel ahead of that, and the
+     * trees of a layer are propagated to the layer below in parallel.
+     * \param infill_outlines For each layer, the outline of the infill.
      */
-    void generateTrees(const SliceMeshStorage& mesh);
+    void generateTrees(const std::vector<Polygons>& infill_outlines);
 
     /*!
      * How far each piece of infill can support skin in the layer above.
@@ -5,7 +5,6 @@
 #define LIGHTNING_LAYER_H
 
 #include <list>
-#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -15,14 +14,13 @@
 
 namespace cura
 {
-using LightningTreeNodeSPtr = std::shared_ptr<LightningTreeNode>;
-using SparseLightningTreeNodeGrid = SparsePointGridInclusive<std::weak_ptr<LightningTreeNode>>;
+using SparseLightningTreeNodeGrid = SparsePointGridInclusive<LightningTreeNodeIdx>;
 
 struct GroundingLocation
 {
-    LightningTreeNodeSPtr tree_node; //!< not null if the gounding location is on a tree
+    LightningTreeNodeIdx tree_node; //!< not NO_LIGHTNING_TREE_NODE if the gounding location is on a tree
     std::optional<ClosestPolygonPoint> boundary_location; //!< in case the gounding location is on the boundary
-    Point2LL p() const;
+    Point2LL p(const LightningTreeNodePool& tree_nodes) const;
 };
 
 /*!
@@ -33,7 +31,8 @@ struct GroundingLocation
 class LightningLayer
 {
 public:
-    std::vector<LightningTreeNodeSPtr> tree_roots;
+    LightningTreeNodePool tree_nodes; //!< The nodes of all trees of this layer.
+    std::vector<LightningTreeNodeIdx> tree_roots;
 
     void generateNewTrees(
         const Polygons& current_overhang,
@@ -52,22 +51,28 @@ public:
         const coord_t supporting_radius,
         const coord_t wall_supporting_radius,
         const SparseLightningTreeNodeGrid& tree_node_locator,
-        const LightningTreeNodeSPtr& exclude_tree = nullptr);
+        const LightningTreeNodeIdx exclude_tree = NO_LIGHTNING_TREE_NODE);
 
     /*!
      * \param[out] new_child The new child node introduced
      * \param[out] new_root The new root node if one had been made
      * \return Whether a new root was added
      */
-    bool attach(const Point2LL& unsupported_location, const GroundingLocation& ground, LightningTreeNodeSPtr& new_child, LightningTreeNodeSPtr& new_root);
+    bool attach(const Point2LL& unsupported_location, const GroundingLocation& ground, LightningTreeNodeIdx& new_child, LightningTreeNodeIdx& new_root);
 
     void reconnectRoots(
-        std::vector<LightningTreeNodeSPtr>& to_be_reconnected_tree_roots,
+        std::vector<LightningTreeNodeIdx>& to_be_reconnected_tree_roots,
         const Polygons& current_outlines,
         const LocToLineGrid& outline_locator,
         const coord_t supporting_radius,
         const coord_t wall_supporting_radius);
 
+    /*!
+     * Drop the nodes that are no longer part of any tree from \ref tree_nodes,
+     * by copying the trees to a new pool.
+     */
+    void compact();
+
     Polygons convertToLines(const Polygons& limit_to_outline, const coord_t line_width) const;
 
     coord_t getWeightedDistance(const Point2LL& boundary_loc, const Point2LL& unsupported_location);
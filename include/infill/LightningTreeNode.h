@@ -4,8 +4,9 @@
 #ifndef LIGHTNING_TREE_NODE_H
 #define LIGHTNING_TREE_NODE_H
 
+#include <cstdint>
 #include <functional>
-#include <memory>
+#include <limits>
 #include <optional>
 #include <vector>
 
@@ -17,75 +18,111 @@ namespace cura
 
 constexpr coord_t locator_cell_size = 4000;
 
+/*!
+ * Index of a node in a \ref LightningTreeNodePool.
+ */
+using LightningTreeNodeIdx = uint32_t;
+
+/*!
+ * Index used to indicate the absence of a node, e.g. the parent of a root.
+ */
+constexpr LightningTreeNodeIdx NO_LIGHTNING_TREE_NODE = std::numeric_limits<LightningTreeNodeIdx>::max();
+
 // NOTE: As written, this struct will only be valid for a single layer, will have to be updated for the next.
 // NOTE: Reasons for implementing this with some separate closures:
 //       - keep clear deliniation during development
 //       - possibility of multiple distance field strategies
 
 /*!
- * A single vertex of a Lightning Tree, the structure that determines the paths
- * to be printed to form Lightning Infill.
+ * The vertices of the Lightning Trees of a layer, the structure that
+ * determines the paths to be printed to form Lightning Infill.
  *
  * In essence these vertices are just a position linked to other positions in
  * 2D. The nodes have a hierarchical structure of parents and children, forming
- * a tree. The class also has some helper functions specific to Lightning Infill
- * e.g. to straighten the paths around this node.
+ * trees. The class also has some helper functions specific to Lightning Infill
+ * e.g. to straighten the paths around a node.
+ *
+ * The nodes are stored as a structure of arrays and refer to each other by
+ * index, so a node costs no separate allocation and copying a tree to the next
+ * layer is a copy of a few contiguous arrays. The children of a node form a
+ * doubly linked list through their sibling indices.
+ *
+ * Nodes are never removed from the pool; nodes that are cut from a tree simply
+ * become unreachable. Use \ref copyTree to obtain a compact copy of a tree.
  */
-class LightningTreeNode : public std::enable_shared_from_this<LightningTreeNode>
+class LightningTreeNodePool
 {
-    using LightningTreeNodeSPtr = std::shared_ptr<LightningTreeNode>;
-
 public:
-    // Workaround for private/protected constructors and 'make_shared': https://stackoverflow.com/a/27832765
-    template<typename... Arg>
-    LightningTreeNodeSPtr static create(Arg&&... arg)
+    /*!
+     * Construct a new node that is the root of a new tree.
+     * \param p The physical location in the 2D layer that the node represents.
+     * Connecting other nodes to this node indicates that a line segment should
+     * be drawn between those two physical positions.
+     * \param last_grounding_location See \ref getLastGroundingLocation.
+     * \return The index of the new node.
+     */
+    LightningTreeNodeIdx create(const Point2LL& p, const std::optional<Point2LL>& last_grounding_location = std::nullopt);
+
+    /*!
+     * Get the number of nodes in this pool, including unreachable ones.
+     */
+    size_t size() const
     {
-        struct EnableMakeShared : public LightningTreeNode
-        {
-            EnableMakeShared(Arg&&... arg)
-                : LightningTreeNode(std::forward<Arg>(arg)...)
-            {
-            }
-        };
-        return std::make_shared<EnableMakeShared>(std::forward<Arg>(arg)...);
+        return locations_.size();
     }
 
     /*!
-     * Get the position on this layer that this node represents, a vertex of the
+     * Get the amount of memory allocated for the nodes of this pool, in bytes.
+     */
+    size_t getMemoryUsage() const;
+
+    /*!
+     * Get the position on this layer that a node represents, a vertex of the
      * path to print.
-     * \return The position that this node represents.
+     * \param node The node to get the position of.
+     * \return The position that the node represents.
      */
-    const Point2LL& getLocation() const;
+    const Point2LL& getLocation(const LightningTreeNodeIdx node) const
+    {
+        return locations_[node];
+    }
 
     /*!
-     * Change the position on this layer that the node represents.
+     * Change the position on this layer that a node represents.
+     * \param node The node to move.
      * \param p The position that the node needs to represent.
      */
-    void setLocation(const Point2LL& p);
+    void setLocation(const LightningTreeNodeIdx node, const Point2LL& p)
+    {
+        locations_[node] = p;
+    }
 
     /*!
-     * Construct a new ``LightningTreeNode`` instance and add it as a child of
-     * this node.
+     * Construct a new node and add it as a child of a node.
+     * \param parent The node to add a child to.
      * \param p The location of the new node.
-     * \return A shared pointer to the new node.
+     * \return The index of the new node.
      */
-    LightningTreeNodeSPtr addChild(const Point2LL& p);
+    LightningTreeNodeIdx addChild(const LightningTreeNodeIdx parent, const Point2LL& p);
 
     /*!
-     * Add an existing ``LightningTreeNode`` as a child of this node.
-     * \param new_child The node that must be added as a child.
+     * Add an existing root as a child of a node.
+     * \param parent The node to add a child to.
+     * \param new_child The root that must be added as a child.
      * \return Always returns \p new_child.
      */
-    LightningTreeNodeSPtr addChild(LightningTreeNodeSPtr& new_child);
+    LightningTreeNodeIdx addChild(const LightningTreeNodeIdx parent, const LightningTreeNodeIdx new_child);
 
     /*!
-     * Propagate this node's sub-tree to the next layer.
+     * Propagate a tree to the next layer.
      *
-     * Creates a copy of this tree, realign it to the new layer boundaries
-     * \p next_outlines and reduce (i.e. prune and straighten) it. A copy of
-     * this node and all of its descendant nodes will be added to the
-     * \p next_trees vector.
-     * \param next_trees A collection of tree nodes to use for the next layer.
+     * Creates a copy of the tree in \p next_nodes, realign it to the new layer
+     * boundaries \p next_outlines and reduce (i.e. prune and straighten) it.
+     * The roots of the resulting trees will be added to the \p next_trees
+     * vector.
+     * \param root The root of the tree to propagate.
+     * \param next_nodes The pool to create the nodes of the next layer in.
+     * \param next_trees A collection of tree roots to use for the next layer.
      * \param next_outlines The shape of the layer below, to make sure that the
      * tree stays within the bounds of the infill area.
      * \param prune_distance The maximum distance that a leaf node may be moved
@@ -97,7 +134,9 @@ public:
      * from which straightening may remove a colinear point.
      */
     void propagateToNextLayer(
-        std::vector<LightningTreeNodeSPtr>& next_trees,
+        const LightningTreeNodeIdx root,
+        LightningTreeNodePool& next_nodes,
+        std::vector<LightningTreeNodeIdx>& next_trees,
         const Polygons& next_outlines,
         const LocToLineGrid& outline_locator,
         const coord_t prune_distance,
@@ -105,102 +144,133 @@ public:
         const coord_t max_remove_colinear_dist) const;
 
     /*!
-     * Executes a given function for every line segment in this node's sub-tree.
+     * Copy a node and its entire sub-tree into another pool.
+     *
+     * Only the reachable nodes are copied, so this can be used to compact a
+     * pool.
+     * \param node The root of the sub-tree to copy.
+     * \param target The pool to copy the nodes into.
+     * \return The equivalent of \p node in the copy (the root of the new sub-
+     * tree).
+     */
+    LightningTreeNodeIdx copyTree(const LightningTreeNodeIdx node, LightningTreeNodePool& target) const;
+
+    /*!
+     * Move all nodes of another pool to the end of this pool.
+     *
+     * The nodes of \p other get their index increased by the current size of
+     * this pool.
+     * \param other The pool to take the nodes from.
+     * \return The offset that was added to the indices of the nodes of
+     * \p other.
+     */
+    LightningTreeNodeIdx append(LightningTreeNodePool&& other);
+
+    /*!
+     * Executes a given function for every line segment in a node's sub-tree.
      *
      * The function takes two `Point` arguments. These arguments will be filled
      * in with the higher-order node (closer to the root) first, and the
      * downtree node (closer to the leaves) as the second argument. The segment
-     * from this node's parent to this node itself is not included.
+     * from the node's parent to the node itself is not included.
      * The order in which the segments are visited is depth-first.
+     * \param node The root of the sub-tree to visit.
      * \param visitor A function to execute for every branch in the node's sub-
      * tree.
      */
-    void visitBranches(const std::function<void(const Point2LL&, const Point2LL&)>& visitor) const;
+    void visitBranches(const LightningTreeNodeIdx node, const std::function<void(const Point2LL&, const Point2LL&)>& visitor) const;
 
     /*!
-     * Execute a given function for every node in this node's sub-tree.
+     * Execute a given function for every node in a node's sub-tree.
      *
-     * The visitor function takes a node as input. This node is not const, so
-     * this can be used to change the tree.
-     * Nodes are visited in depth-first order. This node itself is visited as
+     * Nodes are visited in depth-first order. The node itself is visited as
      * well (pre-order).
-     * \param visitor A function to execute for every node in this node's sub-
+     * \param node The root of the sub-tree to visit.
+     * \param visitor A function to execute for every node in the node's sub-
      * tree.
      */
-    void visitNodes(const std::function<void(LightningTreeNodeSPtr)>& visitor);
+    void visitNodes(const LightningTreeNodeIdx node, const std::function<void(LightningTreeNodeIdx)>& visitor) const;
 
     /*!
-     * Get a weighted distance from an unsupported point to this node (given the current supporting radius).
+     * Get a weighted distance from an unsupported point to a node (given the current supporting radius).
      *
      * When attaching a unsupported location to a node, not all nodes have the same priority.
      * (Eucludian) closer nodes are prioritised, but that's not the whole story.
      * For instance, we give some nodes a 'valence boost' depending on the nr. of branches.
+     * \param node The node to get the distance to.
      * \param unsupported_location The (unsuppported) location of which the weighted distance needs to be calculated.
      * \param supporting_radius The maximum distance which can be bridged without (infill) supporting it.
      * \return The weighted distance.
      */
-    coord_t getWeightedDistance(const Point2LL& unsupported_location, const coord_t& supporting_radius) const;
+    coord_t getWeightedDistance(const LightningTreeNodeIdx node, const Point2LL& unsupported_location, const coord_t& supporting_radius) const;
 
     /*!
-     * Returns whether this node is the root of a lightning tree. It is the root
+     * Returns whether a node is the root of a lightning tree. It is the root
      * if it has no parents.
-     * \return ``true`` if this node is the root (no parents) or ``false`` if it
+     * \return ``true`` if the node is the root (no parents) or ``false`` if it
      * is a child node of some other node.
      */
-    bool isRoot() const
+    bool isRoot(const LightningTreeNodeIdx node) const
     {
-        return is_root_;
+        return parents_[node] == NO_LIGHTNING_TREE_NODE;
     }
 
     /*!
-     * Reverse the parent-child relationship all the way to the root, from this node onward.
-     * This has the effect of 're-rooting' the tree at the current node if no immediate parent is given as argument.
-     * That is, the current node will become the root, it's (former) parent if any, will become one of it's children.
+     * Reverse the parent-child relationship all the way to the root, from a node onward.
+     * This has the effect of 're-rooting' the tree at the node if no immediate parent is given as argument.
+     * That is, the node will become the root, it's (former) parent if any, will become one of it's children.
      * This is then recursively bubbled up until it reaches the (former) root, which then will become a leaf.
+     * \param node The node to become the root.
      * \param new_parent The (new) parent-node of the root, useful for recursing or immediately attaching the node to another tree.
      */
-    void reroot(LightningTreeNodeSPtr new_parent = nullptr);
+    void reroot(const LightningTreeNodeIdx node, const LightningTreeNodeIdx new_parent = NO_LIGHTNING_TREE_NODE);
 
     /*!
      * Retrieves the closest node to the specified location.
+     * \param node The root of the sub-tree to search in.
      * \param loc The specified location.
      * \result The branch that starts at the position closest to the location within this tree.
      */
-    LightningTreeNodeSPtr closestNode(const Point2LL& loc);
+    LightningTreeNodeIdx closestNode(const LightningTreeNodeIdx node, const Point2LL& loc) const;
 
     /*!
-     * Returns whether the given tree node is a descendant of this node.
+     * Returns whether a tree node is a descendant of another node.
      *
-     * If this node itself is given, it is also considered to be a descendant.
+     * If the node itself is given, it is also considered to be a descendant.
+     * \param node The root of the sub-tree to search in.
      * \param to_be_checked A node to find out whether it is a descendant of
-     * this node.
-     * \return ``true`` if the given node is a descendant or this node itself,
+     * \p node.
+     * \return ``true`` if the given node is a descendant or the node itself,
      * or ``false`` if it is not in the sub-tree.
      */
-    bool hasOffspring(const LightningTreeNodeSPtr& to_be_checked) const;
-
-protected:
-    LightningTreeNode() = delete; // Don't allow empty contruction
+    bool hasOffspring(const LightningTreeNodeIdx node, const LightningTreeNodeIdx to_be_checked) const;
 
     /*!
-     * Construct a new node, either for insertion in a tree or as root.
-     * \param p The physical location in the 2D layer that this node represents.
-     * Connecting other nodes to this node indicates that a line segment should
-     * be drawn between those two physical positions.
+     * Convert a tree into polylines
+     *
+     * At each junction one line is chosen at random to continue
+     *
+     * The lines start at a leaf and end in a junction
+     *
+     * \param root The root of the tree to convert.
+     * \param output all branches in this tree connected into polylines
      */
-    LightningTreeNode(const Point2LL& p, const std::optional<Point2LL>& last_grounding_location = std::nullopt);
+    void convertToPolylines(const LightningTreeNodeIdx root, Polygons& output, const coord_t line_width) const;
 
-    /*!
-     * Copy this node and its entire sub-tree.
-     * \return The equivalent of this node in the copy (the root of the new sub-
-     * tree).
+    /*! If a node was ever a direct child of the root, it'll have a previous grounding location.
+     *
+     * This needs to be known when roots are reconnected, so that the last (higher) layer is supported by the next one.
      */
-    LightningTreeNodeSPtr deepCopy() const;
+    const std::optional<Point2LL>& getLastGroundingLocation(const LightningTreeNodeIdx node) const
+    {
+        return last_grounding_locations_[node];
+    }
 
+protected:
     /*! Reconnect trees from the layer above to the new outlines of the lower layer.
      * \return Wether or not the root is kept (false is no, true is yes).
      */
-    bool realign(const Polygons& outlines, const LocToLineGrid& outline_locator, std::vector<LightningTreeNodeSPtr>& rerooted_parts);
+    bool realign(const LightningTreeNodeIdx node, const Polygons& outlines, const LocToLineGrid& outline_locator, std::vector<LightningTreeNodeIdx>& rerooted_parts);
 
     struct RectilinearJunction
     {
@@ -209,12 +279,12 @@ protected:
     };
 
     /*!
-     * Smoothen the tree to make it a bit more printable, while still supporting
+     * Smoothen a tree to make it a bit more printable, while still supporting
      * the trees above.
      * \param magnitude The maximum allowed distance to move the node.
      * \param max_remove_colinear_dist Maximum distance of the (compound) line-segment from which a co-linear point may be removed.
      */
-    void straighten(const coord_t magnitude, const coord_t max_remove_colinear_dist);
+    void straighten(const LightningTreeNodeIdx node, const coord_t magnitude, const coord_t max_remove_colinear_dist);
 
     /*! Recursive part of \ref straighten(.)
      * \param junction_above The last seen junction with multiple children above
@@ -222,52 +292,61 @@ protected:
      * \param max_remove_colinear_dist2 Maximum distance _squared_ of the (compound) line-segment from which a co-linear point may be removed.
      * \return the total distance along the tree from the last junction above to the first next junction below and the location of the next junction below
      */
-    RectilinearJunction straighten(const coord_t magnitude, const Point2LL& junction_above, const coord_t accumulated_dist, const coord_t max_remove_colinear_dist2);
-
-    /*! Prune the tree from the extremeties (leaf-nodes) until the pruning distance is reached.
+    RectilinearJunction straighten(
+        const LightningTreeNodeIdx node,
+        const coord_t magnitude,
+        const Point2LL& junction_above,
+        const coord_t accumulated_dist,
+        const coord_t max_remove_colinear_dist2);
+
+    /*! Prune a tree from the extremeties (leaf-nodes) until the pruning distance is reached.
      * \return The distance that has been pruned. If less than \p distance, then the whole tree was puned away.
      */
-    coord_t prune(const coord_t& distance);
+    coord_t prune(const LightningTreeNodeIdx node, const coord_t& distance);
 
-public:
     /*!
-     * Convert the tree into polylines
+     * Convert a tree into polylines
      *
      * At each junction one line is chosen at random to continue
      *
      * The lines start at a leaf and end in a junction
      *
+     * \param long_line a reference to a polyline in \p output which to continue building on in the recursion
      * \param output all branches in this tree connected into polylines
      */
-    void convertToPolylines(Polygons& output, const coord_t line_width) const;
+    void convertToPolylines(const LightningTreeNodeIdx node, size_t long_line_idx, Polygons& output) const;
 
-    /*! If this was ever a direct child of the root, it'll have a previous grounding location.
-     *
-     * This needs to be known when roots are reconnected, so that the last (higher) layer is supported by the next one.
-     */
-    const std::optional<Point2LL>& getLastGroundingLocation() const;
+    static void removeJunctionOverlap(Polygons& polylines, const coord_t line_width);
 
-protected:
     /*!
-     * Convert the tree into polylines
-     *
-     * At each junction one line is chosen at random to continue
-     *
-     * The lines start at a leaf and end in a junction
-     *
-     * \param long_line a reference to a polyline in \p output which to continue building on in the recursion
-     * \param output all branches in this tree connected into polylines
+     * Add a root to the end of the list of children of a node.
      */
-    void convertToPolylines(size_t long_line_idx, Polygons& output) const;
+    void linkChild(const LightningTreeNodeIdx parent, const LightningTreeNodeIdx child);
 
-    void removeJunctionOverlap(Polygons& polylines, const coord_t line_width) const;
+    /*!
+     * Remove a child from the list of children of its parent, making it a root.
+     */
+    void unlinkChild(const LightningTreeNodeIdx parent, const LightningTreeNodeIdx child);
 
-    bool is_root_;
-    Point2LL p_;
-    std::weak_ptr<LightningTreeNode> parent_;
-    std::vector<LightningTreeNodeSPtr> children_;
+    /*!
+     * Put \p replacement at the place of \p child in the list of children of
+     * \p parent, keeping the order of the children.
+     */
+    void replaceChild(const LightningTreeNodeIdx parent, const LightningTreeNodeIdx child, const LightningTreeNodeIdx replacement);
 
-    std::optional<Point2LL> last_grounding_location_; //<! The last known grounding location, see 'getLastGroundingLocation()'.
+    /*!
+     * Get the child at a certain position in the list of children of a node.
+     */
+    LightningTreeNodeIdx getChild(const LightningTreeNodeIdx parent, size_t child_idx) const;
+
+    std::vector<Point2LL> locations_;
+    std::vector<LightningTreeNodeIdx> parents_;
+    std::vector<LightningTreeNodeIdx> first_children_;
+    std::vector<LightningTreeNodeIdx> last_children_;
+    std::vector<LightningTreeNodeIdx> next_siblings_;
+    std::vector<LightningTreeNodeIdx> previous_siblings_;
+    std::vector<uint32_t> child_counts_;
+    std::vector<std::optional<Point2LL>> last_grounding_locations_; //<! The last known grounding location, see 'getLastGroundingLocation()'.
 };
 
 } // namespace cura
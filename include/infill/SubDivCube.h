@@ -4,10 +4,14 @@
 #ifndef INFILL_SUBDIVCUBE_H
 #define INFILL_SUBDIVCUBE_H
 
+#include <vector>
+
 #include "settings/types/LayerIndex.h"
 #include "settings/types/Ratio.h"
 #include "utils/Point2LL.h"
 #include "utils/Point3LL.h"
+#include "utils/PreparedPolygons.h"
+#include "utils/polygon.h"
 
 namespace cura
 {
@@ -18,13 +22,45 @@ class SliceMeshStorage;
 class SubDivCube
 {
 public:
+    /*!
+     * The infill areas of the layers of a mesh, which are tested many times while building the octree.
+     *
+     * The areas of a layer are only collected and indexed when they are first tested, since the octree may not reach every layer.
+     */
+    class LayerInfillAreas
+    {
+    public:
+        explicit LayerInfillAreas(const SliceMeshStorage& mesh);
+
+        /*!
+         * Get the infill areas of all parts of a layer.
+         * \param layer_nr The layer, which must be a layer of the mesh.
+         */
+        const Polygons& getAreas(const LayerIndex layer_nr);
+
+        /*!
+         * Get an index to test points against \ref getAreas of a layer.
+         * \param layer_nr The layer, which must be a layer of the mesh.
+         */
+        const PreparedPolygons& getIndex(const LayerIndex layer_nr);
+
+    private:
+        void collect(const LayerIndex layer_nr);
+
+        const SliceMeshStorage& mesh_;
+        std::vector<bool> collected_; //!< For each layer whether its areas and index have been made.
+        std::vector<Polygons> areas_;
+        std::vector<PreparedPolygons> indices_;
+    };
+
     /*!
      * Constructor for SubDivCube. Recursively calls itself eight times to flesh out the octree.
      * \param mesh contains infill layer data and settings
+     * \param infill_areas the infill areas of the layers of the mesh
      * \param my_center the center of the cube
      * \param depth the recursion depth of the cube (0 is most recursed)
      */
-    SubDivCube(SliceMeshStorage& mesh, Point3LL& center, size_t depth);
+    SubDivCube(SliceMeshStorage& mesh, LayerInfillAreas& infill_areas, Point3LL& center, size_t depth);
 
     /*!
      * Precompute the octree of subdivided cubes
@@ -72,21 +108,23 @@ private:
     /*!
      * Determines if a described theoretical cube should be subdivided based on if a sphere that encloses the cube touches the infill mesh.
      * \param mesh contains infill layer data and settings
+     * \param infill_areas the infill areas of the layers of the mesh
      * \param center the center of the described cube
      * \param radius the radius of the enclosing sphere
      * \return the described cube should be subdivided
      */
-    static bool isValidSubdivision(SliceMeshStorage& mesh, Point3LL& center, coord_t radius);
+    static bool isValidSubdivision(SliceMeshStorage& mesh, LayerInfillAreas& infill_areas, Point3LL& center, coord_t radius);
 
     /*!
      * Finds the distance to the infill border at the specified layer from the specified point.
      * \param mesh contains infill layer data and settings
+     * \param infill_areas the infill areas of the layers of the mesh
      * \param layer_nr the number of the specified layer
      * \param location the location of the specified point
      * \param[out] distance2 the squared distance to the infill border
      * \return Code 0: outside, 1: inside, 2: boundary does not exist at specified layer
      */
-    static coord_t distanceFromPointToMesh(SliceMeshStorage& mesh, const LayerIndex layer_nr, Point2LL& location, coord_t* distance2);
+    static coord_t distanceFromPointToMesh(SliceMeshStorage& mesh, LayerInfillAreas& infill_areas, const LayerIndex layer_nr, Point2LL& location, coord_t* distance2);
 
     /*!
      * Adds the defined line to the specified polygons. It assumes that the specified polygons are all parallel lines. Combines line segments with touching ends closer than
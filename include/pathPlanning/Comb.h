@@ -8,6 +8,7 @@
 #include <memory> // shared_ptr
 
 #include "../settings/types/LayerIndex.h" // To store the layer on which we comb.
+#include "../utils/PreparedPolygons.h"
 #include "../utils/polygon.h"
 #include "../utils/polygonUtils.h"
 
@@ -144,6 +145,8 @@ private:
                                                             //!< compute it when we move outside the boundary (so not when there is only a single part in the layer)
     std::unordered_map<size_t, Polygons> model_boundary_; //!< The boundary of the model itself
     std::unordered_map<size_t, std::unique_ptr<LocToLineGrid>> outside_loc_to_line_; //!< The SparsePointGridInclusive mapping locations to line segments of the outside boundary.
+    std::unordered_map<size_t, std::unique_ptr<PreparedPolygons>> outside_index_; //!< Point location index over the outside boundary.
+    std::unique_ptr<PreparedPolygons> inside_optimal_index_; //!< Point location index over boundary_inside_optimal.
     std::unordered_map<size_t, std::unique_ptr<LocToLineGrid>>
         model_boundary_loc_to_line_; //!< The SparsePointGridInclusive mapping locations to line segments of the model boundary
     coord_t move_inside_distance_; //!< When using comb_boundary_inside_minimum for combing it tries to move points inside by this amount after calculating the path to move it from
@@ -159,6 +162,16 @@ private:
      */
     Polygons& getBoundaryOutside(const ExtruderTrain& train);
 
+    /*!
+     * Get the point location index over the boundary_outside. Calculate it when it hasn't been calculated yet.
+     */
+    const PreparedPolygons& getOutsideIndex(const ExtruderTrain& train);
+
+    /*!
+     * Get the point location index over boundary_inside_optimal. Calculate it when it hasn't been calculated yet.
+     */
+    const PreparedPolygons& getInsideOptimalIndex();
+
     /*!
      * Get the SparsePointGridInclusive mapping locations to line segments of the model boundary. Calculate it when it hasn't been calculated yet.
      */
@@ -179,7 +192,7 @@ private:
      */
     bool moveInside(Polygons& boundary_inside, bool is_inside, LocToLineGrid* inside_loc_to_line, Point2LL& dest_point, size_t& start_inside_poly);
 
-    void moveCombPathInside(Polygons& boundary_inside, Polygons& boundary_inside_optimal, CombPath& comb_path_input, CombPath& comb_path_output);
+    void moveCombPathInside(Polygons& boundary_inside, const PreparedPolygons& boundary_inside_optimal, CombPath& comb_path_input, CombPath& comb_path_output);
 
 public:
     /*!
@@ -4,9 +4,12 @@
 #ifndef SLICE_DATA_STORAGE_H
 #define SLICE_DATA_STORAGE_H
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <optional>
+#include <shared_mutex>
+#include <unordered_map>
 
 #include "PrimeTower.h"
 #include "RetractionConfig.h"
@@ -375,13 +378,16 @@ public:
      */
     SliceDataStorage();
 
-    ~SliceDataStorage()
-    {
-    }
+    ~SliceDataStorage();
 
     /*!
      * Get all outlines within a given layer.
      *
+     * The outlines of the meshes are cached, so repeated calls for the same
+     * layer are cheap. Support and the prime tower are added on every call, so
+     * those may change freely. If the outlines of the meshes change after this
+     * has been called, \ref invalidateLayerOutlines must be called.
+     *
      * \param layer_nr The index of the layer for which to get the outlines
      * (negative layer numbers indicate the raft).
      * \param include_support Whether to include support in the outline.
@@ -394,6 +400,23 @@ public:
         getLayerOutlines(const LayerIndex layer_nr, const bool include_support, const bool include_prime_tower, const bool external_polys_only = false, const int extruder_nr = -1)
             const;
 
+    /*!
+     * Compute the outlines of the meshes for all layers in parallel, so that
+     * subsequent calls to \ref getLayerOutlines with the same arguments don't
+     * need to compute them one by one.
+     *
+     * \param external_polys_only Whether to disregard all hole polygons.
+     * \param extruder_nr Only compute the outlines for this extruder, or -1
+     * for all extruders.
+     */
+    void precomputeLayerOutlines(const bool external_polys_only = false, const int extruder_nr = -1) const;
+
+    /*!
+     * Forget the cached outlines of the meshes. Must be called when the
+     * outlines of the meshes have changed.
+     */
+    void invalidateLayerOutlines();
+
     /*!
      * Get the extruders used.
      *
@@ -427,10 +450,51 @@ public:
     Polygons getMachineBorder(int extruder_nr = -1) const;
 
 private:
+    /*!
+     * The settings of a mesh that determine whether and how it is part of the
+     * layer outlines, so they don't need to be looked up for every layer.
+     */
+    struct MeshOutlineSettings
+    {
+        bool is_outline; //!< False for infill meshes and anti-overhang meshes, which are never part of the outlines.
+        int wall_0_extruder_nr; //!< The extruder that prints the outer wall of the mesh.
+        bool is_surface_mode; //!< Whether the open polylines of the mesh are printed as well.
+    };
+
+    /*!
+     * Cache for the outlines of the meshes per layer, shared by all threads.
+     */
+    struct LayerOutlinesCache
+    {
+        std::shared_mutex mutex; //!< Guards the outlines and mesh settings.
+        std::unordered_map<uint64_t, std::shared_ptr<const Polygons>> outlines; //!< The outlines per layer, keyed by \ref getLayerOutlinesKey.
+        std::vector<MeshOutlineSettings> mesh_settings; //!< The settings of each mesh, filled on first use.
+        std::atomic<size_t> hits{ 0 }; //!< How often the outlines were found in the cache.
+        std::atomic<size_t> misses{ 0 }; //!< How often the outlines had to be computed.
+    };
+
+    mutable LayerOutlinesCache layer_outlines_cache_;
+
     /*!
      * Construct the retraction_wipe_config_per_extruder
      */
     std::vector<RetractionAndWipeConfig> initializeRetractionAndWipeConfigs();
+
+    /*!
+     * Get the key under which the outlines of the meshes are cached.
+     */
+    static uint64_t getLayerOutlinesKey(const LayerIndex layer_nr, const bool external_polys_only, const int extruder_nr);
+
+    /*!
+     * Get the union of the outlines of the meshes in a layer, from the cache
+     * or computed if they're not in the cache yet.
+     *
+     * \param layer_nr The (non-negative) layer to get the outlines of.
+     * \param external_polys_only Whether to disregard all hole polygons.
+     * \param extruder_nr Only the outlines of meshes of which the outer wall is
+     * printed with this extruder, or -1 for all meshes.
+     */
+    std::shared_ptr<const Polygons> getMeshOutlines(const LayerIndex layer_nr, const bool external_polys_only, const int extruder_nr) const;
 };
 
 } // namespace cura
@@ -56,8 +56,7 @@ public:
 class SlicerLayer
 {
 public:
-    std::vector<SlicerSegment> segments;
-    std::unordered_map<int, int> face_idx_to_segment_idx; // topology
+    std::vector<SlicerSegment> segments; //!< Sorted by face index, every face generates at most one segment per layer. Only present while the polygons are made.
 
     int z = -1;
     Polygons polygons;
@@ -521,10 +520,21 @@ private:
      */
     static std::vector<std::pair<int32_t, int32_t>> buildZHeightsForFaces(const Mesh& mesh);
 
-    /*! Creates the polygons in layers.
+    /*! Creates the segments and polygons of all layers.
+     *
+     * The layers are processed in bands of consecutive layers, in parallel. For each band only the faces that intersect the band are considered, and the segments
+     * of a layer are released as soon as its polygons are made, so that the segments of all layers never need to be in memory at once.
+     * \param[in] mesh The mesh which is analyzed.
+     * \param[in] zbboxes The z part of the bounding boxes of the faces of the mesh.
+     * \param[in] slicing_tolerance Slicing tolerance in order to figure out what happens when vertices are exactly on the slicing boundary.
+     * \param[in, out] layers The polygons are created here.
+     */
+    static void sliceLayers(const Mesh& mesh, const std::vector<std::pair<int32_t, int32_t>>& zbboxes, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers);
+
+    /*! Applies the slicing tolerance and the horizontal expansion to the polygons of the layers.
      * \param[in] mesh The mesh which is analyzed.
      * \param[in] slicing_tolerance The way the slicing tolerance should be applied (MIDDLE/INCLUSIVE/EXCLUSIVE).
-     * \param[in, out] layers The polygon are created here.
+     * \param[in, out] layers The layers with the polygons to adjust.
      */
     static void makePolygons(Mesh& mesh, SlicingTolerance slicing_tolerance, std::vector<SlicerLayer>& layers);
 
@@ -546,14 +556,19 @@ private:
         bool use_variable_layer_heights,
         const std::vector<AdaptiveLayer>* adaptive_layers);
 
-    /*! Creates the segments and write them into the layers.
+    /*! Creates the segments of a layer.
      * \param[in] mesh The mesh which is analyzed.
      * \param[in] zbboxes The z part of the bounding boxes of the faces of the mesh.
+     * \param[in] face_indices The (ascending) indices of the faces that may intersect the layer.
      * \param[in] slicing_tolderance Slicing tolerance in order to figure out what happens when vertices are exactly on the slicing boundary.
-     * \param[in, out] layers The segments are created here.
+     * \param[in, out] layer The segments are created here.
      */
-    static void
-        buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t, int32_t>>& zbboxes, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers);
+    static void buildSegments(
+        const Mesh& mesh,
+        const std::vector<std::pair<int32_t, int32_t>>& zbboxes,
+        const std::vector<uint32_t>& face_indices,
+        const SlicingTolerance& slicing_tolerance,
+        SlicerLayer& layer);
 };
 
 } // namespace cura
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "settings/types/LayerIndex.h"
+#include "utils/Simplify.h"
 #include "utils/polygon.h"
 
 namespace cura
@@ -213,15 +214,36 @@ private:
         const double minimum_interface_area,
         Polygons& interface_polygons);
 
+    /*!
+     * The parameters of \ref join, which are the same for every layer.
+     */
+    struct JoinSettings
+    {
+        bool conical_support; //!< Whether the support gets wider or narrower towards the bottom.
+        coord_t conical_support_offset; //!< By how much the support grows per layer (negative) or shrinks per layer (positive).
+        coord_t conical_smallest_breadth; //!< Parts narrower than this don't get smaller with conical support.
+        Polygons machine_volume_border; //!< The build volume minus the room for platform adhesion, only computed for conical support.
+        coord_t join_distance; //!< Support areas closer than this to each other are merged.
+        coord_t min_even_wall_line_width; //!< Used to prevent tiny areas from being joined.
+        Simplify simplify; //!< To simplify the resulting support areas.
+    };
+
+    /*!
+     * Get the parameters for \ref join from the support infill settings.
+     * \param storage To get the build volume and used extruders from.
+     * \return The parameters to use for all layers.
+     */
+    static JoinSettings getJoinSettings(const SliceDataStorage& storage);
+
     /*!
      * \brief Join current support layer with the support of the layer above,
      * (make support conical) and perform smoothing etc. operations.
-     * \param storage Where to store the resulting support.
+     * \param join_settings The parameters, as given by \ref getJoinSettings.
      * \param supportLayer_up The support areas the layer above.
      * \param supportLayer_this The overhang areas of the current layer at hand.
      * \return The joined support areas for this layer.
      */
-    static Polygons join(const SliceDataStorage& storage, const Polygons& supportLayer_up, Polygons& supportLayer_this);
+    static Polygons join(const JoinSettings& join_settings, const Polygons& supportLayer_up, Polygons& supportLayer_this);
 
     /*!
      * Move the support up from model (cut away polygons to ensure bottom z distance)
@@ -56,30 +56,6 @@ public:
         }
     };
 
-    class Block
-    {
-    public:
-        bool recalculate_flag;
-
-        double accelerate_until;
-        double decelerate_after;
-        Velocity initial_feedrate;
-        Velocity final_feedrate;
-
-        Velocity entry_speed;
-        Velocity max_entry_speed;
-        bool nominal_length_flag;
-
-        Velocity nominal_feedrate;
-        double maxTravel;
-        double distance;
-        Acceleration acceleration;
-        Position delta;
-        Position absDelta;
-
-        PrintFeatureType feature;
-    };
-
 private:
     Velocity max_feedrate[NUM_AXIS] = { 600.0, 600.0, 40.0, 25.0 }; // mm/s
     Velocity minimumfeedrate = 0.01;
@@ -95,7 +71,41 @@ private:
 
     Position currentPosition;
 
-    std::vector<Block> blocks;
+    /*!
+     * The moves planned since the last reset, stored as a structure of arrays.
+     *
+     * Each pass of the planner only needs a few properties of every move, so
+     * keeping them in separate arrays keeps those passes cache-friendly.
+     * Resetting clears the arrays but keeps their memory, so they are reused
+     * for every layer.
+     */
+    struct Blocks
+    {
+        std::vector<double> distance;
+        std::vector<Velocity> nominal_feedrate;
+        std::vector<Acceleration> acceleration;
+        std::vector<Velocity> entry_speed;
+        std::vector<Velocity> max_entry_speed;
+        std::vector<uint8_t> nominal_length_flag; //!< Whether the nominal feedrate can be reached from the entry speed. Bytes rather than bits, to keep them cheap to read.
+        std::vector<PrintFeatureType> feature;
+
+        size_t size() const;
+        void clear();
+    };
+
+    Blocks blocks;
+
+    /*!
+     * The speed profile of a single block: accelerating, cruising at the
+     * nominal feedrate and then decelerating again.
+     */
+    struct Trapezoid
+    {
+        double accelerate_until;
+        double decelerate_after;
+        Velocity initial_feedrate;
+        Velocity final_feedrate;
+    };
 
 public:
     /*!
@@ -114,22 +124,14 @@ public:
     std::vector<Duration> calculate();
 
 private:
+    // Scans the plan from last to first entry, limiting the entry speeds to what can still be decelerated from.
     void reversePass();
-    void forwardPass();
 
-    // Recalculates the trapezoid speed profiles for all blocks in the plan according to the
-    // entry_factor for each junction. Must be called by planner_recalculate() after
-    // updating the blocks.
-    void recalculateTrapezoids();
+    // Scans the plan from first to last entry, limiting the entry speeds to what can be accelerated to.
+    void forwardPass();
 
     // Calculates trapezoid parameters so that the entry- and exit-speed is compensated by the provided factors.
-    void calculateTrapezoidForBlock(Block* block, const Ratio entry_factor, const Ratio exit_factor);
-
-    // The kernel called by accelerationPlanner::calculate() when scanning the plan from last to first entry.
-    void plannerReversePassKernel(Block* previous, Block* current, Block* next);
-
-    // The kernel called by accelerationPlanner::calculate() when scanning the plan from first to last entry.
-    void plannerForwardPassKernel(Block* previous, Block* current, Block* next);
+    Trapezoid calculateTrapezoidForBlock(const size_t block_idx, const Ratio entry_factor, const Ratio exit_factor) const;
 };
 
 } // namespace cura
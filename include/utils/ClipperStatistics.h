@@ -0,0 +1,204 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef UTILS_CLIPPER_STATISTICS_H
+#define UTILS_CLIPPER_STATISTICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace cura
+{
+
+/*!
+ * Counts how often each polygon operation of \ref Polygons is called, how many
+ * vertices go in and come out, and how long it takes, per stage of the slicing.
+ *
+ * The stage is a tag of the current thread, set with a \ref ClipperStage. It's
+ * passed on to the tasks of \ref parallel_for, so that the work done on the
+ * thread pool counts for the stage that started it. Operations outside of any
+ * stage are counted for the stage "other".
+ *
+ * Each thread counts in its own buffer, so counting doesn't contend between
+ * threads. Counting is disabled unless the command line asks for it, in which
+ * case an operation only checks a flag. The totals are logged as a table and
+ * written to a JSON file at the end of the slice.
+ */
+class ClipperStatistics
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Operation
+    {
+        OFFSET,
+        UNION,
+        DIFFERENCE,
+        INTERSECTION,
+        INTERSECTION_POLYLINES,
+        XOR,
+        COUNT //!< The number of operations, not an operation.
+    };
+
+    /*!
+     * Start counting.
+     *
+     * Counts of earlier slices are discarded.
+     * \param output_file The JSON file to write the counts to with \ref write.
+     */
+    static void enable(const std::string& output_file);
+
+    /*!
+     * Stop counting.
+     */
+    static void disable();
+
+    /*!
+     * Whether operations are being counted.
+     */
+    static bool isEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * The stage that the current thread is working on, or nullptr if it's not
+     * in any stage.
+     */
+    static const char* getStage()
+    {
+        return stage_;
+    }
+
+    /*!
+     * Set the stage that the current thread is working on.
+     *
+     * Normally called by \ref ClipperStage.
+     * \param stage The name of the stage. Must outlive the statistics, so
+     * normally a string literal. nullptr if the thread is not in any stage.
+     */
+    static void setStage(const char* stage)
+    {
+        stage_ = stage;
+    }
+
+    /*!
+     * Count an operation for the stage of the current thread.
+     *
+     * Normally called by \ref ClipperOperationCounter.
+     * \param operation The operation that was done.
+     * \param input_vertices The number of vertices of all operands.
+     * \param output_vertices The number of vertices of the result.
+     * \param duration How long the operation took.
+     */
+    static void record(const Operation operation, const size_t input_vertices, const size_t output_vertices, const Clock::duration duration);
+
+    /*!
+     * Log the totals per stage and operation as a table, and write them to
+     * the output file as JSON.
+     *
+     * Operations that are still being counted by other threads may be left
+     * out.
+     */
+    static void write();
+
+private:
+    static std::atomic<bool> enabled_; //!< Whether operations are being counted.
+    inline static thread_local const char* stage_ = nullptr; //!< The stage of the current thread.
+};
+
+/*!
+ * Sets the stage of the current thread for the \ref ClipperStatistics from its
+ * construction to its destruction, after which the previous stage is restored.
+ *
+ * Create one at the start of a scope to count the operations of the scope:
+ * \code
+ * const ClipperStage clipper_stage("walls");
+ * \endcode
+ */
+class ClipperStage
+{
+public:
+    /*!
+     * Enter a stage.
+     * \param stage The name of the stage. Must outlive the statistics, so
+     * normally a string literal. nullptr to leave all stages.
+     */
+    explicit ClipperStage(const char* stage)
+        : previous_stage_(ClipperStatistics::getStage())
+    {
+        ClipperStatistics::setStage(stage);
+    }
+
+    ClipperStage(const ClipperStage&) = delete;
+    ClipperStage& operator=(const ClipperStage&) = delete;
+
+    ~ClipperStage()
+    {
+        ClipperStatistics::setStage(previous_stage_);
+    }
+
+private:
+    const char* previous_stage_;
+};
+
+/*!
+ * Measures a single polygon operation for the \ref ClipperStatistics, if
+ * counting is enabled.
+ *
+ * Create one at the start of the operation with the number of input vertices,
+ * and call \ref finish with the number of output vertices at the end.
+ */
+class ClipperOperationCounter
+{
+public:
+    /*!
+     * Start measuring an operation.
+     * \param operation The operation that is done.
+     */
+    explicit ClipperOperationCounter(const ClipperStatistics::Operation operation)
+        : operation_(operation)
+        , enabled_(ClipperStatistics::isEnabled())
+    {
+        if (enabled_)
+        {
+            start_ = ClipperStatistics::Clock::now();
+        }
+    }
+
+    ClipperOperationCounter(const ClipperOperationCounter&) = delete;
+    ClipperOperationCounter& operator=(const ClipperOperationCounter&) = delete;
+
+    /*!
+     * Whether the operation is being counted, so the vertices need to be
+     * counted as well.
+     */
+    bool isEnabled() const
+    {
+        return enabled_;
+    }
+
+    /*!
+     * Record the operation.
+     * \param input_vertices The number of vertices of all operands.
+     * \param output_vertices The number of vertices of the result.
+     */
+    void finish(const size_t input_vertices, const size_t output_vertices) const
+    {
+        if (enabled_)
+        {
+            ClipperStatistics::record(operation_, input_vertices, output_vertices, ClipperStatistics::Clock::now() - start_);
+        }
+    }
+
+private:
+    ClipperStatistics::Operation operation_;
+    bool enabled_; //!< Whether counting was enabled when the operation started.
+    ClipperStatistics::Clock::time_point start_;
+};
+
+} // namespace cura
+
+#endif // UTILS_CLIPPER_STATISTICS_H
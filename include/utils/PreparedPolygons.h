@@ -0,0 +1,138 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef UTILS_PREPARED_POLYGONS_H
+#define UTILS_PREPARED_POLYGONS_H
+
+#include <vector>
+
+#include "Coord_t.h"
+#include "Point2LL.h"
+
+namespace cura
+{
+
+class Polygons;
+
+/*!
+ * An immutable index over the edges of a set of polygons, to speed up
+ * repeated point-in-polygon and segment-crossing queries against the same
+ * polygons.
+ *
+ * The bounding box of the polygons is cut into horizontal slabs and every
+ * edge is registered in each slab its Y-range overlaps. A query then only
+ * visits the edges of the slab(s) it falls in, instead of all edges.
+ *
+ * The results are exactly the same as those of \ref Polygons::inside and
+ * \ref PolygonUtils::polygonCollidesWithLineSegment, so the index can be used
+ * as a drop-in replacement for those in hot loops.
+ *
+ * The index keeps a copy of the edges, so it stays valid when the polygons it
+ * was built from are changed or destroyed. It doesn't see those changes
+ * though.
+ */
+class PreparedPolygons
+{
+public:
+    /*!
+     * Create an empty index, for which nothing is inside.
+     */
+    PreparedPolygons() = default;
+
+    /*!
+     * Build the index for the given polygons.
+     * \param polygons The polygons to index.
+     */
+    explicit PreparedPolygons(const Polygons& polygons);
+
+    /*!
+     * Whether there are no edges in this index.
+     */
+    bool empty() const;
+
+    /*!
+     * Check whether a point is inside the polygons, using the even-odd rule.
+     *
+     * Same as \ref Polygons::inside.
+     * \param p The point to check.
+     * \param border_result What to return when the point is exactly on the
+     * border of the polygons.
+     * \return Whether the point is inside.
+     */
+    bool inside(const Point2LL& p, bool border_result = false) const;
+
+    /*!
+     * Check for a number of points whether they are inside the polygons.
+     *
+     * The points are processed in slab order, which is considerably more
+     * cache friendly for large batches of scattered points.
+     * \param points The points to check.
+     * \param border_result What to return for points exactly on the border of
+     * the polygons.
+     * \return For each point whether it's inside.
+     */
+    std::vector<bool> inside(const std::vector<Point2LL>& points, bool border_result = false) const;
+
+    /*!
+     * Check whether a line segment touches or crosses any of the edges.
+     *
+     * Same as \ref PolygonUtils::polygonCollidesWithLineSegment(const
+     * Polygons&, const Point2LL&, const Point2LL&).
+     * \param from The start of the line segment.
+     * \param to The end of the line segment.
+     * \return Whether the line segment collides with the polygons. Zero-length
+     * line segments never collide. Edges within a couple of units of the line
+     * segment may collide due to rounding, exactly where they do in
+     * \ref PolygonUtils::polygonCollidesWithLineSegment.
+     */
+    bool intersectsSegment(const Point2LL& from, const Point2LL& to) const;
+
+protected:
+    /*!
+     * An edge of one of the polygons, from one vertex to the next.
+     */
+    struct Edge
+    {
+        Point2LL from_;
+        Point2LL to_;
+        /*!
+         * Whether the edge belongs to a polygon of at least 3 vertices.
+         * Smaller polygons have no area, so \ref Polygons::inside ignores
+         * them, but they can still be collided with.
+         */
+        bool has_area_;
+    };
+
+    coord_t min_y_{ 0 }; //!< The lowest Y coordinate of all vertices.
+    coord_t max_y_{ -1 }; //!< The highest Y coordinate of all vertices.
+    coord_t slab_height_{ 1 }; //!< The height of each slab.
+
+    /*!
+     * For each slab the index into \ref edges_ where its edges start, followed
+     * by the total number of entries.
+     */
+    std::vector<size_t> slab_starts_;
+
+    /*!
+     * The edges of all slabs, stored consecutively per slab.
+     *
+     * Edges spanning multiple slabs are stored multiple times.
+     */
+    std::vector<Edge> edges_;
+
+    /*!
+     * Get the slab that a Y coordinate falls in. The coordinate must be within
+     * the Y-range of the bounding box.
+     */
+    size_t getSlab(const coord_t y) const;
+
+    /*!
+     * Check whether a point is inside the polygons, given that it's within the
+     * Y-range of the bounding box.
+     */
+    bool insideSlab(const Point2LL& p, size_t slab, bool border_result) const;
+};
+
+} // namespace cura
+
+#endif // UTILS_PREPARED_POLYGONS_H
@@ -0,0 +1,184 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_RADIUS_LAYER_POLYGON_CACHE_H
+#define UTILS_RADIUS_LAYER_POLYGON_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "settings/types/LayerIndex.h"
+#include "utils/Coord_t.h"
+#include "utils/polygon.h"
+
+namespace cura
+{
+
+/*!
+ * \brief Write-once cache of areas, indexed by radius and layer.
+ *
+ * Every radius gets its own array of layer slots. A slot is filled exactly once and is published atomically, after which it is never modified until the cache is
+ * destroyed. Reading a slot is therefore lock-free, and references handed out by \ref get stay valid for the lifetime of the cache.
+ *
+ * Only writers that need to allocate a new radius or a new block of layers take the (single) writer lock. The time spent waiting for that lock is recorded, together with
+ * the number of hits and misses of \ref get, so the efficiency of the cache can be reported with \ref logStatistics.
+ */
+class RadiusLayerPolygonCache
+{
+public:
+    using RadiusLayerPair = std::pair<coord_t, LayerIndex>;
+
+    /*!
+     * \brief Counters collected over the lifetime of the cache.
+     */
+    struct Statistics
+    {
+        size_t hits = 0; //!< Number of \ref get calls that found a value.
+        size_t misses = 0; //!< Number of \ref get calls that found no value.
+        size_t inserts = 0; //!< Number of values stored in the cache.
+        std::chrono::nanoseconds wait_time{ 0 }; //!< Total time writers spent waiting for the writer lock.
+    };
+
+    /*!
+     * \param name A human-readable name of the cache, used when reporting statistics.
+     */
+    explicit RadiusLayerPolygonCache(std::string name = "");
+    ~RadiusLayerPolygonCache();
+
+    RadiusLayerPolygonCache(const RadiusLayerPolygonCache&) = delete;
+    RadiusLayerPolygonCache& operator=(const RadiusLayerPolygonCache&) = delete;
+
+    /*!
+     * \brief Get the area stored for the given radius and layer, without locking.
+     * \param radius The (already rounded) radius of interest.
+     * \param layer_idx The layer of interest.
+     * \return A wrapped reference to the stored area, or an empty optional if nothing was stored yet.
+     */
+    std::optional<std::reference_wrapper<const Polygons>> get(const coord_t radius, const LayerIndex layer_idx) const;
+
+    /*!
+     * \brief Whether a value is stored for the given radius and layer. Unlike \ref get, this does not count as a hit or miss.
+     */
+    bool contains(const coord_t radius, const LayerIndex layer_idx) const;
+
+    /*!
+     * \brief Store an area for the given radius and layer.
+     *
+     * If a value was already stored for this radius and layer, the existing value is kept, like \p std::unordered_map::insert would do.
+     * Negative layers are ignored.
+     *
+     * \return Whether the value was stored.
+     */
+    bool insert(const coord_t radius, const LayerIndex layer_idx, Polygons area);
+
+    /*!
+     * \brief Store all (RadiusLayerPair, Polygons) pairs of the given container.
+     */
+    template<typename Container>
+    void insert(Container&& data)
+    {
+        for (auto& [key, area] : data)
+        {
+            insert(key.first, key.second, std::move(area));
+        }
+    }
+
+    /*!
+     * \brief Get the highest layer for which the cache has a consecutive run of values, starting from layer 0.
+     *
+     * As there can not be model below layer 0, some caches will never contain layer 0, in which case the run starts at layer 1 instead.
+     *
+     * \param radius The radius for which the highest already calculated layer has to be found.
+     * \return The highest layer, or -1 if nothing was calculated yet.
+     */
+    LayerIndex getMaxCalculatedLayer(const coord_t radius) const;
+
+    /*!
+     * \brief Call \p visitor for every stored value, in no particular order.
+     *
+     * Values inserted concurrently may or may not be visited.
+     */
+    void visit(const std::function<void(const coord_t radius, const LayerIndex layer_idx, const Polygons& area)>& visitor) const;
+
+    Statistics getStatistics() const;
+
+    /*!
+     * \brief Write the statistics of this cache to the log.
+     */
+    void logStatistics() const;
+
+private:
+    static constexpr size_t LAYERS_PER_CHUNK = 128;
+    static constexpr size_t COUNTER_SHARDS = 16;
+
+    /*!
+     * \brief A block of consecutive layer slots.
+     */
+    struct Chunk
+    {
+        std::array<std::atomic<const Polygons*>, LAYERS_PER_CHUNK> slots{};
+    };
+
+    /*!
+     * \brief The list of chunks of one radius. Replaced by a larger copy when more layers are needed; old directories are kept alive until destruction as readers may
+     * still be using them.
+     */
+    struct ChunkDirectory
+    {
+        explicit ChunkDirectory(const size_t size);
+        const size_t size;
+        std::unique_ptr<std::atomic<Chunk*>[]> chunks;
+    };
+
+    /*!
+     * \brief All slots of one radius. Radii are stored as a singly linked list that only grows at the front.
+     */
+    struct RadiusEntry
+    {
+        RadiusEntry(const coord_t radius, RadiusEntry* next);
+        const coord_t radius;
+        RadiusEntry* const next;
+        std::atomic<ChunkDirectory*> directory{ nullptr };
+    };
+
+    /*!
+     * \brief Counters are spread over several cache lines, so that readers on different threads don't fight over the same one.
+     */
+    struct alignas(64) CounterShard
+    {
+        std::atomic<size_t> hits{ 0 };
+        std::atomic<size_t> misses{ 0 };
+    };
+
+    std::atomic<const Polygons*>* findSlot(const coord_t radius, const LayerIndex layer_idx) const;
+    std::atomic<const Polygons*>& getOrCreateSlot(const coord_t radius, const LayerIndex layer_idx);
+    RadiusEntry* findRadius(const coord_t radius) const;
+    CounterShard& localCounters() const;
+
+    std::string name_;
+    std::atomic<RadiusEntry*> radii_{ nullptr };
+
+    /*!
+     * \brief Guards the creation of radius entries, chunks and directories, and the ownership lists below.
+     */
+    std::mutex writer_mutex_;
+    std::vector<std::unique_ptr<RadiusEntry>> owned_radii_;
+    std::vector<std::unique_ptr<ChunkDirectory>> owned_directories_;
+    std::vector<std::unique_ptr<Chunk>> owned_chunks_;
+
+    mutable std::array<CounterShard, COUNTER_SHARDS> counters_;
+    std::atomic<size_t> inserts_{ 0 };
+    std::atomic<int64_t> wait_time_ns_{ 0 };
+};
+
+} // namespace cura
+
+#endif // UTILS_RADIUS_LAYER_POLYGON_CACHE_H
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "../Application.h" // accessing singleton's Application::thread_pool
+#include "../utils/ClipperStatistics.h" // passing the stage on to the tasks
 #include "../utils/math.h" // round_up_divide
 
 namespace cura
@@ -163,6 +164,9 @@ void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1,
         std::condition_variable work_done = {};
     } shared_state = { std::forward<F>(loop_body), chunks };
 
+    // The tasks count their polygon operations for the stage of the calling thread
+    const char* const stage = ClipperStatistics::getStage();
+
     // Schedules a task per chunk on the thread pool
     lock_t lock = thread_pool->get_lock();
     T chunk_last;
@@ -179,12 +183,15 @@ void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1,
 
         thread_pool->push(
             lock,
-            [&shared_state, chunk_first, chunk_last](lock_t& th_lock)
+            [&shared_state, chunk_first, chunk_last, stage](lock_t& th_lock)
             {
                 th_lock.unlock(); // Enter unsynchronized region
-                for (T i = chunk_first; i < chunk_last; ++i)
                 {
-                    shared_state.loop_body(i);
+                    const ClipperStage clipper_stage(stage);
+                    for (T i = chunk_first; i < chunk_last; ++i)
+                    {
+                        shared_state.loop_body(i);
+                    }
                 }
                 th_lock.lock();
                 if (--shared_state.chunks_remaining == 0)
@@ -282,14 +289,16 @@ public:
             return;
         }
         workers_count_ = thread_pool.thread_count() + 1;
-        // Start thread_pool.thread_count() workers on the thread pool
+        // Start thread_pool.thread_count() workers on the thread pool, counting their polygon operations for the stage of the calling thread
+        const char* const stage = ClipperStatistics::getStage();
         auto lock = thread_pool.get_lock();
         for (size_t i = 1; i < workers_count_; i++)
         {
             thread_pool.push(
                 lock,
-                [this](lock_t& th_lock)
+                [this, stage](lock_t& th_lock)
                 {
+                    const ClipperStage clipper_stage(stage);
                     worker(th_lock);
                 });
         }
@@ -0,0 +1,129 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef UTILS_TRACE_H
+#define UTILS_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace cura
+{
+
+/*!
+ * Records how long the stages of the slicing take on each thread, to show them
+ * on a timeline.
+ *
+ * The recorded zones are written in the Chrome trace event format, which can
+ * be opened with chrome://tracing or https://ui.perfetto.dev. This shows which
+ * stages run serially and where the threads are waiting on each other, which
+ * the total stage times of the log can't show.
+ *
+ * Each thread records its zones in its own ring buffer, so recording doesn't
+ * contend between threads. When a buffer is full the oldest zones of that
+ * thread are overwritten. Tracing is disabled unless the command line asks for
+ * it, in which case a \ref TraceZone only checks a flag.
+ */
+class Trace
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /*!
+     * Start recording zones.
+     *
+     * Zones recorded before, for an earlier trace, are discarded.
+     * \param output_file The file to write the trace to with \ref write.
+     */
+    static void enable(const std::string& output_file);
+
+    /*!
+     * Stop recording zones.
+     */
+    static void disable();
+
+    /*!
+     * Whether zones are being recorded.
+     */
+    static bool isEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * Record a zone on the current thread.
+     *
+     * Normally called by \ref TraceZone.
+     * \param name The name of the zone. Must outlive the trace, so normally a
+     * string literal.
+     * \param layer_nr The layer the zone is about, or -1 if it's not about a
+     * single layer.
+     * \param start When the zone started.
+     * \param end When the zone ended.
+     */
+    static void record(const char* name, const int64_t layer_nr, const Clock::time_point start, const Clock::time_point end);
+
+    /*!
+     * Write all zones recorded so far to the output file.
+     *
+     * Zones that are still being recorded by other threads may be left out.
+     */
+    static void write();
+
+private:
+    static std::atomic<bool> enabled_; //!< Whether zones are being recorded.
+};
+
+/*!
+ * Records the time from its construction to its destruction as a zone of the
+ * \ref Trace, if tracing is enabled.
+ *
+ * Create one at the start of a scope to trace the scope:
+ * \code
+ * const TraceZone trace_zone("processLayer", layer_nr);
+ * \endcode
+ */
+class TraceZone
+{
+public:
+    /*!
+     * Start a zone.
+     * \param name The name of the zone. Must outlive the trace, so normally a
+     * string literal.
+     * \param layer_nr The layer the zone is about, or -1 if it's not about a
+     * single layer.
+     */
+    explicit TraceZone(const char* name, const int64_t layer_nr = -1)
+        : name_(name)
+        , layer_nr_(layer_nr)
+        , enabled_(Trace::isEnabled())
+    {
+        if (enabled_)
+        {
+            start_ = Trace::Clock::now();
+        }
+    }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+    ~TraceZone()
+    {
+        if (enabled_)
+        {
+            Trace::record(name_, layer_nr_, start_, Trace::Clock::now());
+        }
+    }
+
+private:
+    const char* name_;
+    int64_t layer_nr_;
+    bool enabled_; //!< Whether tracing was enabled when the zone started.
+    Trace::Clock::time_point start_;
+};
+
+} // namespace cura
+
+#endif // UTILS_TRACE_H
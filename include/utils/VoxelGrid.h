@@ -0,0 +1,163 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef UTILS_VOXEL_GRID_H
+#define UTILS_VOXEL_GRID_H
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "utils/AABB3D.h"
+#include "utils/VoxelUtils.h"
+
+namespace cura
+{
+
+/*!
+ * A set of voxel cells within fixed bounds, stored as one bit per cell.
+ *
+ * The cells are stored in rows along the X axis, packed in 64-bit words, so
+ * that set operations and dilations process 64 cells at a time. Compared to a
+ * hash set of cells this takes far less memory for dense sets of cells, and
+ * doesn't need to hash each of them.
+ *
+ * Two grids can only be combined if they have the same bounds.
+ */
+class VoxelGrid
+{
+public:
+    /*!
+     * Create an empty grid without any cells in it.
+     */
+    VoxelGrid() = default;
+
+    /*!
+     * Create an empty grid which can hold the cells within some bounds.
+     * \param bounds The minimum and maximum cell that can be in the grid, both
+     * inclusive.
+     */
+    explicit VoxelGrid(const AABB3D& bounds);
+
+    /*!
+     * Whether a cell is within the bounds of this grid.
+     */
+    bool inBounds(const GridPoint3& cell) const
+    {
+        return cell.x_ >= min_.x_ && cell.y_ >= min_.y_ && cell.z_ >= min_.z_ && cell.x_ < min_.x_ + size_.x_ && cell.y_ < min_.y_ + size_.y_ && cell.z_ < min_.z_ + size_.z_;
+    }
+
+    /*!
+     * Whether a cell is in this grid.
+     *
+     * Cells outside of the bounds are never in the grid.
+     */
+    bool contains(const GridPoint3& cell) const
+    {
+        if (! inBounds(cell))
+        {
+            return false;
+        }
+        const coord_t x = cell.x_ - min_.x_;
+        return (words_[getWordIndex(cell.y_ - min_.y_, cell.z_ - min_.z_) + x / 64] >> (x % 64)) & 1;
+    }
+
+    /*!
+     * Add a cell to this grid.
+     *
+     * Cells outside of the bounds of the grid are ignored.
+     */
+    void insert(const GridPoint3& cell)
+    {
+        if (! inBounds(cell))
+        {
+            return;
+        }
+        const coord_t x = cell.x_ - min_.x_;
+        words_[getWordIndex(cell.y_ - min_.y_, cell.z_ - min_.z_) + x / 64] |= uint64_t(1) << (x % 64);
+    }
+
+    /*!
+     * Get the cells near any of the cells in this grid.
+     *
+     * This gives the same cells as \ref VoxelUtils::dilate, but processes a
+     * word of cells at a time for each of the cells in the kernel. Cells which
+     * would end up outside of the bounds are left out.
+     *
+     * \param kernel The offset positions of the nearby cells.
+     * \return A grid with the same bounds, with each cell offset by each of
+     * the cells of the kernel.
+     */
+    VoxelGrid dilate(const DilationKernel& kernel) const;
+
+    /*!
+     * Remove all cells which are not in another grid.
+     * \param other A grid with the same bounds.
+     */
+    void intersect(const VoxelGrid& other);
+
+    /*!
+     * Remove all cells which are also in another grid.
+     * \param other A grid with the same bounds.
+     */
+    void subtract(const VoxelGrid& other);
+
+    /*!
+     * The number of cells in this grid.
+     */
+    size_t size() const;
+
+    /*!
+     * Whether there are no cells in this grid.
+     */
+    bool empty() const;
+
+    /*!
+     * Process each cell in this grid, in order of Z, Y and then X.
+     * \param process_cell_func Function to perform on each cell.
+     */
+    template<typename CellFunc>
+    void forEach(CellFunc&& process_cell_func) const
+    {
+        for (coord_t z = 0; z < size_.z_; z++)
+        {
+            for (coord_t y = 0; y < size_.y_; y++)
+            {
+                const size_t row_start = getWordIndex(y, z);
+                for (size_t word_idx = 0; word_idx < words_per_row_; word_idx++)
+                {
+                    for (uint64_t word = words_[row_start + word_idx]; word != 0; word &= word - 1) // Clear the lowest set bit after processing it.
+                    {
+                        const coord_t x = static_cast<coord_t>(word_idx * 64 + std::countr_zero(word));
+                        process_cell_func(GridPoint3(min_.x_ + x, min_.y_ + y, min_.z_ + z));
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    /*!
+     * Get the index of the first word of a row of cells, relative to the
+     * minimum of the bounds.
+     */
+    size_t getWordIndex(const coord_t y, const coord_t z) const
+    {
+        return (static_cast<size_t>(z) * static_cast<size_t>(size_.y_) + static_cast<size_t>(y)) * words_per_row_;
+    }
+
+    GridPoint3 min_{ 0, 0, 0 }; //!< The minimal cell that can be in the grid.
+    GridPoint3 size_{ 0, 0, 0 }; //!< The number of cells in each dimension.
+    size_t words_per_row_{ 0 }; //!< The number of words for each row of cells along the X axis.
+
+    /*!
+     * The bits of the cells, with a bit for each X coordinate in a row, and a
+     * row for each Y and Z coordinate. The bits beyond the end of a row are
+     * always zero.
+     */
+    std::vector<uint64_t> words_;
+};
+
+} // namespace cura
+
+#endif // UTILS_VOXEL_GRID_H
@@ -4,8 +4,9 @@
 #ifndef UTILS_VOXEL_UTILS_H
 #define UTILS_VOXEL_UTILS_H
 
-#include <functional>
-#include <unordered_set>
+#include <cassert>
+#include <limits>
+#include <vector>
 
 #include "utils/Point2LL.h"
 #include "utils/polygon.h"
@@ -59,6 +60,8 @@ struct DilationKernel
  * Utility class for walking over a 3D voxel grid.
  *
  * Contains the math for intersecting voxels with lines, polgons, areas, etc.
+ *
+ * The walk functions are templated on the function processing the cells, so that the compiler can inline it into the hot loops.
  */
 class VoxelUtils
 {
@@ -80,7 +83,54 @@ public:
      * \param process_cell_func Function to perform on each cell the line crosses
      * \return Whether executing was stopped short as indicated by the \p cell_processing_function
      */
-    bool walkLine(Point3LL start, Point3LL end, const std::function<bool(GridPoint3)>& process_cell_func) const;
+    template<typename CellFunc>
+    bool walkLine(Point3LL start, Point3LL end, CellFunc&& process_cell_func) const
+    {
+        Point3LL diff = end - start;
+
+        const GridPoint3 start_cell = toGridPoint(start);
+        const GridPoint3 end_cell = toGridPoint(end);
+        if (start_cell == end_cell)
+        {
+            return process_cell_func(start_cell);
+        }
+
+        Point3LL current_cell = start_cell;
+        while (true)
+        {
+            bool continue_ = process_cell_func(current_cell);
+
+            if (! continue_)
+            {
+                return false;
+            }
+
+            int stepping_dim = -1; // dimension in which the line next exits the current cell
+            double percentage_along_line = std::numeric_limits<double>::max();
+            for (int dim = 0; dim < 3; dim++)
+            {
+                if (diff[dim] == 0)
+                {
+                    continue;
+                }
+                coord_t crossing_boundary = toLowerCoord(current_cell[dim], dim) + (diff[dim] > 0) * cell_size_[dim];
+                double percentage_along_line_here = (crossing_boundary - start[dim]) / static_cast<double>(diff[dim]);
+                if (percentage_along_line_here < percentage_along_line)
+                {
+                    percentage_along_line = percentage_along_line_here;
+                    stepping_dim = dim;
+                }
+            }
+            assert(stepping_dim != -1);
+            if (percentage_along_line > 1.0)
+            {
+                // next cell is beyond the end
+                return true;
+            }
+            current_cell[stepping_dim] += (diff[stepping_dim] > 0) ? 1 : -1;
+        }
+        return true;
+    }
 
     /*!
      * Process voxels which the line segments of a polygon crosses.
@@ -92,7 +142,24 @@ public:
      * \param process_cell_func Function to perform on each voxel cell
      * \return Whether executing was stopped short as indicated by the \p cell_processing_function
      */
-    bool walkPolygons(const Polygons& polys, coord_t z, const std::function<bool(GridPoint3)>& process_cell_func) const;
+    template<typename CellFunc>
+    bool walkPolygons(const Polygons& polys, coord_t z, CellFunc&& process_cell_func) const
+    {
+        for (ConstPolygonRef poly : polys)
+        {
+            Point2LL last = poly.back();
+            for (Point2LL p : poly)
+            {
+                bool continue_ = walkLine(Point3LL(last.X, last.Y, z), Point3LL(p.X, p.Y, z), process_cell_func);
+                if (! continue_)
+                {
+                    return false;
+                }
+                last = p;
+            }
+        }
+        return true;
+    }
 
     /*!
      * Process voxels near the line segments of a polygon.
@@ -105,13 +172,63 @@ public:
      * \param process_cell_func Function to perform on each voxel cell
      * \return Whether executing was stopped short as indicated by the \p cell_processing_function
      */
-    bool walkDilatedPolygons(const Polygons& polys, coord_t z, const DilationKernel& kernel, const std::function<bool(GridPoint3)>& process_cell_func) const;
+    template<typename CellFunc>
+    bool walkDilatedPolygons(const Polygons& polys, coord_t z, const DilationKernel& kernel, CellFunc&& process_cell_func) const
+    {
+        return walkPolygonsToDilate(polys, z, kernel, dilate(kernel, process_cell_func));
+    }
+
+    /*!
+     * Process the voxels which \ref walkDilatedPolygons would dilate, without dilating them.
+     *
+     * Dilating each of the processed voxels with the \p kernel gives the voxels processed by \ref walkDilatedPolygons.
+     * This allows dilating all voxels at once afterwards, for instance with \ref VoxelGrid::dilate.
+     *
+     * \warning Voxels may be processed multiple times!
+     *
+     * \param polys The polygons to walk
+     * \param z The height at which the polygons occur
+     * \param kernel The kernel with which the voxels are going to be dilated
+     * \param process_cell_func Function to perform on each voxel cell
+     * \return Whether executing was stopped short as indicated by the \p cell_processing_function
+     */
+    template<typename CellFunc>
+    bool walkPolygonsToDilate(const Polygons& polys, coord_t z, const DilationKernel& kernel, CellFunc&& process_cell_func) const
+    {
+        Polygons translated = polys;
+        const Point3LL translation = (Point3LL(1, 1, 1) - kernel.kernel_size_ % 2) * cell_size_ / 2;
+        if (translation.x_ && translation.y_)
+        {
+            translated.translate(Point2LL(translation.x_, translation.y_));
+        }
+        return walkPolygons(translated, z + translation.z_, process_cell_func);
+    }
 
 private:
     /*!
      * \warning the \p polys is assumed to be translated by half the cell_size in xy already
      */
-    bool _walkAreas(const Polygons& polys, coord_t z, const std::function<bool(GridPoint3)>& process_cell_func) const;
+    template<typename CellFunc>
+    bool _walkAreas(const Polygons& polys, coord_t z, CellFunc&& process_cell_func) const
+    {
+        for (Point2LL p : getAreaDots(polys))
+        {
+            bool continue_ = process_cell_func(toGridPoint(Point3LL(p.X + cell_size_.x_ / 2, p.Y + cell_size_.y_ / 2, z)));
+            if (! continue_)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*!
+     * Spread dots over an area, one in each cell of the grid.
+     *
+     * \param polys The area to fill
+     * \return The lower corner of each cell whose lower corner lies inside the area
+     */
+    std::vector<Point2LL> getAreaDots(const Polygons& polys) const;
 
 public:
     /*!
@@ -124,7 +241,17 @@ public:
      * \param process_cell_func Function to perform on each voxel cell
      * \return Whether executing was stopped short as indicated by the \p cell_processing_function
      */
-    bool walkAreas(const Polygons& polys, coord_t z, const std::function<bool(GridPoint3)>& process_cell_func) const;
+    template<typename CellFunc>
+    bool walkAreas(const Polygons& polys, coord_t z, CellFunc&& process_cell_func) const
+    {
+        Polygons translated = polys;
+        const Point3LL translation = -cell_size_ / 2; // offset half a cell so that the dots of spreadDotsArea are centered on the middle of the cell isntead of the lower corners.
+        if (translation.x_ && translation.y_)
+        {
+            translated.translate(Point2LL(translation.x_, translation.y_));
+        }
+        return _walkAreas(translated, z, process_cell_func);
+    }
 
     /*!
      * Process all voxels inside the area of a polygons object.
@@ -137,7 +264,35 @@ public:
      * \param process_cell_func Function to perform on each voxel cell
      * \return Whether executing was stopped short as indicated by the \p cell_processing_function
      */
-    bool walkDilatedAreas(const Polygons& polys, coord_t z, const DilationKernel& kernel, const std::function<bool(GridPoint3)>& process_cell_func) const;
+    template<typename CellFunc>
+    bool walkDilatedAreas(const Polygons& polys, coord_t z, const DilationKernel& kernel, CellFunc&& process_cell_func) const
+    {
+        return walkAreasToDilate(polys, z, kernel, dilate(kernel, process_cell_func));
+    }
+
+    /*!
+     * Process the voxels which \ref walkDilatedAreas would dilate, without dilating them.
+     *
+     * Dilating each of the processed voxels with the \p kernel gives the voxels processed by \ref walkDilatedAreas.
+     *
+     * \param polys The area to fill
+     * \param z The height at which the polygons occur
+     * \param kernel The kernel with which the voxels are going to be dilated
+     * \param process_cell_func Function to perform on each voxel cell
+     * \return Whether executing was stopped short as indicated by the \p cell_processing_function
+     */
+    template<typename CellFunc>
+    bool walkAreasToDilate(const Polygons& polys, coord_t z, const DilationKernel& kernel, CellFunc&& process_cell_func) const
+    {
+        Polygons translated = polys;
+        const Point3LL translation = (Point3LL(1, 1, 1) - kernel.kernel_size_ % 2) * cell_size_ / 2 // offset half a cell when using a n even kernel
+                                   - cell_size_ / 2; // offset half a cell so that the dots of spreadDotsArea are centered on the middle of the cell isntead of the lower corners.
+        if (translation.x_ && translation.y_)
+        {
+            translated.translate(Point2LL(translation.x_, translation.y_));
+        }
+        return _walkAreas(translated, z + translation.z_, process_cell_func);
+    }
 
     /*!
      * Dilate with a kernel.
@@ -146,10 +301,25 @@ public:
      *
      * Apply this function to a process_cell_func to create a new process_cell_func which applies the effect to nearby voxels as well.
      *
+     * \warning The returned function refers to \p kernel and \p process_cell_func, so it may not outlive them.
+     *
      * \param kernel The offset positions relative to the input of \p process_cell_func
      * \param process_cell_func Function to perform on each voxel cell
      */
-    std::function<bool(GridPoint3)> dilate(const DilationKernel& kernel, const std::function<bool(GridPoint3)>& process_cell_func) const;
+    template<typename CellFunc>
+    auto dilate(const DilationKernel& kernel, CellFunc& process_cell_func) const
+    {
+        return [&process_cell_func, &kernel](GridPoint3 loc)
+        {
+            for (const GridPoint3& rel : kernel.relative_cells_)
+            {
+                bool continue_ = process_cell_func(loc + rel);
+                if (! continue_)
+                    return false;
+            }
+            return true;
+        };
+    }
 
     GridPoint3 toGridPoint(const Point3LL& point) const
     {
@@ -1013,41 +1013,60 @@ public:
      */
     static Polygons toPolygons(ClipperLib::PolyTree& poly_tree);
 
-    Polygons difference(const Polygons& other) const
-    {
-        Polygons ret;
-        ClipperLib::Clipper clipper(clipper_init);
-        clipper.AddPaths(paths, ClipperLib::ptSubject, true);
-        clipper.AddPaths(other.paths, ClipperLib::ptClip, true);
-        clipper.Execute(ClipperLib::ctDifference, ret.paths);
-        return ret;
-    }
-    Polygons unionPolygons(const Polygons& other, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero) const
-    {
-        Polygons ret;
-        ClipperLib::Clipper clipper(clipper_init);
-        clipper.AddPaths(paths, ClipperLib::ptSubject, true);
-        clipper.AddPaths(other.paths, ClipperLib::ptSubject, true);
-        clipper.Execute(ClipperLib::ctUnion, ret.paths, fill_type, fill_type);
-        return ret;
-    }
+    /*
+     * The polygon operations have a variant for polygons that are about to
+     * be destroyed, like the result of an earlier operation in a chain. These
+     * reuse the memory of the polygons for the result.
+     */
+
+    Polygons difference(const Polygons& other) const&;
+    Polygons difference(const Polygons& other) &&;
+    Polygons unionPolygons(const Polygons& other, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero) const&;
+    Polygons unionPolygons(const Polygons& other, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero) &&;
     /*!
      * Union all polygons with each other (When polygons.add(polygon) has been called for overlapping polygons)
      */
-    Polygons unionPolygons() const
+    Polygons unionPolygons() const&
     {
         return unionPolygons(Polygons());
     }
-    Polygons intersection(const Polygons& other) const
+    Polygons unionPolygons() &&
     {
-        Polygons ret;
-        ClipperLib::Clipper clipper(clipper_init);
-        clipper.AddPaths(paths, ClipperLib::ptSubject, true);
-        clipper.AddPaths(other.paths, ClipperLib::ptClip, true);
-        clipper.Execute(ClipperLib::ctIntersection, ret.paths);
-        return ret;
+        return std::move(*this).unionPolygons(Polygons());
     }
 
+    /*!
+     * Union many polygons with each other in a single sweep.
+     *
+     * Unioning the inputs one at a time sorts and sweeps everything that was
+     * accumulated so far again for every input, so for more than a few inputs
+     * this is much faster.
+     * \param inputs The polygons to union.
+     * \param fill_type Which areas of the inputs together are filled.
+     * \return The union of all inputs.
+     */
+    static Polygons unionAll(const std::vector<Polygons>& inputs, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero);
+
+    /*!
+     * Union very many polygons with each other, by unioning them in groups in
+     * parallel, then unioning the results in groups again until one is left.
+     *
+     * Each sweep stays small, and the overlap that a group removes doesn't
+     * take part in the later sweeps. The fill type is non-zero. The result is
+     * only the same as that of \ref unionAll if the outlines of the inputs are
+     * positively oriented, with their holes inside them: overlapping outlines
+     * of opposite orientation cancel each other out in the union of all, while
+     * the union of the unions of their groups fills the overlap.
+     * Uses the thread pool of the application.
+     * \param inputs The polygons to union. Their outlines must be positively
+     * oriented.
+     * \param group_size How many inputs to union in a single sweep.
+     * \return The union of all inputs.
+     */
+    static Polygons unionAllParallel(std::vector<Polygons> inputs, const size_t group_size = 16);
+    Polygons intersection(const Polygons& other) const&;
+    Polygons intersection(const Polygons& other) &&;
+
 
     /*!
      * Intersect polylines with this area Polygons object.
@@ -1080,15 +1099,7 @@ public:
     void splitPolygonsIntoSegments(Polygons& result) const;
     Polygons splitPolygonsIntoSegments() const;
 
-    Polygons xorPolygons(const Polygons& other, ClipperLib::PolyFillType pft = ClipperLib::pftEvenOdd) const
-    {
-        Polygons ret;
-        ClipperLib::Clipper clipper(clipper_init);
-        clipper.AddPaths(paths, ClipperLib::ptSubject, true);
-        clipper.AddPaths(other.paths, ClipperLib::ptClip, true);
-        clipper.Execute(ClipperLib::ctXor, ret.paths, pft);
-        return ret;
-    }
+    Polygons xorPolygons(const Polygons& other, ClipperLib::PolyFillType pft = ClipperLib::pftEvenOdd) const;
 
     Polygons execute(ClipperLib::PolyFillType pft = ClipperLib::pftEvenOdd) const
     {
@@ -1099,7 +1110,8 @@ public:
         return ret;
     }
 
-    Polygons offset(coord_t distance, ClipperLib::JoinType joinType = ClipperLib::jtMiter, double miter_limit = 1.2) const;
+    Polygons offset(coord_t distance, ClipperLib::JoinType joinType = ClipperLib::jtMiter, double miter_limit = 1.2) const&;
+    Polygons offset(coord_t distance, ClipperLib::JoinType joinType = ClipperLib::jtMiter, double miter_limit = 1.2) &&;
 
     Polygons offsetPolyLine(int distance, ClipperLib::JoinType joinType = ClipperLib::jtMiter, bool inputPolyIsClosed = false) const
     {
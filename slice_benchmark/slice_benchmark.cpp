@@ -0,0 +1,392 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <docopt/docopt.h>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "Application.h"
+#include "rapidjson/document.h"
+#include "rapidjson/istreamwrapper.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+
+constexpr std::string_view USAGE = R"(Slice Benchmark.
+
+Slices a set of models with the complete slicing pipeline of CuraEngine, and reports the time per stage,
+the peak memory use and the size of the g-code of each of them. If a baseline is given, the results are
+compared to it, and the benchmark fails if any of them regressed or if the size of the g-code changed.
+
+Usage:
+  slice_benchmark -o FILE [--baseline FILE] [--tolerance PERCENT] [--repetitions N] [--verbose]
+  slice_benchmark (-h | --help)
+  slice_benchmark --version
+
+Options:
+  -h --help                      Show this screen.
+  --version                      Show version.
+  -o FILE                        Specify the output Json file.
+  --baseline FILE                Compare against the output Json file of an earlier run.
+  --tolerance PERCENT            How much worse than the baseline a time or memory use may be [default: 10].
+  --repetitions N                Slice each model N times and report the best results [default: 1].
+  --verbose                      Show the output of the slices.
+)";
+
+/*!
+ * A model to slice, with the settings to slice it with.
+ */
+struct Fixture
+{
+    std::string name;
+    std::filesystem::path model_file;
+    std::map<std::string, std::string> settings; //!< The default settings, overridden by those of the fixture.
+};
+
+/*!
+ * A measured result, in the format of the output Json file.
+ */
+struct Result
+{
+    std::string name;
+    std::string unit;
+    double value;
+    std::string extra;
+};
+
+std::filesystem::path getSourcePath()
+{
+    return std::filesystem::path(std::source_location::current().file_name()).parent_path();
+}
+
+std::map<std::string, std::string> readSettings(const std::filesystem::path& settings_file)
+{
+    std::map<std::string, std::string> settings;
+    std::ifstream file{ settings_file };
+    if (! file)
+    {
+        spdlog::critical("Could not read settings from: {}", settings_file.string());
+        exit(EXIT_FAILURE);
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        const size_t value_position = line.find('=');
+        if (value_position != std::string::npos)
+        {
+            settings[line.substr(0, value_position)] = line.substr(value_position + 1);
+        }
+    }
+    return settings;
+}
+
+std::vector<Fixture> getFixtures()
+{
+    const auto resource_path = getSourcePath().append("resources");
+    const auto repository_path = getSourcePath().parent_path();
+    const std::map<std::string, std::string> default_settings = readSettings(resource_path / "default.settings");
+
+    std::ifstream file{ resource_path / "fixtures.json" };
+    rapidjson::IStreamWrapper stream{ file };
+    rapidjson::Document document;
+    document.ParseStream(stream);
+    if (document.HasParseError() || ! document.IsArray())
+    {
+        spdlog::critical("Could not read the fixtures from: {}", (resource_path / "fixtures.json").string());
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<Fixture> fixtures;
+    for (const rapidjson::Value& entry : document.GetArray())
+    {
+        Fixture fixture{ .name = entry["name"].GetString(), .model_file = repository_path / entry["model"].GetString(), .settings = default_settings };
+        for (const auto& setting : entry["settings"].GetObject())
+        {
+            fixture.settings[setting.name.GetString()] = setting.value.GetString();
+        }
+        spdlog::info("Adding fixture: {}", fixture.name);
+        fixtures.push_back(std::move(fixture));
+    }
+    return fixtures;
+}
+
+/*!
+ * Slice a fixture in this process, the same way as the command line would.
+ */
+[[noreturn]] void handleChildProcess(const Fixture& fixture, const std::filesystem::path& gcode_file, const std::filesystem::path& trace_file, const bool verbose)
+{
+    if (! verbose)
+    {
+        std::freopen("/dev/null", "w", stdout);
+        std::freopen("/dev/null", "w", stderr);
+    }
+
+    std::vector<std::string> arguments{ "CuraEngine", "slice", "--trace", trace_file.string() };
+    for (const auto& [key, value] : fixture.settings)
+    {
+        arguments.emplace_back("-s");
+        arguments.push_back(fmt::format("{}={}", key, value));
+    }
+    arguments.insert(arguments.end(), { "-e0", "-l", fixture.model_file.string(), "-o", gcode_file.string() });
+
+    std::vector<char*> argv;
+    for (std::string& argument : arguments)
+    {
+        argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+    cura::Application::getInstance().run(arguments.size(), argv.data());
+    exit(EXIT_SUCCESS);
+}
+
+/*!
+ * Get the wall time of each stage from a trace, as the time from the start of its first zone to the end of its last zone.
+ */
+std::map<std::string, double> getStageTimes(const std::filesystem::path& trace_file)
+{
+    std::ifstream file{ trace_file };
+    rapidjson::IStreamWrapper stream{ file };
+    rapidjson::Document document;
+    document.ParseStream(stream);
+    if (document.HasParseError() || ! document.IsObject() || ! document.HasMember("traceEvents"))
+    {
+        spdlog::error("Could not read the trace: {}", trace_file.string());
+        return {};
+    }
+
+    std::map<std::string, std::pair<double, double>> spans; // Start and end of each stage, in microseconds.
+    for (const rapidjson::Value& event : document["traceEvents"].GetArray())
+    {
+        if (std::string_view(event["ph"].GetString()) != "X")
+        {
+            continue;
+        }
+        const double start = event["ts"].GetDouble();
+        const double end = start + event["dur"].GetDouble();
+        auto [span, inserted] = spans.try_emplace(event["name"].GetString(), start, end);
+        span->second.first = std::min(span->second.first, start);
+        span->second.second = std::max(span->second.second, end);
+    }
+
+    std::map<std::string, double> stage_times;
+    for (const auto& [name, span] : spans)
+    {
+        stage_times[name] = (span.second - span.first) / 1e6;
+    }
+    return stage_times;
+}
+
+/*!
+ * Slice a fixture in a child process, so that its memory use can be measured separately and a crash doesn't stop the benchmark.
+ * \return The results of the fixture, or nothing if the slice failed.
+ */
+std::optional<std::vector<Result>> runFixture(const Fixture& fixture, const bool verbose)
+{
+    const std::filesystem::path output_path = std::filesystem::temp_directory_path() / fmt::format("slice_benchmark_{}", getpid());
+    std::filesystem::create_directories(output_path);
+    const std::filesystem::path gcode_file = output_path / fmt::format("{}.gcode", fixture.name);
+    const std::filesystem::path trace_file = output_path / fmt::format("{}.trace.json", fixture.name);
+
+    const auto start = std::chrono::steady_clock::now();
+    const pid_t pid = fork();
+    if (pid == -1)
+    {
+        spdlog::critical("Unable to fork");
+        exit(EXIT_FAILURE);
+    }
+    if (pid == 0)
+    {
+        handleChildProcess(fixture, gcode_file, trace_file, verbose);
+    }
+
+    int status;
+    rusage usage;
+    wait4(pid, &status, 0, &usage);
+    const double total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (! WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+        spdlog::error("Slicing failed for: {}", fixture.name);
+        std::filesystem::remove_all(output_path);
+        return std::nullopt;
+    }
+
+    std::vector<Result> results{
+        Result{ .name = fmt::format("{}: total", fixture.name), .unit = "s", .value = total_time },
+        Result{ .name = fmt::format("{}: peak RSS", fixture.name), .unit = "MiB", .value = usage.ru_maxrss / 1024.0 }, // ru_maxrss is in KiB on Linux.
+        Result{ .name = fmt::format("{}: output size", fixture.name), .unit = "bytes", .value = static_cast<double>(std::filesystem::file_size(gcode_file)) },
+    };
+    for (const auto& [stage, time] : getStageTimes(trace_file))
+    {
+        results.push_back(Result{ .name = fmt::format("{}: {}", fixture.name, stage), .unit = "s", .value = time });
+    }
+    std::filesystem::remove_all(output_path);
+    return results;
+}
+
+std::map<std::string, double> readBaseline(const std::filesystem::path& baseline_file)
+{
+    std::ifstream file{ baseline_file };
+    rapidjson::IStreamWrapper stream{ file };
+    rapidjson::Document document;
+    document.ParseStream(stream);
+    if (document.HasParseError() || ! document.IsArray())
+    {
+        spdlog::critical("Could not read the baseline: {}", baseline_file.string());
+        exit(EXIT_FAILURE);
+    }
+
+    std::map<std::string, double> baseline;
+    for (const rapidjson::Value& entry : document.GetArray())
+    {
+        baseline[entry["name"].GetString()] = entry["value"].GetDouble();
+    }
+    return baseline;
+}
+
+/*!
+ * Mark the results which are worse than the baseline.
+ *
+ * Times and memory may get better, but any change in the size of the output is a regression, since it means that the slicing result changed. The
+ * tolerance doesn't apply to the output size.
+ * Stage times under a hundredth of a second are too noisy to compare.
+ * \return The number of regressions.
+ */
+size_t compareToBaseline(std::vector<Result>& results, const std::map<std::string, double>& baseline, const double tolerance)
+{
+    size_t regression_count = 0;
+    for (Result& result : results)
+    {
+        const auto baseline_value = baseline.find(result.name);
+        if (baseline_value == baseline.end() || baseline_value->second <= 0.0)
+        {
+            result.extra = "No baseline";
+            continue;
+        }
+        const double ratio = result.value / baseline_value->second;
+        result.extra = fmt::format("{:+.1f}% compared to the baseline", (ratio - 1.0) * 100.0);
+
+        const bool is_time = result.unit == "s";
+        const bool is_output_size = result.unit == "bytes";
+        if (is_time && std::max(result.value, baseline_value->second) < 0.01)
+        {
+            continue;
+        }
+        if (is_output_size ? ratio != 1.0 : ratio > 1.0 + tolerance)
+        {
+            result.extra += ", regression";
+            spdlog::error("Regression in {}: {:.3f} {} instead of {:.3f} {}", result.name, result.value, result.unit, baseline_value->second, result.unit);
+            regression_count++;
+        }
+    }
+    return regression_count;
+}
+
+void writeJson(const std::filesystem::path& out_file, const std::vector<Result>& results)
+{
+    rapidjson::Document doc;
+    doc.SetArray();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    for (const Result& result : results)
+    {
+        rapidjson::Value obj(rapidjson::kObjectType);
+        obj.AddMember("name", rapidjson::Value(result.name.c_str(), allocator), allocator);
+        obj.AddMember("unit", rapidjson::Value(result.unit.c_str(), allocator), allocator);
+        obj.AddMember("value", rapidjson::Value(result.value), allocator);
+        obj.AddMember("extra", rapidjson::Value(result.extra.c_str(), allocator), allocator);
+        doc.PushBack(obj, allocator);
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+
+    spdlog::info("Writing Json results: {}", std::filesystem::absolute(out_file).string());
+    std::ofstream file{ out_file };
+    if (! file)
+    {
+        spdlog::critical("Failed to open the file: {}", out_file.string());
+        exit(EXIT_FAILURE);
+    }
+    file.write(buffer.GetString(), buffer.GetSize());
+}
+
+int main(int argc, const char** argv)
+{
+    constexpr bool show_help = true;
+    constexpr std::string_view version = "0.1.0";
+    const std::map<std::string, docopt::value> args = docopt::docopt(fmt::format("{}", USAGE), { argv + 1, argv + argc }, show_help, fmt::format("{}", version));
+
+    const size_t repetitions = std::max(1l, args.at("--repetitions").asLong());
+    const bool verbose = args.at("--verbose").asBool();
+
+    std::vector<Result> results;
+    size_t failure_count = 0;
+    for (const Fixture& fixture : getFixtures())
+    {
+        // Keep the best result of each measurement, since the noise of other processes only makes results worse.
+        std::optional<std::vector<Result>> best_results;
+        for (size_t repetition = 0; repetition < repetitions; repetition++)
+        {
+            std::optional<std::vector<Result>> fixture_results = runFixture(fixture, verbose);
+            if (! fixture_results)
+            {
+                best_results.reset();
+                break;
+            }
+            if (! best_results)
+            {
+                best_results = std::move(fixture_results);
+                continue;
+            }
+            for (const Result& result : *fixture_results)
+            {
+                auto best = std::find_if(best_results->begin(), best_results->end(), [&result](const Result& best_result) { return best_result.name == result.name; });
+                if (best == best_results->end())
+                {
+                    best_results->push_back(result);
+                }
+                else
+                {
+                    best->value = std::min(best->value, result.value);
+                }
+            }
+        }
+
+        if (! best_results)
+        {
+            failure_count++;
+            results.push_back(Result{ .name = fmt::format("{}: failed", fixture.name), .unit = "-", .value = 1.0, .extra = "The slice didn't finish" });
+            continue;
+        }
+        spdlog::info("Sliced {} in {:.3f}s", fixture.name, best_results->front().value);
+        results.insert(results.end(), best_results->begin(), best_results->end());
+    }
+
+    size_t regression_count = 0;
+    if (args.at("--baseline"))
+    {
+        const double tolerance = std::stod(args.at("--tolerance").asString()) / 100.0;
+        regression_count = compareToBaseline(results, readBaseline(args.at("--baseline").asString()), tolerance);
+        spdlog::info("{} regressions compared to the baseline", regression_count);
+    }
+
+    writeJson(std::filesystem::path{ args.at("-o").asString() }, results);
+    return (failure_count > 0 || regression_count > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -3,9 +3,13 @@
 
 #include "Application.h"
 
+#include <cctype>
 #include <chrono>
+#include <cstdio>
+#include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/uuid/random_generator.hpp> //For generating a UUID.
 #include <boost/uuid/uuid_io.hpp> //For generating a UUID.
@@ -29,6 +33,52 @@
 namespace cura
 {
 
+namespace
+{
+
+/*!
+ * Split a job of the daemon into its arguments.
+ *
+ * Arguments are separated by whitespace. Double quotes group an argument that
+ * contains whitespace, such as a file name.
+ * \param job The line that describes the job.
+ * \param arguments The arguments to append the arguments of the job to.
+ */
+void splitJobArguments(const std::string& job, std::vector<std::string>& arguments)
+{
+    std::string argument;
+    bool in_argument = false;
+    bool in_quotes = false;
+    for (const char character : job)
+    {
+        if (character == '"')
+        {
+            in_quotes = ! in_quotes;
+            in_argument = true;
+        }
+        else if (! in_quotes && std::isspace(static_cast<unsigned char>(character)))
+        {
+            if (in_argument)
+            {
+                arguments.push_back(argument);
+                argument.clear();
+                in_argument = false;
+            }
+        }
+        else
+        {
+            argument += character;
+            in_argument = true;
+        }
+    }
+    if (in_argument)
+    {
+        arguments.push_back(argument);
+    }
+}
+
+} // namespace
+
 Application::Application()
     : instance_uuid_(boost::uuids::to_string(boost::uuids::random_generator()()))
 {
@@ -127,7 +177,7 @@ void Application::printHelp() const
     fmt::print("  -m<thread_count>\n\tSet the desired number of threads. Supports only a single digit.\n");
     fmt::print("\n");
 #endif // ARCUS
-    fmt::print("CuraEngine slice [-v] [-p] [-j <settings.json>] [-s <settingkey>=<value>] [-g] [-e<extruder_nr>] [-o <output.gcode>] [-l <model.stl>] [--next]\n");
+    fmt::print("CuraEngine slice [-v] [-p] [-j <settings.json>] [-s <settingkey>=<value>] [-g] [-e<extruder_nr>] [-o <output.gcode>] [-l <model.stl>] [--next] [--trace <trace.json>] [--clipper-stats <stats.json>]\n");
     fmt::print("  -v\n\tIncrease the verbose level (show log messages).\n");
     fmt::print("  -m<thread_count>\n\tSet the desired number of threads.\n");
     fmt::print("  -p\n\tLog progress information.\n");
@@ -138,11 +188,20 @@ void Application::printHelp() const
     fmt::print("  -e<extruder_nr>\n\tSwitch setting focus to the extruder train with the given number.\n");
     fmt::print("  --next\n\tGenerate gcode for the previously supplied mesh group and append that to \n\tthe gcode of further models for one-at-a-time printing.\n");
     fmt::print("  -o <output_file>\n\tSpecify a file to which to write the generated gcode.\n");
+    fmt::print("  --trace <trace_file>\n\tRecord how long each stage takes on each thread, and write that to a file \n\tin the Chrome trace format, to view with chrome://tracing or ui.perfetto.dev.\n");
+    fmt::print("  --clipper-stats <stats_file>\n\tCount the calls, vertices and time of the polygon operations per stage, \n\tlog them as a table and write them to a JSON file.\n");
     fmt::print("\n");
     fmt::print("The settings are appended to the last supplied object:\n");
     fmt::print("CuraEngine slice [general settings] \n\t-g [current group settings] \n\t-e0 [extruder train 0 settings] \n\t-l obj_inheriting_from_last_extruder_train.stl [object "
                "settings] \n\t--next [next group settings]\n\t... etc.\n");
     fmt::print("\n");
+    fmt::print("CuraEngine daemon\n");
+    fmt::print("\tKeep running and slice jobs read from stdin, one job per line. Each job has the \n\targuments of CuraEngine slice, "
+               "for instance:\n\t-j <settings.json> -l <model.stl> -o <output.gcode>\n");
+    fmt::print("\tThe thread pool and the parsed definition files are kept between jobs. After each job \n\ta line "
+               "'done <job_nr> <seconds>' is written to stdout. The log is written to stderr.\n");
+    fmt::print("\tA job that fails to load stops the daemon, like it stops CuraEngine slice.\n");
+    fmt::print("\n");
     fmt::print("In order to load machine definitions from custom locations, you need to create the environment variable CURA_ENGINE_SEARCH_PATH, which should contain all search "
                "paths delimited by a (semi-)colon.\n");
     fmt::print("\n");
@@ -179,6 +238,40 @@ void Application::slice()
     communication_ = new CommandLine(arguments);
 }
 
+void Application::daemon()
+{
+    // Keep stdout for reporting the finished jobs.
+    auto dup_sink = std::make_shared<spdlog::sinks::dup_filter_sink_mt>(std::chrono::seconds{ 10 });
+    dup_sink->add_sink(std::make_shared<spdlog::sinks::stderr_color_sink_mt>());
+    spdlog::default_logger()->sinks() = std::vector<std::shared_ptr<spdlog::sinks::sink>>{ dup_sink };
+
+    startThreadPool();
+    DefinitionCache definition_cache;
+    size_t job_nr = 0;
+    std::string job;
+    while (std::getline(std::cin, job))
+    {
+        std::vector<std::string> arguments{ argv_[0], "slice" };
+        splitJobArguments(job, arguments);
+        if (arguments.size() == 2)
+        {
+            continue; // Empty line.
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        communication_ = new CommandLine(arguments, &definition_cache);
+        communication_->sliceNext();
+        delete communication_;
+        communication_ = nullptr;
+        FffProcessor::getInstance()->reset(); // Close the output file, and don't let the next job continue where this one left off.
+
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        fmt::print("done {} {:.3f}\n", job_nr, duration.count());
+        std::fflush(stdout);
+        job_nr++;
+    }
+}
+
 void Application::run(const size_t argc, char** argv)
 {
     argc_ = argc;
@@ -204,6 +297,10 @@ void Application::run(const size_t argc, char** argv)
         {
             slice();
         }
+        else if (stringcasecompare(argv[1], "daemon") == 0)
+        {
+            daemon();
+        }
         else if (stringcasecompare(argv[1], "help") == 0)
         {
             printHelp();
@@ -220,7 +317,8 @@ void Application::run(const size_t argc, char** argv)
     {
         // No communication channel is open any more, so either:
         //- communication failed to connect, or
-        //- the engine was called with an unknown command or a command that doesn't connect (like "help").
+        //- the engine was called with an unknown command or a command that doesn't connect (like "help"), or
+        //- the daemon has run out of jobs.
         // In either case, we don't want to slice.
         exit(0);
     }
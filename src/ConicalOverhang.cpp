@@ -9,70 +9,155 @@
 #include "settings/types/LayerIndex.h"
 #include "slicer.h"
 #include "utils/Simplify.h" //Simplifying at every step to prevent getting lots of vertices from all the insets.
+#include "utils/ThreadPool.h"
 
 namespace cura
 {
 
+namespace
+{
+/*!
+ * Whether a hole is completely covered by the layer above it.
+ */
+bool isCoveredBy(const Polygons& hole, const Polygons& above)
+{
+    Polygons holeWithAbove = hole.intersection(above);
+    if (holeWithAbove.empty())
+    {
+        return false;
+    }
+    // The hole had some intersection with the above layer, check if it's a complete overlap
+    return hole.xorPolygons(holeWithAbove).empty();
+}
+
+/*!
+ * Whether any of the other holes is inside a hole.
+ *
+ * The holes of the parts of a layer are either disjoint or nested, so one
+ * vertex strictly inside is enough.
+ */
+bool containsAnyOf(const Polygons& hole, const Polygons& other_holes)
+{
+    for (ConstPolygonRef other_hole : other_holes)
+    {
+        for (const Point2LL& point : other_hole)
+        {
+            if (hole[0].inside(point, false))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*!
+ * A hole in a layer that may have to be cut out of the layer above.
+ */
+struct CandidateHole
+{
+    Polygons outline;
+    bool covered_by_original_above; //!< Then it's also covered by the changed layer above.
+};
+} // namespace
+
 void ConicalOverhang::apply(Slicer* slicer, const Mesh& mesh)
 {
-    const AngleRadians angle = mesh.settings_.get<AngleRadians>("conical_overhang_angle");
-    const double maxHoleArea = mesh.settings_.get<double>("conical_overhang_hole_size");
+    apply(slicer->layers, mesh.settings_);
+}
+
+void ConicalOverhang::apply(std::vector<SlicerLayer>& layers, const Settings& settings)
+{
+    const AngleRadians angle = settings.get<AngleRadians>("conical_overhang_angle");
+    const double maxHoleArea = settings.get<double>("conical_overhang_hole_size");
     const double tan_angle = tan(angle); // the XY-component of the angle
-    const coord_t layer_thickness = mesh.settings_.get<coord_t>("layer_height");
+    const coord_t layer_thickness = settings.get<coord_t>("layer_height");
     coord_t max_dist_from_lower_layer = std::llround(tan_angle * static_cast<double>(layer_thickness)); // max dist which can be bridged
 
-    for (LayerIndex layer_nr = slicer->layers.size() - 2; static_cast<int>(layer_nr) >= 0; layer_nr--)
+    if (layers.size() < 2)
     {
-        SlicerLayer& layer = slicer->layers[static_cast<size_t>(layer_nr)];
-        SlicerLayer& layer_above = slicer->layers[static_cast<size_t>(layer_nr) + 1ul];
-        if (std::abs(max_dist_from_lower_layer) < 5)
-        { // magically nothing happens when max_dist_from_lower_layer == 0
-            // below magic code solves that
-            constexpr coord_t safe_dist = 20;
-            Polygons diff = layer_above.polygons.difference(layer.polygons.offset(-safe_dist));
+        return;
+    }
+    const size_t layer_count = layers.size() - 1; // The number of layers that have a layer above them.
+
+    if (std::abs(max_dist_from_lower_layer) < 5)
+    { // magically nothing happens when max_dist_from_lower_layer == 0
+        // below magic code solves that
+        constexpr coord_t safe_dist = 20;
+        std::vector<Polygons> insets(layer_count); // Only depends on the original layer, so compute these in parallel beforehand.
+        cura::parallel_for<size_t>(
+            0,
+            layer_count,
+            [&](const size_t layer_nr)
+            {
+                insets[layer_nr] = layers[layer_nr].polygons.offset(-safe_dist);
+            });
+
+        for (size_t layer_nr = layer_count; layer_nr-- > 0;)
+        {
+            SlicerLayer& layer = layers[layer_nr];
+            const SlicerLayer& layer_above = layers[layer_nr + 1];
+            Polygons diff = layer_above.polygons.difference(insets[layer_nr]);
             layer.polygons = layer.polygons.unionPolygons(diff);
             layer.polygons = layer.polygons.smooth(safe_dist);
             layer.polygons = Simplify(safe_dist, safe_dist / 2, 0).polygon(layer.polygons);
             // somehow layer.polygons get really jagged lines with a lot of vertices
             // without the above steps slicing goes really slow
         }
-        else
-        {
-            // Get the current layer and split it into parts
-            std::vector<PolygonsPart> layerParts = layer.polygons.splitIntoParts();
-            // Get a copy of the layer above to prune away before we shrink it
-            Polygons above = layer_above.polygons;
-
-            // Now go through all the holes in the current layer and check if they intersect anything in the layer above
-            // If not, then they're the top of a hole and should be cut from the layer above before the union
-            for (unsigned int part = 0; part < layerParts.size(); part++)
+        return;
+    }
+
+    // Go through all the holes in each layer and check if they intersect anything in the layer above.
+    // If not, then they're the top of a hole and should be cut from the layer above before the union.
+    // The layer above only grows when it's changed, so a hole that is covered by the original layer above is also covered by the changed one.
+    // Only whether the other holes are covered has to be checked once the layer above is changed.
+    std::vector<std::vector<CandidateHole>> holes(layer_count); // Per layer, the holes that are small enough, in the order of the parts.
+    if (maxHoleArea > 0.0)
+    {
+        cura::parallel_for<size_t>(
+            0,
+            layer_count,
+            [&](const size_t layer_nr)
             {
-                if (layerParts[part].size() > 1) // first poly is the outer contour, 1..n are the holes
+                // Get the current layer and split it into parts
+                const std::vector<PolygonsPart> layerParts = layers[layer_nr].polygons.splitIntoParts();
+                const Polygons& original_above = layers[layer_nr + 1].polygons;
+                for (const PolygonsPart& part : layerParts)
                 {
-                    for (unsigned int hole_nr = 1; hole_nr < layerParts[part].size(); ++hole_nr)
+                    for (unsigned int hole_nr = 1; hole_nr < part.size(); ++hole_nr) // first poly is the outer contour, 1..n are the holes
                     {
                         Polygons holePoly;
-                        holePoly.add(layerParts[part][hole_nr]);
-                        if (maxHoleArea > 0.0 && INT2MM2(std::abs(holePoly.area())) < maxHoleArea)
+                        holePoly.add(part[hole_nr]);
+                        if (INT2MM2(std::abs(holePoly.area())) >= maxHoleArea)
                         {
-                            Polygons holeWithAbove = holePoly.intersection(above);
-                            if (! holeWithAbove.empty())
-                            {
-                                // The hole had some intersection with the above layer, check if it's a complete overlap
-                                Polygons holeDifference = holePoly.xorPolygons(holeWithAbove);
-                                if (holeDifference.empty())
-                                {
-                                    // The hole was returned unchanged, so the layer above must completely cover it.  Remove the hole from the layer above.
-                                    above = above.difference(holePoly);
-                                }
-                            }
+                            continue;
                         }
+                        const bool covered = isCoveredBy(holePoly, original_above);
+                        holes[layer_nr].push_back(CandidateHole{ std::move(holePoly), covered });
                     }
                 }
+            });
+    }
+
+    for (size_t layer_nr = layer_count; layer_nr-- > 0;)
+    {
+        SlicerLayer& layer = layers[layer_nr];
+        const SlicerLayer& layer_above = layers[layer_nr + 1];
+
+        // Removing a hole from the layer above makes it no longer cover the holes around it, which come later in the order of the parts.
+        // The holes that are removed are therefore disjoint, so they can be removed from the layer above all at once.
+        Polygons holes_to_remove;
+        for (const CandidateHole& hole : holes[layer_nr])
+        {
+            if ((hole.covered_by_original_above || isCoveredBy(hole.outline, layer_above.polygons)) && ! containsAnyOf(hole.outline, holes_to_remove))
+            {
+                holes_to_remove.add(hole.outline);
             }
-            // And now union with offset of the resulting above layer
-            layer.polygons = layer.polygons.unionPolygons(above.offset(-max_dist_from_lower_layer));
         }
+        const Polygons above = holes_to_remove.empty() ? layer_above.polygons : layer_above.polygons.difference(holes_to_remove);
+
+        // And now union with offset of the resulting above layer
+        layer.polygons = layer.polygons.unionPolygons(above.offset(-max_dist_from_lower_layer));
     }
 }
 
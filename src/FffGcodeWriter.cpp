@@ -31,6 +31,8 @@
 #include "raft.h"
 #include "utils/Simplify.h" //Removing micro-segments created by offsetting.
 #include "utils/ThreadPool.h"
+#include "utils/ClipperStatistics.h"
+#include "utils/Trace.h"
 #include "utils/linearAlg2D.h"
 #include "utils/math.h"
 #include "utils/orderOptimizer.h"
@@ -66,6 +68,10 @@ std::vector<Duration> FffGcodeWriter::getTotalPrintTimePerFeature()
 
 bool FffGcodeWriter::setTargetFile(const char* filename)
 {
+    if (output_file.is_open())
+    {
+        output_file.close(); // Written by an earlier slice in the same process.
+    }
     output_file.open(filename);
     if (output_file.is_open())
     {
@@ -77,6 +83,8 @@ bool FffGcodeWriter::setTargetFile(const char* filename)
 
 void FffGcodeWriter::writeGCode(SliceDataStorage& storage, TimeKeeper& time_keeper)
 {
+    const TraceZone trace_zone("writeGCode");
+    const ClipperStage clipper_stage("gcode");
     const size_t start_extruder_nr = getStartExtruder(storage);
     gcode.preSetup(start_extruder_nr);
     gcode.setSliceUUID(slice_uuid);
@@ -174,11 +182,15 @@ void FffGcodeWriter::writeGCode(SliceDataStorage& storage, TimeKeeper& time_keep
         [this, total_layers](std::optional<ProcessLayerResult> result_opt)
         {
             const ProcessLayerResult& result = result_opt.value();
+            const TraceZone trace_zone("writeLayer", result.layer_plan->getLayerNr());
             Progress::messageProgressLayer(result.layer_plan->getLayerNr(), total_layers, result.total_elapsed_time, result.stages_times);
             layer_plan_buffer.handle(*result.layer_plan, gcode);
         });
 
-    layer_plan_buffer.flush();
+    {
+        const TraceZone trace_zone("writeLayer");
+        layer_plan_buffer.flush();
+    }
 
     Progress::messageProgressStage(Progress::Stage::FINISH, &time_keeper);
 
@@ -975,6 +987,7 @@ void FffGcodeWriter::processRaft(const SliceDataStorage& storage)
 FffGcodeWriter::ProcessLayerResult FffGcodeWriter::processLayer(const SliceDataStorage& storage, LayerIndex layer_nr, const size_t total_layers) const
 {
     spdlog::debug("GcodeWriter processing layer {} of {}", layer_nr, total_layers);
+    const TraceZone trace_zone("processLayer", layer_nr);
     TimeKeeper time_keeper;
     spdlog::stopwatch timer_total;
 
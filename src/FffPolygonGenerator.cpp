@@ -47,6 +47,8 @@
 #include "settings/types/LayerIndex.h"
 #include "utils/algorithm.h"
 #include "utils/ThreadPool.h"
+#include "utils/ClipperStatistics.h"
+#include "utils/Trace.h"
 #include "utils/gettime.h"
 #include "utils/math.h"
 #include "utils/Simplify.h"
@@ -58,6 +60,7 @@ namespace cura
 
 bool FffPolygonGenerator::generateAreas(SliceDataStorage& storage, MeshGroup* meshgroup, TimeKeeper& timeKeeper)
 {
+    const ClipperStage clipper_stage("polygon generation");
     if (! sliceModel(meshgroup, timeKeeper, storage))
     {
         return false;
@@ -91,6 +94,8 @@ size_t FffPolygonGenerator::getDraftShieldLayerCount(const size_t total_layers)
 
 bool FffPolygonGenerator::sliceModel(MeshGroup* meshgroup, TimeKeeper& timeKeeper, SliceDataStorage& storage) /// slices the model
 {
+    const TraceZone trace_zone("sliceModel");
+    const ClipperStage clipper_stage("slicing");
     Progress::messageProgressStage(Progress::Stage::SLICING, &timeKeeper);
 
     storage.model_min = meshgroup->min();
@@ -402,12 +407,28 @@ void FffPolygonGenerator::slices2polygons(SliceDataStorage& storage, TimeKeeper&
         return;
     }
 
+    // The outlines of the meshes are final from here on. Support generation queries them for every layer, multiple times.
+    storage.invalidateLayerOutlines();
+    if (has_support)
+    {
+        storage.precomputeLayerOutlines();
+    }
+
     Progress::messageProgressStage(Progress::Stage::SUPPORT, &time_keeper);
 
-    AreaSupport::generateOverhangAreas(storage);
-    AreaSupport::generateSupportAreas(storage);
-    TreeSupport tree_support_generator(storage);
-    tree_support_generator.generateSupportAreas(storage);
+    {
+        const TraceZone trace_zone("generateOverhangAreas");
+        AreaSupport::generateOverhangAreas(storage);
+    }
+    {
+        const TraceZone trace_zone("generateSupportAreas");
+        AreaSupport::generateSupportAreas(storage);
+    }
+    {
+        const TraceZone trace_zone("TreeSupport");
+        TreeSupport tree_support_generator(storage);
+        tree_support_generator.generateSupportAreas(storage);
+    }
 
     computePrintHeightStatistics(storage);
 
@@ -727,6 +748,8 @@ void FffPolygonGenerator::processDerivedWallsSkinInfill(SliceMeshStorage& mesh)
  */
 void FffPolygonGenerator::processWalls(SliceMeshStorage& mesh, size_t layer_nr)
 {
+    const TraceZone trace_zone("processWalls", layer_nr);
+    const ClipperStage clipper_stage("walls");
     SliceLayer* layer = &mesh.layers[layer_nr];
     WallsComputation walls_computation(mesh.settings, layer_nr);
     walls_computation.generateWalls(layer, SectionType::WALL);
@@ -824,6 +847,8 @@ void FffPolygonGenerator::processSkinsAndInfill(SliceMeshStorage& mesh, const La
         return;
     }
 
+    const TraceZone trace_zone("processSkinsAndInfill", layer_nr);
+    const ClipperStage clipper_stage("skins and infill");
     SkinInfillAreaComputation skin_infill_area_computation(layer_nr, mesh, process_infill);
     skin_infill_area_computation.generateSkinsAndInfill();
 
@@ -0,0 +1,344 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "GCodeTimeEstimator.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <optional>
+#include <string>
+
+namespace cura
+{
+
+namespace
+{
+
+/*!
+ * The parameters of a g-code command, by their letter.
+ */
+class Parameters
+{
+public:
+    /*!
+     * Parse the parameters from the words of a command, after the command
+     * itself.
+     */
+    explicit Parameters(std::string_view words)
+    {
+        while (! words.empty())
+        {
+            const size_t word_start = words.find_first_not_of(" \t\r");
+            if (word_start == std::string_view::npos)
+            {
+                break;
+            }
+            words.remove_prefix(word_start);
+            const size_t word_end = std::min(words.find_first_of(" \t\r"), words.size());
+            const std::string_view word = words.substr(0, word_end);
+            words.remove_prefix(word_end);
+
+            const char letter = word[0] & ~0x20; // To upper case.
+            if (letter < 'A' || letter > 'Z')
+            {
+                continue;
+            }
+            double value;
+            if (std::from_chars(word.data() + 1, word.data() + word.size(), value).ec == std::errc())
+            {
+                values_[letter - 'A'] = value;
+            }
+        }
+    }
+
+    std::optional<double> get(const char letter) const
+    {
+        return values_[letter - 'A'];
+    }
+
+private:
+    std::array<std::optional<double>, 26> values_;
+};
+
+/*!
+ * Get the feature type of a ";TYPE:" comment, as written by
+ * \ref GCodeExport::writeTypeComment.
+ */
+PrintFeatureType getFeatureType(const std::string_view type_name)
+{
+    if (type_name == "WALL-OUTER")
+    {
+        return PrintFeatureType::OuterWall;
+    }
+    if (type_name == "WALL-INNER")
+    {
+        return PrintFeatureType::InnerWall;
+    }
+    if (type_name == "SKIN")
+    {
+        return PrintFeatureType::Skin;
+    }
+    if (type_name == "SUPPORT")
+    {
+        return PrintFeatureType::Support;
+    }
+    if (type_name == "SKIRT")
+    {
+        return PrintFeatureType::SkirtBrim;
+    }
+    if (type_name == "FILL")
+    {
+        return PrintFeatureType::Infill;
+    }
+    if (type_name == "SUPPORT-INTERFACE")
+    {
+        return PrintFeatureType::SupportInterface;
+    }
+    if (type_name == "PRIME-TOWER")
+    {
+        return PrintFeatureType::PrimeTower;
+    }
+    return PrintFeatureType::NoneType;
+}
+
+} // namespace
+
+GCodeTimeEstimator::GCodeTimeEstimator()
+    : total_print_times_(static_cast<size_t>(PrintFeatureType::NumPrintFeatureTypes), 0.0)
+{
+    calculator_.setPosition(position_);
+}
+
+GCodeTimeEstimator::GCodeTimeEstimator(const Settings& settings)
+    : GCodeTimeEstimator()
+{
+    calculator_.setFirmwareDefaults(settings);
+}
+
+void GCodeTimeEstimator::process(std::istream& gcode)
+{
+    std::string line;
+    while (std::getline(gcode, line))
+    {
+        processLine(line);
+    }
+}
+
+void GCodeTimeEstimator::processLine(std::string_view line)
+{
+    const size_t comment_start = line.find(';');
+    if (comment_start != std::string_view::npos)
+    {
+        const std::string_view comment = line.substr(comment_start + 1);
+        if (comment.starts_with("LAYER:"))
+        {
+            // The g-code writer plans each layer separately.
+            const Duration layer_time = flush();
+            if (in_layer_)
+            {
+                layer_times_.push_back(layer_time);
+            }
+            in_layer_ = true;
+        }
+        else if (comment.starts_with("TYPE:"))
+        {
+            const std::string_view type_name = comment.substr(5);
+            feature_ = getFeatureType(type_name.substr(0, type_name.find_last_not_of(" \t\r") + 1));
+        }
+        line = line.substr(0, comment_start);
+    }
+
+    const size_t command_start = line.find_first_not_of(" \t");
+    if (command_start == std::string_view::npos)
+    {
+        return;
+    }
+    line.remove_prefix(command_start);
+    if ((line[0] & ~0x20) == 'N') // Skip line numbers.
+    {
+        const size_t command_after_line_number = line.find_first_not_of(" \t", line.find_first_of(" \t"));
+        if (command_after_line_number == std::string_view::npos)
+        {
+            return;
+        }
+        line.remove_prefix(command_after_line_number);
+    }
+    const char command_letter = line[0] & ~0x20;
+    const size_t command_end = std::min(line.find_first_of(" \t\r"), line.size());
+    int command_number;
+    if (std::from_chars(line.data() + 1, line.data() + command_end, command_number).ec != std::errc())
+    {
+        return;
+    }
+    const Parameters parameters(line.substr(command_end));
+
+    if (command_letter == 'G')
+    {
+        switch (command_number)
+        {
+        case 0:
+        case 1:
+        {
+            if (const std::optional<double> feedrate = parameters.get('F'))
+            {
+                feedrate_ = *feedrate / 60.0;
+            }
+            TimeEstimateCalculator::Position new_position = position_;
+            bool moves = false;
+            constexpr std::array<char, 3> axis_letters{ 'X', 'Y', 'Z' };
+            for (size_t axis = 0; axis < axis_letters.size(); axis++)
+            {
+                if (const std::optional<double> coordinate = parameters.get(axis_letters[axis]))
+                {
+                    new_position[axis] = relative_positioning_ ? position_[axis] + *coordinate : *coordinate;
+                    moves |= new_position[axis] != position_[axis];
+                }
+            }
+            bool extrudes = false;
+            if (const std::optional<double> e = parameters.get('E'))
+            {
+                new_position[TimeEstimateCalculator::E_AXIS] = relative_extrusion_ ? position_[TimeEstimateCalculator::E_AXIS] + *e : *e;
+                extrudes = new_position[TimeEstimateCalculator::E_AXIS] != position_[TimeEstimateCalculator::E_AXIS];
+            }
+            if (! moves && ! extrudes)
+            {
+                return;
+            }
+
+            PrintFeatureType feature = feature_;
+            if (! extrudes)
+            {
+                feature = is_retracted_ ? PrintFeatureType::MoveRetraction : PrintFeatureType::MoveCombing;
+            }
+            else if (! moves)
+            {
+                feature = PrintFeatureType::MoveRetraction;
+                is_retracted_ = new_position[TimeEstimateCalculator::E_AXIS] < position_[TimeEstimateCalculator::E_AXIS];
+            }
+            calculator_.plan(new_position, feedrate_, feature);
+            position_ = new_position;
+            break;
+        }
+        case 4: // Dwell.
+            if (const std::optional<double> milliseconds = parameters.get('P'))
+            {
+                calculator_.addTime(*milliseconds / 1000.0);
+            }
+            else if (const std::optional<double> seconds = parameters.get('S'))
+            {
+                calculator_.addTime(*seconds);
+            }
+            break;
+        case 10: // Firmware retract.
+            is_retracted_ = true;
+            break;
+        case 11: // Firmware unretract.
+            is_retracted_ = false;
+            break;
+        case 28: // Home.
+        {
+            const bool home_all = ! parameters.get('X') && ! parameters.get('Y') && ! parameters.get('Z');
+            constexpr std::array<char, 3> axis_letters{ 'X', 'Y', 'Z' };
+            for (size_t axis = 0; axis < axis_letters.size(); axis++)
+            {
+                if (home_all || parameters.get(axis_letters[axis]))
+                {
+                    position_[axis] = 0.0;
+                }
+            }
+            calculator_.setPosition(position_);
+            break;
+        }
+        case 90:
+            relative_positioning_ = false;
+            relative_extrusion_ = false;
+            break;
+        case 91:
+            relative_positioning_ = true;
+            relative_extrusion_ = true;
+            break;
+        case 92: // Set position.
+        {
+            constexpr std::array<char, 4> axis_letters{ 'X', 'Y', 'Z', 'E' };
+            for (size_t axis = 0; axis < axis_letters.size(); axis++)
+            {
+                if (const std::optional<double> coordinate = parameters.get(axis_letters[axis]))
+                {
+                    position_[axis] = *coordinate;
+                }
+            }
+            calculator_.setPosition(position_);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    else if (command_letter == 'M')
+    {
+        switch (command_number)
+        {
+        case 82:
+            relative_extrusion_ = false;
+            break;
+        case 83:
+            relative_extrusion_ = true;
+            break;
+        case 204: // Set acceleration. The g-code writer gives the estimate the last acceleration it writes, for printing or travelling.
+            for (const char letter : { 'S', 'P', 'T' })
+            {
+                if (const std::optional<double> acceleration = parameters.get(letter))
+                {
+                    calculator_.setAcceleration(Acceleration(*acceleration));
+                }
+            }
+            break;
+        case 205: // Set jerk (Marlin).
+            if (const std::optional<double> jerk = parameters.get('X'))
+            {
+                calculator_.setMaxXyJerk(Velocity(*jerk));
+            }
+            break;
+        case 566: // Set jerk (RepRap), in mm/min.
+            if (const std::optional<double> jerk = parameters.get('X'))
+            {
+                calculator_.setMaxXyJerk(Velocity(*jerk / 60.0));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+std::vector<Duration> GCodeTimeEstimator::calculate()
+{
+    const Duration layer_time = flush();
+    if (in_layer_)
+    {
+        layer_times_.push_back(layer_time);
+        in_layer_ = false;
+    }
+    return total_print_times_;
+}
+
+const std::vector<Duration>& GCodeTimeEstimator::getLayerTimes() const
+{
+    return layer_times_;
+}
+
+Duration GCodeTimeEstimator::flush()
+{
+    const std::vector<Duration> times = calculator_.calculate();
+    calculator_.reset();
+    Duration total = 0.0;
+    for (size_t feature_idx = 0; feature_idx < times.size(); feature_idx++)
+    {
+        total_print_times_[feature_idx] += times[feature_idx];
+        total += times[feature_idx];
+    }
+    return total;
+}
+
+} // namespace cura
@@ -4,6 +4,7 @@
 #include "InsetOrderOptimizer.h"
 
 #include <iterator>
+#include <map>
 #include <tuple>
 
 #include <range/v3/algorithm/max.hpp>
@@ -12,9 +13,9 @@
 #include <range/v3/range/operations.hpp>
 #include <range/v3/view/addressof.hpp>
 #include <range/v3/view/any_view.hpp>
-#include <range/v3/view/drop.hpp>
 #include <range/v3/view/drop_last.hpp>
 #include <range/v3/view/join.hpp>
+#include <range/v3/view/map.hpp>
 #include <range/v3/view/remove_if.hpp>
 #include <range/v3/view/reverse.hpp>
 #include <range/v3/view/take_exactly.hpp>
@@ -25,8 +26,8 @@
 #include "ExtruderTrain.h"
 #include "FffGcodeWriter.h"
 #include "LayerPlan.h"
+#include "utils/AABB.h"
 #include "utils/views/convert.h"
-#include "utils/views/dfs.h"
 
 namespace rg = ranges;
 namespace rv = ranges::views;
@@ -179,108 +180,119 @@ InsetOrderOptimizer::value_type InsetOrderOptimizer::getRegionOrder(const auto&
 
     // Create a bi-direction directed acyclic graph (Tree). Where polygon B is a child of A if B is inside A. The root of the graph is
     // the polygon that contains all other polygons. The leaves are polygons that contain no polygons.
-    // We need a bi-directional graph as we are performing a dfs from the root down and from each of the hole (which are leaves in the graph) up the tree
-    std::unordered_multimap<const LineLoc*, const LineLoc*> graph;
-    std::unordered_set<LineLoc*> roots{ &rg::front(locator_view) };
-    for (const auto& locator : locator_view | rv::addressof | rv::drop(1))
+    // We need a bi-directional graph as we are performing a bfs from the root down and from each of the hole (which are leaves in the graph) up the tree.
+    // The graph is stored as adjacency lists, indexed by the position of the polygons in locator_view.
+    const size_t node_count = locator_view.size();
+    std::vector<std::vector<size_t>> graph(node_count);
+    std::vector<AABB> bounding_boxes;
+    bounding_boxes.reserve(node_count);
+    for (const LineLoc& locator : locator_view)
     {
-        std::vector<LineLoc*> erase;
-        for (const auto& root : roots)
+        bounding_boxes.emplace_back(locator.poly);
+    }
+
+    // The current roots, sorted by the left side of their bounding box. A root can only be inside a polygon if its bounding box is inside the bounding box of that
+    // polygon, so only the roots that start within the horizontal range of a polygon need to be tested.
+    std::multimap<coord_t, size_t> roots{ { bounding_boxes.front().min_.X, 0 } };
+    for (size_t locator_idx = 1; locator_idx < node_count; locator_idx++)
+    {
+        const AABB& locator_box = bounding_boxes[locator_idx];
+        for (auto root_it = roots.lower_bound(locator_box.min_.X); root_it != roots.end() && root_it->first <= locator_box.max_.X;)
         {
-            if (root->poly.inside(locator->poly))
+            const size_t root_idx = root_it->second;
+            if (locator_box.contains(bounding_boxes[root_idx]) && locator_view[root_idx].poly.inside(locator_view[locator_idx].poly))
             {
                 // The root polygon is inside the location polygon. It is no longer a root in the graph we are building.
                 // Add this relationship (locator <-> root) to the graph, and remove root from roots.
-                graph.emplace(locator, root);
-                graph.emplace(root, locator);
-                erase.emplace_back(root);
+                graph[locator_idx].push_back(root_idx);
+                graph[root_idx].push_back(locator_idx);
+                root_it = roots.erase(root_it);
+            }
+            else
+            {
+                root_it++;
             }
-        }
-        for (const auto& node : erase)
-        {
-            roots.erase(node);
         }
         // We are adding to the graph from smallest area -> largest area. This means locator will always be the largest polygon in the graph so far.
         // No polygon in the graph is big enough to contain locator, so it must be a root.
-        roots.emplace(locator);
+        roots.emplace(locator_box.min_.X, locator_idx);
     }
 
     std::unordered_multimap<const ExtrusionLine*, const ExtrusionLine*> order;
 
-    for (const LineLoc* root : roots)
+    std::vector<bool> reached(node_count, false); // Whether the node is part of a tree that was already handled.
+    std::vector<bool> claimed(node_count, false); // Whether the closest root or hole root of the node has been found.
+    std::vector<size_t> closest_source(node_count);
+    for (const size_t root : roots | rv::values)
     {
-        std::map<const LineLoc*, unsigned int> min_depth;
-        std::map<const LineLoc*, const LineLoc*> min_node;
-        std::vector<const LineLoc*> hole_roots;
-
-        // Responsible for the following initialization
-        // - initialize all reachable nodes to root
-        // - mark all reachable nodes with their depth from the root
-        // - find hole roots, these are the innermost polygons enclosing a hole
+        // Find hole roots, these are the innermost polygons enclosing a hole.
+        // Holes are defined by a positive area in clipper1. These are leaves of the tree structure. As odd walls are also leaves we filter them out by adding a
+        // non-zero area check.
+        std::vector<size_t> sources{ root };
+        std::vector<size_t> tree{ root };
+        reached[root] = true;
+        for (size_t tree_idx = 0; tree_idx < tree.size(); tree_idx++)
         {
-            const std::function<void(const LineLoc*, const unsigned int)> initialize_nodes
-                = [graph, root, &hole_roots, &min_node, &min_depth](const auto current_node, const auto depth)
+            const size_t node = tree[tree_idx];
+            for (const size_t neighbour : graph[node])
             {
-                min_node[current_node] = root;
-                min_depth[current_node] = depth;
-
-                // find hole roots (defined by a positive area in clipper1), these are leaves of the tree structure
-                // as odd walls are also leaves we filter them out by adding a non-zero area check
-                if (current_node != root && graph.count(current_node) == 1 && current_node->line->is_closed_ && current_node->area > 0)
+                if (! reached[neighbour])
                 {
-                    hole_roots.push_back(current_node);
+                    reached[neighbour] = true;
+                    tree.push_back(neighbour);
                 }
-            };
-
-            actions::dfs_depth_state(root, graph, initialize_nodes);
-        };
-
-        // For each hole root perform a dfs, and keep track of depth from hole root
-        // if the depth to a node is smaller than a depth calculated from another root update
-        // min_depth and min_node
-        {
-            for (auto& hole_root : hole_roots)
+            }
+            const LineLoc& locator = locator_view[node];
+            if (node != root && graph[node].size() == 1 && locator.line->is_closed_ && locator.area > 0)
             {
-                const std::function<void(const LineLoc*, const unsigned int)> update_nodes = [hole_root, &min_depth, &min_node](const auto& current_node, auto depth)
-                {
-                    if (depth < min_depth[current_node])
-                    {
-                        min_depth[current_node] = depth;
-                        min_node[current_node] = hole_root;
-                    }
-                };
-
-                actions::dfs_depth_state(hole_root, graph, update_nodes);
+                sources.push_back(node);
             }
-        };
+        }
 
-        // perform a dfs from the root and all hole roots $r$ and set the order constraints for each polyline for which
-        // the depth is closest to root $r$
+        // Perform a bfs from the root and all hole roots $r$ at once, and set the order constraints for each polyline towards the $r$ that it is closest to.
+        // In a tree, the node that first reaches a polyline lies on the path to that $r$. When a polyline is equally close to several $r$, the root wins. After
+        // that a hole root wins if the polyline encloses it (an inset around that hole), which is why each step of the bfs first grows the root, then grows
+        // the hole roots outwards and only then grows the hole roots inwards.
+        std::vector<size_t> frontier = sources;
+        for (const size_t source : sources)
+        {
+            claimed[source] = true;
+            closest_source[source] = source;
+        }
+        while (! frontier.empty())
         {
-            const LineLoc* root_ = root;
-            const std::function<void(const LineLoc*, const LineLoc*)> set_order_constraints
-                = [&order, &min_node, &root_, graph, outer_to_inner](const auto& current_node, const auto& parent_node)
+            std::vector<size_t> next_frontier;
+            for (const auto& [from_root, outwards] : { std::make_pair(true, false), std::make_pair(false, true), std::make_pair(false, false) })
             {
-                if (min_node[current_node] == root_ && parent_node != nullptr)
+                for (const size_t node : frontier)
                 {
-                    if (outer_to_inner)
+                    if ((closest_source[node] == root) != from_root)
                     {
-                        order.insert(std::make_pair(parent_node->line, current_node->line));
+                        continue;
                     }
-                    else
+                    for (const size_t neighbour : graph[node])
                     {
-                        order.insert(std::make_pair(current_node->line, parent_node->line));
+                        const bool encloses = neighbour > node; // Polygons are sorted by area, so the bigger index is the enclosing polygon.
+                        if (claimed[neighbour] || (! from_root && encloses != outwards))
+                        {
+                            continue;
+                        }
+                        claimed[neighbour] = true;
+                        closest_source[neighbour] = closest_source[node];
+                        next_frontier.push_back(neighbour);
+
+                        if (outer_to_inner)
+                        {
+                            order.emplace(locator_view[node].line, locator_view[neighbour].line);
+                        }
+                        else
+                        {
+                            order.emplace(locator_view[neighbour].line, locator_view[node].line);
+                        }
                     }
                 }
-            };
-
-            actions::dfs_parent_state(root, graph, set_order_constraints);
-
-            for (auto& hole_root : hole_roots)
-            {
-                root_ = hole_root;
-                actions::dfs_parent_state(hole_root, graph, set_order_constraints);
             }
+            frontier = std::move(next_frontier);
         }
     }
 
@@ -314,6 +326,21 @@ InsetOrderOptimizer::value_type InsetOrderOptimizer::getInsetOrder(const auto& i
             walls_by_inset[line.inset_idx_].emplace_back(&line);
         }
     }
+
+    // Every wall is ordered against every wall of the next inset, and every odd wall against every wall of the inset around it. These constraints are already
+    // the transitive reduction of the order, so the number of them can only be reduced by changing how the order is traversed. Reserve them up front to
+    // avoid rehashing while inserting millions of constraints.
+    size_t constraint_count = 0;
+    for (size_t inset_idx = 0; inset_idx + 1 < walls_by_inset.size(); inset_idx++)
+    {
+        constraint_count += walls_by_inset[inset_idx].size() * walls_by_inset[inset_idx + 1].size();
+    }
+    for (size_t inset_idx = 1; inset_idx < fillers_by_inset.size() && inset_idx - 1 < walls_by_inset.size(); inset_idx++)
+    {
+        constraint_count += fillers_by_inset[inset_idx].size() * walls_by_inset[inset_idx - 1].size();
+    }
+    order.reserve(constraint_count);
+
     for (size_t inset_idx = 0; inset_idx + 1 < walls_by_inset.size(); inset_idx++)
     {
         for (const ExtrusionLine* line : walls_by_inset[inset_idx])
@@ -14,6 +14,9 @@
 #include "Slice.h"
 #include "settings/types/LayerIndex.h"
 #include "slicer.h"
+#include "utils/AABB3D.h"
+#include "utils/ThreadPool.h"
+#include "utils/VoxelGrid.h"
 #include "utils/VoxelUtils.h"
 #include "utils/polygonUtils.h"
 
@@ -89,7 +92,7 @@ std::pair<Polygons, Polygons> InterlockingGenerator::growBorderAreasPerpendicula
     return { from_border_a, from_border_b };
 }
 
-void InterlockingGenerator::handleThinAreas(const std::unordered_set<GridPoint3>& has_all_meshes) const
+void InterlockingGenerator::handleThinAreas(const VoxelGrid& has_all_meshes) const
 {
     Settings& global_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
     const coord_t boundary_avoidance = global_settings.get<int>("interlocking_boundary_avoidance");
@@ -106,14 +109,15 @@ void InterlockingGenerator::handleThinAreas(const std::unordered_set<GridPoint3>
     // Make an inclusionary polygon, to only actually handle thin areas near actual microstructures (so not in skin for example).
     std::vector<Polygons> near_interlock_per_layer;
     near_interlock_per_layer.assign(std::min(mesh_a_.layers.size(), mesh_b_.layers.size()), Polygons());
-    for (const auto& cell : has_all_meshes)
-    {
-        const Point3LL bottom_corner = vu_.toLowerCorner(cell);
-        for (coord_t layer_nr = bottom_corner.z_; layer_nr < bottom_corner.z_ + cell_size_.z_ && layer_nr < static_cast<coord_t>(near_interlock_per_layer.size()); ++layer_nr)
+    has_all_meshes.forEach(
+        [&](const GridPoint3& cell)
         {
-            near_interlock_per_layer[static_cast<size_t>(layer_nr)].add(vu_.toPolygon(cell));
-        }
-    }
+            const Point3LL bottom_corner = vu_.toLowerCorner(cell);
+            for (coord_t layer_nr = bottom_corner.z_; layer_nr < bottom_corner.z_ + cell_size_.z_ && layer_nr < static_cast<coord_t>(near_interlock_per_layer.size()); ++layer_nr)
+            {
+                near_interlock_per_layer[static_cast<size_t>(layer_nr)].add(vu_.toPolygon(cell));
+            }
+        });
     for (auto& near_interlock : near_interlock_per_layer)
     {
         near_interlock = near_interlock.offset(rounding_errors).offset(-rounding_errors).unionPolygons().offset(detect);
@@ -149,23 +153,57 @@ void InterlockingGenerator::handleThinAreas(const std::unordered_set<GridPoint3>
 
 void InterlockingGenerator::generateInterlockingStructure() const
 {
-    std::vector<std::unordered_set<GridPoint3>> voxels_per_mesh = getShellVoxels(interface_dilation_);
-
-    std::unordered_set<GridPoint3>& has_any_mesh = voxels_per_mesh[0];
-    std::unordered_set<GridPoint3>& has_all_meshes = voxels_per_mesh[1];
-    has_any_mesh.merge(has_all_meshes); // perform union and intersection simultaneously. Cannibalizes voxels_per_mesh
+    const std::vector<std::vector<GridPoint3>> shell_cells_per_mesh = getShellVoxels(interface_dilation_);
 
     const std::vector<Polygons> layer_regions = computeUnionedVolumeRegions();
 
+    std::vector<GridPoint3> air_cells;
     if (air_filtering_)
     {
-        std::unordered_set<GridPoint3> air_cells;
-        addBoundaryCells(layer_regions, air_dilation_, air_cells);
+        air_cells = getBoundaryCells(layer_regions, air_dilation_);
+    }
 
-        for (const GridPoint3& p : air_cells)
+    // The dilated shells of both meshes can only overlap where the bounding boxes of their dilated cells overlap.
+    const coord_t interface_margin = std::max({ interface_dilation_.kernel_size_.x_, interface_dilation_.kernel_size_.y_, interface_dilation_.kernel_size_.z_ });
+    AABB3D interface_bounds[2];
+    for (size_t mesh_idx = 0; mesh_idx < 2; mesh_idx++)
+    {
+        for (const GridPoint3& cell : shell_cells_per_mesh[mesh_idx])
         {
-            has_all_meshes.erase(p);
+            interface_bounds[mesh_idx].include(cell);
         }
+        interface_bounds[mesh_idx].expand(interface_margin);
+    }
+    AABB3D bounds(
+        Point3LL(
+            std::max(interface_bounds[0].min_.x_, interface_bounds[1].min_.x_),
+            std::max(interface_bounds[0].min_.y_, interface_bounds[1].min_.y_),
+            std::max(interface_bounds[0].min_.z_, interface_bounds[1].min_.z_)),
+        Point3LL(
+            std::min(interface_bounds[0].max_.x_, interface_bounds[1].max_.x_),
+            std::min(interface_bounds[0].max_.y_, interface_bounds[1].max_.y_),
+            std::min(interface_bounds[0].max_.z_, interface_bounds[1].max_.z_)));
+    // Include the cells which can be dilated into those bounds, so that the dilation is complete within them.
+    // Cells dilated into the outer margin may be missing, but the intersection of both meshes is empty there anyway.
+    const coord_t air_margin = air_filtering_ ? std::max({ air_dilation_.kernel_size_.x_, air_dilation_.kernel_size_.y_, air_dilation_.kernel_size_.z_ }) : 0;
+    bounds.expand(std::max(interface_margin, air_margin));
+
+    const auto dilate_cells = [&bounds](const std::vector<GridPoint3>& cells, const DilationKernel& kernel)
+    {
+        VoxelGrid grid(bounds);
+        for (const GridPoint3& cell : cells)
+        {
+            grid.insert(cell);
+        }
+        return grid.dilate(kernel);
+    };
+
+    VoxelGrid has_all_meshes = dilate_cells(shell_cells_per_mesh[0], interface_dilation_);
+    has_all_meshes.intersect(dilate_cells(shell_cells_per_mesh[1], interface_dilation_));
+
+    if (air_filtering_)
+    {
+        has_all_meshes.subtract(dilate_cells(air_cells, air_dilation_));
 
         handleThinAreas(has_all_meshes);
     }
@@ -173,50 +211,64 @@ void InterlockingGenerator::generateInterlockingStructure() const
     applyMicrostructureToOutlines(has_all_meshes, layer_regions);
 }
 
-std::vector<std::unordered_set<GridPoint3>> InterlockingGenerator::getShellVoxels(const DilationKernel& kernel) const
+std::vector<std::vector<GridPoint3>> InterlockingGenerator::getShellVoxels(const DilationKernel& kernel) const
 {
-    std::vector<std::unordered_set<GridPoint3>> voxels_per_mesh(2);
+    std::vector<std::vector<GridPoint3>> voxels_per_mesh;
 
     // mark all cells which contain some boundary
-    for (size_t mesh_idx = 0; mesh_idx < 2; mesh_idx++)
+    for (Slicer* mesh : { &mesh_a_, &mesh_b_ })
     {
-        Slicer* mesh = (mesh_idx == 0) ? &mesh_a_ : &mesh_b_;
-        std::unordered_set<GridPoint3>& mesh_voxels = voxels_per_mesh[mesh_idx];
-
         std::vector<Polygons> rotated_polygons_per_layer(mesh->layers.size());
-        for (size_t layer_nr = 0; layer_nr < mesh->layers.size(); layer_nr++)
-        {
-            SlicerLayer& layer = mesh->layers[layer_nr];
-            rotated_polygons_per_layer[layer_nr] = layer.polygons;
-            rotated_polygons_per_layer[layer_nr].applyMatrix(rotation_);
-        }
+        cura::parallel_for<size_t>(
+            0,
+            mesh->layers.size(),
+            [&](const size_t layer_nr)
+            {
+                rotated_polygons_per_layer[layer_nr] = mesh->layers[layer_nr].polygons;
+                rotated_polygons_per_layer[layer_nr].applyMatrix(rotation_);
+            });
 
-        addBoundaryCells(rotated_polygons_per_layer, kernel, mesh_voxels);
+        voxels_per_mesh.push_back(getBoundaryCells(rotated_polygons_per_layer, kernel));
     }
 
     return voxels_per_mesh;
 }
 
-void InterlockingGenerator::addBoundaryCells(const std::vector<Polygons>& layers, const DilationKernel& kernel, std::unordered_set<GridPoint3>& cells) const
+std::vector<GridPoint3> InterlockingGenerator::getBoundaryCells(const std::vector<Polygons>& layers, const DilationKernel& kernel) const
 {
-    auto voxel_emplacer = [&cells](GridPoint3 p)
-    {
-        cells.emplace(p);
-        return true;
-    };
+    std::vector<std::vector<GridPoint3>> cells_per_layer(layers.size());
+    cura::parallel_for<size_t>(
+        0,
+        layers.size(),
+        [&](const size_t layer_nr)
+        {
+            std::vector<GridPoint3>& cells = cells_per_layer[layer_nr];
+            const auto voxel_emplacer = [&cells](const GridPoint3& p)
+            {
+                if (cells.empty() || ! (cells.back() == p)) // Consecutive segments of a polygon start in the cell where the previous one ended.
+                {
+                    cells.push_back(p);
+                }
+                return true;
+            };
+
+            const coord_t z = static_cast<coord_t>(layer_nr);
+            vu_.walkPolygonsToDilate(layers[layer_nr], z, kernel, voxel_emplacer);
+            Polygons skin = layers[layer_nr];
+            if (layer_nr > 0)
+            {
+                skin = skin.xorPolygons(layers[layer_nr - 1]);
+            }
+            skin = skin.offset(-cell_size_.x_ / 2).offset(cell_size_.x_ / 2); // remove superfluous small areas, which would anyway be included because of walkPolygons
+            vu_.walkAreasToDilate(skin, z, kernel, voxel_emplacer);
+        });
 
-    for (size_t layer_nr = 0; layer_nr < layers.size(); layer_nr++)
+    std::vector<GridPoint3> cells;
+    for (const std::vector<GridPoint3>& layer_cells : cells_per_layer)
     {
-        const coord_t z = static_cast<coord_t>(layer_nr);
-        vu_.walkDilatedPolygons(layers[layer_nr], z, kernel, voxel_emplacer);
-        Polygons skin = layers[layer_nr];
-        if (layer_nr > 0)
-        {
-            skin = skin.xorPolygons(layers[layer_nr - 1]);
-        }
-        skin = skin.offset(-cell_size_.x_ / 2).offset(cell_size_.x_ / 2); // remove superfluous small areas, which would anyway be included because of walkPolygons
-        vu_.walkDilatedAreas(skin, z, kernel, voxel_emplacer);
+        cells.insert(cells.end(), layer_cells.begin(), layer_cells.end());
     }
+    return cells;
 }
 
 std::vector<Polygons> InterlockingGenerator::computeUnionedVolumeRegions() const
@@ -224,21 +276,24 @@ std::vector<Polygons> InterlockingGenerator::computeUnionedVolumeRegions() const
     const size_t max_layer_count = std::max(mesh_a_.layers.size(), mesh_b_.layers.size()) + 1; // introduce ghost layer on top for correct skin computation of topmost layer.
     std::vector<Polygons> layer_regions(max_layer_count);
 
-    for (LayerIndex layer_nr = 0; layer_nr < max_layer_count; layer_nr++)
-    {
-        Polygons& layer_region = layer_regions[static_cast<size_t>(layer_nr)];
-        for (Slicer* mesh : { &mesh_a_, &mesh_b_ })
+    cura::parallel_for<size_t>(
+        0,
+        max_layer_count,
+        [&](const size_t layer_nr)
         {
-            if (layer_nr >= mesh->layers.size())
+            Polygons& layer_region = layer_regions[layer_nr];
+            for (Slicer* mesh : { &mesh_a_, &mesh_b_ })
             {
-                break;
+                if (layer_nr >= mesh->layers.size())
+                {
+                    break;
+                }
+                const SlicerLayer& layer = mesh->layers[layer_nr];
+                layer_region.add(layer.polygons);
             }
-            const SlicerLayer& layer = mesh->layers[static_cast<size_t>(layer_nr)];
-            layer_region.add(layer.polygons);
-        }
-        layer_region = layer_region.offset(ignored_gap_).offset(-ignored_gap_); // Morphological close to merge meshes into single volume
-        layer_region.applyMatrix(rotation_);
-    }
+            layer_region = layer_region.offset(ignored_gap_).offset(-ignored_gap_); // Morphological close to merge meshes into single volume
+            layer_region.applyMatrix(rotation_);
+        });
     return layer_regions;
 }
 
@@ -275,7 +330,7 @@ std::vector<std::vector<Polygons>> InterlockingGenerator::generateMicrostructure
     return cell_area_per_mesh_per_layer;
 }
 
-void InterlockingGenerator::applyMicrostructureToOutlines(const std::unordered_set<GridPoint3>& cells, const std::vector<Polygons>& layer_regions) const
+void InterlockingGenerator::applyMicrostructureToOutlines(const VoxelGrid& cells, const std::vector<Polygons>& layer_regions) const
 {
     std::vector<std::vector<Polygons>> cell_area_per_mesh_per_layer = generateMicrostructure();
 
@@ -292,19 +347,20 @@ void InterlockingGenerator::applyMicrostructureToOutlines(const std::unordered_s
     structure_per_layer[1].resize(num_interlocking_layers);
 
     // Only compute cell structure for half the layers, because since our beams are two layers high, every odd layer of the structure will be the same as the layer below.
-    for (const GridPoint3& grid_loc : cells)
-    {
-        Point3LL bottom_corner = vu_.toLowerCorner(grid_loc);
-        for (size_t mesh_idx = 0; mesh_idx < 2; mesh_idx++)
+    cells.forEach(
+        [&](const GridPoint3& grid_loc)
         {
-            for (LayerIndex layer_nr = bottom_corner.z_; layer_nr < bottom_corner.z_ + cell_size_.z_ && layer_nr < max_layer_count; layer_nr += beam_layer_count_)
+            Point3LL bottom_corner = vu_.toLowerCorner(grid_loc);
+            for (size_t mesh_idx = 0; mesh_idx < 2; mesh_idx++)
             {
-                Polygons areas_here = cell_area_per_mesh_per_layer[static_cast<size_t>(layer_nr / beam_layer_count_) % cell_area_per_mesh_per_layer.size()][mesh_idx];
-                areas_here.translate(Point2LL(bottom_corner.x_, bottom_corner.y_));
-                structure_per_layer[mesh_idx][static_cast<size_t>(layer_nr / beam_layer_count_)].add(areas_here);
+                for (LayerIndex layer_nr = bottom_corner.z_; layer_nr < bottom_corner.z_ + cell_size_.z_ && layer_nr < max_layer_count; layer_nr += beam_layer_count_)
+                {
+                    Polygons areas_here = cell_area_per_mesh_per_layer[static_cast<size_t>(layer_nr / beam_layer_count_) % cell_area_per_mesh_per_layer.size()][mesh_idx];
+                    areas_here.translate(Point2LL(bottom_corner.x_, bottom_corner.y_));
+                    structure_per_layer[mesh_idx][static_cast<size_t>(layer_nr / beam_layer_count_)].add(areas_here);
+                }
             }
-        }
-    }
+        });
 
     for (size_t mesh_idx = 0; mesh_idx < 2; mesh_idx++)
     {
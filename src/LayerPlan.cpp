@@ -300,7 +300,11 @@ void LayerPlan::moveInsideCombBoundary(const coord_t distance, const std::option
     {
         // Move inside again, so we move out of tight 90deg corners
         PolygonUtils::moveInside(comb_boundary_preferred_, p, distance, max_dist2);
-        if (comb_boundary_preferred_.inside(p) && (part == std::nullopt || part->outline.inside(p)))
+        if (! comb_boundary_preferred_index_)
+        {
+            comb_boundary_preferred_index_.emplace(comb_boundary_preferred_);
+        }
+        if (comb_boundary_preferred_index_->inside(p) && (part == std::nullopt || part->outline.inside(p)))
         {
             addTravel_simple(p);
             // Make sure the that any retraction happens after this move, not before it by starting a new move path.
@@ -715,7 +719,7 @@ void LayerPlan::addWallLine(
                         segment_flow,
                         width_factor,
                         spiralize,
-                        (overhang_mask_.empty() || (! overhang_mask_.inside(p0, true) && ! overhang_mask_.inside(p1, true))) ? speed_factor : overhang_speed_factor);
+                        (overhang_mask_.empty() || (! overhang_mask_index_.inside(p0, true) && ! overhang_mask_index_.inside(p1, true))) ? speed_factor : overhang_speed_factor);
                 }
 
                 distance_to_bridge_start -= len;
@@ -730,7 +734,7 @@ void LayerPlan::addWallLine(
                     segment_flow,
                     width_factor,
                     spiralize,
-                    (overhang_mask_.empty() || (! overhang_mask_.inside(p0, true) && ! overhang_mask_.inside(p1, true))) ? speed_factor : overhang_speed_factor);
+                    (overhang_mask_.empty() || (! overhang_mask_index_.inside(p0, true) && ! overhang_mask_index_.inside(p1, true))) ? speed_factor : overhang_speed_factor);
             }
             non_bridge_line_volume += vSize(cur_point - segment_end) * segment_flow * width_factor * speed_factor * non_bridge_config.getSpeed();
             cur_point = segment_end;
@@ -753,12 +757,12 @@ void LayerPlan::addWallLine(
             flow,
             width_factor,
             spiralize,
-            (overhang_mask_.empty() || (! overhang_mask_.inside(p0, true) && ! overhang_mask_.inside(p1, true))) ? 1.0_r : overhang_speed_factor);
+            (overhang_mask_.empty() || (! overhang_mask_index_.inside(p0, true) && ! overhang_mask_index_.inside(p1, true))) ? 1.0_r : overhang_speed_factor);
     }
     else
     {
         // bridges may be required
-        if (PolygonUtils::polygonCollidesWithLineSegment(bridge_wall_mask_, p0, p1))
+        if (bridge_wall_mask_index_.intersectsSegment(p0, p1))
         {
             // the line crosses the boundary between supported and non-supported regions so one or more bridges are required
 
@@ -831,7 +835,7 @@ void LayerPlan::addWallLine(
             // if we haven't yet reached p1, fill the gap with non_bridge_config line
             addNonBridgeLine(p1);
         }
-        else if (bridge_wall_mask_.inside(p0, true) && vSize(p0 - p1) >= min_bridge_line_len)
+        else if (bridge_wall_mask_index_.inside(p0, true) && vSize(p0 - p1) >= min_bridge_line_len)
         {
             // both p0 and p1 must be above air (the result will be ugly!)
             addExtrusionMove(p1, bridge_config, SpaceFillType::Polygons, flow, width_factor);
@@ -928,7 +932,7 @@ void LayerPlan::addWall(
                 const ExtrusionJunction& p0 = wall[point_idx];
                 const ExtrusionJunction& p1 = wall[(point_idx + 1) % wall.size()];
 
-                if (PolygonUtils::polygonCollidesWithLineSegment(bridge_wall_mask_, p0.p_, p1.p_))
+                if (bridge_wall_mask_index_.intersectsSegment(p0.p_, p1.p_))
                 {
                     // the line crosses the boundary between supported and non-supported regions so it will contain one or more bridge segments
 
@@ -982,7 +986,7 @@ void LayerPlan::addWall(
                         line_polys.remove(nearest);
                     }
                 }
-                else if (! bridge_wall_mask_.inside(p0.p_, true))
+                else if (! bridge_wall_mask_index_.inside(p0.p_, true))
                 {
                     // none of the line is over air
                     distance_to_bridge_start += vSize(p1.p_ - p0.p_);
@@ -2464,11 +2468,13 @@ size_t LayerPlan::getExtruder() const
 void LayerPlan::setBridgeWallMask(const Polygons& polys)
 {
     bridge_wall_mask_ = polys;
+    bridge_wall_mask_index_ = PreparedPolygons(bridge_wall_mask_);
 }
 
 void LayerPlan::setOverhangMask(const Polygons& polys)
 {
     overhang_mask_ = polys;
+    overhang_mask_index_ = PreparedPolygons(overhang_mask_);
 }
 
 } // namespace cura
@@ -11,6 +11,8 @@
 #include "sliceDataStorage.h"
 #include "slicer.h"
 #include "utils/Point2LL.h"
+#include "utils/ThreadPool.h"
+#include "utils/math.h"
 
 namespace cura
 {
@@ -46,78 +48,149 @@ void Mold::process(std::vector<Slicer*>& slicer_list)
     }
 
     const coord_t layer_height = scene.current_mesh_group->settings.get<coord_t>("layer_height");
-    std::vector<Polygons> mold_outline_above_per_mesh; // the outer outlines of the layer above without the original model(s) being cut out
-    mold_outline_above_per_mesh.resize(slicer_list.size());
-    for (int layer_nr = layer_count - 1; layer_nr >= 0; layer_nr--)
+    std::vector<std::vector<Polygons>> model_outlines_per_mesh(slicer_list.size()); // the outlines of the models for which to generate a mold (insides of the molds)
+    std::vector<std::vector<Polygons>> mold_outlines_per_mesh(slicer_list.size()); // the outer outlines of the molds without the original model(s) being cut out
+    for (unsigned int mesh_idx = 0; mesh_idx < slicer_list.size(); mesh_idx++)
     {
-        Polygons all_original_mold_outlines; // outlines of all models for which to generate a mold (insides of all molds)
-
-        // first generate outlines
-        for (unsigned int mesh_idx = 0; mesh_idx < slicer_list.size(); mesh_idx++)
+        const Mesh& mesh = scene.current_mesh_group->meshes[mesh_idx];
+        if (! mesh.settings_.get<bool>("mold_enabled"))
         {
-            const Mesh& mesh = scene.current_mesh_group->meshes[mesh_idx];
-            Slicer& slicer = *slicer_list[mesh_idx];
-            if (! mesh.settings_.get<bool>("mold_enabled") || layer_nr >= static_cast<int>(slicer.layers.size()))
+            continue;
+        }
+        Slicer& slicer = *slicer_list[mesh_idx];
+        const size_t mesh_layer_count = slicer.layers.size();
+        const coord_t width = mesh.settings_.get<coord_t>("mold_width");
+        const AngleDegrees angle = mesh.settings_.get<AngleDegrees>("mold_angle");
+        const coord_t roof_height = mesh.settings_.get<coord_t>("mold_roof_height");
+
+        const coord_t inset = tan(angle / 180 * std::numbers::pi) * layer_height;
+        const size_t roof_layer_count = roof_height / layer_height;
+
+        // First everything that only depends on the model on a single layer, which can be computed for all layers in parallel.
+        std::vector<Polygons>& model_outlines = model_outlines_per_mesh[mesh_idx];
+        model_outlines.resize(mesh_layer_count);
+        std::vector<Polygons> model_offsets(mesh_layer_count);
+        cura::parallel_for<size_t>(
+            0,
+            mesh_layer_count,
+            [&](const size_t layer_nr)
             {
-                continue;
-            }
-            coord_t width = mesh.settings_.get<coord_t>("mold_width");
-            coord_t open_polyline_width = mesh.settings_.get<coord_t>("wall_line_width_0");
-            if (layer_nr == 0)
+                coord_t open_polyline_width = mesh.settings_.get<coord_t>("wall_line_width_0");
+                if (layer_nr == 0)
+                {
+                    const ExtruderTrain& train_wall_0 = mesh.settings_.get<ExtruderTrain&>("wall_0_extruder_nr");
+                    open_polyline_width *= train_wall_0.settings_.get<Ratio>("initial_layer_line_width_factor");
+                }
+                const SlicerLayer& layer = slicer.layers[layer_nr];
+                model_outlines[layer_nr] = layer.polygons.unionPolygons(layer.openPolylines.offsetPolyLine(open_polyline_width / 2));
+                model_offsets[layer_nr] = model_outlines[layer_nr].offset(width, ClipperLib::jtRound);
+            });
+
+        // Add roofs, which are the mold around the model some layers below.
+        std::vector<Polygons>& mold_outlines = mold_outlines_per_mesh[mesh_idx];
+        mold_outlines.resize(mesh_layer_count);
+        cura::parallel_for<size_t>(
+            0,
+            mesh_layer_count,
+            [&](const size_t layer_nr)
             {
-                const ExtruderTrain& train_wall_0 = mesh.settings_.get<ExtruderTrain&>("wall_0_extruder_nr");
-                open_polyline_width *= train_wall_0.settings_.get<Ratio>("initial_layer_line_width_factor");
-            }
-            const AngleDegrees angle = mesh.settings_.get<AngleDegrees>("mold_angle");
-            const coord_t roof_height = mesh.settings_.get<coord_t>("mold_roof_height");
-
-            const coord_t inset = tan(angle / 180 * std::numbers::pi) * layer_height;
-            const size_t roof_layer_count = roof_height / layer_height;
-
-
-            SlicerLayer& layer = slicer.layers[layer_nr];
-            Polygons model_outlines = layer.polygons.unionPolygons(layer.openPolylines.offsetPolyLine(open_polyline_width / 2));
-            layer.openPolylines.clear();
-            all_original_mold_outlines.add(model_outlines);
+                if (roof_layer_count == 0 || layer_nr == 0)
+                {
+                    mold_outlines[layer_nr] = model_offsets[layer_nr];
+                    return;
+                }
+                const size_t layer_nr_below = layer_nr - std::min(layer_nr, roof_layer_count);
+                const SlicerLayer& layer_below = slicer.layers[layer_nr_below];
+                // Without open polylines, the offset of the model below is the offset of the roof, so don't compute it twice.
+                const Polygons roofs = layer_below.openPolylines.empty() ? model_offsets[layer_nr_below] : layer_below.polygons.offset(width, ClipperLib::jtRound);
+                mold_outlines[layer_nr] = model_offsets[layer_nr].unionPolygons(roofs);
+            });
+
+        if (angle < 90)
+        {
+            // Each layer of the mold is at least the layer above, shrunk to get the mold angle.
+            mold_outlines = accumulateOutlines(mold_outlines, inset);
+        }
+    }
 
-            if (angle >= 90)
+    // cut out molds from all objects after generating mold outlines for all objects so that molds won't overlap into the casting cutout of another mold
+    cura::parallel_for<size_t>(
+        0,
+        layer_count,
+        [&](const size_t layer_nr)
+        {
+            Polygons all_original_mold_outlines; // outlines of all models for which to generate a mold (insides of all molds)
+            for (const std::vector<Polygons>& model_outlines : model_outlines_per_mesh)
             {
-                layer.polygons = model_outlines.offset(width, ClipperLib::jtRound);
+                if (layer_nr < model_outlines.size())
+                {
+                    all_original_mold_outlines.add(model_outlines[layer_nr]);
+                }
             }
-            else
+            all_original_mold_outlines = all_original_mold_outlines.unionPolygons();
+
+            // carve molds out of all other models
+            for (unsigned int mesh_idx = 0; mesh_idx < slicer_list.size(); mesh_idx++)
             {
-                Polygons& mold_outline_above = mold_outline_above_per_mesh[mesh_idx]; // the outside of the mold on the layer above
-                layer.polygons = mold_outline_above.offset(-inset).unionPolygons(model_outlines.offset(width, ClipperLib::jtRound));
+                const std::vector<Polygons>& mold_outlines = mold_outlines_per_mesh[mesh_idx];
+                if (layer_nr >= mold_outlines.size())
+                {
+                    continue; // only cut original models out of all molds
+                }
+                SlicerLayer& layer = slicer_list[mesh_idx]->layers[layer_nr];
+                layer.polygons = mold_outlines[layer_nr].difference(all_original_mold_outlines);
+                layer.openPolylines.clear();
             }
+        });
+}
 
-            // add roofs
-            if (roof_layer_count > 0 && layer_nr > 0)
+std::vector<Polygons> Mold::accumulateOutlines(const std::vector<Polygons>& mold_parts, const coord_t inset)
+{
+    const size_t layer_count = mold_parts.size();
+    std::vector<Polygons> outlines(layer_count);
+    if (layer_count == 0)
+    {
+        return outlines;
+    }
+    const auto add_outline_above = [&mold_parts, inset](const Polygons& outline_above, const size_t layer_nr)
+    {
+        return outline_above.offset(-inset).unionPolygons(mold_parts[layer_nr]);
+    };
+
+    // Compute each block of layers as if there is nothing above it. For the top block, that's the actual result.
+    const size_t block_count = round_up_divide(layer_count, block_size);
+    cura::parallel_for<size_t>(
+        0,
+        block_count,
+        [&](const size_t block_idx)
+        {
+            Polygons outline_above;
+            for (size_t layer_nr = std::min(layer_count, (block_idx + 1) * block_size); layer_nr-- > block_idx * block_size;)
             {
-                LayerIndex layer_nr_below = std::max(0, static_cast<int>(layer_nr - roof_layer_count));
-                Polygons roofs = slicer.layers[layer_nr_below].polygons.offset(width, ClipperLib::jtRound); // TODO: don't compute offset twice!
-                layer.polygons = layer.polygons.unionPolygons(roofs);
+                outlines[layer_nr] = add_outline_above(outline_above, layer_nr);
+                outline_above = outlines[layer_nr];
             }
+        });
 
-            mold_outline_above_per_mesh[mesh_idx] = layer.polygons;
-        }
-        all_original_mold_outlines = all_original_mold_outlines.unionPolygons();
-
-        // cut out molds from all objects after generating mold outlines for all objects so that molds won't overlap into the casting cutout of another mold
-
-        // carve molds out of all other models
-        for (unsigned int mesh_idx = 0; mesh_idx < slicer_list.size(); mesh_idx++)
+    // Then correct the other blocks from the top down. The outline above usually shrinks away or is covered by the mold parts within a few
+    // layers, after which the rest of the block is already correct.
+    for (size_t block_top = (block_count - 1) * block_size; block_top > 0; block_top -= block_size)
+    {
+        for (size_t layer_nr = block_top; layer_nr-- > block_top - block_size;)
         {
-            const Mesh& mesh = scene.current_mesh_group->meshes[mesh_idx];
-            if (! mesh.settings_.get<bool>("mold_enabled"))
+            Polygons outline = add_outline_above(outlines[layer_nr + 1], layer_nr);
+            // The outline that includes the layers above always covers the guess, so if their area is about the same it's worth checking whether they are.
+            const double area_difference = std::abs(outline.area() - outlines[layer_nr].area());
+            const bool converged = area_difference <= convergence_tolerance * (outline.polygonLength() + outlines[layer_nr].polygonLength())
+                                && outline.xorPolygons(outlines[layer_nr]).offset(-convergence_tolerance / 2).empty();
+            outlines[layer_nr] = std::move(outline);
+            if (converged)
             {
-                continue; // only cut original models out of all molds
+                break;
             }
-            Slicer& slicer = *slicer_list[mesh_idx];
-            SlicerLayer& layer = slicer.layers[layer_nr];
-            layer.polygons = layer.polygons.difference(all_original_mold_outlines);
         }
     }
+    return outlines;
 }
 
-
 } // namespace cura
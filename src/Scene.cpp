@@ -8,6 +8,7 @@
 #include "Application.h"
 #include "FffProcessor.h" //To start a slice.
 #include "communication/Communication.h" //To flush g-code and layer view when we're done.
+#include "infill/InfillCache.h"
 #include "progress/Progress.h"
 #include "sliceDataStorage.h"
 
@@ -85,6 +86,8 @@ void Scene::processMeshGroup(MeshGroup& mesh_group)
         return;
     }
 
+    InfillCache::getInstance().reset(InfillCache::getMaxSizeFromEnvironment()); // Results of other mesh groups can't be reused, since their settings differ.
+
     SliceDataStorage storage;
     if (! fff_processor->polygon_generator.generateAreas(storage, &mesh_group, fff_processor->time_keeper))
     {
@@ -92,7 +95,9 @@ void Scene::processMeshGroup(MeshGroup& mesh_group)
     }
 
     Progress::messageProgressStage(Progress::Stage::EXPORT, &fff_processor->time_keeper);
-    fff_processor->gcode_writer.writeGCode(storage, fff_processor->time_keeper);
+    fff_processor->gcode_writer->writeGCode(storage, fff_processor->time_keeper);
+    InfillCache::getInstance().logStatistics();
+    InfillCache::getInstance().reset(0); // Free the memory of the results.
 
     Progress::messageProgress(Progress::Stage::FINISH, 1, 1); // 100% on this meshgroup
     Application::getInstance().communication_->flushGCode();
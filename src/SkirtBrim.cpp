@@ -110,6 +110,16 @@ std::vector<SkirtBrim::Offset> SkirtBrim::generateBrimOffsetPlan(std::vector<Pol
     return all_brim_offsets;
 }
 
+Polygons& SkirtBrim::CoveredArea::get()
+{
+    if (! added.empty())
+    {
+        area = area.unionPolygons(added);
+        added.clear();
+    }
+    return area;
+}
+
 void SkirtBrim::generate()
 {
     std::vector<Polygons> starting_outlines(extruder_count_);
@@ -119,7 +129,7 @@ void SkirtBrim::generate()
     constexpr bool include_support = true;
     const bool include_prime_tower = adhesion_type_ == EPlatformAdhesion::SKIRT;
     const bool has_prime_tower = storage_.primeTower.enabled_;
-    Polygons covered_area = storage_.getLayerOutlines(layer_nr, include_support, include_prime_tower, /*external_polys_only*/ false);
+    CoveredArea covered_area{ storage_.getLayerOutlines(layer_nr, include_support, include_prime_tower, /*external_polys_only*/ false) };
 
     std::vector<Polygons> allowed_areas_per_extruder(extruder_count_);
     for (int extruder_nr = 0; extruder_nr < extruder_count_; extruder_nr++)
@@ -129,12 +139,12 @@ void SkirtBrim::generate()
             continue;
         }
         Polygons machine_area = storage_.getMachineBorder(extruder_nr);
-        allowed_areas_per_extruder[extruder_nr] = machine_area.difference(covered_area);
+        allowed_areas_per_extruder[extruder_nr] = machine_area.difference(covered_area.area);
         if (external_polys_only_[extruder_nr])
         {
             // Expand covered area on inside of holes when external_only is enabled for any extruder,
             // so that the brim lines don't overlap with the holes by half the line width
-            allowed_areas_per_extruder[extruder_nr] = allowed_areas_per_extruder[extruder_nr].difference(getInternalHoleExclusionArea(covered_area, extruder_nr));
+            allowed_areas_per_extruder[extruder_nr] = allowed_areas_per_extruder[extruder_nr].difference(getInternalHoleExclusionArea(covered_area.area, extruder_nr));
         }
 
         if (has_prime_tower)
@@ -148,20 +158,21 @@ void SkirtBrim::generate()
     // with the other area calculation above, since they are either itself a simple/convex shape or relevant for brim.
     if (adhesion_type_ == EPlatformAdhesion::SKIRT)
     {
-        covered_area = covered_area.approxConvexHull();
+        covered_area.area = covered_area.area.approxConvexHull();
     }
 
     std::vector<coord_t> total_length = generatePrimaryBrim(all_brim_offsets, covered_area, allowed_areas_per_extruder);
 
     // ooze/draft shield brim
-    generateShieldBrim(covered_area, allowed_areas_per_extruder);
+    generateShieldBrim(covered_area.get(), allowed_areas_per_extruder);
 
     { // only allow secondary skirt/brim to appear on the very outside
-        covered_area = covered_area.getOutsidePolygons();
+        covered_area.area = covered_area.get().getOutsidePolygons();
         for (int extruder_nr = 0; extruder_nr < extruder_count_; extruder_nr++)
         {
-            allowed_areas_per_extruder[extruder_nr] = allowed_areas_per_extruder[extruder_nr].difference(covered_area);
+            allowed_areas_per_extruder[extruder_nr] = allowed_areas_per_extruder[extruder_nr].difference(covered_area.area);
         }
+        covered_area.excluded = true;
     }
 
     // Secondary brim of all other materials which don;t meet minimum length constriant yet
@@ -182,7 +193,7 @@ void SkirtBrim::generate()
     }
 }
 
-std::vector<coord_t> SkirtBrim::generatePrimaryBrim(std::vector<Offset>& all_brim_offsets, Polygons& covered_area, std::vector<Polygons>& allowed_areas_per_extruder)
+std::vector<coord_t> SkirtBrim::generatePrimaryBrim(std::vector<Offset>& all_brim_offsets, CoveredArea& covered_area, std::vector<Polygons>& allowed_areas_per_extruder)
 {
     std::vector<coord_t> total_length(extruder_count_, 0U);
 
@@ -245,7 +256,7 @@ Polygons SkirtBrim::getInternalHoleExclusionArea(const Polygons& outline, const
     return ret;
 }
 
-coord_t SkirtBrim::generateOffset(const Offset& offset, Polygons& covered_area, std::vector<Polygons>& allowed_areas_per_extruder, SkirtBrimLine& result)
+coord_t SkirtBrim::generateOffset(const Offset& offset, CoveredArea& covered_area, std::vector<Polygons>& allowed_areas_per_extruder, SkirtBrimLine& result)
 {
     coord_t length_added;
     Polygons brim;
@@ -324,14 +335,22 @@ coord_t SkirtBrim::generateOffset(const Offset& offset, Polygons& covered_area,
     }
 
     { // update allowed_areas_per_extruder
+        // The allowed areas don't overlap the covered area, except right after it was changed without removing it from them, so usually it's
+        // enough to remove what is newly covered.
+        newly_covered = newly_covered.unionPolygons();
+        covered_area.added.add(newly_covered);
+        if (! covered_area.excluded)
+        {
+            newly_covered = newly_covered.unionPolygons(covered_area.area);
+            covered_area.excluded = true;
+        }
         for (int extruder_nr = 0; extruder_nr < extruder_count_; extruder_nr++)
         {
             if (! extruder_is_used_[extruder_nr])
             {
                 continue;
             }
-            covered_area = covered_area.unionPolygons(newly_covered.unionPolygons());
-            allowed_areas_per_extruder[extruder_nr] = allowed_areas_per_extruder[extruder_nr].difference(covered_area);
+            allowed_areas_per_extruder[extruder_nr] = allowed_areas_per_extruder[extruder_nr].difference(newly_covered);
         }
     }
     return length_added;
@@ -532,14 +551,14 @@ void SkirtBrim::generateShieldBrim(Polygons& brim_covered_area, std::vector<Poly
     }
 }
 
-void SkirtBrim::generateSecondarySkirtBrim(Polygons& covered_area, std::vector<Polygons>& allowed_areas_per_extruder, std::vector<coord_t>& total_length)
+void SkirtBrim::generateSecondarySkirtBrim(CoveredArea& covered_area, std::vector<Polygons>& allowed_areas_per_extruder, std::vector<coord_t>& total_length)
 {
     constexpr coord_t bogus_total_offset = 0u; // Doesn't matter. The offsets won't be sorted here.
     constexpr bool is_last = false; // Doesn't matter. Isn't used in the algorithm below.
     for (int extruder_nr = 0; extruder_nr < extruder_count_; extruder_nr++)
     {
         bool first = true;
-        Polygons reference_outline = covered_area;
+        Polygons reference_outline = covered_area.get();
         while (total_length[extruder_nr] < skirt_brim_minimal_length_[extruder_nr])
         {
             decltype(Offset::reference_outline_or_index_) ref_polys_or_idx = nullptr;
@@ -3,6 +3,9 @@
 
 #include "TreeModelVolumes.h"
 
+#include <array>
+#include <string_view>
+
 #include <range/v3/view/enumerate.hpp>
 #include <range/v3/view/iota.hpp>
 #include <range/v3/view/reverse.hpp>
@@ -18,6 +21,101 @@
 namespace cura
 {
 
+namespace
+{
+
+/*!
+ * Every setting that the precalculation reads from the settings of a group of meshes: those read here, and those that its TreeSupportSettings are made from.
+ *
+ * Keep this up to date when TreeModelVolumes or TreeSupportSettings start to read another setting, or a disk cache could return areas that were calculated with another value.
+ */
+constexpr auto PRECALCULATION_SETTINGS = std::to_array<std::string_view>({
+    // Read by TreeModelVolumes.
+    "anti_overhang_mesh",
+    "infill_mesh",
+    "layer_height",
+    "magic_mesh_surface_mode",
+    "meshfix_maximum_deviation",
+    "meshfix_maximum_extrusion_area_deviation",
+    "meshfix_maximum_resolution",
+    "support_bottom_distance",
+    "support_top_distance",
+    "support_type",
+    "support_xy_distance",
+    // Read by TreeSupportSettings.
+    "fill_outline_gaps",
+    "min_bead_width",
+    "min_even_wall_line_width",
+    "min_feature_size",
+    "min_odd_wall_line_width",
+    "min_wall_line_width",
+    "support_bottom_enable",
+    "support_bottom_height",
+    "support_bottom_offset",
+    "support_connect_zigzags",
+    "support_infill_angles",
+    "support_interface_priority",
+    "support_interface_skip_height",
+    "support_line_distance",
+    "support_line_width",
+    "support_pattern",
+    "support_roof_angles",
+    "support_roof_line_distance",
+    "support_roof_line_width",
+    "support_roof_pattern",
+    "support_roof_wall_count",
+    "support_skip_some_zags",
+    "support_tree_angle",
+    "support_tree_angle_slow",
+    "support_tree_bp_diameter",
+    "support_tree_branch_diameter",
+    "support_tree_branch_diameter_angle",
+    "support_tree_max_diameter",
+    "support_tree_max_diameter_increase_by_merges_when_support_to_model",
+    "support_tree_min_height_to_model",
+    "support_tree_rest_preference",
+    "support_tree_tip_diameter",
+    "support_wall_count",
+    "support_xy_distance_overhang",
+    "support_xy_overrides_z",
+    "support_zag_skip_count",
+    "wall_distribution_count",
+    "wall_line_width_x",
+    "wall_transition_angle",
+    "wall_transition_filter_deviation",
+    "wall_transition_filter_distance",
+    "wall_transition_length",
+    "zig_zaggify_support",
+});
+
+template<typename T>
+void appendValueToKey(std::string& key, const T value)
+{
+    key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendStringToKey(std::string& key, const std::string_view value)
+{
+    appendValueToKey<uint64_t>(key, value.size());
+    key.append(value);
+}
+
+void appendPolygonsToKey(std::string& key, const Polygons& polygons)
+{
+    appendValueToKey<uint64_t>(key, polygons.size());
+    for (ConstPolygonRef polygon : polygons)
+    {
+        appendValueToKey<uint64_t>(key, polygon.size());
+        for (const Point2LL& point : polygon)
+        {
+            appendValueToKey<int64_t>(key, point.X);
+            appendValueToKey<int64_t>(key, point.Y);
+        }
+    }
+}
+
+} // namespace
+
 TreeModelVolumes::TreeModelVolumes(
     const SliceDataStorage& storage,
     const coord_t max_move,
@@ -167,6 +265,7 @@ TreeModelVolumes::TreeModelVolumes(
     radius_0_ = config.getRadius(0);
     support_rest_preference_ = config.support_rest_preference;
     simplifier_ = Simplify(min_maximum_resolution, min_maximum_deviation, min_maximum_area_deviation);
+    disk_cache_ = TreeModelVolumesDiskCache::fromEnvironment();
 }
 
 void TreeModelVolumes::precalculate(coord_t max_layer)
@@ -196,6 +295,21 @@ void TreeModelVolumes::precalculate(coord_t max_layer)
         }
     }
 
+    std::string disk_cache_key;
+    if (disk_cache_)
+    {
+        disk_cache_key = getPrecalculationKey(config, max_layer);
+        if (disk_cache_->load(disk_cache_key, getCaches()))
+        {
+            precalculation_finished_ = true;
+            precalculation_progress_ = TREE_PROGRESS_PRECALC_COLL + TREE_PROGRESS_PRECALC_AVO;
+            Progress::messageProgress(Progress::Stage::SUPPORT, precalculation_progress_ * progress_multiplier_ + progress_offset_, TREE_PROGRESS_TOTAL);
+            const auto dur_load = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - t_start).count();
+            spdlog::info("Loaded precalculated collision and avoidance from the tree support cache in {} ms.", dur_load);
+            return;
+        }
+    }
+
     // Since we possibly have a required max/min size branches can be on the build-plate, and also of course a restricted rate at wich a radius normally is altered,
     //   (also) pre-calculate the restriction(s) on the radius at each layer which maximum these restrictions impose.
 
@@ -313,6 +427,10 @@ void TreeModelVolumes::precalculate(coord_t max_layer)
     }
 
     precalculation_finished_ = true;
+    if (disk_cache_)
+    {
+        disk_cache_->store(disk_cache_key, getCaches());
+    }
     const auto dur_col = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_coll - t_start).count();
     const auto dur_acc = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_acc - t_coll).count();
     const auto dur_avo = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_avo - t_acc).count();
@@ -345,10 +463,7 @@ const Polygons& TreeModelVolumes::getCollision(coord_t radius, LayerIndex layer_
     }
     RadiusLayerPair key{ radius, layer_idx };
 
-    {
-        std::lock_guard<std::mutex> critical_section_support_max_layer_nr(*critical_avoidance_cache_);
-        result = getArea(collision_cache_, key);
-    }
+    result = collision_cache_->get(key.first, key.second);
     if (result)
     {
         return result.value().get();
@@ -375,10 +490,7 @@ const Polygons& TreeModelVolumes::getCollisionHolefree(coord_t radius, LayerInde
     }
     RadiusLayerPair key{ radius, layer_idx };
 
-    {
-        std::lock_guard<std::mutex> critical_section_support_max_layer_nr(*critical_collision_cache_holefree_);
-        result = getArea(collision_cache_holefree_, key);
-    }
+    result = collision_cache_holefree_->get(key.first, key.second);
     if (result)
     {
         return result.value().get();
@@ -393,12 +505,9 @@ const Polygons& TreeModelVolumes::getCollisionHolefree(coord_t radius, LayerInde
 
 const Polygons& TreeModelVolumes::getAccumulatedPlaceable0(LayerIndex layer_idx)
 {
+    if (const auto result = accumulated_placeables_cache_radius_0_->get(0, layer_idx))
     {
-        std::lock_guard<std::mutex> critical_section_support_max_layer_nr(*critical_accumulated_placeables_cache_radius_0_);
-        if (accumulated_placeables_cache_radius_0_.count(layer_idx))
-        {
-            return accumulated_placeables_cache_radius_0_[layer_idx];
-        }
+        return result.value().get();
     }
     calculateAccumulatedPlaceable0(layer_idx);
     return getAccumulatedPlaceable0(layer_idx);
@@ -425,21 +534,17 @@ const Polygons& TreeModelVolumes::getAvoidance(coord_t radius, LayerIndex layer_
 
     const RadiusLayerPair key{ radius, layer_idx };
 
-    std::unordered_map<RadiusLayerPair, Polygons>* cache_ptr = nullptr;
-    std::mutex* mutex_ptr = nullptr;
+    const RadiusLayerPolygonCache* cache_ptr = nullptr;
     switch (type)
     {
     case AvoidanceType::FAST:
-        cache_ptr = to_model ? &avoidance_cache_to_model_ : &avoidance_cache_;
-        mutex_ptr = to_model ? critical_avoidance_cache_to_model_.get() : critical_avoidance_cache_.get();
+        cache_ptr = to_model ? avoidance_cache_to_model_.get() : avoidance_cache_.get();
         break;
     case AvoidanceType::SLOW:
-        cache_ptr = to_model ? &avoidance_cache_to_model_slow_ : &avoidance_cache_slow_;
-        mutex_ptr = to_model ? critical_avoidance_cache_to_model_slow_.get() : critical_avoidance_cache_slow_.get();
+        cache_ptr = to_model ? avoidance_cache_to_model_slow_.get() : avoidance_cache_slow_.get();
         break;
     case AvoidanceType::FAST_SAFE:
-        cache_ptr = to_model ? &avoidance_cache_hole_to_model_ : &avoidance_cache_hole_;
-        mutex_ptr = to_model ? critical_avoidance_cache_holefree_to_model_.get() : critical_avoidance_cache_holefree_.get();
+        cache_ptr = to_model ? avoidance_cache_hole_to_model_.get() : avoidance_cache_hole_.get();
         break;
     case AvoidanceType::COLLISION:
         if (layer_idx <= max_layer_idx_without_blocker_)
@@ -448,8 +553,7 @@ const Polygons& TreeModelVolumes::getAvoidance(coord_t radius, LayerIndex layer_
         }
         else
         {
-            cache_ptr = &avoidance_cache_collision_;
-            mutex_ptr = critical_avoidance_cache_collision_.get();
+            cache_ptr = avoidance_cache_collision_.get();
         }
         break;
     default:
@@ -457,10 +561,7 @@ const Polygons& TreeModelVolumes::getAvoidance(coord_t radius, LayerIndex layer_
         break;
     }
 
-    {
-        std::lock_guard<std::mutex> critical_section(*mutex_ptr);
-        result = getArea(*cache_ptr, key);
-    }
+    result = cache_ptr->get(key.first, key.second);
     if (result)
     {
         return result.value().get();
@@ -496,10 +597,7 @@ const Polygons& TreeModelVolumes::getPlaceableAreas(coord_t radius, LayerIndex l
     radius = ceilRadius(radius);
     RadiusLayerPair key{ radius, layer_idx };
 
-    {
-        std::lock_guard<std::mutex> critical_section(*critical_placeable_areas_cache_);
-        result = getArea(placeable_areas_cache_, key);
-    }
+    result = placeable_areas_cache_->get(key.first, key.second);
     if (result)
     {
         return result.value().get();
@@ -535,11 +633,8 @@ const Polygons& TreeModelVolumes::getWallRestriction(coord_t radius, LayerIndex
     radius = ceilRadius(radius);
     const RadiusLayerPair key{ radius, layer_idx };
 
-    std::unordered_map<RadiusLayerPair, Polygons>* cache_ptr = min_xy_dist ? &wall_restrictions_cache_min_ : &wall_restrictions_cache_;
-    {
-        std::lock_guard<std::mutex> critical_section(min_xy_dist ? *critical_wall_restrictions_cache_min_ : *critical_wall_restrictions_cache_);
-        result = getArea(*cache_ptr, key);
-    }
+    const RadiusLayerPolygonCache& cache = min_xy_dist ? *wall_restrictions_cache_min_ : *wall_restrictions_cache_;
+    result = cache.get(key.first, key.second);
     if (result)
     {
         return result.value().get();
@@ -563,6 +658,99 @@ coord_t TreeModelVolumes::getRadiusNextCeil(coord_t radius, bool min_xy_dist) co
     return ceilRadius(radius, min_xy_dist) - (min_xy_dist ? 0 : current_min_xy_dist_delta_);
 }
 
+void TreeModelVolumes::logCacheStatistics() const
+{
+    for (const RadiusLayerPolygonCache* cache : getCaches())
+    {
+        cache->logStatistics();
+    }
+}
+
+std::vector<RadiusLayerPolygonCache*> TreeModelVolumes::getCaches() const
+{
+    return { collision_cache_.get(),
+             collision_cache_holefree_.get(),
+             accumulated_placeables_cache_radius_0_.get(),
+             avoidance_cache_collision_.get(),
+             avoidance_cache_.get(),
+             avoidance_cache_slow_.get(),
+             avoidance_cache_to_model_.get(),
+             avoidance_cache_to_model_slow_.get(),
+             placeable_areas_cache_.get(),
+             avoidance_cache_hole_.get(),
+             avoidance_cache_hole_to_model_.get(),
+             wall_restrictions_cache_.get(),
+             wall_restrictions_cache_min_.get() };
+}
+
+std::string TreeModelVolumes::getPrecalculationKey(const TreeSupportSettings& config, const LayerIndex max_layer) const
+{
+    // Serialize the geometry of every layer in parallel, then append them in order.
+    std::vector<std::string> layer_keys(anti_overhang_.size());
+    cura::parallel_for<coord_t>(
+        0,
+        LayerIndex(anti_overhang_.size()),
+        [&](const LayerIndex layer_idx)
+        {
+            std::string& layer_key = layer_keys[layer_idx];
+            for (const auto& layer_outline : layer_outlines_)
+            {
+                appendPolygonsToKey(layer_key, layer_outline.second[layer_idx]);
+            }
+            appendPolygonsToKey(layer_key, anti_overhang_[layer_idx]);
+        });
+
+    std::string key;
+    appendStringToKey(key, CURA_ENGINE_VERSION);
+    appendValueToKey<uint32_t>(key, TreeModelVolumesDiskCache::FORMAT_VERSION);
+    appendValueToKey<uint64_t>(key, layer_outlines_.size());
+    appendValueToKey<uint64_t>(key, layer_keys.size());
+    for (const std::string& layer_key : layer_keys)
+    {
+        key += layer_key;
+    }
+    appendPolygonsToKey(key, machine_border_);
+    appendPolygonsToKey(key, machine_area_);
+
+    for (const auto& layer_outline : layer_outlines_)
+    {
+        for (const std::string_view setting : PRECALCULATION_SETTINGS)
+        {
+            appendStringToKey(key, layer_outline.first.get<std::string>(std::string(setting)));
+        }
+    }
+
+    // The values derived from those settings, including those that depend on other meshes, like the minimum xy distance.
+    for (const coord_t value : { max_move_,
+                                 max_move_slow_,
+                                 min_offset_per_step_,
+                                 current_min_xy_dist_,
+                                 current_min_xy_dist_delta_,
+                                 coord_t(max_layer_idx_without_blocker_),
+                                 coord_t(support_rests_on_model_),
+                                 increase_until_radius_,
+                                 radius_0_,
+                                 coord_t(support_rest_preference_),
+                                 coord_t(current_outline_idx_),
+                                 coord_t(max_layer),
+                                 config.branch_radius,
+                                 config.min_radius,
+                                 config.max_radius,
+                                 coord_t(config.tip_layers),
+                                 config.layer_start_bp_radius,
+                                 config.increase_radius_until_radius,
+                                 config.xy_distance,
+                                 config.xy_min_distance,
+                                 coord_t(config.support_overrides),
+                                 coord_t(config.support_rest_preference) })
+    {
+        appendValueToKey<int64_t>(key, value);
+    }
+    appendValueToKey(key, config.diameter_angle_scale_factor);
+    appendValueToKey(key, config.diameter_scale_bp_radius);
+    return key;
+}
+
 bool TreeModelVolumes::checkSettingsEquality(const Settings& me, const Settings& other) const
 {
     return TreeSupportSettings(me) == TreeSupportSettings(other);
@@ -592,25 +780,6 @@ Polygons TreeModelVolumes::extractOutlineFromMesh(const SliceMeshStorage& mesh,
     return Simplify(maximum_resolution, maximum_deviation, maximum_area_deviation).polygon(total);
 }
 
-LayerIndex TreeModelVolumes::getMaxCalculatedLayer(coord_t radius, const std::unordered_map<RadiusLayerPair, Polygons>& map) const
-{
-    LayerIndex max_layer = -1;
-
-    // the placeable on model areas do not exist on layer 0, as there can not be model below it. As such it may be possible that layer 1 is available, but layer 0 does not exist.
-    const RadiusLayerPair key_layer_1(radius, 1);
-    if (getArea(map, key_layer_1))
-    {
-        max_layer = 1;
-    }
-
-    while (map.count(RadiusLayerPair(radius, max_layer + 1)))
-    {
-        max_layer++;
-    }
-
-    return max_layer;
-}
-
 void TreeModelVolumes::calculateCollision(const std::deque<RadiusLayerPair>& keys)
 {
     cura::parallel_for<size_t>(
@@ -639,11 +808,7 @@ void TreeModelVolumes::calculateCollision(const std::deque<RadiusLayerPair>& key
                 // be added at request time. Avoiding this would require saving each collision for each outline_idx separately,
                 //   and later for each avoidance... But avoidance calculation has to be for the whole scene and can NOT be done for each outline_idx separately and combined later.
                 // So avoiding this inaccuracy seems infeasible as it would require 2x the avoidance calculations => 0.5x the performance.
-                coord_t min_layer_bottom;
-                {
-                    std::lock_guard<std::mutex> critical_section(*critical_collision_cache_);
-                    min_layer_bottom = getMaxCalculatedLayer(radius, collision_cache_) - z_distance_bottom_layers;
-                }
+                coord_t min_layer_bottom = collision_cache_->getMaxCalculatedLayer(radius) - z_distance_bottom_layers;
 
                 if (min_layer_bottom < 0)
                 {
@@ -754,16 +919,10 @@ void TreeModelVolumes::calculateCollision(const std::deque<RadiusLayerPair>& key
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_collision_cache_);
-                collision_cache_.insert(data_outer.begin(), data_outer.end());
-            }
+            collision_cache_->insert(data_outer);
             if (radius == 0)
             {
-                {
-                    std::lock_guard<std::mutex> critical_section(*critical_placeable_areas_cache_);
-                    placeable_areas_cache_.insert(data_placeable_outer.begin(), data_placeable_outer.end());
-                }
+                placeable_areas_cache_->insert(data_placeable_outer);
             }
         });
 }
@@ -793,10 +952,7 @@ void TreeModelVolumes::calculateCollisionHolefree(const std::deque<RadiusLayerPa
                 data[RadiusLayerPair(radius, layer_idx)] = col;
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_collision_cache_holefree_);
-                collision_cache_holefree_.insert(data.begin(), data.end());
-            }
+            collision_cache_holefree_->insert(data);
         });
 }
 
@@ -805,14 +961,11 @@ void TreeModelVolumes::calculateAccumulatedPlaceable0(const LayerIndex max_layer
     LayerIndex start_layer = -1;
 
     // the placeable on model areas do not exist on layer 0, as there can not be model below it. As such it may be possible that layer 1 is available, but layer 0 does not exist.
+    while (accumulated_placeables_cache_radius_0_->contains(0, start_layer + 1))
     {
-        std::lock_guard<std::mutex> critical_section(*critical_accumulated_placeables_cache_radius_0_);
-        while (accumulated_placeables_cache_radius_0_.count(start_layer + 1))
-        {
-            start_layer++;
-        }
-        start_layer = std::max(LayerIndex{ start_layer + 1 }, LayerIndex{ 1 });
+        start_layer++;
     }
+    start_layer = std::max(LayerIndex{ start_layer + 1 }, LayerIndex{ 1 });
     if (start_layer > max_layer)
     {
         spdlog::debug("Requested calculation for value already calculated ?");
@@ -828,7 +981,6 @@ void TreeModelVolumes::calculateAccumulatedPlaceable0(const LayerIndex max_layer
     for (LayerIndex layer = start_layer; layer <= max_layer; layer++)
     {
         accumulated_placeable_0 = accumulated_placeable_0.unionPolygons(getPlaceableAreas(0, layer).offset(FUDGE_LENGTH)).difference(anti_overhang_[layer]);
-        std::lock_guard<std::mutex> critical_section(*critical_accumulated_placeables_cache_radius_0_);
         accumulated_placeable_0 = simplifier_.polygon(accumulated_placeable_0);
         data[layer] = std::pair(layer, accumulated_placeable_0);
     }
@@ -839,9 +991,9 @@ void TreeModelVolumes::calculateAccumulatedPlaceable0(const LayerIndex max_layer
         {
             data[layer_idx].second = data[layer_idx].second.offset(-(current_min_xy_dist_ + current_min_xy_dist_delta_));
         });
+    for (auto& [layer_idx, accumulated_placeable] : data)
     {
-        std::lock_guard<std::mutex> critical_section(*critical_accumulated_placeables_cache_radius_0_);
-        accumulated_placeables_cache_radius_0_.insert(data.begin(), data.end());
+        accumulated_placeables_cache_radius_0_->insert(0, layer_idx, std::move(accumulated_placeable)); // Unused entries have layer -1 and are ignored.
     }
 }
 
@@ -856,11 +1008,7 @@ void TreeModelVolumes::calculateCollisionAvoidance(const std::deque<RadiusLayerP
             const coord_t radius = keys[key_idx].first;
             const LayerIndex max_required_layer = keys[key_idx].second;
             const coord_t max_step_move = std::max(1.9 * radius, current_min_xy_dist_ * 1.9);
-            LayerIndex start_layer = 0;
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_avoidance_cache_collision_);
-                start_layer = 1 + std::max(getMaxCalculatedLayer(radius, avoidance_cache_collision_), max_layer_idx_without_blocker_);
-            }
+            LayerIndex start_layer = 1 + std::max(avoidance_cache_collision_->getMaxCalculatedLayer(radius), max_layer_idx_without_blocker_);
 
             if (start_layer > max_required_layer)
             {
@@ -889,10 +1037,7 @@ void TreeModelVolumes::calculateCollisionAvoidance(const std::deque<RadiusLayerP
                 data[layer] = std::pair<RadiusLayerPair, Polygons>(key, latest_avoidance);
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_avoidance_cache_collision_);
-                avoidance_cache_collision_.insert(data.begin(), data.end());
-            }
+            avoidance_cache_collision_->insert(data);
         });
 }
 
@@ -945,11 +1090,8 @@ void TreeModelVolumes::calculateAvoidance(const std::deque<RadiusLayerPair>& key
             const coord_t max_step_move = std::max(1.9 * radius, current_min_xy_dist_ * 1.9);
             RadiusLayerPair key(radius, 0);
             Polygons latest_avoidance;
-            LayerIndex start_layer;
-            {
-                std::lock_guard<std::mutex> critical_section(*(slow ? critical_avoidance_cache_slow_ : holefree ? critical_avoidance_cache_holefree_ : critical_avoidance_cache_));
-                start_layer = 1 + getMaxCalculatedLayer(radius, slow ? avoidance_cache_slow_ : holefree ? avoidance_cache_hole_ : avoidance_cache_);
-            }
+            RadiusLayerPolygonCache& cache = slow ? *avoidance_cache_slow_ : holefree ? *avoidance_cache_hole_ : *avoidance_cache_;
+            LayerIndex start_layer = 1 + cache.getMaxCalculatedLayer(radius);
             if (start_layer > max_required_layer)
             {
                 spdlog::debug("Requested calculation for value already calculated ?");
@@ -995,10 +1137,7 @@ void TreeModelVolumes::calculateAvoidance(const std::deque<RadiusLayerPair>& key
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*(slow ? critical_avoidance_cache_slow_ : holefree ? critical_avoidance_cache_holefree_ : critical_avoidance_cache_));
-                (slow ? avoidance_cache_slow_ : holefree ? avoidance_cache_hole_ : avoidance_cache_).insert(data.begin(), data.end());
-            }
+            cache.insert(data);
         });
 }
 
@@ -1016,11 +1155,7 @@ void TreeModelVolumes::calculatePlaceables(const std::deque<RadiusLayerPair>& ke
             std::vector<std::pair<RadiusLayerPair, Polygons>> data(max_required_layer + 1, std::pair<RadiusLayerPair, Polygons>(RadiusLayerPair(radius, -1), Polygons()));
             RadiusLayerPair key(radius, 0);
 
-            LayerIndex start_layer;
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_placeable_areas_cache_);
-                start_layer = 1 + getMaxCalculatedLayer(radius, placeable_areas_cache_);
-            }
+            LayerIndex start_layer = 1 + placeable_areas_cache_->getMaxCalculatedLayer(radius);
             if (start_layer > max_required_layer)
             {
                 spdlog::debug("Requested calculation for value already calculated ?");
@@ -1052,10 +1187,7 @@ void TreeModelVolumes::calculatePlaceables(const std::deque<RadiusLayerPair>& ke
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_placeable_areas_cache_);
-                placeable_areas_cache_.insert(data.begin(), data.end());
-            }
+            placeable_areas_cache_->insert(data);
         });
 }
 
@@ -1091,15 +1223,8 @@ void TreeModelVolumes::calculateAvoidanceToModel(const std::deque<RadiusLayerPai
             std::vector<std::pair<RadiusLayerPair, Polygons>> data(max_required_layer + 1, std::pair<RadiusLayerPair, Polygons>(RadiusLayerPair(radius, -1), Polygons()));
             RadiusLayerPair key(radius, 0);
 
-            LayerIndex start_layer;
-
-            {
-                std::lock_guard<std::mutex> critical_section(
-                    *(slow       ? critical_avoidance_cache_to_model_slow_
-                      : holefree ? critical_avoidance_cache_holefree_to_model_
-                                 : critical_avoidance_cache_to_model_));
-                start_layer = 1 + getMaxCalculatedLayer(radius, slow ? avoidance_cache_to_model_slow_ : holefree ? avoidance_cache_hole_to_model_ : avoidance_cache_to_model_);
-            }
+            RadiusLayerPolygonCache& cache = slow ? *avoidance_cache_to_model_slow_ : holefree ? *avoidance_cache_hole_to_model_ : *avoidance_cache_to_model_;
+            LayerIndex start_layer = 1 + cache.getMaxCalculatedLayer(radius);
             if (start_layer > max_required_layer)
             {
                 spdlog::debug("Requested calculation for value already calculated ?");
@@ -1144,13 +1269,7 @@ void TreeModelVolumes::calculateAvoidanceToModel(const std::deque<RadiusLayerPai
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(
-                    *(slow       ? critical_avoidance_cache_to_model_slow_
-                      : holefree ? critical_avoidance_cache_holefree_to_model_
-                                 : critical_avoidance_cache_to_model_));
-                (slow ? avoidance_cache_to_model_slow_ : holefree ? avoidance_cache_hole_to_model_ : avoidance_cache_to_model_).insert(data.begin(), data.end());
-            }
+            cache.insert(data);
         });
 }
 
@@ -1201,15 +1320,10 @@ void TreeModelVolumes::calculateWallRestrictions(const std::deque<RadiusLayerPai
         {
             const coord_t radius = keys[key_idx].first;
             RadiusLayerPair key(radius, 0);
-            coord_t min_layer_bottom;
+            coord_t min_layer_bottom = wall_restrictions_cache_->getMaxCalculatedLayer(radius);
             std::unordered_map<RadiusLayerPair, Polygons> data;
             std::unordered_map<RadiusLayerPair, Polygons> data_min;
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_wall_restrictions_cache_);
-                min_layer_bottom = getMaxCalculatedLayer(radius, wall_restrictions_cache_);
-            }
-
             if (min_layer_bottom < 1)
             {
                 min_layer_bottom = 1;
@@ -1228,15 +1342,8 @@ void TreeModelVolumes::calculateWallRestrictions(const std::deque<RadiusLayerPai
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_wall_restrictions_cache_);
-                wall_restrictions_cache_.insert(data.begin(), data.end());
-            }
-
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_wall_restrictions_cache_min_);
-                wall_restrictions_cache_min_.insert(data_min.begin(), data_min.end());
-            }
+            wall_restrictions_cache_->insert(data);
+            wall_restrictions_cache_min_->insert(data_min);
         });
 }
 
@@ -1270,20 +1377,6 @@ coord_t TreeModelVolumes::ceilRadius(coord_t radius) const
     return exponential_result;
 }
 
-template<typename KEY>
-const std::optional<std::reference_wrapper<const Polygons>> TreeModelVolumes::getArea(const std::unordered_map<KEY, Polygons>& cache, const KEY key) const
-{
-    const auto it = cache.find(key);
-    if (it != cache.end())
-    {
-        return std::optional<std::reference_wrapper<const Polygons>>{ it->second };
-    }
-    else
-    {
-        return std::optional<std::reference_wrapper<const Polygons>>();
-    }
-}
-
 Polygons TreeModelVolumes::calculateMachineBorderCollision(const Polygons&& machine_border)
 {
     Polygons machine_volume_border = machine_border.offset(MM2INT(1000.0)); // Put a border of 1 meter around the print volume so that we don't collide.
@@ -0,0 +1,312 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "TreeModelVolumesDiskCache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+
+#include <fmt/format.h>
+#include <spdlog/details/os.h>
+#include <spdlog/spdlog.h>
+
+#include "utils/RadiusLayerPolygonCache.h"
+#include "utils/polygon.h"
+
+namespace cura
+{
+
+namespace
+{
+constexpr std::array<char, 8> MAGIC = { 'C', 'E', 'T', 'M', 'V', 'C', 'H', 'E' };
+constexpr uintmax_t DEFAULT_MAX_SIZE_MB = 1024;
+constexpr std::string_view FILE_EXTENSION = ".tmvcache";
+
+template<typename T>
+void writeValue(std::ostream& out, const T value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::istream& in, T& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return in.good();
+}
+
+void writePolygons(std::ostream& out, const Polygons& polygons)
+{
+    writeValue<uint64_t>(out, polygons.size());
+    for (ConstPolygonRef polygon : polygons)
+    {
+        writeValue<uint64_t>(out, polygon.size());
+        for (const Point2LL& point : polygon)
+        {
+            writeValue<int64_t>(out, point.X);
+            writeValue<int64_t>(out, point.Y);
+        }
+    }
+}
+
+bool readPolygons(std::istream& in, Polygons& polygons)
+{
+    uint64_t polygon_count;
+    if (! readValue(in, polygon_count))
+    {
+        return false;
+    }
+    for (uint64_t polygon_idx = 0; polygon_idx < polygon_count; ++polygon_idx)
+    {
+        uint64_t point_count;
+        if (! readValue(in, point_count))
+        {
+            return false;
+        }
+        PolygonRef polygon = polygons.newPoly();
+        for (uint64_t point_idx = 0; point_idx < point_count; ++point_idx)
+        {
+            int64_t x;
+            int64_t y;
+            if (! readValue(in, x) || ! readValue(in, y))
+            {
+                return false;
+            }
+            polygon.emplace_back(x, y);
+        }
+    }
+    return true;
+}
+} // namespace
+
+std::optional<TreeModelVolumesDiskCache> TreeModelVolumesDiskCache::fromEnvironment()
+{
+    const std::string directory = spdlog::details::os::getenv("CURAENGINE_TREE_SUPPORT_CACHE");
+    if (directory.empty())
+    {
+        return std::nullopt;
+    }
+
+    uintmax_t max_size_mb = DEFAULT_MAX_SIZE_MB;
+    if (const std::string max_size_str = spdlog::details::os::getenv("CURAENGINE_TREE_SUPPORT_CACHE_MAX_MB"); ! max_size_str.empty())
+    {
+        try
+        {
+            max_size_mb = std::stoull(max_size_str);
+        }
+        catch (const std::exception&)
+        {
+            spdlog::warn("Invalid tree support cache size limit '{}', using {} MB instead.", max_size_str, DEFAULT_MAX_SIZE_MB);
+        }
+    }
+    return TreeModelVolumesDiskCache(directory, max_size_mb * 1024 * 1024);
+}
+
+TreeModelVolumesDiskCache::TreeModelVolumesDiskCache(std::filesystem::path directory, const uintmax_t max_size)
+    : directory_{ std::move(directory) }
+    , max_size_{ max_size }
+{
+}
+
+bool TreeModelVolumesDiskCache::load(const std::string& key, const std::vector<RadiusLayerPolygonCache*>& caches) const
+{
+    const std::filesystem::path path = getPath(key);
+    std::error_code error;
+    if (! std::filesystem::exists(path, error))
+    {
+        spdlog::debug("No tree support cache file {}.", path.string());
+        return false;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    std::array<char, MAGIC.size()> magic{};
+    uint32_t version = 0;
+    uint64_t key_size = 0;
+    in.read(magic.data(), magic.size());
+    if (! in.good() || magic != MAGIC || ! readValue(in, version) || version != FORMAT_VERSION || ! readValue(in, key_size))
+    {
+        spdlog::warn("Tree support cache file {} is outdated or corrupt, removing it.", path.string());
+        in.close();
+        std::filesystem::remove(path, error);
+        return false;
+    }
+
+    // The name of the file is only a hash of the key, so compare the whole key.
+    std::string stored_key(std::min<uint64_t>(key_size, key.size()), '\0');
+    if (key_size != key.size() || ! in.read(stored_key.data(), stored_key.size()) || stored_key != key)
+    {
+        spdlog::debug("Tree support cache file {} was stored for other inputs.", path.string());
+        return false;
+    }
+
+    uint64_t cache_count = 0;
+    if (! readValue(in, cache_count) || cache_count != caches.size())
+    {
+        spdlog::warn("Tree support cache file {} is corrupt, removing it.", path.string());
+        in.close();
+        std::filesystem::remove(path, error);
+        return false;
+    }
+
+    // Read everything before touching the caches, so they stay empty if the file turns out to be truncated.
+    using Entry = std::pair<RadiusLayerPolygonCache::RadiusLayerPair, Polygons>;
+    std::vector<std::vector<Entry>> data(caches.size());
+    for (std::vector<Entry>& cache_data : data)
+    {
+        uint64_t entry_count;
+        if (! readValue(in, entry_count))
+        {
+            spdlog::warn("Tree support cache file {} is truncated, removing it.", path.string());
+            in.close();
+            std::filesystem::remove(path, error);
+            return false;
+        }
+        cache_data.reserve(entry_count);
+        for (uint64_t entry_idx = 0; entry_idx < entry_count; ++entry_idx)
+        {
+            int64_t radius;
+            int64_t layer_idx;
+            Polygons area;
+            if (! readValue(in, radius) || ! readValue(in, layer_idx) || ! readPolygons(in, area))
+            {
+                spdlog::warn("Tree support cache file {} is truncated, removing it.", path.string());
+                in.close();
+                std::filesystem::remove(path, error);
+                return false;
+            }
+            cache_data.emplace_back(RadiusLayerPolygonCache::RadiusLayerPair(radius, layer_idx), std::move(area));
+        }
+    }
+
+    for (size_t cache_idx = 0; cache_idx < caches.size(); ++cache_idx)
+    {
+        caches[cache_idx]->insert(data[cache_idx]);
+    }
+
+    // Mark the file as recently used, so it is the last to be removed when the size limit is reached.
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+    return true;
+}
+
+void TreeModelVolumesDiskCache::store(const std::string& key, const std::vector<RadiusLayerPolygonCache*>& caches) const
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    if (error)
+    {
+        spdlog::warn("Could not create tree support cache directory {}: {}", directory_.string(), error.message());
+        return;
+    }
+
+    // Write to a temporary file first, so a concurrently running engine never reads a partially written file.
+    const std::filesystem::path path = getPath(key);
+    std::filesystem::path temporary_path = path;
+    temporary_path += fmt::format(".{}.tmp", spdlog::details::os::pid());
+    {
+        std::ofstream out(temporary_path, std::ios::binary | std::ios::trunc);
+        out.write(MAGIC.data(), MAGIC.size());
+        writeValue<uint32_t>(out, FORMAT_VERSION);
+        writeValue<uint64_t>(out, key.size());
+        out.write(key.data(), key.size());
+        writeValue<uint64_t>(out, caches.size());
+        for (const RadiusLayerPolygonCache* cache : caches)
+        {
+            uint64_t entry_count = 0;
+            cache->visit(
+                [&entry_count](const coord_t, const LayerIndex, const Polygons&)
+                {
+                    entry_count++;
+                });
+            writeValue<uint64_t>(out, entry_count);
+            cache->visit(
+                [&out](const coord_t radius, const LayerIndex layer_idx, const Polygons& area)
+                {
+                    writeValue<int64_t>(out, radius);
+                    writeValue<int64_t>(out, layer_idx.value);
+                    writePolygons(out, area);
+                });
+        }
+        if (! out.good())
+        {
+            spdlog::warn("Could not write tree support cache file {}.", temporary_path.string());
+            out.close();
+            std::filesystem::remove(temporary_path, error);
+            return;
+        }
+    }
+
+    if (std::filesystem::file_size(temporary_path, error) > max_size_)
+    {
+        spdlog::info("Tree support cache file for this slice exceeds the size limit of the cache, not storing it.");
+        std::filesystem::remove(temporary_path, error);
+        return;
+    }
+    std::filesystem::rename(temporary_path, path, error);
+    if (error)
+    {
+        spdlog::warn("Could not move tree support cache file to {}: {}", path.string(), error.message());
+        std::filesystem::remove(temporary_path, error);
+        return;
+    }
+    spdlog::debug("Stored tree support cache file {}.", path.string());
+    enforceSizeLimit();
+}
+
+std::filesystem::path TreeModelVolumesDiskCache::getPath(const std::string& key) const
+{
+    return directory_ / fmt::format("{:016x}{}", static_cast<uint64_t>(std::hash<std::string>{}(key)), FILE_EXTENSION);
+}
+
+void TreeModelVolumesDiskCache::enforceSizeLimit() const
+{
+    struct CacheFile
+    {
+        std::filesystem::path path;
+        uintmax_t size;
+        std::filesystem::file_time_type last_used;
+    };
+    std::vector<CacheFile> files;
+    uintmax_t total_size = 0;
+
+    std::error_code error;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory_, error))
+    {
+        if (! entry.is_regular_file(error) || entry.path().extension() != FILE_EXTENSION)
+        {
+            continue;
+        }
+        CacheFile file{ entry.path(), entry.file_size(error), entry.last_write_time(error) };
+        if (error)
+        {
+            continue; // Probably removed by another engine in the meantime.
+        }
+        total_size += file.size;
+        files.push_back(std::move(file));
+    }
+
+    std::sort(
+        files.begin(),
+        files.end(),
+        [](const CacheFile& a, const CacheFile& b)
+        {
+            return a.last_used < b.last_used;
+        });
+    for (const CacheFile& file : files)
+    {
+        if (total_size <= max_size_)
+        {
+            break;
+        }
+        spdlog::debug("Removing least recently used tree support cache file {}.", file.path.string());
+        if (std::filesystem::remove(file.path, error))
+        {
+            total_size -= file.size;
+        }
+    }
+}
+
+} // namespace cura
@@ -27,6 +27,8 @@
 #include "support.h" //For precomputeCrossInfillTree
 #include "utils/Simplify.h"
 #include "utils/ThreadPool.h"
+#include "utils/ClipperStatistics.h"
+#include "utils/Trace.h"
 #include "utils/algorithm.h"
 #include "utils/math.h" //For round_up_divide and PI.
 #include "utils/polygonUtils.h" //For moveInside.
@@ -103,6 +105,7 @@ TreeSupport::TreeSupport(const SliceDataStorage& storage)
 
 void TreeSupport::generateSupportAreas(SliceDataStorage& storage)
 {
+    const ClipperStage clipper_stage("tree support");
     if (grouped_meshes.empty())
     {
         return;
@@ -159,26 +162,41 @@ void TreeSupport::generateSupportAreas(SliceDataStorage& storage)
             exclude);
 
         // ### Precalculate avoidances, collision etc.
-        precalculate(storage, processing.second);
+        {
+            const TraceZone trace_zone("TreeSupport::precalculate");
+            precalculate(storage, processing.second);
+        }
         const auto t_precalc = std::chrono::high_resolution_clock::now();
 
         // ### Place tips of the support tree
-        for (size_t mesh_idx : processing.second)
         {
-            generateInitialAreas(*storage.meshes[mesh_idx], move_bounds, storage);
+            const TraceZone trace_zone("TreeSupport::generateInitialAreas");
+            for (size_t mesh_idx : processing.second)
+            {
+                generateInitialAreas(*storage.meshes[mesh_idx], move_bounds, storage);
+            }
         }
         const auto t_gen = std::chrono::high_resolution_clock::now();
 
         // ### Propagate the influence areas downwards.
-        createLayerPathing(move_bounds);
+        {
+            const TraceZone trace_zone("TreeSupport::createLayerPathing");
+            createLayerPathing(move_bounds);
+        }
         const auto t_path = std::chrono::high_resolution_clock::now();
 
         // ### Set a point in each influence area
-        createNodesFromArea(move_bounds);
+        {
+            const TraceZone trace_zone("TreeSupport::createNodesFromArea");
+            createNodesFromArea(move_bounds);
+        }
         const auto t_place = std::chrono::high_resolution_clock::now();
 
         // ### draw these points as circles
-        drawAreas(move_bounds, storage);
+        {
+            const TraceZone trace_zone("TreeSupport::drawAreas");
+            drawAreas(move_bounds, storage);
+        }
 
         const auto t_draw = std::chrono::high_resolution_clock::now();
         const auto dur_pre_gen = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_precalc - t_start).count();
@@ -197,6 +215,7 @@ void TreeSupport::generateSupportAreas(SliceDataStorage& storage)
             dur_path,
             dur_place,
             dur_draw);
+        volumes_.logCacheStatistics();
 
 
         for (auto& layer : move_bounds)
@@ -1752,12 +1771,12 @@ void TreeSupport::generateBranchAreas(
                     // if larger area did not fix the problem, all parts off the nozzle path that do not contain the center point are removed, hoping for the best
                     if (nozzle_path.splitIntoParts(false).size() > 1)
                     {
-                        Polygons polygons_with_correct_center;
+                        std::vector<Polygons> parts_with_correct_center;
                         for (PolygonsPart part : nozzle_path.splitIntoParts(false))
                         {
                             if (part.inside(elem->result_on_layer_, true))
                             {
-                                polygons_with_correct_center = polygons_with_correct_center.unionPolygons(part);
+                                parts_with_correct_center.push_back(std::move(part));
                             }
                             else
                             {
@@ -1766,10 +1785,11 @@ void TreeSupport::generateBranchAreas(
                                 PolygonUtils::moveInside(part, from, 0);
                                 if (vSize2(elem->result_on_layer_ - from) < (FUDGE_LENGTH * FUDGE_LENGTH) / 4)
                                 {
-                                    polygons_with_correct_center = polygons_with_correct_center.unionPolygons(part);
+                                    parts_with_correct_center.push_back(std::move(part));
                                 }
                             }
                         }
+                        const Polygons polygons_with_correct_center = Polygons::unionAll(parts_with_correct_center);
                         // Increase the area again, to ensure the nozzle path when calculated later is very similar to the one assumed above.
                         linear_inserts[idx] = polygons_with_correct_center.offset(config.support_line_width / 2).unionPolygons();
                         linear_inserts[idx]
@@ -1994,6 +2014,7 @@ void TreeSupport::filterFloatingLines(std::vector<Polygons>& support_layer_stora
     const auto t_union = std::chrono::high_resolution_clock::now();
 
     std::vector<std::vector<Polygons>> holeparts(support_layer_storage.size());
+    std::vector<std::vector<AABB>> hole_aabbs(support_layer_storage.size());
     // Split all holes into parts
     cura::parallel_for<coord_t>(
         0,
@@ -2002,6 +2023,7 @@ void TreeSupport::filterFloatingLines(std::vector<Polygons>& support_layer_stora
         {
             for (Polygons hole : support_holes[layer_idx].splitIntoParts())
             {
+                hole_aabbs[layer_idx].emplace_back(hole);
                 holeparts[layer_idx].emplace_back(hole);
             }
         });
@@ -2033,7 +2055,7 @@ void TreeSupport::filterFloatingLines(std::vector<Polygons>& support_layer_stora
 
             for (auto [idx, hole] : holeparts[layer_idx] | ranges::views::enumerate)
             {
-                AABB hole_aabb = AABB(hole);
+                AABB hole_aabb = hole_aabbs[layer_idx][idx];
                 hole_aabb.expand(EPSILON);
                 if (! hole.intersection(PolygonUtils::clipPolygonWithAABB(outer_walls, hole_aabb)).empty())
                 {
@@ -2043,7 +2065,7 @@ void TreeSupport::filterFloatingLines(std::vector<Polygons>& support_layer_stora
                 {
                     for (auto [idx2, hole2] : holeparts[layer_idx - 1] | ranges::views::enumerate)
                     {
-                        if (hole_aabb.hit(AABB(hole2))
+                        if (hole_aabb.hit(hole_aabbs[layer_idx - 1][idx2])
                             && ! hole.intersection(hole2).empty()) // TODO should technically be outline: Check if this is fine either way as it would save an offset
                         {
                             hole_rest_map[layer_idx][idx].emplace_back(idx2);
@@ -20,13 +20,16 @@
 #include "FffProcessor.h" //To start a slice and get time estimates.
 #include "Slice.h"
 #include "utils/Matrix4x3D.h" //For the mesh_rotation_matrix setting.
+#include "utils/ClipperStatistics.h" //To write the polygon operation statistics after slicing.
+#include "utils/Trace.h" //To write the trace after slicing.
 
 namespace cura
 {
 
-CommandLine::CommandLine(const std::vector<std::string>& arguments)
+CommandLine::CommandLine(const std::vector<std::string>& arguments, DefinitionCache* definition_cache)
     : arguments_(arguments)
     , last_shown_progress_(0)
+    , definition_cache_(definition_cache)
 {
 }
 
@@ -161,6 +164,26 @@ void CommandLine::sliceNext()
                         exit(1);
                     }
                 }
+                else if (argument == "--trace")
+                {
+                    argument_index++;
+                    if (argument_index >= arguments_.size())
+                    {
+                        spdlog::error("Missing output file with --trace argument.");
+                        exit(1);
+                    }
+                    Trace::enable(arguments_[argument_index]);
+                }
+                else if (argument == "--clipper-stats")
+                {
+                    argument_index++;
+                    if (argument_index >= arguments_.size())
+                    {
+                        spdlog::error("Missing output file with --clipper-stats argument.");
+                        exit(1);
+                    }
+                    ClipperStatistics::enable(arguments_[argument_index]);
+                }
                 else if (argument.find("--force-read-parent") == 0 || argument.find("--force_read_parent") == 0)
                 {
                     spdlog::info("From this point on, force the parser to read values of non-leaf settings, instead of skipping over them as is proper.");
@@ -358,10 +381,37 @@ void CommandLine::sliceNext()
 
     // Finalize the processor. This adds the end g-code and reports statistics.
     FffProcessor::getInstance()->finalize();
+
+    if (Trace::isEnabled())
+    {
+        Trace::write();
+        Trace::disable(); // A next slice in the same process only records if it asks for it too.
+    }
+    if (ClipperStatistics::isEnabled())
+    {
+        ClipperStatistics::write();
+        ClipperStatistics::disable(); // A next slice in the same process only counts if it asks for it too.
+    }
 }
 
 int CommandLine::loadJSON(const std::string& json_filename, Settings& settings, bool force_read_parent, bool force_read_nondefault)
 {
+    std::error_code error;
+    const std::filesystem::file_time_type last_modified = std::filesystem::last_write_time(json_filename, error);
+
+    std::unordered_set<std::string> search_directories = defaultSearchDirectories(); // For finding the inheriting JSON files.
+    std::string directory = std::filesystem::path(json_filename).parent_path().string();
+    search_directories.insert(directory);
+
+    if (definition_cache_ && ! error)
+    {
+        const auto cached = definition_cache_->definitions.find(json_filename);
+        if (cached != definition_cache_->definitions.end() && cached->second.last_modified == last_modified)
+        {
+            return loadJSON(cached->second.document, search_directories, settings, force_read_parent, force_read_nondefault);
+        }
+    }
+
     FILE* file = fopen(json_filename.c_str(), "rb");
     if (! file)
     {
@@ -380,10 +430,13 @@ int CommandLine::loadJSON(const std::string& json_filename, Settings& settings,
         return 2;
     }
 
-    std::unordered_set<std::string> search_directories = defaultSearchDirectories(); // For finding the inheriting JSON files.
-    std::string directory = std::filesystem::path(json_filename).parent_path().string();
-    search_directories.insert(directory);
-
+    if (definition_cache_ && ! error)
+    {
+        DefinitionCache::Definition& cached = definition_cache_->definitions[json_filename];
+        cached.last_modified = last_modified;
+        cached.document = std::move(json_document);
+        return loadJSON(cached.document, search_directories, settings, force_read_parent, force_read_nondefault);
+    }
     return loadJSON(json_document, search_directories, settings, force_read_parent, force_read_nondefault);
 }
 
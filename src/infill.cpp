@@ -4,6 +4,7 @@
 #include "infill.h"
 
 #include <algorithm> //For std::sort.
+#include <cmath>
 #include <functional>
 #include <unordered_set>
 
@@ -13,6 +14,7 @@
 #include "WallToolPaths.h"
 #include "infill/GyroidInfill.h"
 #include "infill/ImageBasedDensityProvider.h"
+#include "infill/InfillCache.h"
 #include "infill/LightningGenerator.h"
 #include "infill/NoZigZagConnectorProcessor.h"
 #include "infill/SierpinskiFill.h"
@@ -97,6 +99,21 @@ void Infill::generate(
         return;
     }
 
+    // The result can only be reused if it's the whole output, since connecting the polygons involves what was in the output before.
+    InfillCache& cache = InfillCache::getInstance();
+    const bool use_cache = cache.isEnabled() && isCacheable() && toolpaths.empty() && result_polygons.empty() && result_lines.empty();
+    const std::string cache_key = use_cache ? getCacheKey(settings, section_type, prevent_small_exposed_to_air) : std::string(); // Before the outer contour gets offset below.
+    if (use_cache)
+    {
+        if (const std::shared_ptr<const InfillCache::Result> cached = cache.find(cache_key))
+        {
+            toolpaths = cached->toolpaths;
+            result_polygons = cached->result_polygons;
+            result_lines = cached->result_lines;
+            return;
+        }
+    }
+
     inner_contour_ = generateWallToolPaths(toolpaths, outer_contour_, wall_line_count_, infill_line_width_, infill_overlap_, settings, layer_idx, section_type);
     scripta::log("infill_inner_contour_0", inner_contour_, section_type, layer_idx);
 
@@ -246,6 +263,104 @@ void Infill::generate(
             scripta::PointVDI{ "width", &ExtrusionJunction::w_ },
             scripta::PointVDI{ "perimeter_index", &ExtrusionJunction::perimeter_index_ });
     }
+
+    if (use_cache)
+    {
+        cache.insert(cache_key, InfillCache::Result{ toolpaths, result_polygons, result_lines });
+    }
+}
+
+bool Infill::isCacheable() const
+{
+    switch (pattern_)
+    {
+    case EFillMethod::CUBICSUBDIV: // Depends on the mesh.
+    case EFillMethod::CROSS: // Depends on the fill provider.
+    case EFillMethod::CROSS_3D:
+    case EFillMethod::LIGHTNING: // Depends on the trees of the layer.
+    case EFillMethod::PLUGIN: // Depends on the plug-in.
+        return false;
+    default:
+        return true;
+    }
+}
+
+std::string Infill::getCacheKey(const Settings& settings, const SectionType section_type, const Polygons& prevent_small_exposed_to_air) const
+{
+    std::string key;
+    const auto append_value = [&key]<typename T>(const T value)
+    {
+        key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    };
+    const auto append_polygons = [&key, &append_value](const Polygons& polygons)
+    {
+        append_value(uint64_t(polygons.size()));
+        for (ConstPolygonRef polygon : polygons)
+        {
+            append_value(uint64_t(polygon.size()));
+            for (const Point2LL& point : polygon)
+            {
+                append_value(int64_t(point.X));
+                append_value(int64_t(point.Y));
+            }
+        }
+    };
+    append_polygons(outer_contour_);
+    append_polygons(prevent_small_exposed_to_air);
+
+    append_value(static_cast<int>(pattern_));
+    append_value(static_cast<int>(section_type));
+    for (const coord_t value : { infill_line_width_, line_distance_, infill_overlap_, shift_, max_resolution_, max_deviation_, small_area_width_, infill_origin_.X,
+                                 infill_origin_.Y, pocket_size_ })
+    {
+        append_value(value);
+    }
+    for (const size_t value : { infill_multiplier_, wall_line_count_, zag_skip_count_ })
+    {
+        append_value(value);
+    }
+    for (const bool value : { zig_zaggify_, connect_polygons_, skip_line_stitching_, fill_gaps_, connected_zigzags_, use_endpieces_, skip_some_zags_, mirror_offset_ })
+    {
+        append_value(value);
+    }
+    append_value(fill_angle_.value_);
+
+    // Only these patterns change with the height of the layer.
+    if (pattern_ == EFillMethod::CUBIC || pattern_ == EFillMethod::TETRAHEDRAL || pattern_ == EFillMethod::QUARTER_CUBIC || pattern_ == EFillMethod::GYROID)
+    {
+        append_value(z_);
+    }
+
+    // The settings are only read for walls, narrow areas and concentric infill. Only add them if they are needed, since otherwise they might not exist.
+    if (wall_line_count_ > 0 || small_area_width_ > 0 || pattern_ == EFillMethod::CONCENTRIC)
+    {
+        for (const std::string setting : { "fill_outline_gaps",
+                                           "min_feature_size",
+                                           "min_bead_width",
+                                           "min_wall_line_width",
+                                           "min_even_wall_line_width",
+                                           "min_odd_wall_line_width",
+                                           "wall_line_width_0",
+                                           "wall_line_width_x",
+                                           "wall_distribution_count",
+                                           "wall_transition_angle",
+                                           "wall_transition_length",
+                                           "wall_transition_filter_distance",
+                                           "wall_transition_filter_deviation",
+                                           "meshfix_maximum_resolution",
+                                           "meshfix_maximum_deviation",
+                                           "meshfix_maximum_extrusion_area_deviation",
+                                           "meshfix_fluid_motion_enabled",
+                                           "meshfix_fluid_motion_shift_distance",
+                                           "meshfix_fluid_motion_small_distance",
+                                           "meshfix_fluid_motion_angle" })
+        {
+            const std::string value = settings.get<std::string>(setting);
+            append_value(uint64_t(value.size()));
+            key += value;
+        }
+    }
+    return key;
 }
 
 void Infill::_generate(
@@ -470,53 +585,52 @@ void Infill::generateConcentricInfill(std::vector<VariableWidthLines>& toolpaths
 
 void Infill::generateGridInfill(Polygons& result)
 {
-    generateLineInfill(result, line_distance_, fill_angle_, 0);
-    generateLineInfill(result, line_distance_, fill_angle_ + 90, 0);
+    generateLineInfill(result, { { line_distance_, fill_angle_, 0 }, { line_distance_, fill_angle_ + 90, 0 } });
 }
 
 void Infill::generateCubicInfill(Polygons& result)
 {
     const coord_t shift = one_over_sqrt_2 * z_;
-    generateLineInfill(result, line_distance_, fill_angle_, shift);
-    generateLineInfill(result, line_distance_, fill_angle_ + 120, shift);
-    generateLineInfill(result, line_distance_, fill_angle_ + 240, shift);
+    generateLineInfill(result, { { line_distance_, fill_angle_, shift }, { line_distance_, fill_angle_ + 120, shift }, { line_distance_, fill_angle_ + 240, shift } });
 }
 
 void Infill::generateTetrahedralInfill(Polygons& result)
 {
-    generateHalfTetrahedralInfill(0.0, 0, result);
-    generateHalfTetrahedralInfill(0.0, 90, result);
+    std::vector<LineInfillDirection> directions;
+    addHalfTetrahedralDirections(0.0, 0, directions);
+    addHalfTetrahedralDirections(0.0, 90, directions);
+    generateLineInfill(result, directions);
 }
 
 void Infill::generateQuarterCubicInfill(Polygons& result)
 {
-    generateHalfTetrahedralInfill(0.0, 0, result);
-    generateHalfTetrahedralInfill(0.5, 90, result);
+    std::vector<LineInfillDirection> directions;
+    addHalfTetrahedralDirections(0.0, 0, directions);
+    addHalfTetrahedralDirections(0.5, 90, directions);
+    generateLineInfill(result, directions);
 }
 
-void Infill::generateHalfTetrahedralInfill(double pattern_z_shift, int angle_shift, Polygons& result)
+void Infill::addHalfTetrahedralDirections(double pattern_z_shift, int angle_shift, std::vector<LineInfillDirection>& directions)
 {
     const coord_t period = line_distance_ * 2;
     coord_t shift = coord_t(one_over_sqrt_2 * (z_ + pattern_z_shift * period * 2)) % period;
     shift = std::min(shift, period - shift); // symmetry due to the fact that we are applying the shift in both directions
     shift = std::min(shift, period / 2 - infill_line_width_ / 2); // don't put lines too close to each other
     shift = std::max(shift, infill_line_width_ / 2); // don't put lines too close to each other
-    generateLineInfill(result, period, fill_angle_ + angle_shift, shift);
-    generateLineInfill(result, period, fill_angle_ + angle_shift, -shift);
+    directions.push_back({ period, fill_angle_ + angle_shift, shift });
+    directions.push_back({ period, fill_angle_ + angle_shift, -shift });
 }
 
 void Infill::generateTriangleInfill(Polygons& result)
 {
-    generateLineInfill(result, line_distance_, fill_angle_, 0);
-    generateLineInfill(result, line_distance_, fill_angle_ + 60, 0);
-    generateLineInfill(result, line_distance_, fill_angle_ + 120, 0);
+    generateLineInfill(result, { { line_distance_, fill_angle_, 0 }, { line_distance_, fill_angle_ + 60, 0 }, { line_distance_, fill_angle_ + 120, 0 } });
 }
 
 void Infill::generateTrihexagonInfill(Polygons& result)
 {
-    generateLineInfill(result, line_distance_, fill_angle_, 0);
-    generateLineInfill(result, line_distance_, fill_angle_ + 60, 0);
-    generateLineInfill(result, line_distance_, fill_angle_ + 120, line_distance_ / 2);
+    generateLineInfill(
+        result,
+        { { line_distance_, fill_angle_, 0 }, { line_distance_, fill_angle_ + 60, 0 }, { line_distance_, fill_angle_ + 120, line_distance_ / 2 } });
 }
 
 void Infill::generateCubicSubDivInfill(Polygons& result, const SliceMeshStorage& mesh)
@@ -605,6 +719,258 @@ void Infill::generateLineInfill(Polygons& result, int line_distance, const doubl
     generateLinearBasedInfill(result, line_distance, rotation_matrix, lines_processor, connected_zigzags, shift);
 }
 
+void Infill::generateLineInfill(Polygons& result, const std::vector<LineInfillDirection>& directions)
+{
+    if (inner_contour_.empty())
+    {
+        return;
+    }
+
+    // The vertices of the outline, as separate arrays of coordinates, so that they can be rotated in bulk.
+    std::vector<double> vertex_x;
+    std::vector<double> vertex_y;
+    std::vector<size_t> polygon_starts; // The index of the first vertex of each polygon, and the number of vertices at the end.
+    vertex_x.reserve(inner_contour_.pointCount());
+    vertex_y.reserve(inner_contour_.pointCount());
+    polygon_starts.reserve(inner_contour_.size() + 1);
+    coord_t max_extent = 0; // Upper bound of the absolute value of any coordinate after rotating.
+    for (ConstPolygonRef poly : inner_contour_)
+    {
+        polygon_starts.push_back(vertex_x.size());
+        for (const Point2LL& point : poly)
+        {
+            vertex_x.push_back(static_cast<double>(point.X));
+            vertex_y.push_back(static_cast<double>(point.Y));
+            max_extent = std::max(max_extent, std::abs(point.X) + std::abs(point.Y));
+        }
+    }
+    polygon_starts.push_back(vertex_x.size());
+    const size_t vertex_count = vertex_x.size();
+
+    // Adding and then subtracting 1.5 * 2^52 rounds to the nearest integer, ties to even, which is the same as what std::llrint does in PointMatrix::apply.
+    // Unlike std::llrint, the compiler can vectorize this. It's only exact for values up to 2^51, so far beyond that we fall back to PointMatrix::apply.
+    constexpr double round_to_integer = 6755399441055744.0;
+    const bool can_round_in_bulk = max_extent < (coord_t(1) << 50);
+
+    /*
+     * The outline as rotated for one angle. Directions with the same angle share the rotated outline.
+     */
+    struct RotatedOutline
+    {
+        double infill_rotation;
+        PointMatrix rotation_matrix;
+        std::vector<coord_t> x;
+        std::vector<coord_t> y;
+        coord_t min_x = POINT_MAX;
+        coord_t max_x = POINT_MIN;
+    };
+    std::vector<RotatedOutline> rotated_outlines;
+
+    /*
+     * What is gathered of the scanlines of one direction. This is the same as what generateLinearBasedInfill gathers.
+     */
+    struct DirectionScanlines
+    {
+        size_t rotated_outline_idx;
+        const coord_t* x; //!< The rotated vertices.
+        const coord_t* y;
+        std::vector<int> scan_segment; //!< For each vertex, the index of the scan segment that it is in.
+        int line_distance;
+        coord_t shift;
+        int scanline_min_idx;
+        int min_scanline_index;
+        std::vector<std::vector<coord_t>> cut_list; // mapping from scanline to all intersections with polygon segments
+        std::vector<std::vector<ScanlineCrossing>> crossings_per_scanline; // For each scanline, a list of crossings.
+    };
+    std::vector<DirectionScanlines> scanlines;
+
+    for (const LineInfillDirection& direction : directions)
+    {
+        if (direction.line_distance == 0) // No infill to generate (0% density).
+        {
+            continue;
+        }
+        auto rotated_outline = std::find_if(
+            rotated_outlines.begin(),
+            rotated_outlines.end(),
+            [&direction](const RotatedOutline& outline)
+            {
+                return outline.infill_rotation == direction.infill_rotation;
+            });
+        if (rotated_outline == rotated_outlines.end())
+        {
+            // Rotate the outline to make intersections always horizontal, for better performance.
+            RotatedOutline& outline = rotated_outlines.emplace_back(RotatedOutline{ direction.infill_rotation, PointMatrix(direction.infill_rotation) });
+            outline.x.resize(vertex_count);
+            outline.y.resize(vertex_count);
+            const double* matrix = outline.rotation_matrix.matrix;
+            if (can_round_in_bulk)
+            {
+                for (size_t vertex_idx = 0; vertex_idx < vertex_count; vertex_idx++) // The same as PointMatrix::apply.
+                {
+                    const double x = vertex_x[vertex_idx];
+                    const double y = vertex_y[vertex_idx];
+                    outline.x[vertex_idx] = static_cast<coord_t>((x * matrix[0] + y * matrix[1] + round_to_integer) - round_to_integer);
+                    outline.y[vertex_idx] = static_cast<coord_t>((x * matrix[2] + y * matrix[3] + round_to_integer) - round_to_integer);
+                }
+            }
+            else
+            {
+                size_t vertex_idx = 0;
+                for (ConstPolygonRef poly : inner_contour_)
+                {
+                    for (const Point2LL& point : poly)
+                    {
+                        const Point2LL rotated = outline.rotation_matrix.apply(point);
+                        outline.x[vertex_idx] = rotated.X;
+                        outline.y[vertex_idx] = rotated.Y;
+                        vertex_idx++;
+                    }
+                }
+            }
+            for (const coord_t x : outline.x)
+            {
+                outline.min_x = std::min(outline.min_x, x);
+                outline.max_x = std::max(outline.max_x, x);
+            }
+            rotated_outline = rotated_outlines.end() - 1;
+        }
+
+        coord_t shift = direction.extra_shift + getShiftOffsetFromInfillOriginAndRotation(direction.infill_rotation) + this->shift_;
+        if (shift < 0)
+        {
+            shift = direction.line_distance - (-shift) % direction.line_distance;
+        }
+        else
+        {
+            shift = shift % direction.line_distance;
+        }
+
+        DirectionScanlines& direction_scanlines = scanlines.emplace_back();
+        direction_scanlines.rotated_outline_idx = rotated_outline - rotated_outlines.begin();
+        direction_scanlines.line_distance = static_cast<int>(direction.line_distance);
+        direction_scanlines.shift = shift;
+        direction_scanlines.scanline_min_idx = computeScanSegmentIdx(rotated_outline->min_x - shift, direction.line_distance);
+        direction_scanlines.min_scanline_index = direction_scanlines.scanline_min_idx + 1;
+        const int max_scanline_index = computeScanSegmentIdx(rotated_outline->max_x - shift, direction.line_distance) + 1;
+        if (connect_lines_)
+        {
+            direction_scanlines.crossings_per_scanline.resize(max_scanline_index - direction_scanlines.min_scanline_index);
+        }
+        else
+        {
+            direction_scanlines.cut_list.resize(max_scanline_index - direction_scanlines.scanline_min_idx);
+        }
+    }
+    if (scanlines.empty())
+    {
+        return;
+    }
+    for (DirectionScanlines& direction_scanlines : scanlines) // Only now that the rotated outlines are no longer moved around.
+    {
+        const RotatedOutline& outline = rotated_outlines[direction_scanlines.rotated_outline_idx];
+        direction_scanlines.x = outline.x.data();
+        direction_scanlines.y = outline.y.data();
+        direction_scanlines.scan_segment.resize(vertex_count);
+        for (size_t vertex_idx = 0; vertex_idx < vertex_count; vertex_idx++)
+        {
+            direction_scanlines.scan_segment[vertex_idx] = computeScanSegmentIdx(outline.x[vertex_idx] - direction_scanlines.shift, direction_scanlines.line_distance);
+        }
+    }
+
+    // Find where the scanlines of all directions cross each edge of the outline, in one pass over the edges.
+    for (size_t poly_idx = 0; poly_idx + 1 < polygon_starts.size(); poly_idx++)
+    {
+        const size_t poly_start = polygon_starts[poly_idx];
+        const size_t poly_end = polygon_starts[poly_idx + 1];
+        if (poly_start == poly_end)
+        {
+            continue;
+        }
+        for (size_t vertex_idx = poly_start; vertex_idx < poly_end; vertex_idx++)
+        {
+            const size_t previous_idx = (vertex_idx == poly_start) ? poly_end - 1 : vertex_idx - 1;
+            const size_t point_idx = vertex_idx - poly_start;
+            for (DirectionScanlines& direction_scanlines : scanlines)
+            {
+                const Point2LL p0(direction_scanlines.x[previous_idx], direction_scanlines.y[previous_idx]);
+                const Point2LL p1(direction_scanlines.x[vertex_idx], direction_scanlines.y[vertex_idx]);
+                if (p1.X == p0.X)
+                {
+                    continue;
+                }
+
+                const int line_distance = direction_scanlines.line_distance;
+                const coord_t shift = direction_scanlines.shift;
+                int scanline_idx0;
+                int scanline_idx1;
+                // This handles the case where a boundary line segment ends exactly on a scanline the same as generateLinearBasedInfill does.
+                int direction = 1;
+                if (p0.X < p1.X)
+                {
+                    scanline_idx0 = direction_scanlines.scan_segment[previous_idx] + 1;
+                    scanline_idx1 = direction_scanlines.scan_segment[vertex_idx];
+                }
+                else
+                {
+                    direction = -1;
+                    scanline_idx0 = direction_scanlines.scan_segment[previous_idx];
+                    scanline_idx1 = direction_scanlines.scan_segment[vertex_idx] + 1;
+                }
+
+                for (int scanline_idx = scanline_idx0; scanline_idx != scanline_idx1 + direction; scanline_idx += direction)
+                {
+                    int x = scanline_idx * line_distance + shift;
+                    int y = p1.Y + (p0.Y - p1.Y) * (x - p1.X) / (p0.X - p1.X);
+                    if (connect_lines_)
+                    {
+                        direction_scanlines.crossings_per_scanline[scanline_idx - direction_scanlines.min_scanline_index].emplace_back(Point2LL(x, y), poly_idx, point_idx);
+                    }
+                    else
+                    {
+                        assert(
+                            scanline_idx - direction_scanlines.scanline_min_idx >= 0 && scanline_idx - direction_scanlines.scanline_min_idx < int(direction_scanlines.cut_list.size())
+                            && "reading infill cutlist index out of bounds!");
+                        direction_scanlines.cut_list[scanline_idx - direction_scanlines.scanline_min_idx].push_back(y);
+                    }
+                }
+            }
+        }
+    }
+
+    // Turn the crossings into lines, one direction after another.
+    if (connect_lines_)
+    {
+        crossings_on_line_.resize(inner_contour_.size()); // One for each polygon.
+        for (size_t poly_idx = 0; poly_idx < inner_contour_.size(); poly_idx++)
+        {
+            crossings_on_line_[poly_idx].resize(inner_contour_[poly_idx].size()); // One for each line in this polygon.
+        }
+    }
+    for (DirectionScanlines& direction_scanlines : scanlines)
+    {
+        const RotatedOutline& outline = rotated_outlines[direction_scanlines.rotated_outline_idx];
+        if (connect_lines_)
+        {
+            addCrossingSegments(direction_scanlines.crossings_per_scanline, outline.rotation_matrix);
+        }
+        else if (! direction_scanlines.cut_list.empty())
+        {
+            AABB boundary;
+            boundary.include(Point2LL(outline.min_x, 0));
+            boundary.include(Point2LL(outline.max_x, 0));
+            addLineInfill(
+                result,
+                outline.rotation_matrix,
+                direction_scanlines.scanline_min_idx,
+                direction_scanlines.line_distance,
+                boundary,
+                direction_scanlines.cut_list,
+                direction_scanlines.shift);
+        }
+    }
+}
+
 
 void Infill::generateZigZagInfill(Polygons& result, const coord_t line_distance, const double& infill_rotation)
 {
@@ -615,6 +981,34 @@ void Infill::generateZigZagInfill(Polygons& result, const coord_t line_distance,
     generateLinearBasedInfill(result, line_distance, rotation_matrix, zigzag_processor, connected_zigzags_, shift);
 }
 
+void Infill::addCrossingSegments(std::vector<std::vector<ScanlineCrossing>>& crossings_per_scanline, const PointMatrix& rotation_matrix)
+{
+    // Gather all crossings per scanline and find out which crossings belong together, then store them in crossings_on_line.
+    for (std::vector<ScanlineCrossing>& crossings : crossings_per_scanline)
+    {
+        // Sorts them by Y coordinate.
+        std::sort(crossings.begin(), crossings.end());
+        // Combine each 2 subsequent crossings together.
+        for (long crossing_index = 0; crossing_index < static_cast<long>(crossings.size()) - 1; crossing_index += 2)
+        {
+            const ScanlineCrossing& first = crossings[crossing_index];
+            const ScanlineCrossing& second = crossings[crossing_index + 1];
+            // Avoid creating zero length crossing lines
+            const Point2LL unrotated_first = rotation_matrix.unapply(first.coordinate_);
+            const Point2LL unrotated_second = rotation_matrix.unapply(second.coordinate_);
+            if (unrotated_first == unrotated_second)
+            {
+                continue;
+            }
+            InfillLineSegment* new_segment
+                = new InfillLineSegment(unrotated_first, first.vertex_index_, first.polygon_index_, unrotated_second, second.vertex_index_, second.polygon_index_);
+            // Put the same line segment in the data structure twice: Once for each of the polygon line segment that it crosses.
+            crossings_on_line_[first.polygon_index_][first.vertex_index_].push_back(new_segment);
+            crossings_on_line_[second.polygon_index_][second.vertex_index_].push_back(new_segment);
+        }
+    }
+}
+
 /*
  * algorithm:
  * 1. for each line segment of each polygon:
@@ -673,25 +1067,7 @@ void Infill::generateLinearBasedInfill(
 
     // When we find crossings, keep track of which crossing belongs to which scanline and to which polygon line segment.
     // Then we can later join two crossings together to form lines and still know what polygon line segments that infill line connected to.
-    struct Crossing
-    {
-        Point2LL coordinate_;
-        size_t polygon_index_;
-        size_t vertex_index_;
-
-        Crossing(Point2LL coordinate, size_t polygon_index, size_t vertex_index)
-            : coordinate_(coordinate)
-            , polygon_index_(polygon_index)
-            , vertex_index_(vertex_index)
-        {
-        }
-
-        bool operator<(const Crossing& other) const // Crossings will be ordered by their Y coordinate so that they get ordered along the scanline.
-        {
-            return coordinate_.Y < other.coordinate_.Y;
-        }
-    };
-    std::vector<std::vector<Crossing>> crossings_per_scanline; // For each scanline, a list of crossings.
+    std::vector<std::vector<ScanlineCrossing>> crossings_per_scanline; // For each scanline, a list of crossings.
     const int min_scanline_index = computeScanSegmentIdx(boundary.min_.X - shift, line_distance) + 1;
     const int max_scanline_index = computeScanSegmentIdx(boundary.max_.X - shift, line_distance) + 1;
     crossings_per_scanline.resize(max_scanline_index - min_scanline_index);
@@ -760,31 +1136,7 @@ void Infill::generateLinearBasedInfill(
 
     if (connect_lines_)
     {
-        // Gather all crossings per scanline and find out which crossings belong together, then store them in crossings_on_line.
-        for (int scanline_index = min_scanline_index; scanline_index < max_scanline_index; scanline_index++)
-        {
-            auto& crossings = crossings_per_scanline[scanline_index - min_scanline_index];
-            // Sorts them by Y coordinate.
-            std::sort(crossings.begin(), crossings.end());
-            // Combine each 2 subsequent crossings together.
-            for (long crossing_index = 0; crossing_index < static_cast<long>(crossings.size()) - 1; crossing_index += 2)
-            {
-                const Crossing& first = crossings[crossing_index];
-                const Crossing& second = crossings[crossing_index + 1];
-                // Avoid creating zero length crossing lines
-                const Point2LL unrotated_first = rotation_matrix.unapply(first.coordinate_);
-                const Point2LL unrotated_second = rotation_matrix.unapply(second.coordinate_);
-                if (unrotated_first == unrotated_second)
-                {
-                    continue;
-                }
-                InfillLineSegment* new_segment
-                    = new InfillLineSegment(unrotated_first, first.vertex_index_, first.polygon_index_, unrotated_second, second.vertex_index_, second.polygon_index_);
-                // Put the same line segment in the data structure twice: Once for each of the polygon line segment that it crosses.
-                crossings_on_line_[first.polygon_index_][first.vertex_index_].push_back(new_segment);
-                crossings_on_line_[second.polygon_index_][second.vertex_index_].push_back(new_segment);
-            }
-        }
+        addCrossingSegments(crossings_per_scanline, rotation_matrix);
     }
     else
     {
@@ -0,0 +1,152 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "infill/InfillCache.h"
+
+#include <string>
+
+#include <spdlog/details/os.h>
+#include <spdlog/spdlog.h>
+
+namespace cura
+{
+
+namespace
+{
+size_t estimatePolygonsSize(const Polygons& polygons)
+{
+    size_t size = sizeof(Polygons) + polygons.size() * sizeof(ClipperLib::Path);
+    for (ConstPolygonRef polygon : polygons)
+    {
+        size += polygon.size() * sizeof(Point2LL);
+    }
+    return size;
+}
+} // namespace
+
+InfillCache& InfillCache::getInstance()
+{
+    static InfillCache instance;
+    return instance;
+}
+
+size_t InfillCache::getMaxSizeFromEnvironment()
+{
+    const std::string max_size_str = spdlog::details::os::getenv("CURAENGINE_INFILL_CACHE_MB");
+    if (max_size_str.empty())
+    {
+        return 0;
+    }
+    try
+    {
+        return std::stoull(max_size_str) * 1024 * 1024;
+    }
+    catch (const std::exception&)
+    {
+        spdlog::warn("Invalid infill cache size limit '{}', not caching infill.", max_size_str);
+        return 0;
+    }
+}
+
+InfillCache::InfillCache(const size_t max_size)
+    : max_size_{ max_size }
+{
+}
+
+void InfillCache::reset(const size_t max_size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_size_.store(max_size, std::memory_order_relaxed);
+    size_ = 0;
+    entries_.clear();
+    recency_.clear();
+    statistics_ = Statistics{};
+}
+
+bool InfillCache::isEnabled() const
+{
+    return max_size_.load(std::memory_order_relaxed) > 0;
+}
+
+std::shared_ptr<const InfillCache::Result> InfillCache::find(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto entry = entries_.find(key);
+    if (entry == entries_.end())
+    {
+        statistics_.misses++;
+        return nullptr;
+    }
+    statistics_.hits++;
+    recency_.splice(recency_.begin(), recency_, entry->second.recency);
+    return entry->second.result;
+}
+
+void InfillCache::insert(const std::string& key, Result result)
+{
+    const size_t size = estimateSize(key, result);
+    auto shared_result = std::make_shared<const Result>(std::move(result));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t max_size = max_size_.load(std::memory_order_relaxed);
+    if (size > max_size)
+    {
+        return;
+    }
+    if (entries_.contains(key)) // Another thread computed the same result in the meantime.
+    {
+        return;
+    }
+    const auto entry = entries_.emplace(key, Entry{ std::move(shared_result), size, recency_.end() }).first;
+    recency_.push_front(&entry->first);
+    entry->second.recency = recency_.begin();
+    size_ += size;
+
+    while (size_ > max_size)
+    {
+        const auto least_recent = entries_.find(*recency_.back());
+        size_ -= least_recent->second.size;
+        recency_.pop_back();
+        entries_.erase(least_recent);
+        statistics_.evictions++;
+    }
+}
+
+InfillCache::Statistics InfillCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void InfillCache::logStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (max_size_.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    const size_t lookups = statistics_.hits + statistics_.misses;
+    spdlog::info(
+        "Infill cache: {} hits out of {} lookups ({:.1f}%), {} evictions, {:.1f} MB in use.",
+        statistics_.hits,
+        lookups,
+        lookups == 0 ? 0.0 : 100.0 * static_cast<double>(statistics_.hits) / static_cast<double>(lookups),
+        statistics_.evictions,
+        static_cast<double>(size_) / (1024.0 * 1024.0));
+}
+
+size_t InfillCache::estimateSize(const std::string& key, const Result& result)
+{
+    size_t size = sizeof(Entry) + sizeof(Result) + sizeof(std::string) + key.size() + estimatePolygonsSize(result.result_polygons) + estimatePolygonsSize(result.result_lines);
+    for (const VariableWidthLines& lines : result.toolpaths)
+    {
+        size += sizeof(VariableWidthLines) + lines.size() * sizeof(ExtrusionLine);
+        for (const ExtrusionLine& line : lines)
+        {
+            size += line.size() * sizeof(ExtrusionJunction);
+        }
+    }
+    return size;
+}
+
+} // namespace cura
@@ -3,11 +3,13 @@
 
 #include "infill/LightningGenerator.h"
 
+#include "Application.h"
 #include "ExtruderTrain.h"
 #include "infill/LightningLayer.h"
 #include "infill/LightningTreeNode.h"
 #include "sliceDataStorage.h"
 #include "utils/SparsePointGridInclusive.h"
+#include "utils/ThreadPool.h"
 #include "utils/linearAlg2D.h"
 
 /* Possible future tasks/optimizations,etc.:
@@ -37,34 +39,50 @@ LightningGenerator::LightningGenerator(const SliceMeshStorage& mesh)
     prune_length = layer_thickness * std::tan(infill_extruder.settings_.get<AngleRadians>("lightning_infill_prune_angle"));
     straightening_max_distance = layer_thickness * std::tan(infill_extruder.settings_.get<AngleRadians>("lightning_infill_straightening_angle"));
 
-    generateInitialInternalOverhangs(mesh);
-    generateTrees(mesh);
+    const std::vector<Polygons> infill_outlines = generateInfillOutlines(mesh);
+    generateInitialInternalOverhangs(infill_outlines);
+    generateTrees(infill_outlines);
 }
 
-void LightningGenerator::generateInitialInternalOverhangs(const SliceMeshStorage& mesh)
+std::vector<Polygons> LightningGenerator::generateInfillOutlines(const SliceMeshStorage& mesh) const
 {
-    overhang_per_layer.resize(mesh.layers.size());
     const auto infill_wall_line_count = static_cast<coord_t>(mesh.settings.get<size_t>("infill_wall_line_count"));
     const auto infill_line_width = mesh.settings.get<coord_t>("infill_line_width");
     const coord_t infill_wall_offset = -infill_wall_line_count * infill_line_width;
 
-    Polygons infill_area_above;
-    // Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = mesh.layers.size() - 1; layer_nr >= 0; layer_nr--)
-    {
-        const SliceLayer& current_layer = mesh.layers[layer_nr];
-        Polygons infill_area_here;
-        for (auto& part : current_layer.parts)
+    std::vector<Polygons> infill_outlines(mesh.layers.size());
+    cura::parallel_for<size_t>(
+        0,
+        mesh.layers.size(),
+        [&](const size_t layer_id)
         {
-            infill_area_here.add(part.getOwnInfillArea().offset(infill_wall_offset));
-        }
-
-        // Remove the part of the infill area that is already supported by the walls.
-        Polygons overhang = infill_area_here.offset(-wall_supporting_radius).difference(infill_area_above);
+            for (const auto& part : mesh.layers[layer_id].parts)
+            {
+                infill_outlines[layer_id].add(part.getOwnInfillArea().offset(infill_wall_offset));
+            }
+        });
+    return infill_outlines;
+}
 
-        overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+void LightningGenerator::generateInitialInternalOverhangs(const std::vector<Polygons>& infill_outlines)
+{
+    overhang_per_layer.resize(infill_outlines.size());
+
+    // Subtract the infill area above from the area on each layer, to get only overhang in the top layer where it is overhanging.
+    // Every layer only depends on the (precomputed) outlines of the layer above, so all layers can be computed at once.
+    cura::parallel_for<size_t>(
+        0,
+        infill_outlines.size(),
+        [&](const size_t layer_nr)
+        {
+            // Remove the part of the infill area that is already supported by the walls.
+            Polygons overhang = infill_outlines[layer_nr].offset(-wall_supporting_radius);
+            if (layer_nr + 1 < infill_outlines.size())
+            {
+                overhang = overhang.difference(infill_outlines[layer_nr + 1]);
+            }
+            overhang_per_layer[layer_nr] = std::move(overhang);
+        });
 }
 
 const LightningLayer& LightningGenerator::getTreesForLayer(const size_t& layer_id) const
@@ -73,56 +91,95 @@ const LightningLayer& LightningGenerator::getTreesForLayer(const size_t& layer_i
     return lightning_layers[layer_id];
 }
 
-void LightningGenerator::generateTrees(const SliceMeshStorage& mesh)
+void LightningGenerator::generateTrees(const std::vector<Polygons>& infill_outlines)
 {
-    lightning_layers.resize(mesh.layers.size());
-    const auto infill_wall_line_count = static_cast<coord_t>(mesh.settings.get<size_t>("infill_wall_line_count"));
-    const auto infill_line_width = mesh.settings.get<coord_t>("infill_line_width");
-    const coord_t infill_wall_offset = -infill_wall_line_count * infill_line_width;
-
-    std::vector<Polygons> infill_outlines;
-    infill_outlines.insert(infill_outlines.end(), mesh.layers.size(), Polygons());
-
-    // For-each layer from top to bottom:
-    for (int layer_id = mesh.layers.size() - 1; layer_id >= 0; layer_id--)
+    lightning_layers.resize(infill_outlines.size());
+    if (infill_outlines.empty())
     {
-        for (const auto& part : mesh.layers[layer_id].parts)
-        {
-            infill_outlines[layer_id].add(part.getOwnInfillArea().offset(infill_wall_offset));
-        }
+        return;
     }
 
-    // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = mesh.layers.size() - 1;
-    auto outlines_locator_ptr = PolygonUtils::createLocToLineGrid(infill_outlines[top_layer_id], locator_cell_size);
+    // For various operations its beneficial to quickly locate nearby features on the polygon.
+    // The trees have to be generated from top to bottom, but the locators don't depend on them. They are created in parallel for a batch of layers ahead of the tree
+    // generation, which keeps only a limited number of them in memory at once.
+    const size_t locator_batch_size = 2 * (Application::getInstance().thread_pool_->thread_count() + 1);
+    std::vector<std::unique_ptr<LocToLineGrid>> outline_locators(infill_outlines.size());
+    const auto create_locators_below = [&](const int layer_id)
+    {
+        const int batch_end = std::max(0, layer_id - static_cast<int>(locator_batch_size) + 1);
+        cura::parallel_for<int>(
+            batch_end,
+            layer_id + 1,
+            [&](const int locator_layer_id)
+            {
+                outline_locators[locator_layer_id] = PolygonUtils::createLocToLineGrid(infill_outlines[locator_layer_id], locator_cell_size);
+            });
+    };
 
     // For-each layer from top to bottom:
-    for (int layer_id = top_layer_id; layer_id >= 0; layer_id--)
+    for (int layer_id = infill_outlines.size() - 1; layer_id >= 0; layer_id--)
     {
+        if (! outline_locators[layer_id])
+        {
+            create_locators_below(layer_id);
+        }
         LightningLayer& current_lightning_layer = lightning_layers[layer_id];
-        Polygons& current_outlines = infill_outlines[layer_id];
-        const auto& outlines_locator = *outlines_locator_ptr;
+        const Polygons& current_outlines = infill_outlines[layer_id];
+        const auto& outlines_locator = *outline_locators[layer_id];
 
         // register all trees propagated from the previous layer as to-be-reconnected
-        std::vector<LightningTreeNodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
+        std::vector<LightningTreeNodeIdx> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
 
         current_lightning_layer.generateNewTrees(overhang_per_layer[layer_id], current_outlines, outlines_locator, supporting_radius, wall_supporting_radius);
 
         current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, outlines_locator, supporting_radius, wall_supporting_radius);
 
+        outline_locators[layer_id].reset(); // Not needed anymore.
+
+        // Propagating to the layer below has left unreachable nodes behind, which don't need to be kept for the rest of the slice.
+        current_lightning_layer.compact();
+
         // Initialize trees for next lower layer from the current one.
         if (layer_id == 0)
         {
             return;
         }
+        if (! outline_locators[layer_id - 1])
+        {
+            create_locators_below(layer_id - 1);
+        }
         const Polygons& below_outlines = infill_outlines[layer_id - 1];
-        outlines_locator_ptr = PolygonUtils::createLocToLineGrid(below_outlines, locator_cell_size);
-        const auto& below_outlines_locator = *outlines_locator_ptr;
-
-        std::vector<LightningTreeNodeSPtr>& lower_trees = lightning_layers[layer_id - 1].tree_roots;
-        for (auto& tree : current_lightning_layer.tree_roots)
+        const auto& below_outlines_locator = *outline_locators[layer_id - 1];
+
+        // Each tree is propagated independently: it is copied before it is modified and only reads the outlines of the layer below.
+        // The results are collected in a pool per tree and appended afterwards, so that the order of the trees doesn't depend on the scheduling.
+        const std::vector<LightningTreeNodeIdx>& current_trees = current_lightning_layer.tree_roots;
+        std::vector<LightningTreeNodePool> propagated_nodes(current_trees.size());
+        std::vector<std::vector<LightningTreeNodeIdx>> propagated_trees(current_trees.size());
+        cura::parallel_for<size_t>(
+            0,
+            current_trees.size(),
+            [&](const size_t tree_idx)
+            {
+                current_lightning_layer.tree_nodes.propagateToNextLayer(
+                    current_trees[tree_idx],
+                    propagated_nodes[tree_idx],
+                    propagated_trees[tree_idx],
+                    below_outlines,
+                    below_outlines_locator,
+                    prune_length,
+                    straightening_max_distance,
+                    locator_cell_size / 2);
+            });
+
+        LightningLayer& lower_layer = lightning_layers[layer_id - 1];
+        for (size_t tree_idx = 0; tree_idx < current_trees.size(); tree_idx++)
         {
-            tree->propagateToNextLayer(lower_trees, below_outlines, below_outlines_locator, prune_length, straightening_max_distance, locator_cell_size / 2);
+            const LightningTreeNodeIdx offset = lower_layer.tree_nodes.append(std::move(propagated_nodes[tree_idx]));
+            for (const LightningTreeNodeIdx tree : propagated_trees[tree_idx])
+            {
+                lower_layer.tree_roots.push_back(tree + offset);
+            }
         }
     }
 }
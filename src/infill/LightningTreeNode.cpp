@@ -7,74 +7,90 @@
 
 using namespace cura;
 
-using LightningTreeNodeSPtr = std::shared_ptr<LightningTreeNode>;
+LightningTreeNodeIdx LightningTreeNodePool::create(const Point2LL& p, const std::optional<Point2LL>& last_grounding_location /*= std::nullopt*/)
+{
+    const auto node = static_cast<LightningTreeNodeIdx>(locations_.size());
+    locations_.push_back(p);
+    parents_.push_back(NO_LIGHTNING_TREE_NODE);
+    first_children_.push_back(NO_LIGHTNING_TREE_NODE);
+    last_children_.push_back(NO_LIGHTNING_TREE_NODE);
+    next_siblings_.push_back(NO_LIGHTNING_TREE_NODE);
+    previous_siblings_.push_back(NO_LIGHTNING_TREE_NODE);
+    child_counts_.push_back(0);
+    last_grounding_locations_.push_back(last_grounding_location);
+    return node;
+}
+
+size_t LightningTreeNodePool::getMemoryUsage() const
+{
+    return locations_.capacity() * sizeof(Point2LL)
+         + (parents_.capacity() + first_children_.capacity() + last_children_.capacity() + next_siblings_.capacity() + previous_siblings_.capacity())
+               * sizeof(LightningTreeNodeIdx)
+         + child_counts_.capacity() * sizeof(uint32_t) + last_grounding_locations_.capacity() * sizeof(std::optional<Point2LL>);
+}
 
-coord_t LightningTreeNode::getWeightedDistance(const Point2LL& unsupported_location, const coord_t& supporting_radius) const
+coord_t LightningTreeNodePool::getWeightedDistance(const LightningTreeNodeIdx node, const Point2LL& unsupported_location, const coord_t& supporting_radius) const
 {
     constexpr coord_t min_valence_for_boost = 0;
     constexpr coord_t max_valence_for_boost = 4;
     constexpr coord_t valence_boost_multiplier = 4;
 
-    const size_t valence = (! is_root_) + children_.size();
+    const size_t valence = (! isRoot(node)) + child_counts_[node];
     const coord_t valence_boost = (min_valence_for_boost < valence && valence < max_valence_for_boost) ? valence_boost_multiplier * supporting_radius : 0;
-    const coord_t dist_here = vSize(getLocation() - unsupported_location);
+    const coord_t dist_here = vSize(getLocation(node) - unsupported_location);
     return dist_here - valence_boost;
 }
 
-bool LightningTreeNode::hasOffspring(const LightningTreeNodeSPtr& to_be_checked) const
+bool LightningTreeNodePool::hasOffspring(const LightningTreeNodeIdx node, const LightningTreeNodeIdx to_be_checked) const
 {
-    if (to_be_checked == shared_from_this())
-    {
-        return true;
-    }
-    for (auto& child_ptr : children_)
+    // Walking up from the descendant only visits its ancestors, instead of the whole sub-tree.
+    for (LightningTreeNodeIdx ancestor = to_be_checked; ancestor != NO_LIGHTNING_TREE_NODE; ancestor = parents_[ancestor])
     {
-        if (child_ptr->hasOffspring(to_be_checked))
+        if (ancestor == node)
+        {
             return true;
+        }
     }
     return false;
 }
 
-const Point2LL& LightningTreeNode::getLocation() const
+LightningTreeNodeIdx LightningTreeNodePool::addChild(const LightningTreeNodeIdx parent, const Point2LL& child_loc)
 {
-    return p_;
+    assert(getLocation(parent) != child_loc);
+    const LightningTreeNodeIdx child = create(child_loc);
+    return addChild(parent, child);
 }
 
-void LightningTreeNode::setLocation(const Point2LL& loc)
+LightningTreeNodeIdx LightningTreeNodePool::addChild(const LightningTreeNodeIdx parent, const LightningTreeNodeIdx new_child)
 {
-    p_ = loc;
-}
-
-LightningTreeNodeSPtr LightningTreeNode::addChild(const Point2LL& child_loc)
-{
-    assert(p_ != child_loc);
-    LightningTreeNodeSPtr child = LightningTreeNode::create(child_loc);
-    return addChild(child);
-}
-
-LightningTreeNodeSPtr LightningTreeNode::addChild(LightningTreeNodeSPtr& new_child)
-{
-    assert(new_child != shared_from_this());
+    assert(new_child != parent);
     // assert(p != new_child->p); // NOTE: No problem for now. Issue to solve later. Maybe even afetr final. Low prio.
-    children_.push_back(new_child);
-    new_child->parent_ = shared_from_this();
-    new_child->is_root_ = false;
+    linkChild(parent, new_child);
     return new_child;
 }
 
-void LightningTreeNode::propagateToNextLayer(
-    std::vector<LightningTreeNodeSPtr>& next_trees,
+void LightningTreeNodePool::propagateToNextLayer(
+    const LightningTreeNodeIdx root,
+    LightningTreeNodePool& next_nodes,
+    std::vector<LightningTreeNodeIdx>& next_trees,
     const Polygons& next_outlines,
     const LocToLineGrid& outline_locator,
     const coord_t prune_distance,
     const coord_t smooth_magnitude,
     const coord_t max_remove_colinear_dist) const
 {
-    auto tree_below = deepCopy();
+    const LightningTreeNodeIdx tree_below = copyTree(root, next_nodes);
+
+    // Only the root of the copy remembers where it was grounded, its sub-tree is copied in consecutive nodes.
+    next_nodes.last_grounding_locations_[tree_below] = last_grounding_locations_[root].value_or(locations_[root]);
+    for (size_t node = tree_below + 1; node < next_nodes.size(); node++)
+    {
+        next_nodes.last_grounding_locations_[node].reset();
+    }
 
-    tree_below->prune(prune_distance);
-    tree_below->straighten(smooth_magnitude, max_remove_colinear_dist);
-    if (tree_below->realign(next_outlines, outline_locator, next_trees))
+    next_nodes.prune(tree_below, prune_distance);
+    next_nodes.straighten(tree_below, smooth_magnitude, max_remove_colinear_dist);
+    if (next_nodes.realign(tree_below, next_outlines, outline_locator, next_trees))
     {
         next_trees.push_back(tree_below);
     }
@@ -82,83 +98,91 @@ void LightningTreeNode::propagateToNextLayer(
 
 // NOTE: Depth-first, as currently implemented.
 //       Skips the root (because that has no root itself), but all initial nodes will have the root point anyway.
-void LightningTreeNode::visitBranches(const std::function<void(const Point2LL&, const Point2LL&)>& visitor) const
+void LightningTreeNodePool::visitBranches(const LightningTreeNodeIdx node, const std::function<void(const Point2LL&, const Point2LL&)>& visitor) const
 {
-    for (const auto& node : children_)
+    for (LightningTreeNodeIdx child = first_children_[node]; child != NO_LIGHTNING_TREE_NODE; child = next_siblings_[child])
     {
-        assert(node->parent_.lock() == shared_from_this());
-        visitor(p_, node->p_);
-        node->visitBranches(visitor);
+        assert(parents_[child] == node);
+        visitor(locations_[node], locations_[child]);
+        visitBranches(child, visitor);
     }
 }
 
 // NOTE: Depth-first, as currently implemented.
-void LightningTreeNode::visitNodes(const std::function<void(LightningTreeNodeSPtr)>& visitor)
+void LightningTreeNodePool::visitNodes(const LightningTreeNodeIdx node, const std::function<void(LightningTreeNodeIdx)>& visitor) const
 {
-    visitor(shared_from_this());
-    for (const auto& node : children_)
+    visitor(node);
+    for (LightningTreeNodeIdx child = first_children_[node]; child != NO_LIGHTNING_TREE_NODE; child = next_siblings_[child])
     {
-        assert(node->parent_.lock() == shared_from_this());
-        node->visitNodes(visitor);
+        assert(parents_[child] == node);
+        visitNodes(child, visitor);
     }
 }
 
-LightningTreeNode::LightningTreeNode(const Point2LL& p, const std::optional<Point2LL>& last_grounding_location /*= std::nullopt*/)
-    : is_root_(true)
-    , p_(p)
-    , last_grounding_location_(last_grounding_location)
+LightningTreeNodeIdx LightningTreeNodePool::copyTree(const LightningTreeNodeIdx node, LightningTreeNodePool& target) const
 {
+    const LightningTreeNodeIdx local_root = target.create(locations_[node], last_grounding_locations_[node]);
+    for (LightningTreeNodeIdx child = first_children_[node]; child != NO_LIGHTNING_TREE_NODE; child = next_siblings_[child])
+    {
+        target.linkChild(local_root, copyTree(child, target));
+    }
+    return local_root;
 }
 
-LightningTreeNodeSPtr LightningTreeNode::deepCopy() const
+LightningTreeNodeIdx LightningTreeNodePool::append(LightningTreeNodePool&& other)
 {
-    LightningTreeNodeSPtr local_root = LightningTreeNode::create(p_);
-    local_root->is_root_ = is_root_;
-    if (is_root_)
+    const auto offset = static_cast<LightningTreeNodeIdx>(size());
+    if (offset == 0)
     {
-        local_root->last_grounding_location_ = last_grounding_location_.value_or(p_);
+        *this = std::move(other);
+        return offset;
     }
-    local_root->children_.reserve(children_.size());
-    for (const auto& node : children_)
+
+    const auto append_indices = [offset](std::vector<LightningTreeNodeIdx>& indices, const std::vector<LightningTreeNodeIdx>& other_indices)
     {
-        LightningTreeNodeSPtr child = node->deepCopy();
-        child->parent_ = local_root;
-        local_root->children_.push_back(child);
-    }
-    return local_root;
+        indices.reserve(indices.size() + other_indices.size());
+        for (const LightningTreeNodeIdx idx : other_indices)
+        {
+            indices.push_back(idx == NO_LIGHTNING_TREE_NODE ? NO_LIGHTNING_TREE_NODE : idx + offset);
+        }
+    };
+    locations_.insert(locations_.end(), other.locations_.begin(), other.locations_.end());
+    append_indices(parents_, other.parents_);
+    append_indices(first_children_, other.first_children_);
+    append_indices(last_children_, other.last_children_);
+    append_indices(next_siblings_, other.next_siblings_);
+    append_indices(previous_siblings_, other.previous_siblings_);
+    child_counts_.insert(child_counts_.end(), other.child_counts_.begin(), other.child_counts_.end());
+    last_grounding_locations_.insert(last_grounding_locations_.end(), other.last_grounding_locations_.begin(), other.last_grounding_locations_.end());
+    other = LightningTreeNodePool();
+    return offset;
 }
 
-void LightningTreeNode::reroot(LightningTreeNodeSPtr new_parent /*= nullptr*/)
+void LightningTreeNodePool::reroot(const LightningTreeNodeIdx node, const LightningTreeNodeIdx new_parent /*= NO_LIGHTNING_TREE_NODE*/)
 {
-    if (! is_root_)
+    if (! isRoot(node))
     {
-        auto old_parent = parent_.lock();
-        old_parent->reroot(shared_from_this());
-        children_.push_back(old_parent);
+        const LightningTreeNodeIdx old_parent = parents_[node];
+        reroot(old_parent, node); // Makes this node a root again.
+        linkChild(node, old_parent);
     }
 
-    if (new_parent)
+    if (new_parent != NO_LIGHTNING_TREE_NODE)
     {
-        children_.erase(std::remove(children_.begin(), children_.end(), new_parent), children_.end());
-        is_root_ = false;
-        parent_ = new_parent;
-    }
-    else
-    {
-        is_root_ = true;
-        parent_.reset();
+        // The new parent is one of the children of this node, it adopts this node after this returns.
+        unlinkChild(node, new_parent);
     }
 }
 
-LightningTreeNodeSPtr LightningTreeNode::closestNode(const Point2LL& loc)
+LightningTreeNodeIdx LightningTreeNodePool::closestNode(const LightningTreeNodeIdx node, const Point2LL& loc) const
 {
-    LightningTreeNodeSPtr result = shared_from_this();
-    coord_t closest_dist2 = vSize2(p_ - loc);
+    LightningTreeNodeIdx result = node;
+    coord_t closest_dist2 = vSize2(locations_[node] - loc);
 
-    for (const auto& child : children_)
+    for (LightningTreeNodeIdx child = first_children_[node]; child != NO_LIGHTNING_TREE_NODE; child = next_siblings_[child])
     {
-        LightningTreeNodeSPtr candidate_node = child->closestNode(loc);
-        const coord_t child_dist2 = vSize2(candidate_node->p_ - loc);
+        const LightningTreeNodeIdx candidate_node = closestNode(child, loc);
+        const coord_t child_dist2 = vSize2(locations_[candidate_node] - loc);
         if (child_dist2 < closest_dist2)
         {
             closest_dist2 = child_dist2;
@@ -169,109 +193,108 @@ LightningTreeNodeSPtr LightningTreeNode::closestNode(const Point2LL& loc)
     return result;
 }
 
-bool LightningTreeNode::realign(const Polygons& outlines, const LocToLineGrid& outline_locator, std::vector<LightningTreeNodeSPtr>& rerooted_parts)
+bool LightningTreeNodePool::realign(const LightningTreeNodeIdx node, const Polygons& outlines, const LocToLineGrid& outline_locator, std::vector<LightningTreeNodeIdx>& rerooted_parts)
 {
     if (outlines.empty())
     {
         return false;
     }
 
-    if (outlines.inside(p_, true))
+    if (outlines.inside(locations_[node], true))
     {
         // Only keep children that have an unbroken connection to here, realign will put the rest in rerooted parts due to recursion:
         Point2LL coll;
         bool reground_me = false;
-        const auto remove_unconnected_func{
-            [&](const LightningTreeNodeSPtr& child)
+        LightningTreeNodeIdx next_child;
+        for (LightningTreeNodeIdx child = first_children_[node]; child != NO_LIGHTNING_TREE_NODE; child = next_child)
+        {
+            next_child = next_siblings_[child];
+            bool connect_branch = realign(child, outlines, outline_locator, rerooted_parts);
+            if (connect_branch
+                && PolygonUtils::lineSegmentPolygonsIntersection(locations_[child], locations_[node], outlines, outline_locator, coll, outline_locator.getCellSize() * 2))
             {
-                bool connect_branch = child->realign(outlines, outline_locator, rerooted_parts);
-                if (connect_branch && PolygonUtils::lineSegmentPolygonsIntersection(child->p_, p_, outlines, outline_locator, coll, outline_locator.getCellSize() * 2))
-                {
-                    child->last_grounding_location_.reset();
-                    child->parent_.reset();
-                    child->is_root_ = true;
-                    rerooted_parts.push_back(child);
-
-                    reground_me = true;
-                    connect_branch = false;
-                }
-                return ! connect_branch;
+                last_grounding_locations_[child].reset();
+                rerooted_parts.push_back(child);
+
+                reground_me = true;
+                connect_branch = false;
             }
-        };
-        children_.erase(std::remove_if(children_.begin(), children_.end(), remove_unconnected_func), children_.end());
+            if (! connect_branch)
+            {
+                unlinkChild(node, child);
+            }
+        }
         if (reground_me)
         {
-            last_grounding_location_.reset();
+            last_grounding_locations_[node].reset();
         }
         return true;
     }
 
     // 'Lift' any decendants out of this tree:
-    for (auto& child : children_)
+    LightningTreeNodeIdx next_child;
+    for (LightningTreeNodeIdx child = first_children_[node]; child != NO_LIGHTNING_TREE_NODE; child = next_child)
     {
-        if (child->realign(outlines, outline_locator, rerooted_parts))
+        next_child = next_siblings_[child];
+        const bool keep_child = realign(child, outlines, outline_locator, rerooted_parts);
+        unlinkChild(node, child);
+        if (keep_child)
         {
-            child->last_grounding_location_ = p_;
-            child->parent_.reset();
-            child->is_root_ = true;
+            last_grounding_locations_[child] = locations_[node];
             rerooted_parts.push_back(child);
         }
     }
-    children_.clear();
 
     return false;
 }
 
-void LightningTreeNode::straighten(const coord_t magnitude, const coord_t max_remove_colinear_dist)
+void LightningTreeNodePool::straighten(const LightningTreeNodeIdx node, const coord_t magnitude, const coord_t max_remove_colinear_dist)
 {
-    straighten(magnitude, p_, 0, max_remove_colinear_dist * max_remove_colinear_dist);
+    straighten(node, magnitude, locations_[node], 0, max_remove_colinear_dist * max_remove_colinear_dist);
 }
 
-LightningTreeNode::RectilinearJunction
-    LightningTreeNode::straighten(const coord_t magnitude, const Point2LL& junction_above, const coord_t accumulated_dist, const coord_t max_remove_colinear_dist2)
+LightningTreeNodePool::RectilinearJunction LightningTreeNodePool::straighten(
+    const LightningTreeNodeIdx node,
+    const coord_t magnitude,
+    const Point2LL& junction_above,
+    const coord_t accumulated_dist,
+    const coord_t max_remove_colinear_dist2)
 {
     constexpr coord_t junction_magnitude_factor_numerator = 3;
     constexpr coord_t junction_magnitude_factor_denominator = 4;
 
     const coord_t junction_magnitude = magnitude * junction_magnitude_factor_numerator / junction_magnitude_factor_denominator;
-    if (children_.size() == 1)
+    if (child_counts_[node] == 1)
     {
-        auto child_p = children_.front();
-        coord_t child_dist = vSize(p_ - child_p->p_);
-        RectilinearJunction junction_below = child_p->straighten(magnitude, junction_above, accumulated_dist + child_dist, max_remove_colinear_dist2);
+        LightningTreeNodeIdx child = first_children_[node];
+        const coord_t child_dist = vSize(locations_[node] - locations_[child]);
+        RectilinearJunction junction_below = straighten(child, magnitude, junction_above, accumulated_dist + child_dist, max_remove_colinear_dist2);
         coord_t total_dist_to_junction_below = junction_below.total_recti_dist;
         Point2LL a = junction_above;
         Point2LL b = junction_below.junction_loc;
         if (a != b) // should always be true!
         {
+            Point2LL& p = locations_[node];
             Point2LL ab = b - a;
             Point2LL destination = a + ab * accumulated_dist / std::max(coord_t(1), total_dist_to_junction_below);
-            if (shorterThen(destination - p_, magnitude))
+            if (shorterThen(destination - p, magnitude))
             {
-                p_ = destination;
+                p = destination;
             }
             else
             {
-                p_ = p_ + normal(destination - p_, magnitude);
+                p = p + normal(destination - p, magnitude);
             }
         }
         { // remove nodes on linear segments
             constexpr coord_t close_enough = 10;
 
-            child_p = children_.front(); // recursive call to straighten might have removed the child
-            const LightningTreeNodeSPtr& parent_node = parent_.lock();
-            if (parent_node && vSize2(child_p->p_ - parent_node->p_) < max_remove_colinear_dist2
-                && LinearAlg2D::getDist2FromLineSegment(parent_node->p_, p_, child_p->p_) < close_enough)
+            child = first_children_[node]; // recursive call to straighten might have removed the child
+            const LightningTreeNodeIdx parent = parents_[node];
+            if (parent != NO_LIGHTNING_TREE_NODE && vSize2(locations_[child] - locations_[parent]) < max_remove_colinear_dist2
+                && LinearAlg2D::getDist2FromLineSegment(locations_[parent], locations_[node], locations_[child]) < close_enough)
             {
-                child_p->parent_ = parent_;
-                for (auto& sibling : parent_node->children_)
-                { // find this node among siblings
-                    if (sibling == shared_from_this())
-                    {
-                        sibling = child_p; // replace this node by child
-                        break;
-                    }
-                }
+                replaceChild(parent, node, child); // replace this node by child
             }
         }
         return junction_below;
@@ -279,34 +302,36 @@ LightningTreeNode::RectilinearJunction
     else
     {
         constexpr coord_t weight = 1000;
-        Point2LL junction_moving_dir = normal(junction_above - p_, weight);
+        Point2LL junction_moving_dir = normal(junction_above - locations_[node], weight);
         bool prevent_junction_moving = false;
-        for (auto& child_p : children_)
+        LightningTreeNodeIdx next_child;
+        for (LightningTreeNodeIdx child = first_children_[node]; child != NO_LIGHTNING_TREE_NODE; child = next_child)
         {
-            const coord_t child_dist = vSize(p_ - child_p->p_);
-            RectilinearJunction below = child_p->straighten(magnitude, p_, child_dist, max_remove_colinear_dist2);
+            next_child = next_siblings_[child]; // The child might replace itself by its own child.
+            const coord_t child_dist = vSize(locations_[node] - locations_[child]);
+            RectilinearJunction below = straighten(child, magnitude, locations_[node], child_dist, max_remove_colinear_dist2);
 
-            junction_moving_dir += normal(below.junction_loc - p_, weight);
+            junction_moving_dir += normal(below.junction_loc - locations_[node], weight);
             if (below.total_recti_dist < magnitude) // TODO: make configurable?
             {
                 prevent_junction_moving = true; // prevent flipflopping in branches due to straightening and junctoin moving clashing
             }
         }
-        if (junction_moving_dir != Point2LL(0, 0) && ! children_.empty() && ! is_root_ && ! prevent_junction_moving)
+        if (junction_moving_dir != Point2LL(0, 0) && child_counts_[node] != 0 && ! isRoot(node) && ! prevent_junction_moving)
         {
             coord_t junction_moving_dir_len = vSize(junction_moving_dir);
             if (junction_moving_dir_len > junction_magnitude)
             {
                 junction_moving_dir = junction_moving_dir * junction_magnitude / junction_moving_dir_len;
             }
-            p_ += junction_moving_dir;
+            locations_[node] += junction_moving_dir;
         }
-        return RectilinearJunction{ accumulated_dist, p_ };
+        return RectilinearJunction{ accumulated_dist, locations_[node] };
     }
 }
 
 // Prune the tree from the extremeties (leaf-nodes) until the pruning distance is reached.
-coord_t LightningTreeNode::prune(const coord_t& pruning_distance)
+coord_t LightningTreeNodePool::prune(const LightningTreeNodeIdx node, const coord_t& pruning_distance)
 {
     if (pruning_distance <= 0)
     {
@@ -314,34 +339,33 @@ coord_t LightningTreeNode::prune(const coord_t& pruning_distance)
     }
 
     coord_t max_distance_pruned = 0;
-    for (auto child_it = children_.begin(); child_it != children_.end();)
+    LightningTreeNodeIdx next_child;
+    for (LightningTreeNodeIdx child = first_children_[node]; child != NO_LIGHTNING_TREE_NODE; child = next_child)
     {
-        auto& child = *child_it;
-        coord_t dist_pruned_child = child->prune(pruning_distance);
+        next_child = next_siblings_[child];
+        coord_t dist_pruned_child = prune(child, pruning_distance);
         if (dist_pruned_child >= pruning_distance)
         { // pruning is finished for child; dont modify further
             max_distance_pruned = std::max(max_distance_pruned, dist_pruned_child);
-            ++child_it;
         }
         else
         {
-            const Point2LL a = getLocation();
-            const Point2LL b = child->getLocation();
+            const Point2LL a = getLocation(node);
+            const Point2LL b = getLocation(child);
             const Point2LL ba = a - b;
             const coord_t ab_len = vSize(ba);
             if (dist_pruned_child + ab_len <= pruning_distance)
             { // we're still in the process of pruning
-                assert(child->children_.empty() && "when pruning away a node all it's children must already have been pruned away");
+                assert(child_counts_[child] == 0 && "when pruning away a node all it's children must already have been pruned away");
                 max_distance_pruned = std::max(max_distance_pruned, dist_pruned_child + ab_len);
-                child_it = children_.erase(child_it);
+                unlinkChild(node, child);
             }
             else
             { // pruning stops in between this node and the child
                 const Point2LL n = b + normal(ba, pruning_distance - dist_pruned_child);
                 assert(std::abs(vSize(n - b) + dist_pruned_child - pruning_distance) < 10 && "total pruned distance must be equal to the pruning_distance");
                 max_distance_pruned = std::max(max_distance_pruned, pruning_distance);
-                child->setLocation(n);
-                ++child_it;
+                setLocation(child, n);
             }
         }
     }
@@ -349,43 +373,38 @@ coord_t LightningTreeNode::prune(const coord_t& pruning_distance)
     return max_distance_pruned;
 }
 
-const std::optional<Point2LL>& LightningTreeNode::getLastGroundingLocation() const
-{
-    return last_grounding_location_;
-}
-
-void LightningTreeNode::convertToPolylines(Polygons& output, const coord_t line_width) const
+void LightningTreeNodePool::convertToPolylines(const LightningTreeNodeIdx root, Polygons& output, const coord_t line_width) const
 {
     Polygons result;
     result.newPoly();
-    convertToPolylines(0, result);
+    convertToPolylines(root, 0, result);
     removeJunctionOverlap(result, line_width);
     output.add(result);
 }
 
-void LightningTreeNode::convertToPolylines(size_t long_line_idx, Polygons& output) const
+void LightningTreeNodePool::convertToPolylines(const LightningTreeNodeIdx node, size_t long_line_idx, Polygons& output) const
 {
-    if (children_.empty())
+    const size_t child_count = child_counts_[node];
+    if (child_count == 0)
     {
-        output[long_line_idx].add(p_);
+        output[long_line_idx].add(locations_[node]);
         return;
     }
-    size_t first_child_idx = rand() % children_.size();
-    children_[first_child_idx]->convertToPolylines(long_line_idx, output);
-    output[long_line_idx].add(p_);
+    size_t first_child_idx = rand() % child_count;
+    convertToPolylines(getChild(node, first_child_idx), long_line_idx, output);
+    output[long_line_idx].add(locations_[node]);
 
-    for (size_t idx_offset = 1; idx_offset < children_.size(); idx_offset++)
+    for (size_t idx_offset = 1; idx_offset < child_count; idx_offset++)
     {
-        size_t child_idx = (first_child_idx + idx_offset) % children_.size();
-        const LightningTreeNode& child = *children_[child_idx];
+        size_t child_idx = (first_child_idx + idx_offset) % child_count;
         output.newPoly();
         size_t child_line_idx = output.size() - 1;
-        child.convertToPolylines(child_line_idx, output);
-        output[child_line_idx].add(p_);
+        convertToPolylines(getChild(node, child_idx), child_line_idx, output);
+        output[child_line_idx].add(locations_[node]);
     }
 }
 
-void LightningTreeNode::removeJunctionOverlap(Polygons& result_lines, const coord_t line_width) const
+void LightningTreeNodePool::removeJunctionOverlap(Polygons& result_lines, const coord_t line_width)
 {
     const coord_t reduction = line_width / 2; // TODO make configurable?
     for (auto poly_it = result_lines.begin(); poly_it != result_lines.end();)
@@ -429,3 +448,61 @@ void LightningTreeNode::removeJunctionOverlap(Polygons& result_lines, const coor
         }
     }
 }
+
+void LightningTreeNodePool::linkChild(const LightningTreeNodeIdx parent, const LightningTreeNodeIdx child)
+{
+    assert(isRoot(child) && next_siblings_[child] == NO_LIGHTNING_TREE_NODE && previous_siblings_[child] == NO_LIGHTNING_TREE_NODE);
+    parents_[child] = parent;
+    const LightningTreeNodeIdx last_child = last_children_[parent];
+    previous_siblings_[child] = last_child;
+    if (last_child == NO_LIGHTNING_TREE_NODE)
+    {
+        first_children_[parent] = child;
+    }
+    else
+    {
+        next_siblings_[last_child] = child;
+    }
+    last_children_[parent] = child;
+    child_counts_[parent]++;
+}
+
+void LightningTreeNodePool::unlinkChild(const LightningTreeNodeIdx parent, const LightningTreeNodeIdx child)
+{
+    assert(parents_[child] == parent);
+    const LightningTreeNodeIdx previous = previous_siblings_[child];
+    const LightningTreeNodeIdx next = next_siblings_[child];
+    (previous == NO_LIGHTNING_TREE_NODE ? first_children_[parent] : next_siblings_[previous]) = next;
+    (next == NO_LIGHTNING_TREE_NODE ? last_children_[parent] : previous_siblings_[next]) = previous;
+    parents_[child] = NO_LIGHTNING_TREE_NODE;
+    previous_siblings_[child] = NO_LIGHTNING_TREE_NODE;
+    next_siblings_[child] = NO_LIGHTNING_TREE_NODE;
+    child_counts_[parent]--;
+}
+
+void LightningTreeNodePool::replaceChild(const LightningTreeNodeIdx parent, const LightningTreeNodeIdx child, const LightningTreeNodeIdx replacement)
+{
+    assert(parents_[child] == parent && parents_[replacement] == child);
+    // Take the replacement out of the children of the node it replaces, that node is dropped from the tree.
+    unlinkChild(child, replacement);
+    const LightningTreeNodeIdx previous = previous_siblings_[child];
+    const LightningTreeNodeIdx next = next_siblings_[child];
+    (previous == NO_LIGHTNING_TREE_NODE ? first_children_[parent] : next_siblings_[previous]) = replacement;
+    (next == NO_LIGHTNING_TREE_NODE ? last_children_[parent] : previous_siblings_[next]) = replacement;
+    parents_[replacement] = parent;
+    previous_siblings_[replacement] = previous;
+    next_siblings_[replacement] = next;
+    parents_[child] = NO_LIGHTNING_TREE_NODE;
+    previous_siblings_[child] = NO_LIGHTNING_TREE_NODE;
+    next_siblings_[child] = NO_LIGHTNING_TREE_NODE;
+}
+
+LightningTreeNodeIdx LightningTreeNodePool::getChild(const LightningTreeNodeIdx parent, size_t child_idx) const
+{
+    LightningTreeNodeIdx child = first_children_[parent];
+    for (; child_idx > 0; child_idx--)
+    {
+        child = next_siblings_[child];
+    }
+    return child;
+}
@@ -23,6 +23,40 @@ coord_t SubDivCube::radius_addition_ = 0;
 Point3Matrix SubDivCube::rotation_matrix_;
 PointMatrix SubDivCube::infill_rotation_matrix_;
 
+SubDivCube::LayerInfillAreas::LayerInfillAreas(const SliceMeshStorage& mesh)
+    : mesh_(mesh)
+    , collected_(mesh.layers.size(), false)
+    , areas_(mesh.layers.size())
+    , indices_(mesh.layers.size())
+{
+}
+
+const Polygons& SubDivCube::LayerInfillAreas::getAreas(const LayerIndex layer_nr)
+{
+    collect(layer_nr);
+    return areas_[layer_nr];
+}
+
+const PreparedPolygons& SubDivCube::LayerInfillAreas::getIndex(const LayerIndex layer_nr)
+{
+    collect(layer_nr);
+    return indices_[layer_nr];
+}
+
+void SubDivCube::LayerInfillAreas::collect(const LayerIndex layer_nr)
+{
+    if (collected_[layer_nr])
+    {
+        return;
+    }
+    for (const SliceLayerPart& part : mesh_.layers[layer_nr].parts)
+    {
+        areas_[layer_nr].add(part.infill_area);
+    }
+    indices_[layer_nr] = PreparedPolygons(areas_[layer_nr]);
+    collected_[layer_nr] = true;
+}
+
 void SubDivCube::precomputeOctree(SliceMeshStorage& mesh, const Point2LL& infill_origin)
 {
     radius_addition_ = mesh.settings.get<coord_t>("sub_div_rad_add");
@@ -80,7 +114,9 @@ void SubDivCube::precomputeOctree(SliceMeshStorage& mesh, const Point2LL& infill
 
     rotation_matrix_ = infill_angle_mat.compose(tilt);
 
-    mesh.base_subdiv_cube = std::make_shared<SubDivCube>(mesh, center, curr_recursion_depth - 1);
+    // Building the octree tests many points against the infill areas of each layer, so collect those areas only once.
+    LayerInfillAreas infill_areas(mesh);
+    mesh.base_subdiv_cube = std::make_shared<SubDivCube>(mesh, infill_areas, center, curr_recursion_depth - 1);
 }
 
 void SubDivCube::generateSubdivisionLines(const coord_t z, Polygons& result)
@@ -145,7 +181,7 @@ void SubDivCube::generateSubdivisionLines(const coord_t z, Polygons (&directiona
     }
 }
 
-SubDivCube::SubDivCube(SliceMeshStorage& mesh, Point3LL& center, size_t depth)
+SubDivCube::SubDivCube(SliceMeshStorage& mesh, LayerInfillAreas& infill_areas, Point3LL& center, size_t depth)
     : depth_(depth)
     , center_(center)
 {
@@ -175,15 +211,15 @@ SubDivCube::SubDivCube(SliceMeshStorage& mesh, Point3LL& center, size_t depth)
     for (Point3LL rel_child_center : rel_child_centers)
     {
         child_center = center + rotation_matrix_.apply(rel_child_center * int32_t(cube_properties.side_length / 4));
-        if (isValidSubdivision(mesh, child_center, radius))
+        if (isValidSubdivision(mesh, infill_areas, child_center, radius))
         {
-            children_[child_nr] = std::make_shared<SubDivCube>(mesh, child_center, depth - 1);
+            children_[child_nr] = std::make_shared<SubDivCube>(mesh, infill_areas, child_center, depth - 1);
             child_nr++;
         }
     }
 }
 
-bool SubDivCube::isValidSubdivision(SliceMeshStorage& mesh, Point3LL& center, coord_t radius)
+bool SubDivCube::isValidSubdivision(SliceMeshStorage& mesh, LayerInfillAreas& infill_areas, Point3LL& center, coord_t radius)
 {
     coord_t distance2 = 0;
     coord_t sphere_slice_radius2; //!< squared radius of bounding sphere slice on target layer
@@ -200,7 +236,7 @@ bool SubDivCube::isValidSubdivision(SliceMeshStorage& mesh, Point3LL& center, co
         sphere_slice_radius2 = radius * radius * (1.0 - (part_dist * part_dist));
         Point2LL loc(center.x_, center.y_);
 
-        inside = distanceFromPointToMesh(mesh, test_layer, loc, &distance2);
+        inside = distanceFromPointToMesh(mesh, infill_areas, test_layer, loc, &distance2);
         if (inside == 1)
         {
             inside_somewhere = true;
@@ -221,21 +257,17 @@ bool SubDivCube::isValidSubdivision(SliceMeshStorage& mesh, Point3LL& center, co
     return false;
 }
 
-coord_t SubDivCube::distanceFromPointToMesh(SliceMeshStorage& mesh, const LayerIndex layer_nr, Point2LL& location, coord_t* distance2)
+coord_t SubDivCube::distanceFromPointToMesh(SliceMeshStorage& mesh, LayerInfillAreas& infill_areas, const LayerIndex layer_nr, Point2LL& location, coord_t* distance2)
 {
     if (layer_nr < 0 || (unsigned int)layer_nr >= mesh.layers.size()) //!< this layer is outside of valid range
     {
         return 2;
         *distance2 = 0;
     }
-    Polygons collide;
-    for (const SliceLayerPart& part : mesh.layers[layer_nr].parts)
-    {
-        collide.add(part.infill_area);
-    }
+    const Polygons& collide = infill_areas.getAreas(layer_nr);
 
     Point2LL centerpoint = location;
-    bool inside = collide.inside(centerpoint);
+    bool inside = infill_areas.getIndex(layer_nr).inside(centerpoint);
     ClosestPolygonPoint border_point = PolygonUtils::moveInside2(collide, centerpoint);
     Point2LL diff = border_point.location_ - location;
     *distance2 = vSize2(diff);
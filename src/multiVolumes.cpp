@@ -4,13 +4,16 @@
 #include "multiVolumes.h"
 
 #include <algorithm>
+#include <optional>
 
 #include "Application.h"
 #include "Slice.h"
 #include "settings/EnumSettings.h"
 #include "settings/types/LayerIndex.h"
 #include "slicer.h"
+#include "utils/AABB.h"
 #include "utils/PolylineStitcher.h"
+#include "utils/ThreadPool.h"
 
 namespace cura
 {
@@ -19,39 +22,83 @@ void carveMultipleVolumes(std::vector<Slicer*>& volumes)
 {
     // Go trough all the volumes, and remove the previous volume outlines from our own outline, so we never have overlapped areas.
     const bool alternate_carve_order = Application::getInstance().current_slice_->scene.current_mesh_group->settings.get<bool>("alternate_carve_order");
-    std::vector<Slicer*> ranked_volumes = volumes;
+
+    struct RankedVolume
+    {
+        Slicer* volume;
+        int infill_mesh_order;
+        bool is_carved; //!< Whether this volume takes part in the carving at all.
+    };
+    std::vector<RankedVolume> ranked_volumes;
+    ranked_volumes.reserve(volumes.size());
+    for (Slicer* volume : volumes)
+    {
+        const Settings& mesh_settings = volume->mesh->settings_;
+        ranked_volumes.push_back(RankedVolume{ .volume = volume,
+                                               .infill_mesh_order = mesh_settings.get<int>("infill_mesh_order"),
+                                               .is_carved = ! mesh_settings.get<bool>("infill_mesh") && ! mesh_settings.get<bool>("anti_overhang_mesh")
+                                                         && ! mesh_settings.get<bool>("support_mesh")
+                                                         && mesh_settings.get<ESurfaceMode>("magic_mesh_surface_mode") != ESurfaceMode::SURFACE });
+    }
     std::sort(
         ranked_volumes.begin(),
         ranked_volumes.end(),
-        [](Slicer* volume_1, Slicer* volume_2)
+        [](const RankedVolume& volume_1, const RankedVolume& volume_2)
         {
-            return volume_1->mesh->settings_.get<int>("infill_mesh_order") < volume_2->mesh->settings_.get<int>("infill_mesh_order");
+            return volume_1.infill_mesh_order < volume_2.infill_mesh_order;
         });
-    for (unsigned int volume_1_idx = 1; volume_1_idx < volumes.size(); volume_1_idx++)
+
+    // The pairs of volumes that may overlap, in the order in which they need to be carved.
+    std::vector<std::pair<size_t, size_t>> carve_pairs;
+    size_t layer_count = 0;
+    for (size_t volume_1_idx = 1; volume_1_idx < ranked_volumes.size(); volume_1_idx++)
     {
-        Slicer& volume_1 = *ranked_volumes[volume_1_idx];
-        if (volume_1.mesh->settings_.get<bool>("infill_mesh") || volume_1.mesh->settings_.get<bool>("anti_overhang_mesh") || volume_1.mesh->settings_.get<bool>("support_mesh")
-            || volume_1.mesh->settings_.get<ESurfaceMode>("magic_mesh_surface_mode") == ESurfaceMode::SURFACE)
+        if (! ranked_volumes[volume_1_idx].is_carved)
         {
             continue;
         }
-        for (unsigned int volume_2_idx = 0; volume_2_idx < volume_1_idx; volume_2_idx++)
+        const AABB3D volume_1_aabb = ranked_volumes[volume_1_idx].volume->mesh->getAABB();
+        for (size_t volume_2_idx = 0; volume_2_idx < volume_1_idx; volume_2_idx++)
         {
-            Slicer& volume_2 = *ranked_volumes[volume_2_idx];
-            if (volume_2.mesh->settings_.get<bool>("infill_mesh") || volume_2.mesh->settings_.get<bool>("anti_overhang_mesh") || volume_2.mesh->settings_.get<bool>("support_mesh")
-                || volume_2.mesh->settings_.get<ESurfaceMode>("magic_mesh_surface_mode") == ESurfaceMode::SURFACE)
+            if (! ranked_volumes[volume_2_idx].is_carved || ! volume_1_aabb.hit(ranked_volumes[volume_2_idx].volume->mesh->getAABB()))
             {
                 continue;
             }
-            if (! volume_1.mesh->getAABB().hit(volume_2.mesh->getAABB()))
+            carve_pairs.emplace_back(volume_1_idx, volume_2_idx);
+            layer_count = std::max(layer_count, ranked_volumes[volume_1_idx].volume->layers.size());
+        }
+    }
+
+    // Each layer is carved independently of the other layers, so the layers can be processed in parallel.
+    // Within a layer the pairs are carved in the same order as always, since the result depends on it.
+    cura::parallel_for<size_t>(
+        0,
+        layer_count,
+        [&](const size_t layer_nr)
+        {
+            // Bounding boxes of the layers, to skip pairs that don't overlap in this layer.
+            // They are computed lazily, so before or after earlier pairs carved this layer, but carving only shrinks the polygons, so they remain conservative.
+            std::vector<std::optional<AABB>> layer_aabbs(ranked_volumes.size());
+            const auto get_layer_aabb = [&](const size_t volume_idx) -> const AABB&
             {
-                continue;
-            }
-            for (LayerIndex layerNr = 0; layerNr < volume_1.layers.size(); layerNr++)
+                if (! layer_aabbs[volume_idx])
+                {
+                    layer_aabbs[volume_idx] = AABB(ranked_volumes[volume_idx].volume->layers[layer_nr].polygons);
+                }
+                return *layer_aabbs[volume_idx];
+            };
+
+            for (const auto& [volume_1_idx, volume_2_idx] : carve_pairs)
             {
-                SlicerLayer& layer1 = volume_1.layers[layerNr];
-                SlicerLayer& layer2 = volume_2.layers[layerNr];
-                if (alternate_carve_order && layerNr % 2 == 0 && volume_1.mesh->settings_.get<int>("infill_mesh_order") == volume_2.mesh->settings_.get<int>("infill_mesh_order"))
+                const RankedVolume& volume_1 = ranked_volumes[volume_1_idx];
+                const RankedVolume& volume_2 = ranked_volumes[volume_2_idx];
+                if (layer_nr >= volume_1.volume->layers.size() || ! get_layer_aabb(volume_1_idx).hit(get_layer_aabb(volume_2_idx)))
+                {
+                    continue;
+                }
+                SlicerLayer& layer1 = volume_1.volume->layers[layer_nr];
+                SlicerLayer& layer2 = volume_2.volume->layers[layer_nr];
+                if (alternate_carve_order && layer_nr % 2 == 0 && volume_1.infill_mesh_order == volume_2.infill_mesh_order)
                 {
                     layer2.polygons = layer2.polygons.difference(layer1.polygons);
                 }
@@ -60,8 +107,7 @@ void carveMultipleVolumes(std::vector<Slicer*>& volumes)
                     layer1.polygons = layer1.polygons.difference(layer2.polygons);
                 }
             }
-        }
-    }
+        });
 }
 
 // Expand each layer a bit and then keep the extra overlapping parts that overlap with other volumes.
@@ -39,6 +39,24 @@ Polygons& Comb::getBoundaryOutside(const ExtruderTrain& train)
     return boundary_outside_[train.extruder_nr_];
 }
 
+const PreparedPolygons& Comb::getOutsideIndex(const ExtruderTrain& train)
+{
+    if (outside_index_[train.extruder_nr_] == nullptr)
+    {
+        outside_index_[train.extruder_nr_] = std::make_unique<PreparedPolygons>(getBoundaryOutside(train));
+    }
+    return *outside_index_[train.extruder_nr_];
+}
+
+const PreparedPolygons& Comb::getInsideOptimalIndex()
+{
+    if (inside_optimal_index_ == nullptr)
+    {
+        inside_optimal_index_ = std::make_unique<PreparedPolygons>(boundary_inside_optimal_);
+    }
+    return *inside_optimal_index_;
+}
+
 Polygons& Comb::getModelBoundary(const ExtruderTrain& train)
 {
     if (model_boundary_[train.extruder_nr_].empty())
@@ -167,7 +185,7 @@ bool Comb::calc(
             -offset_dist_to_get_from_on_the_polygon_to_outside_,
             max_comb_distance_ignored,
             fail_on_unavoidable_obstacles);
-        Comb::moveCombPathInside(boundary_inside_minimum_, boundary_inside_optimal_, result_path, comb_paths.back()); // add altered result_path to combPaths.back()
+        Comb::moveCombPathInside(boundary_inside_minimum_, getInsideOptimalIndex(), result_path, comb_paths.back()); // add altered result_path to combPaths.back()
         // If the endpoint of the travel path changes with combing, then it means that we are moving to an outer wall
         // and we should unretract before the last travel move when travelling to that outer wall
         unretract_before_last_travel_move = comb_result && end_point != travel_end_point_before_combing;
@@ -374,7 +392,7 @@ bool Comb::calc(
 }
 
 // Try to move comb_path_input points inside by the amount of `move_inside_distance` and see if the points are still in boundary_inside_optimal, add result in comb_path_output
-void Comb::moveCombPathInside(Polygons& boundary_inside, Polygons& boundary_inside_optimal, CombPath& comb_path_input, CombPath& comb_path_output)
+void Comb::moveCombPathInside(Polygons& boundary_inside, const PreparedPolygons& boundary_inside_optimal, CombPath& comb_path_input, CombPath& comb_path_output)
 {
     const coord_t dist = move_inside_distance_;
     const coord_t dist2 = dist * dist;
@@ -516,7 +534,7 @@ void Comb::Crossing::findCrossingInOrMid(const PartsView& partsView_inside, cons
 bool Comb::Crossing::findOutside(const ExtruderTrain& train, const Polygons& outside, const Point2LL close_to, const bool fail_on_unavoidable_obstacles, Comb& comber)
 {
     out_ = in_or_mid_;
-    if (dest_is_inside_ || outside.inside(in_or_mid_, true)) // start in_between
+    if (dest_is_inside_ || comber.getOutsideIndex(train).inside(in_or_mid_, true)) // start in_between
     { // move outside
         Point2LL preferred_crossing_1_out = in_or_mid_ + normal(close_to - in_or_mid_, comber.offset_from_inside_to_outside_);
         std::function<int(Point2LL)> close_to_penalty_function(
@@ -14,6 +14,7 @@
 #include "infill/SierpinskiFillProvider.h"
 #include "infill/SubDivCube.h" // For the destructor
 #include "raft.h"
+#include "utils/ThreadPool.h"
 #include "utils/math.h" //For PI.
 
 
@@ -266,6 +267,16 @@ SliceDataStorage::SliceDataStorage()
     machine_size.include(machine_max);
 }
 
+SliceDataStorage::~SliceDataStorage()
+{
+    const size_t hits = layer_outlines_cache_.hits.load(std::memory_order_relaxed);
+    const size_t misses = layer_outlines_cache_.misses.load(std::memory_order_relaxed);
+    if (hits + misses > 0)
+    {
+        spdlog::debug("Layer outlines cache: {} hits, {} misses ({:.1f}% hit rate).", hits, misses, 100.0 * hits / (hits + misses));
+    }
+}
+
 Polygons
     SliceDataStorage::getLayerOutlines(const LayerIndex layer_nr, const bool include_support, const bool include_prime_tower, const bool external_polys_only, const int extruder_nr)
         const
@@ -300,20 +311,7 @@ Polygons
         Polygons total;
         if (layer_nr >= 0)
         {
-            for (const std::shared_ptr<SliceMeshStorage>& mesh : meshes)
-            {
-                if (mesh->settings.get<bool>("infill_mesh") || mesh->settings.get<bool>("anti_overhang_mesh")
-                    || (extruder_nr != -1 && extruder_nr != int(mesh->settings.get<ExtruderTrain&>("wall_0_extruder_nr").extruder_nr_)))
-                {
-                    continue;
-                }
-                const SliceLayer& layer = mesh->layers[layer_nr];
-                layer.getOutlines(total, external_polys_only);
-                if (mesh->settings.get<ESurfaceMode>("magic_mesh_surface_mode") != ESurfaceMode::NORMAL)
-                {
-                    total = total.unionPolygons(layer.openPolyLines.offsetPolyLine(MM2INT(0.1)));
-                }
-            }
+            total = *getMeshOutlines(layer_nr, external_polys_only, extruder_nr);
         }
         if (include_support && (extruder_nr == -1 || extruder_nr == int(mesh_group_settings.get<ExtruderTrain&>("support_infill_extruder_nr").extruder_nr_)))
         {
@@ -340,6 +338,92 @@ Polygons
     }
 }
 
+void SliceDataStorage::precomputeLayerOutlines(const bool external_polys_only, const int extruder_nr) const
+{
+    cura::parallel_for<size_t>(
+        0,
+        print_layer_count,
+        [&](const size_t layer_nr)
+        {
+            getMeshOutlines(layer_nr, external_polys_only, extruder_nr);
+        });
+}
+
+void SliceDataStorage::invalidateLayerOutlines()
+{
+    std::unique_lock lock(layer_outlines_cache_.mutex);
+    layer_outlines_cache_.outlines.clear();
+    layer_outlines_cache_.mesh_settings.clear();
+}
+
+uint64_t SliceDataStorage::getLayerOutlinesKey(const LayerIndex layer_nr, const bool external_polys_only, const int extruder_nr)
+{
+    return (static_cast<uint64_t>(layer_nr.value) << 16) | (static_cast<uint64_t>(extruder_nr + 1) << 1) | (external_polys_only ? 1 : 0);
+}
+
+std::shared_ptr<const Polygons> SliceDataStorage::getMeshOutlines(const LayerIndex layer_nr, const bool external_polys_only, const int extruder_nr) const
+{
+    const uint64_t key = getLayerOutlinesKey(layer_nr, external_polys_only, extruder_nr);
+    {
+        std::shared_lock lock(layer_outlines_cache_.mutex);
+        const auto cached = layer_outlines_cache_.outlines.find(key);
+        if (cached != layer_outlines_cache_.outlines.end())
+        {
+            layer_outlines_cache_.hits.fetch_add(1, std::memory_order_relaxed);
+            return cached->second;
+        }
+    }
+    layer_outlines_cache_.misses.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<MeshOutlineSettings> mesh_settings;
+    {
+        std::unique_lock lock(layer_outlines_cache_.mutex);
+        if (layer_outlines_cache_.mesh_settings.size() != meshes.size())
+        {
+            layer_outlines_cache_.mesh_settings.clear();
+            for (const std::shared_ptr<SliceMeshStorage>& mesh : meshes)
+            {
+                layer_outlines_cache_.mesh_settings.push_back(MeshOutlineSettings{
+                    .is_outline = ! mesh->settings.get<bool>("infill_mesh") && ! mesh->settings.get<bool>("anti_overhang_mesh"),
+                    .wall_0_extruder_nr = int(mesh->settings.get<ExtruderTrain&>("wall_0_extruder_nr").extruder_nr_),
+                    .is_surface_mode = mesh->settings.get<ESurfaceMode>("magic_mesh_surface_mode") != ESurfaceMode::NORMAL });
+            }
+        }
+        mesh_settings = layer_outlines_cache_.mesh_settings;
+    }
+
+    // Computed without holding the lock, so that other layers can be computed at the same time.
+    // The outlines up to the last surface mode mesh are unioned with the open polylines of the surface mode meshes, in a single sweep.
+    std::vector<Polygons> to_union;
+    auto total = std::make_shared<Polygons>();
+    for (size_t mesh_idx = 0; mesh_idx < meshes.size(); mesh_idx++)
+    {
+        const MeshOutlineSettings& settings = mesh_settings[mesh_idx];
+        if (! settings.is_outline || (extruder_nr != -1 && extruder_nr != settings.wall_0_extruder_nr))
+        {
+            continue;
+        }
+        const SliceLayer& layer = meshes[mesh_idx]->layers[layer_nr];
+        layer.getOutlines(*total, external_polys_only);
+        if (settings.is_surface_mode)
+        {
+            to_union.push_back(std::move(*total));
+            total->clear();
+            to_union.push_back(layer.openPolyLines.offsetPolyLine(MM2INT(0.1)));
+        }
+    }
+    if (! to_union.empty())
+    {
+        Polygons unioned = Polygons::unionAll(to_union);
+        unioned.add(*total);
+        *total = std::move(unioned);
+    }
+
+    std::unique_lock lock(layer_outlines_cache_.mutex);
+    // If another thread computed the same outlines in the meantime, keep those.
+    return layer_outlines_cache_.outlines.emplace(key, std::move(total)).first->second;
+}
+
 std::vector<bool> SliceDataStorage::getExtrudersUsed() const
 {
     std::vector<bool> ret;
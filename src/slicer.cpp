@@ -4,6 +4,7 @@
 #include "slicer.h"
 
 #include <algorithm> // remove_if
+#include <limits>
 #include <numbers>
 #include <stdio.h>
 
@@ -38,8 +39,9 @@ void SlicerLayer::makeBasicPolygonLoops(Polygons& open_polylines)
             makeBasicPolygonLoop(open_polylines, start_segment_idx);
         }
     }
-    // Clear the segmentList to save memory, it is no longer needed after this point.
+    // Release the segments to save memory, they are no longer needed after this point.
     segments.clear();
+    segments.shrink_to_fit();
 }
 
 void SlicerLayer::makeBasicPolygonLoop(Polygons& open_polylines, const size_t start_segment_idx)
@@ -65,12 +67,18 @@ void SlicerLayer::makeBasicPolygonLoop(Polygons& open_polylines, const size_t st
 
 int SlicerLayer::tryFaceNextSegmentIdx(const SlicerSegment& segment, const int face_idx, const size_t start_segment_idx) const
 {
-    decltype(face_idx_to_segment_idx.begin()) it;
-    auto it_end = face_idx_to_segment_idx.end();
-    it = face_idx_to_segment_idx.find(face_idx);
-    if (it != it_end)
+    // The segments are sorted by face index, and each face generates at most one segment.
+    const auto it = std::lower_bound(
+        segments.begin(),
+        segments.end(),
+        face_idx,
+        [](const SlicerSegment& candidate, const int idx)
+        {
+            return candidate.faceIndex < idx;
+        });
+    if (it != segments.end() && it->faceIndex == face_idx)
     {
-        const int segment_idx = (*it).second;
+        const int segment_idx = static_cast<int>(it - segments.begin());
         Point2LL p1 = segments[segment_idx].start;
         Point2LL diff = segment.end - p1;
         if (shorterThen(diff, largest_neglected_gap_first_phase))
@@ -828,7 +836,7 @@ Slicer::Slicer(Mesh* i_mesh, const coord_t thickness, const size_t slice_layer_c
 
     std::vector<std::pair<int32_t, int32_t>> zbbox = buildZHeightsForFaces(*mesh);
 
-    buildSegments(*mesh, zbbox, slicing_tolerance, layers);
+    sliceLayers(*mesh, zbbox, slicing_tolerance, layers);
 
     spdlog::info("Slice of mesh took {:03.3f} seconds", slice_timer.restart());
 
@@ -837,136 +845,183 @@ Slicer::Slicer(Mesh* i_mesh, const coord_t thickness, const size_t slice_layer_c
     spdlog::info("Make polygons took {:03.3f} seconds", slice_timer.restart());
 }
 
-void Slicer::buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t, int32_t>>& zbbox, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers)
+void Slicer::sliceLayers(const Mesh& mesh, const std::vector<std::pair<int32_t, int32_t>>& zbbox, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers)
 {
-    cura::parallel_for(
-        layers,
-        [&](auto layer_it)
+    // Enough bands to keep all threads busy, while scanning all faces of the mesh only once per band instead of once per layer.
+    constexpr size_t bands_per_worker = 4;
+    const size_t worker_count = Application::getInstance().thread_pool_->thread_count() + 1;
+    const size_t band_count = std::min(layers.size(), bands_per_worker * worker_count);
+    if (band_count == 0)
+    {
+        return;
+    }
+    const size_t layers_per_band = round_up_divide(layers.size(), band_count);
+
+    cura::parallel_for<size_t>(
+        0,
+        band_count,
+        [&](const size_t band_idx)
         {
-            SlicerLayer& layer = *layer_it;
-            const int32_t& z = layer.z;
-            layer.segments.reserve(100);
+            const size_t band_start = band_idx * layers_per_band;
+            const size_t band_end = std::min(band_start + layers_per_band, layers.size());
+            if (band_start >= band_end)
+            {
+                return;
+            }
 
-            // loop over all mesh faces
-            for (unsigned int mesh_idx = 0; mesh_idx < mesh.faces_.size(); mesh_idx++)
+            int32_t band_min_z = std::numeric_limits<int32_t>::max();
+            int32_t band_max_z = std::numeric_limits<int32_t>::lowest();
+            for (size_t layer_idx = band_start; layer_idx < band_end; layer_idx++)
+            {
+                band_min_z = std::min(band_min_z, static_cast<int32_t>(layers[layer_idx].z));
+                band_max_z = std::max(band_max_z, static_cast<int32_t>(layers[layer_idx].z));
+            }
+            std::vector<uint32_t> band_face_indices;
+            for (uint32_t face_idx = 0; face_idx < zbbox.size(); face_idx++)
             {
-                if ((z < zbbox[mesh_idx].first) || (z > zbbox[mesh_idx].second))
+                if (zbbox[face_idx].second >= band_min_z && zbbox[face_idx].first <= band_max_z)
                 {
-                    continue;
+                    band_face_indices.push_back(face_idx);
                 }
+            }
 
-                // get all vertices per face
-                const MeshFace& face = mesh.faces_[mesh_idx];
-                const MeshVertex& v0 = mesh.vertices_[face.vertex_index_[0]];
-                const MeshVertex& v1 = mesh.vertices_[face.vertex_index_[1]];
-                const MeshVertex& v2 = mesh.vertices_[face.vertex_index_[2]];
+            for (size_t layer_idx = band_start; layer_idx < band_end; layer_idx++)
+            {
+                SlicerLayer& layer = layers[layer_idx];
+                buildSegments(mesh, zbbox, band_face_indices, slicing_tolerance, layer);
+                layer.makePolygons(&mesh); // Also releases the segments again.
+            }
+        });
+}
 
-                // get all vertices represented as 3D point
-                Point3LL p0 = v0.p_;
-                Point3LL p1 = v1.p_;
-                Point3LL p2 = v2.p_;
+void Slicer::buildSegments(
+    const Mesh& mesh,
+    const std::vector<std::pair<int32_t, int32_t>>& zbbox,
+    const std::vector<uint32_t>& face_indices,
+    const SlicingTolerance& slicing_tolerance,
+    SlicerLayer& layer)
+{
+    const int32_t& z = layer.z;
+    layer.segments.reserve(100);
 
-                // Compensate for points exactly on the slice-boundary, except for 'inclusive', which already handles this correctly.
-                if (slicing_tolerance != SlicingTolerance::INCLUSIVE)
-                {
-                    p0.z_ += static_cast<int>(p0.z_ == z) * -static_cast<int>(p0.z_ < 1);
-                    p1.z_ += static_cast<int>(p1.z_ == z) * -static_cast<int>(p1.z_ < 1);
-                    p2.z_ += static_cast<int>(p2.z_ == z) * -static_cast<int>(p2.z_ < 1);
-                }
+    // loop over the mesh faces, in ascending order so that the segments are sorted by face
+    for (const uint32_t mesh_idx : face_indices)
+    {
+        if ((z < zbbox[mesh_idx].first) || (z > zbbox[mesh_idx].second))
+        {
+            continue;
+        }
 
-                SlicerSegment s;
-                s.endVertex = nullptr;
-                int end_edge_idx = -1;
-
-                /*
-                Now see if the triangle intersects the layer, and if so, where.
-
-                Edge cases are important here:
-                - If all three vertices of the triangle are exactly on the layer,
-                  don't count the triangle at all, because if the model is
-                  watertight, there will be adjacent triangles on all 3 sides that
-                  are not flat on the layer.
-                - If two of the vertices are exactly on the layer, only count the
-                  triangle if the last vertex is going up. We can't count both
-                  upwards and downwards triangles here, because if the model is
-                  manifold there will always be an adjacent triangle that is going
-                  the other way and you'd get double edges. You would also get one
-                  layer too many if the total model height is an exact multiple of
-                  the layer thickness. Between going up and going down, we need to
-                  choose the triangles going up, because otherwise the first layer
-                  of where the model starts will be empty and the model will float
-                  in mid-air. We'd much rather let the last layer be empty in that
-                  case.
-                - If only one of the vertices is exactly on the layer, the
-                  intersection between the triangle and the plane would be a point.
-                  We can't print points and with a manifold model there would be
-                  line segments adjacent to the point on both sides anyway, so we
-                  need to discard this 0-length line segment then.
-                - Vertices in ccw order if look from outside.
-                */
-
-                if (p0.z_ < z && p1.z_ > z && p2.z_ > z) //  1_______2
-                { //   \     /
-                    s = project2D(p0, p2, p1, z); //------------- z
-                    end_edge_idx = 0; //     \ /
-                } //      0
-
-                else if (p0.z_ > z && p1.z_ <= z && p2.z_ <= z) //      0
-                { //     / \      .
-                    s = project2D(p0, p1, p2, z); //------------- z
-                    end_edge_idx = 2; //   /     \    .
-                    if (p2.z_ == z) //  1_______2
-                    {
-                        s.endVertex = &v2;
-                    }
-                }
+        // get all vertices per face
+        const MeshFace& face = mesh.faces_[mesh_idx];
+        const MeshVertex& v0 = mesh.vertices_[face.vertex_index_[0]];
+        const MeshVertex& v1 = mesh.vertices_[face.vertex_index_[1]];
+        const MeshVertex& v2 = mesh.vertices_[face.vertex_index_[2]];
 
-                else if (p1.z_ < z && p0.z_ > z && p2.z_ > z) //  0_______2
-                { //   \     /
-                    s = project2D(p1, p0, p2, z); //------------- z
-                    end_edge_idx = 1; //     \ /
-                } //      1
-
-                else if (p1.z_ > z && p0.z_ <= z && p2.z_ <= z) //      1
-                { //     / \      .
-                    s = project2D(p1, p2, p0, z); //------------- z
-                    end_edge_idx = 0; //   /     \    .
-                    if (p0.z_ == z) //  0_______2
-                    {
-                        s.endVertex = &v0;
-                    }
-                }
+        // get all vertices represented as 3D point
+        Point3LL p0 = v0.p_;
+        Point3LL p1 = v1.p_;
+        Point3LL p2 = v2.p_;
 
-                else if (p2.z_ < z && p1.z_ > z && p0.z_ > z) //  0_______1
-                { //   \     /
-                    s = project2D(p2, p1, p0, z); //------------- z
-                    end_edge_idx = 2; //     \ /
-                } //      2
-
-                else if (p2.z_ > z && p1.z_ <= z && p0.z_ <= z) //      2
-                { //     / \      .
-                    s = project2D(p2, p0, p1, z); //------------- z
-                    end_edge_idx = 1; //   /     \    .
-                    if (p1.z_ == z) //  0_______1
-                    {
-                        s.endVertex = &v1;
-                    }
-                }
-                else
-                {
-                    // Not all cases create a segment, because a point of a face could create just a dot, and two touching faces
-                    //   on the slice would create two segments
-                    continue;
-                }
+        // Compensate for points exactly on the slice-boundary, except for 'inclusive', which already handles this correctly.
+        if (slicing_tolerance != SlicingTolerance::INCLUSIVE)
+        {
+            p0.z_ += static_cast<int>(p0.z_ == z) * -static_cast<int>(p0.z_ < 1);
+            p1.z_ += static_cast<int>(p1.z_ == z) * -static_cast<int>(p1.z_ < 1);
+            p2.z_ += static_cast<int>(p2.z_ == z) * -static_cast<int>(p2.z_ < 1);
+        }
 
-                // store the segments per layer
-                layer.face_idx_to_segment_idx.insert(std::make_pair(mesh_idx, layer.segments.size()));
-                s.faceIndex = mesh_idx;
-                s.endOtherFaceIdx = face.connected_face_index_[end_edge_idx];
-                s.addedToPolygon = false;
-                layer.segments.push_back(s);
+        SlicerSegment s;
+        s.endVertex = nullptr;
+        int end_edge_idx = -1;
+
+        /*
+        Now see if the triangle intersects the layer, and if so, where.
+
+        Edge cases are important here:
+        - If all three vertices of the triangle are exactly on the layer,
+          don't count the triangle at all, because if the model is
+          watertight, there will be adjacent triangles on all 3 sides that
+          are not flat on the layer.
+        - If two of the vertices are exactly on the layer, only count the
+          triangle if the last vertex is going up. We can't count both
+          upwards and downwards triangles here, because if the model is
+          manifold there will always be an adjacent triangle that is going
+          the other way and you'd get double edges. You would also get one
+          layer too many if the total model height is an exact multiple of
+          the layer thickness. Between going up and going down, we need to
+          choose the triangles going up, because otherwise the first layer
+          of where the model starts will be empty and the model will float
+          in mid-air. We'd much rather let the last layer be empty in that
+          case.
+        - If only one of the vertices is exactly on the layer, the
+          intersection between the triangle and the plane would be a point.
+          We can't print points and with a manifold model there would be
+          line segments adjacent to the point on both sides anyway, so we
+          need to discard this 0-length line segment then.
+        - Vertices in ccw order if look from outside.
+        */
+
+        if (p0.z_ < z && p1.z_ > z && p2.z_ > z) //  1_______2
+        { //   \     /
+            s = project2D(p0, p2, p1, z); //------------- z
+            end_edge_idx = 0; //     \ /
+        } //      0
+
+        else if (p0.z_ > z && p1.z_ <= z && p2.z_ <= z) //      0
+        { //     / \      .
+            s = project2D(p0, p1, p2, z); //------------- z
+            end_edge_idx = 2; //   /     \    .
+            if (p2.z_ == z) //  1_______2
+            {
+                s.endVertex = &v2;
             }
-        });
+        }
+
+        else if (p1.z_ < z && p0.z_ > z && p2.z_ > z) //  0_______2
+        { //   \     /
+            s = project2D(p1, p0, p2, z); //------------- z
+            end_edge_idx = 1; //     \ /
+        } //      1
+
+        else if (p1.z_ > z && p0.z_ <= z && p2.z_ <= z) //      1
+        { //     / \      .
+            s = project2D(p1, p2, p0, z); //------------- z
+            end_edge_idx = 0; //   /     \    .
+            if (p0.z_ == z) //  0_______2
+            {
+                s.endVertex = &v0;
+            }
+        }
+
+        else if (p2.z_ < z && p1.z_ > z && p0.z_ > z) //  0_______1
+        { //   \     /
+            s = project2D(p2, p1, p0, z); //------------- z
+            end_edge_idx = 2; //     \ /
+        } //      2
+
+        else if (p2.z_ > z && p1.z_ <= z && p0.z_ <= z) //      2
+        { //     / \      .
+            s = project2D(p2, p0, p1, z); //------------- z
+            end_edge_idx = 1; //   /     \    .
+            if (p1.z_ == z) //  0_______1
+            {
+                s.endVertex = &v1;
+            }
+        }
+        else
+        {
+            // Not all cases create a segment, because a point of a face could create just a dot, and two touching faces
+            //   on the slice would create two segments
+            continue;
+        }
+
+        // store the segments per layer
+        s.faceIndex = mesh_idx;
+        s.endOtherFaceIdx = face.connected_face_index_[end_edge_idx];
+        s.addedToPolygon = false;
+        layer.segments.push_back(s);
+    }
 }
 
 std::vector<SlicerLayer> Slicer::buildLayersWithHeight(
@@ -1012,13 +1067,6 @@ std::vector<SlicerLayer> Slicer::buildLayersWithHeight(
 
 void Slicer::makePolygons(Mesh& mesh, SlicingTolerance slicing_tolerance, std::vector<SlicerLayer>& layers)
 {
-    cura::parallel_for(
-        layers,
-        [&mesh](auto layer_it)
-        {
-            layer_it->makePolygons(&mesh);
-        });
-
     switch (slicing_tolerance)
     {
     case SlicingTolerance::INCLUSIVE:
@@ -33,6 +33,8 @@
 #include "settings/types/Ratio.h"
 #include "sliceDataStorage.h"
 #include "slicer.h"
+#include "utils/AABB.h"
+#include "utils/ClipperStatistics.h"
 #include "utils/Simplify.h"
 #include "utils/ThreadPool.h"
 #include "utils/VoronoiUtils.h"
@@ -457,10 +459,8 @@ void AreaSupport::cleanup(SliceDataStorage& storage)
     }
 }
 
-Polygons AreaSupport::join(const SliceDataStorage& storage, const Polygons& supportLayer_up, Polygons& supportLayer_this)
+AreaSupport::JoinSettings AreaSupport::getJoinSettings(const SliceDataStorage& storage)
 {
-    Polygons joined;
-
     const Settings& infill_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings.get<ExtruderTrain&>("support_infill_extruder_nr").settings_;
     const AngleRadians conical_support_angle = infill_settings.get<AngleRadians>("support_conical_angle");
     const coord_t layer_thickness = infill_settings.get<coord_t>("layer_height");
@@ -474,11 +474,12 @@ Polygons AreaSupport::join(const SliceDataStorage& storage, const Polygons& supp
         conical_support_offset = (tan(-conical_support_angle) - 0.01) * layer_thickness;
     }
     const bool conical_support = infill_settings.get<bool>("support_conical_enabled") && conical_support_angle != 0;
+    Polygons machine_volume_border;
+    coord_t conical_smallest_breadth = 0;
     if (conical_support)
     {
         const Settings& mesh_group_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
         // Don't go outside the build volume.
-        Polygons machine_volume_border;
         switch (mesh_group_settings.get<BuildPlateShape>("machine_shape"))
         {
         case BuildPlateShape::ELLIPTIC:
@@ -554,11 +555,30 @@ Polygons AreaSupport::join(const SliceDataStorage& storage, const Polygons& supp
             break;
         }
         machine_volume_border = machine_volume_border.offset(-adhesion_size);
+        conical_smallest_breadth = infill_settings.get<coord_t>("support_conical_min_width");
+    }
 
-        const coord_t conical_smallest_breadth = infill_settings.get<coord_t>("support_conical_min_width");
+    return JoinSettings{ .conical_support = conical_support,
+                         .conical_support_offset = conical_support_offset,
+                         .conical_smallest_breadth = conical_smallest_breadth,
+                         .machine_volume_border = std::move(machine_volume_border),
+                         .join_distance = infill_settings.get<coord_t>("support_join_distance"),
+                         .min_even_wall_line_width = infill_settings.get<coord_t>("min_even_wall_line_width"),
+                         .simplify = Simplify(infill_settings) };
+}
+
+Polygons AreaSupport::join(const JoinSettings& join_settings, const Polygons& supportLayer_up, Polygons& supportLayer_this)
+{
+    Polygons joined;
+
+    if (join_settings.conical_support)
+    {
+        const coord_t conical_smallest_breadth = join_settings.conical_smallest_breadth;
         Polygons insetted = supportLayer_up.offset(-conical_smallest_breadth / 2);
         Polygons small_parts = supportLayer_up.difference(insetted.offset(conical_smallest_breadth / 2 + 20));
-        joined = supportLayer_this.unionPolygons(supportLayer_up.offset(conical_support_offset)).unionPolygons(small_parts).intersection(machine_volume_border);
+        joined = supportLayer_this.unionPolygons(supportLayer_up.offset(join_settings.conical_support_offset))
+                     .unionPolygons(small_parts)
+                     .intersection(join_settings.machine_volume_border);
     }
     else
     {
@@ -566,14 +586,13 @@ Polygons AreaSupport::join(const SliceDataStorage& storage, const Polygons& supp
     }
 
     // join different parts
-    const coord_t join_distance = infill_settings.get<coord_t>("support_join_distance");
+    const coord_t join_distance = join_settings.join_distance;
     if (join_distance > 0)
     {
         // first offset the layer a little inwards; this way tiny area's will not be joined
         // (narrow areas; ergo small areas will be removed in a later step using this same offset)
         // this inwards offset is later reversed by increasing the outwards offset
-        const coord_t min_even_wall_line_width = infill_settings.get<coord_t>("min_even_wall_line_width");
-        auto half_min_feature_width = min_even_wall_line_width + 10;
+        auto half_min_feature_width = join_settings.min_even_wall_line_width + 10;
 
         joined = joined.offset(-half_min_feature_width)
                      .offset(join_distance + half_min_feature_width, ClipperLib::jtRound)
@@ -581,14 +600,14 @@ Polygons AreaSupport::join(const SliceDataStorage& storage, const Polygons& supp
                      .unionPolygons(joined);
     }
 
-    const Simplify simplify(infill_settings);
-    joined = simplify.polygon(joined);
+    joined = join_settings.simplify.polygon(joined);
 
     return joined;
 }
 
 void AreaSupport::generateOverhangAreas(SliceDataStorage& storage)
 {
+    const ClipperStage clipper_stage("support");
     for (std::shared_ptr<SliceMeshStorage>& mesh_ptr : storage.meshes)
     {
         auto& mesh = *mesh_ptr;
@@ -603,6 +622,7 @@ void AreaSupport::generateOverhangAreas(SliceDataStorage& storage)
 
 void AreaSupport::generateSupportAreas(SliceDataStorage& storage)
 {
+    const ClipperStage clipper_stage("support");
     std::vector<Polygons> global_support_areas_per_layer;
     global_support_areas_per_layer.resize(storage.print_layer_count);
 
@@ -1143,58 +1163,83 @@ void AreaSupport::generateSupportAreasForMesh(
 
     // Post-process the sloped areas's. (Skip if no stair-stepping anyway.)
     // The idea here is to 'add up' all the sloped 'areas' so they form actual areas per each stair-step height.
-    // (Only the 'top' sloped area for each step is actually used in the end, see 'moveUpFromModel'.)
+    // Only the 'top' sloped area for each step is actually used in the end (see 'moveUpFromModel'), so each step is a single union of the sloped areas of its layers.
+    // The sloped areas of the other layers are moved into that union, and are left empty.
     if (bottom_stair_step_layer_count > 1)
     {
-        // We can parallelize this part, which is needed since these are potentially expensive operations,
-        // but only in chunks of `bottom_stair_step_layer_count` steps, since, within such a chunk,
-        // the order of execution is important.
-        // Unless thinking about optimization & threading, you can just think of this as a single for-loop.
         cura::parallel_for<size_t>(
             1,
-            layer_count,
-            [&](const size_t layer_idx)
+            layer_count / bottom_stair_step_layer_count + 1,
+            [&](const size_t step_idx)
             {
-                // Add the sloped areas together for each stair of the stair stepping.
-                // Start a new stair every modulo bottom_stair_step_layer_count steps.
-                if (layer_idx % bottom_stair_step_layer_count != 1)
+                // A new stair starts every modulo bottom_stair_step_layer_count steps, at the layer after the top of the previous stair.
+                const size_t top_layer_idx = step_idx * bottom_stair_step_layer_count;
+                if (top_layer_idx >= layer_count)
                 {
-                    sloped_areas_per_layer[layer_idx] = sloped_areas_per_layer[layer_idx].unionPolygons(sloped_areas_per_layer[layer_idx - 1]);
+                    return;
                 }
-            },
-            bottom_stair_step_layer_count);
+                std::vector<Polygons> step_sloped_areas(
+                    std::make_move_iterator(sloped_areas_per_layer.begin() + top_layer_idx - bottom_stair_step_layer_count + 1),
+                    std::make_move_iterator(sloped_areas_per_layer.begin() + top_layer_idx + 1));
+                sloped_areas_per_layer[top_layer_idx] = Polygons::unionAll(step_sloped_areas);
+            });
     }
 
-    for (size_t layer_idx = layer_count - 1 - layer_z_distance_top; layer_idx != static_cast<size_t>(-1); layer_idx--)
-    {
-        Polygons layer_this = mesh.full_overhang_areas[layer_idx + layer_z_distance_top];
-
-        if (extension_offset && ! is_support_mesh_place_holder)
+    // Everything a layer needs from the model and from its own overhang doesn't depend on the support of the layers above it, so compute that up front
+    // in parallel. The top-down loop below then only carries the joining with the layer above and the towers from layer to layer.
+    const JoinSettings join_settings = getJoinSettings(storage);
+    const size_t top_layer_idx = layer_count - 1 - layer_z_distance_top;
+    std::vector<Polygons> model_outlines_per_layer(top_layer_idx + 1);
+    std::vector<Polygons> overhang_per_layer(top_layer_idx + 1);
+    cura::parallel_for<size_t>(
+        0,
+        top_layer_idx + 1,
+        [&](const size_t layer_idx)
         {
-            // To avoid that the support is folding around the model, the support horizontal expansion should not cause
-            // the support to grow towards the model. Stepwise applying the support horizontal expansion to both the
-            // model outline and the support is effectively calculating a voronoi. The offset is first applied to
-            // the support and next to the model to ensure that the expanded support area is connected to the original
-            // support area. Please note that the horizontal expansion is rounded down to an integer offset_per_step.
-            Polygons model_outline = storage.getLayerOutlines(layer_idx, no_support, no_prime_tower);
-            const coord_t offset_per_step = support_line_width / 2;
-
-            // perform a small offset we don't enlarge small features of the support
-            Polygons horizontal_expansion = layer_this;
-            for (coord_t offset_cumulative = 0; offset_cumulative <= extension_offset; offset_cumulative += offset_per_step)
+            if ((extension_offset && ! is_support_mesh_place_holder) || (layer_idx > 0 && ! is_support_mesh_nondrop_place_holder))
             {
-                horizontal_expansion = horizontal_expansion.offset(offset_per_step);
-                model_outline = model_outline.difference(horizontal_expansion);
-                model_outline = model_outline.offset(offset_per_step);
-                horizontal_expansion = horizontal_expansion.difference(model_outline);
+                model_outlines_per_layer[layer_idx] = storage.getLayerOutlines(layer_idx, no_support, no_prime_tower);
+            }
+
+            Polygons layer_this = mesh.full_overhang_areas[layer_idx + layer_z_distance_top];
+
+            if (extension_offset && ! is_support_mesh_place_holder)
+            {
+                // To avoid that the support is folding around the model, the support horizontal expansion should not cause
+                // the support to grow towards the model. Stepwise applying the support horizontal expansion to both the
+                // model outline and the support is effectively calculating a voronoi. The offset is first applied to
+                // the support and next to the model to ensure that the expanded support area is connected to the original
+                // support area. Please note that the horizontal expansion is rounded down to an integer offset_per_step.
+                Polygons model_outline = model_outlines_per_layer[layer_idx];
+                const coord_t offset_per_step = support_line_width / 2;
+
+                // perform a small offset we don't enlarge small features of the support
+                Polygons horizontal_expansion = layer_this;
+                for (coord_t offset_cumulative = 0; offset_cumulative <= extension_offset; offset_cumulative += offset_per_step)
+                {
+                    horizontal_expansion = horizontal_expansion.offset(offset_per_step);
+                    model_outline = model_outline.difference(horizontal_expansion);
+                    model_outline = model_outline.offset(offset_per_step);
+                    horizontal_expansion = horizontal_expansion.difference(model_outline);
+                }
+                layer_this = layer_this.unionPolygons(horizontal_expansion);
             }
-            layer_this = layer_this.unionPolygons(horizontal_expansion);
-        }
+
+            if (use_towers && ! is_support_mesh_place_holder)
+            {
+                // handle straight walls
+                AreaSupport::handleWallStruts(infill_settings, layer_this);
+            }
+            overhang_per_layer[layer_idx] = std::move(layer_this);
+        });
+
+    for (size_t layer_idx = top_layer_idx; layer_idx != static_cast<size_t>(-1); layer_idx--)
+    {
+        Polygons layer_this = std::move(overhang_per_layer[layer_idx]);
+        const Polygons model_outline = std::move(model_outlines_per_layer[layer_idx]);
 
         if (use_towers && ! is_support_mesh_place_holder)
         {
-            // handle straight walls
-            AreaSupport::handleWallStruts(infill_settings, layer_this);
             // handle towers
             AreaSupport::handleTowers(infill_settings, xy_disallowed_per_layer[layer_idx], layer_this, tower_roofs, mesh.overhang_points, layer_idx, layer_count);
         }
@@ -1203,14 +1248,13 @@ void AreaSupport::generateSupportAreasForMesh(
         { // join with support from layer up
             const Polygons empty;
             const Polygons* layer_above = (layer_idx < support_areas.size()) ? &support_areas[layer_idx + 1] : &empty;
-            const Polygons model_mesh_on_layer
-                = (layer_idx > 0) && ! is_support_mesh_nondrop_place_holder ? storage.getLayerOutlines(layer_idx, no_support, no_prime_tower) : empty;
+            const Polygons& model_mesh_on_layer = (layer_idx > 0) && ! is_support_mesh_nondrop_place_holder ? model_outline : empty;
             if (is_support_mesh_nondrop_place_holder)
             {
                 layer_above = &empty;
                 layer_this = layer_this.unionPolygons(storage.support.supportLayers[layer_idx].support_mesh);
             }
-            layer_this = AreaSupport::join(storage, *layer_above, layer_this).difference(model_mesh_on_layer);
+            layer_this = AreaSupport::join(join_settings, *layer_above, layer_this).difference(model_mesh_on_layer);
         }
 
         // make towers for small support
@@ -1341,18 +1385,46 @@ void AreaSupport::generateSupportAreasForMesh(
             });
     }
 
-    // Procedure to remove floating support
+    // Procedure to remove floating support: only keep the support that overlaps with the support in the layer above or below.
+    // Filtering the layer below first only removes areas from it that don't overlap with this layer, so it doesn't change what remains of this layer.
+    // Therefore all layers can be filtered independently against the unfiltered layers around them.
+    std::vector<AABB> support_area_boxes(layer_count);
+    cura::parallel_for<size_t>(
+        0,
+        layer_count,
+        [&](const size_t layer_idx)
+        {
+            support_area_boxes[layer_idx] = AABB(support_areas[layer_idx]);
+        });
+    std::vector<Polygons> non_floating_support_areas(layer_count);
+    cura::parallel_for<size_t>(
+        1,
+        layer_count - 1,
+        [&](const size_t layer_idx)
+        {
+            const Polygons& layer_this = support_areas[layer_idx];
+            if (layer_this.empty())
+            {
+                return;
+            }
+            // Only the neighbouring layers whose bounding box hits this layer can have any overlap with it.
+            Polygons surrounding_layer;
+            if (support_area_boxes[layer_idx].hit(support_area_boxes[layer_idx - 1]))
+            {
+                surrounding_layer.add(support_areas[layer_idx - 1]);
+            }
+            if (support_area_boxes[layer_idx].hit(support_area_boxes[layer_idx + 1]))
+            {
+                surrounding_layer.add(support_areas[layer_idx + 1]);
+            }
+            if (! surrounding_layer.empty())
+            {
+                non_floating_support_areas[layer_idx] = layer_this.intersection(surrounding_layer.unionPolygons());
+            }
+        });
     for (size_t layer_idx = 1; layer_idx < layer_count - 1; layer_idx++)
     {
-        Polygons& layer_this = support_areas[layer_idx];
-
-        if (! layer_this.empty())
-        {
-            Polygons& layer_below = support_areas[layer_idx - 1];
-            Polygons& layer_above = support_areas[layer_idx + 1];
-            Polygons surrounding_layer = layer_above.unionPolygons(layer_below);
-            layer_this = layer_this.intersection(surrounding_layer);
-        }
+        support_areas[layer_idx] = std::move(non_floating_support_areas[layer_idx]);
     }
 
     for (size_t layer_idx = support_areas.size() - 1; layer_idx != static_cast<size_t>(std::max(-1, storage.support.layer_nr_max_filled_layer)); layer_idx--)
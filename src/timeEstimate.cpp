@@ -5,8 +5,6 @@
 
 #include <algorithm>
 #include <math.h>
-#include <stdio.h>
-#include <string.h>
 
 #include "settings/Settings.h"
 #include "utils/math.h"
@@ -60,6 +58,22 @@ void TimeEstimateCalculator::reset()
     blocks.clear();
 }
 
+size_t TimeEstimateCalculator::Blocks::size() const
+{
+    return distance.size();
+}
+
+void TimeEstimateCalculator::Blocks::clear()
+{
+    distance.clear();
+    nominal_feedrate.clear();
+    acceleration.clear();
+    entry_speed.clear();
+    max_entry_speed.clear();
+    nominal_length_flag.clear();
+    feature.clear();
+}
+
 // Calculates the maximum allowable speed at this point when you must be able to reach target_velocity using the
 // acceleration within the allotted distance.
 static inline Velocity maxAllowableSpeed(const Acceleration& acceleration, const Velocity& target_velocity, double distance)
@@ -129,49 +143,50 @@ static inline double accelerationTimeFromDistance(const Velocity& initial_feedra
     return (-initial_feedrate + sqrt(discriminant)) / acceleration;
 }
 
-void TimeEstimateCalculator::calculateTrapezoidForBlock(Block* block, const Ratio entry_factor, const Ratio exit_factor)
+TimeEstimateCalculator::Trapezoid TimeEstimateCalculator::calculateTrapezoidForBlock(const size_t block_idx, const Ratio entry_factor, const Ratio exit_factor) const
 {
-    const Velocity initial_feedrate = block->nominal_feedrate * entry_factor;
-    const Velocity final_feedrate = block->nominal_feedrate * exit_factor;
+    const Velocity nominal_feedrate = blocks.nominal_feedrate[block_idx];
+    const Acceleration block_acceleration = blocks.acceleration[block_idx];
+    const double distance = blocks.distance[block_idx];
+    const Velocity initial_feedrate = nominal_feedrate * entry_factor;
+    const Velocity final_feedrate = nominal_feedrate * exit_factor;
 
-    double accelerate_distance = estimateAccelerationDistance(initial_feedrate, block->nominal_feedrate, block->acceleration);
-    const double decelerate_distance = estimateAccelerationDistance(block->nominal_feedrate, final_feedrate, -block->acceleration);
+    double accelerate_distance = estimateAccelerationDistance(initial_feedrate, nominal_feedrate, block_acceleration);
+    const double decelerate_distance = estimateAccelerationDistance(nominal_feedrate, final_feedrate, -block_acceleration);
 
     // Calculate the size of Plateau of Nominal Rate.
-    double plateau_distance = block->distance - accelerate_distance - decelerate_distance;
+    double plateau_distance = distance - accelerate_distance - decelerate_distance;
 
     // Is the Plateau of Nominal Rate smaller than nothing? That means no cruising, and we will
     // have to use intersection_distance() to calculate when to abort acceleration and start braking
     // in order to reach the final_rate exactly at the end of this block.
     if (plateau_distance < 0)
     {
-        accelerate_distance = intersectionDistance(initial_feedrate, final_feedrate, block->acceleration, block->distance);
+        accelerate_distance = intersectionDistance(initial_feedrate, final_feedrate, block_acceleration, distance);
         accelerate_distance = std::max(accelerate_distance, 0.0); // Check limits due to numerical round-off
-        accelerate_distance = std::min(accelerate_distance, block->distance); //(We can cast here to unsigned, because the above line ensures that we are above zero)
+        accelerate_distance = std::min(accelerate_distance, distance); //(We can cast here to unsigned, because the above line ensures that we are above zero)
         plateau_distance = 0;
     }
 
-    block->accelerate_until = accelerate_distance;
-    block->decelerate_after = accelerate_distance + plateau_distance;
-    block->initial_feedrate = initial_feedrate;
-    block->final_feedrate = final_feedrate;
+    return Trapezoid{ .accelerate_until = accelerate_distance,
+                      .decelerate_after = accelerate_distance + plateau_distance,
+                      .initial_feedrate = initial_feedrate,
+                      .final_feedrate = final_feedrate };
 }
 
 void TimeEstimateCalculator::plan(Position newPos, Velocity feedrate, PrintFeatureType feature)
 {
-    Block block;
-    memset(&block, 0, sizeof(block));
-
-    block.feature = feature;
-
-    // block.maxTravel = 0; //Done by memset.
+    // The per-axis computations are done on plain arrays without early exits, so that the compiler can vectorise them.
+    double delta[NUM_AXIS];
+    double abs_delta[NUM_AXIS];
+    double max_travel = 0.0;
     for (size_t n = 0; n < NUM_AXIS; n++)
     {
-        block.delta[n] = newPos[n] - currentPosition[n];
-        block.absDelta[n] = std::abs(block.delta[n]);
-        block.maxTravel = std::max(block.maxTravel, block.absDelta[n]);
+        delta[n] = newPos[n] - currentPosition[n];
+        abs_delta[n] = std::abs(delta[n]);
+        max_travel = std::max(max_travel, abs_delta[n]);
     }
-    if (block.maxTravel <= 0)
+    if (max_travel <= 0)
     {
         return;
     }
@@ -179,19 +194,19 @@ void TimeEstimateCalculator::plan(Position newPos, Velocity feedrate, PrintFeatu
     {
         feedrate = minimumfeedrate;
     }
-    block.distance = sqrtf(square(block.absDelta[0]) + square(block.absDelta[1]) + square(block.absDelta[2]));
-    if (block.distance == 0.0)
+    double distance = sqrtf(square(abs_delta[0]) + square(abs_delta[1]) + square(abs_delta[2]));
+    if (distance == 0.0)
     {
-        block.distance = block.absDelta[3];
+        distance = abs_delta[3];
     }
-    block.nominal_feedrate = feedrate;
+    Velocity nominal_feedrate = feedrate;
 
     Position current_feedrate;
-    Position current_abs_feedrate;
+    double current_abs_feedrate[NUM_AXIS];
     Ratio feedrate_factor = 1.0;
     for (size_t n = 0; n < NUM_AXIS; n++)
     {
-        current_feedrate[n] = (block.delta[n] * feedrate) / block.distance;
+        current_feedrate[n] = (delta[n] * feedrate) / distance;
         current_abs_feedrate[n] = std::abs(current_feedrate[n]);
         if (current_abs_feedrate[n] > max_feedrate[n])
         {
@@ -207,15 +222,15 @@ void TimeEstimateCalculator::plan(Position newPos, Velocity feedrate, PrintFeatu
             current_feedrate[n] *= feedrate_factor;
             current_abs_feedrate[n] *= feedrate_factor;
         }
-        block.nominal_feedrate *= feedrate_factor;
+        nominal_feedrate *= feedrate_factor;
     }
 
-    block.acceleration = acceleration;
+    Acceleration block_acceleration = acceleration;
     for (size_t n = 0; n < NUM_AXIS; n++)
     {
-        if (block.acceleration * (block.absDelta[n] / block.distance) > max_acceleration[n])
+        if (block_acceleration * (abs_delta[n] / distance) > max_acceleration[n])
         {
-            block.acceleration = max_acceleration[n];
+            block_acceleration = max_acceleration[n];
         }
     }
 
@@ -229,13 +244,12 @@ void TimeEstimateCalculator::plan(Position newPos, Velocity feedrate, PrintFeatu
     {
         vmax_junction = std::min(vmax_junction, Velocity{ max_e_jerk / 2.0 });
     }
-    vmax_junction = std::min(vmax_junction, block.nominal_feedrate);
-    const Velocity safe_speed = vmax_junction;
+    vmax_junction = std::min(vmax_junction, nominal_feedrate);
 
     if ((blocks.size() > 0) && (previous_nominal_feedrate > 0.0001))
     {
         const Velocity xy_jerk = sqrt(square(current_feedrate[X_AXIS] - previous_feedrate[X_AXIS]) + square(current_feedrate[Y_AXIS] - previous_feedrate[Y_AXIS]));
-        vmax_junction = block.nominal_feedrate;
+        vmax_junction = nominal_feedrate;
         if (xy_jerk > max_xy_jerk)
         {
             vmax_junction_factor = Ratio(max_xy_jerk / xy_jerk);
@@ -253,105 +267,72 @@ void TimeEstimateCalculator::plan(Position newPos, Velocity feedrate, PrintFeatu
         vmax_junction = std::min(previous_nominal_feedrate, Velocity{ vmax_junction * vmax_junction_factor }); // Limit speed to max previous speed
     }
 
-    block.max_entry_speed = vmax_junction;
+    const Velocity v_allowable = maxAllowableSpeed(-block_acceleration, MINIMUM_PLANNER_SPEED, distance);
 
-    const Velocity v_allowable = maxAllowableSpeed(-block.acceleration, MINIMUM_PLANNER_SPEED, block.distance);
-    block.entry_speed = std::min(vmax_junction, v_allowable);
-    block.nominal_length_flag = block.nominal_feedrate <= v_allowable;
-    block.recalculate_flag = true; // Always calculate trapezoid for new block
+    blocks.distance.push_back(distance);
+    blocks.nominal_feedrate.push_back(nominal_feedrate);
+    blocks.acceleration.push_back(block_acceleration);
+    blocks.entry_speed.push_back(std::min(vmax_junction, v_allowable));
+    blocks.max_entry_speed.push_back(vmax_junction);
+    blocks.nominal_length_flag.push_back(nominal_feedrate <= v_allowable);
+    blocks.feature.push_back(feature);
 
     previous_feedrate = current_feedrate;
-    previous_nominal_feedrate = block.nominal_feedrate;
+    previous_nominal_feedrate = nominal_feedrate;
 
     currentPosition = newPos;
-
-    calculateTrapezoidForBlock(&block, Ratio(block.entry_speed / block.nominal_feedrate), Ratio(safe_speed / block.nominal_feedrate));
-
-    blocks.push_back(block);
 }
 
 std::vector<Duration> TimeEstimateCalculator::calculate()
 {
     reversePass();
     forwardPass();
-    recalculateTrapezoids();
 
     std::vector<Duration> totals(static_cast<unsigned char>(PrintFeatureType::NumPrintFeatureTypes), 0.0);
     totals[static_cast<unsigned char>(PrintFeatureType::NoneType)] = extra_time; // Extra time (pause for minimum layer time, etc) is marked as NoneType
-    for (unsigned int n = 0; n < blocks.size(); n++)
+    for (size_t n = 0; n < blocks.size(); n++)
     {
-        const Block& block = blocks[n];
-        const double plateau_distance = block.decelerate_after - block.accelerate_until;
-
-        totals[static_cast<unsigned char>(block.feature)] += accelerationTimeFromDistance(block.initial_feedrate, block.accelerate_until, block.acceleration);
-        totals[static_cast<unsigned char>(block.feature)] += plateau_distance / block.nominal_feedrate;
-        totals[static_cast<unsigned char>(block.feature)] += accelerationTimeFromDistance(block.final_feedrate, (block.distance - block.decelerate_after), block.acceleration);
+        // The trapezoid of each block follows from its own entry speed and the entry speed of the next block.
+        // The last/newest block in the buffer exits with MINIMUM_PLANNER_SPEED.
+        // NOTE: Entry and exit factors always > 0 by all previous logic operations.
+        const Velocity nominal_feedrate = blocks.nominal_feedrate[n];
+        const Ratio exit_factor = (n + 1 < blocks.size()) ? Ratio(blocks.entry_speed[n + 1] / nominal_feedrate) : Ratio(MINIMUM_PLANNER_SPEED / nominal_feedrate);
+        const Trapezoid trapezoid = calculateTrapezoidForBlock(n, Ratio(blocks.entry_speed[n] / nominal_feedrate), exit_factor);
+        const double plateau_distance = trapezoid.decelerate_after - trapezoid.accelerate_until;
+
+        Duration& total = totals[static_cast<unsigned char>(blocks.feature[n])];
+        total += accelerationTimeFromDistance(trapezoid.initial_feedrate, trapezoid.accelerate_until, blocks.acceleration[n]);
+        total += plateau_distance / nominal_feedrate;
+        total += accelerationTimeFromDistance(trapezoid.final_feedrate, (blocks.distance[n] - trapezoid.decelerate_after), blocks.acceleration[n]);
     }
     return totals;
 }
 
-void TimeEstimateCalculator::plannerReversePassKernel(Block* previous, Block* current, Block* next)
-{
-    (void)previous;
-    if (! current || ! next)
-    {
-        return;
-    }
-
-    // If entry speed is already at the maximum entry speed, no need to recheck. Block is cruising.
-    // If not, block in state of acceleration or deceleration. Reset entry speed to maximum and
-    // check for maximum allowable speed reductions to ensure maximum possible planned speed.
-    if (current->entry_speed != current->max_entry_speed)
-    {
-        // If nominal length true, max junction speed is guaranteed to be reached. Only compute
-        // for max allowable speed if block is decelerating and nominal length is false.
-        if ((! current->nominal_length_flag) && (current->max_entry_speed > next->entry_speed))
-        {
-            current->entry_speed = std::min(current->max_entry_speed, maxAllowableSpeed(-current->acceleration, next->entry_speed, current->distance));
-        }
-        else
-        {
-            current->entry_speed = current->max_entry_speed;
-        }
-        current->recalculate_flag = true;
-    }
-}
-
 void TimeEstimateCalculator::reversePass()
 {
-    Block* block[3] = { nullptr, nullptr, nullptr };
-    for (size_t n = blocks.size() - 1; int(n) >= 0; n--)
-    {
-        block[2] = block[1];
-        block[1] = block[0];
-        block[0] = &blocks[n];
-        plannerReversePassKernel(block[0], block[1], block[2]);
-    }
-}
-
-void TimeEstimateCalculator::plannerForwardPassKernel(Block* previous, Block* current, Block* next)
-{
-    (void)next;
-    if (! previous)
+    // The first block and the last block are never limited by this pass.
+    if (blocks.size() < 3)
     {
         return;
     }
-
-    // If the previous block is an acceleration block, but it is not long enough to complete the
-    // full speed change within the block, we need to adjust the entry speed accordingly. Entry
-    // speeds have already been reset, maximized, and reverse planned by reverse planner.
-    // If nominal length is true, max junction speed is guaranteed to be reached. No need to recheck.
-    if (! previous->nominal_length_flag)
+    for (size_t current = blocks.size() - 2; current > 0; current--)
     {
-        if (previous->entry_speed < current->entry_speed)
+        // If entry speed is already at the maximum entry speed, no need to recheck. Block is cruising.
+        // If not, block in state of acceleration or deceleration. Reset entry speed to maximum and
+        // check for maximum allowable speed reductions to ensure maximum possible planned speed.
+        if (blocks.entry_speed[current] != blocks.max_entry_speed[current])
         {
-            const Velocity entry_speed = std::min(current->entry_speed, maxAllowableSpeed(-previous->acceleration, previous->entry_speed, previous->distance));
-
-            // Check for junction speed change
-            if (current->entry_speed != entry_speed)
+            // If nominal length true, max junction speed is guaranteed to be reached. Only compute
+            // for max allowable speed if block is decelerating and nominal length is false.
+            if ((! blocks.nominal_length_flag[current]) && (blocks.max_entry_speed[current] > blocks.entry_speed[current + 1]))
+            {
+                blocks.entry_speed[current] = std::min(
+                    blocks.max_entry_speed[current],
+                    maxAllowableSpeed(-blocks.acceleration[current], blocks.entry_speed[current + 1], blocks.distance[current]));
+            }
+            else
             {
-                current->entry_speed = entry_speed;
-                current->recalculate_flag = true;
+                blocks.entry_speed[current] = blocks.max_entry_speed[current];
             }
         }
     }
@@ -359,43 +340,19 @@ void TimeEstimateCalculator::plannerForwardPassKernel(Block* previous, Block* cu
 
 void TimeEstimateCalculator::forwardPass()
 {
-    Block* block[3] = { nullptr, nullptr, nullptr };
-    for (size_t n = 0; n < blocks.size(); n++)
+    for (size_t current = 1; current < blocks.size(); current++)
     {
-        block[0] = block[1];
-        block[1] = block[2];
-        block[2] = &blocks[n];
-        plannerForwardPassKernel(block[0], block[1], block[2]);
-    }
-    plannerForwardPassKernel(block[1], block[2], nullptr);
-}
-
-void TimeEstimateCalculator::recalculateTrapezoids()
-{
-    Block* current;
-    Block* next = nullptr;
-
-    for (unsigned int n = 0; n < blocks.size(); n++)
-    {
-        current = next;
-        next = &blocks[n];
-        if (current)
+        const size_t previous = current - 1;
+        // If the previous block is an acceleration block, but it is not long enough to complete the
+        // full speed change within the block, we need to adjust the entry speed accordingly. Entry
+        // speeds have already been reset, maximized, and reverse planned by reverse planner.
+        // If nominal length is true, max junction speed is guaranteed to be reached. No need to recheck.
+        if (! blocks.nominal_length_flag[previous] && blocks.entry_speed[previous] < blocks.entry_speed[current])
         {
-            // Recalculate if current block entry or exit junction speed has changed.
-            if (current->recalculate_flag || next->recalculate_flag)
-            {
-                // NOTE: Entry and exit factors always > 0 by all previous logic operations.
-                calculateTrapezoidForBlock(current, Ratio(current->entry_speed / current->nominal_feedrate), Ratio(next->entry_speed / current->nominal_feedrate));
-                current->recalculate_flag = false; // Reset current only to ensure next trapezoid is computed
-            }
+            blocks.entry_speed[current]
+                = std::min(blocks.entry_speed[current], maxAllowableSpeed(-blocks.acceleration[previous], blocks.entry_speed[previous], blocks.distance[previous]));
         }
     }
-    // Last/newest block in buffer. Exit speed is set with MINIMUM_PLANNER_SPEED. Always recalculated.
-    if (next != nullptr)
-    {
-        calculateTrapezoidForBlock(next, Ratio(next->entry_speed / next->nominal_feedrate), Ratio(MINIMUM_PLANNER_SPEED / next->nominal_feedrate));
-        next->recalculate_flag = false;
-    }
 }
 
 } // namespace cura
@@ -0,0 +1,214 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/ClipperStatistics.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+namespace cura
+{
+
+std::atomic<bool> ClipperStatistics::enabled_{ false };
+
+namespace
+{
+
+constexpr size_t operation_count = static_cast<size_t>(ClipperStatistics::Operation::COUNT);
+
+constexpr std::array<const char*, operation_count> operation_names{ "offset", "union", "difference", "intersection", "intersectionPolyLines", "xor" };
+
+/*!
+ * The totals of one operation in one stage.
+ */
+struct OperationCounts
+{
+    size_t calls = 0;
+    size_t input_vertices = 0;
+    size_t output_vertices = 0;
+    ClipperStatistics::Clock::duration duration{ 0 };
+
+    void add(const OperationCounts& other)
+    {
+        calls += other.calls;
+        input_vertices += other.input_vertices;
+        output_vertices += other.output_vertices;
+        duration += other.duration;
+    }
+};
+
+using StageCounts = std::array<OperationCounts, operation_count>;
+
+/*!
+ * The totals counted by a single thread.
+ */
+struct ThreadCounts
+{
+    std::mutex mutex; //!< Only contended while writing the statistics.
+    std::vector<std::pair<const char*, StageCounts>> stages; //!< Few enough that a linear search beats a map.
+};
+
+/*!
+ * The counting state shared by all threads.
+ */
+struct StatisticsState
+{
+    std::mutex mutex; //!< Guards the list of threads, not the counts of each thread.
+    std::vector<std::unique_ptr<ThreadCounts>> threads; //!< Kept alive after their thread exits, so that their counts can still be written.
+    std::string output_file;
+};
+
+StatisticsState& getState()
+{
+    static StatisticsState state;
+    return state;
+}
+
+ThreadCounts& getThreadCounts()
+{
+    thread_local ThreadCounts* thread_counts = nullptr;
+    if (! thread_counts)
+    {
+        StatisticsState& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.threads.push_back(std::make_unique<ThreadCounts>());
+        thread_counts = state.threads.back().get();
+    }
+    return *thread_counts;
+}
+
+double toMilliseconds(const ClipperStatistics::Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+void ClipperStatistics::enable(const std::string& output_file)
+{
+    StatisticsState& state = getState();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.output_file = output_file;
+        for (const std::unique_ptr<ThreadCounts>& thread_counts : state.threads)
+        {
+            std::lock_guard<std::mutex> thread_lock(thread_counts->mutex);
+            thread_counts->stages.clear();
+        }
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void ClipperStatistics::disable()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void ClipperStatistics::record(const Operation operation, const size_t input_vertices, const size_t output_vertices, const Clock::duration duration)
+{
+    const char* stage = stage_ ? stage_ : "other";
+    ThreadCounts& thread_counts = getThreadCounts();
+    std::lock_guard<std::mutex> lock(thread_counts.mutex);
+    auto stage_counts = std::find_if(
+        thread_counts.stages.begin(),
+        thread_counts.stages.end(),
+        [stage](const std::pair<const char*, StageCounts>& counts)
+        {
+            return counts.first == stage;
+        });
+    if (stage_counts == thread_counts.stages.end())
+    {
+        thread_counts.stages.emplace_back(stage, StageCounts{});
+        stage_counts = std::prev(thread_counts.stages.end());
+    }
+    stage_counts->second[static_cast<size_t>(operation)].add(OperationCounts{ 1, input_vertices, output_vertices, duration });
+}
+
+void ClipperStatistics::write()
+{
+    StatisticsState& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    // Merge the threads. The same stage may have a different pointer in different translation units, so merge by name.
+    std::map<std::string, StageCounts> totals;
+    for (const std::unique_ptr<ThreadCounts>& thread_counts : state.threads)
+    {
+        std::lock_guard<std::mutex> thread_lock(thread_counts->mutex);
+        for (const auto& [stage, stage_counts] : thread_counts->stages)
+        {
+            StageCounts& total = totals[stage];
+            for (size_t operation_idx = 0; operation_idx < operation_count; operation_idx++)
+            {
+                total[operation_idx].add(stage_counts[operation_idx]);
+            }
+        }
+    }
+
+    spdlog::info("Polygon operations per stage (time summed over all threads):");
+    spdlog::info("{:<24} {:<22} {:>10} {:>14} {:>14} {:>12}", "stage", "operation", "calls", "vertices in", "vertices out", "time [ms]");
+    for (const auto& [stage, stage_counts] : totals)
+    {
+        for (size_t operation_idx = 0; operation_idx < operation_count; operation_idx++)
+        {
+            const OperationCounts& counts = stage_counts[operation_idx];
+            if (counts.calls == 0)
+            {
+                continue;
+            }
+            spdlog::info(
+                "{:<24} {:<22} {:>10} {:>14} {:>14} {:>12.1f}",
+                stage,
+                operation_names[operation_idx],
+                counts.calls,
+                counts.input_vertices,
+                counts.output_vertices,
+                toMilliseconds(counts.duration));
+        }
+    }
+
+    std::ofstream file(state.output_file);
+    if (! file)
+    {
+        spdlog::error("Couldn't open {} to write the polygon operation statistics to.", state.output_file);
+        return;
+    }
+    file << "{\"stages\":[";
+    bool first_stage = true;
+    for (const auto& [stage, stage_counts] : totals)
+    {
+        file << (first_stage ? "\n" : ",\n") << fmt::format(R"({{"name":"{}","operations":[)", stage);
+        first_stage = false;
+        bool first_operation = true;
+        for (size_t operation_idx = 0; operation_idx < operation_count; operation_idx++)
+        {
+            const OperationCounts& counts = stage_counts[operation_idx];
+            if (counts.calls == 0)
+            {
+                continue;
+            }
+            file << (first_operation ? "" : ",")
+                 << fmt::format(
+                        R"({{"name":"{}","calls":{},"input_vertices":{},"output_vertices":{},"time_ms":{:.3f}}})",
+                        operation_names[operation_idx],
+                        counts.calls,
+                        counts.input_vertices,
+                        counts.output_vertices,
+                        toMilliseconds(counts.duration));
+            first_operation = false;
+        }
+        file << "]}";
+    }
+    file << "\n]}\n";
+    spdlog::info("Wrote polygon operation statistics to {}", state.output_file);
+}
+
+} // namespace cura
@@ -0,0 +1,240 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/PreparedPolygons.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "utils/linearAlg2D.h"
+#include "utils/math.h"
+#include "utils/polygon.h"
+
+namespace cura
+{
+
+namespace
+{
+constexpr size_t EDGES_PER_SLAB = 2; //!< The number of edges per slab to aim for.
+constexpr size_t MAX_SLAB_COUNT = 4096;
+constexpr size_t MAX_ENTRIES_PER_EDGE = 8; //!< Use fewer slabs when edges would on average be duplicated more than this.
+/*!
+ * How far the bounding box of an edge may be from that of a line segment while they still collide.
+ *
+ * The segment query gives exactly the same result as PolygonUtils::polygonCollidesWithLineSegment,
+ * which rotates all vertices so the segment is horizontal. The rotated vertices are rounded to whole
+ * units, and the intersection of the edge with the horizontal line is truncated to whole units. That
+ * lets edges collide that are less than 0.5 + 1 + 0.5 units beyond the ends of the segment and up to
+ * 1 unit beside it, so less than sqrt(5) units away. Bounding boxes are in whole units, so an edge
+ * whose bounding box is more than 2 units away from that of the segment can't collide. Nearer edges
+ * are tested with the same rounded transformation, so the margin doesn't make the result approximate.
+ */
+constexpr coord_t SEGMENT_ROUNDING_MARGIN = 2;
+} // namespace
+
+PreparedPolygons::PreparedPolygons(const Polygons& polygons)
+{
+    std::vector<Edge> edges;
+    for (ConstPolygonRef polygon : polygons)
+    {
+        if (polygon.empty())
+        {
+            continue;
+        }
+        const bool has_area = polygon.size() >= 3;
+        Point2LL previous = polygon.back();
+        for (const Point2LL& point : polygon)
+        {
+            edges.push_back(Edge{ previous, point, has_area });
+            previous = point;
+        }
+    }
+    if (edges.empty())
+    {
+        return;
+    }
+
+    min_y_ = std::numeric_limits<coord_t>::max();
+    max_y_ = std::numeric_limits<coord_t>::lowest();
+    for (const Edge& edge : edges)
+    {
+        min_y_ = std::min(min_y_, edge.from_.Y);
+        max_y_ = std::max(max_y_, edge.from_.Y);
+    }
+
+    // Long edges are stored in every slab they span. Use fewer slabs if that would take too much memory.
+    size_t slab_count = std::clamp(edges.size() / EDGES_PER_SLAB, size_t(1), MAX_SLAB_COUNT);
+    std::vector<size_t> slab_sizes;
+    while (true)
+    {
+        slab_height_ = static_cast<coord_t>(round_up_divide(max_y_ - min_y_ + 1, slab_count));
+        slab_sizes.assign(slab_count, 0);
+        size_t entry_count = 0;
+        for (const Edge& edge : edges)
+        {
+            const auto [low, high] = std::minmax(edge.from_.Y, edge.to_.Y);
+            for (size_t slab = getSlab(low); slab <= getSlab(high); slab++)
+            {
+                slab_sizes[slab]++;
+            }
+            entry_count += getSlab(high) - getSlab(low) + 1;
+        }
+        if (entry_count <= edges.size() * MAX_ENTRIES_PER_EDGE || slab_count == 1)
+        {
+            break;
+        }
+        slab_count /= 2;
+    }
+
+    slab_starts_.resize(slab_count + 1, 0);
+    std::partial_sum(slab_sizes.begin(), slab_sizes.end(), slab_starts_.begin() + 1);
+    edges_.resize(slab_starts_.back());
+    std::vector<size_t> slab_ends(slab_starts_.begin(), slab_starts_.end() - 1);
+    for (const Edge& edge : edges)
+    {
+        const auto [low, high] = std::minmax(edge.from_.Y, edge.to_.Y);
+        for (size_t slab = getSlab(low); slab <= getSlab(high); slab++)
+        {
+            edges_[slab_ends[slab]++] = edge;
+        }
+    }
+}
+
+bool PreparedPolygons::empty() const
+{
+    return edges_.empty();
+}
+
+size_t PreparedPolygons::getSlab(const coord_t y) const
+{
+    return static_cast<size_t>((y - min_y_) / slab_height_);
+}
+
+bool PreparedPolygons::inside(const Point2LL& p, bool border_result) const
+{
+    if (p.Y < min_y_ || p.Y > max_y_)
+    {
+        return false;
+    }
+    return insideSlab(p, getSlab(p.Y), border_result);
+}
+
+std::vector<bool> PreparedPolygons::inside(const std::vector<Point2LL>& points, bool border_result) const
+{
+    std::vector<bool> result(points.size(), false);
+    if (empty())
+    {
+        return result;
+    }
+
+    // Bucket the points per slab, so that each slab's edges are only loaded into the cache once.
+    const size_t slab_count = slab_starts_.size() - 1;
+    std::vector<size_t> bucket_starts(slab_count + 1, 0);
+    for (const Point2LL& p : points)
+    {
+        if (p.Y >= min_y_ && p.Y <= max_y_)
+        {
+            bucket_starts[getSlab(p.Y) + 1]++;
+        }
+    }
+    std::partial_sum(bucket_starts.begin(), bucket_starts.end(), bucket_starts.begin());
+    std::vector<size_t> order(bucket_starts.back());
+    std::vector<size_t> bucket_ends(bucket_starts.begin(), bucket_starts.end() - 1);
+    for (size_t point_idx = 0; point_idx < points.size(); point_idx++)
+    {
+        const Point2LL& p = points[point_idx];
+        if (p.Y >= min_y_ && p.Y <= max_y_)
+        {
+            order[bucket_ends[getSlab(p.Y)]++] = point_idx;
+        }
+    }
+
+    for (size_t slab = 0; slab < slab_count; slab++)
+    {
+        for (size_t order_idx = bucket_starts[slab]; order_idx < bucket_starts[slab + 1]; order_idx++)
+        {
+            const size_t point_idx = order[order_idx];
+            result[point_idx] = insideSlab(points[point_idx], slab, border_result);
+        }
+    }
+    return result;
+}
+
+bool PreparedPolygons::insideSlab(const Point2LL& p, const size_t slab, bool border_result) const
+{
+    // Same test as ClipperLib::PointInPolygon, which Polygons::inside uses, but only for the edges near the point.
+    // Edges that don't span the Y coordinate of the point can't change the result, so those in other slabs can be skipped.
+    bool result = false;
+    for (size_t edge_idx = slab_starts_[slab]; edge_idx < slab_starts_[slab + 1]; edge_idx++)
+    {
+        const Edge& edge = edges_[edge_idx];
+        if (! edge.has_area_)
+        {
+            continue;
+        }
+        const Point2LL& a = edge.from_;
+        const Point2LL& b = edge.to_;
+        if (b.Y == p.Y && (b.X == p.X || (a.Y == p.Y && ((b.X > p.X) == (a.X < p.X)))))
+        {
+            return border_result;
+        }
+        if ((a.Y < p.Y) == (b.Y < p.Y))
+        {
+            continue;
+        }
+        if (a.X >= p.X && b.X > p.X)
+        {
+            result = ! result;
+        }
+        else if (a.X >= p.X || b.X > p.X)
+        {
+            const double cross = static_cast<double>(a.X - p.X) * static_cast<double>(b.Y - p.Y) - static_cast<double>(b.X - p.X) * static_cast<double>(a.Y - p.Y);
+            if (cross == 0)
+            {
+                return border_result;
+            }
+            if ((cross > 0) == (b.Y > a.Y))
+            {
+                result = ! result;
+            }
+        }
+    }
+    return result;
+}
+
+bool PreparedPolygons::intersectsSegment(const Point2LL& from, const Point2LL& to) const
+{
+    if (from == to || empty())
+    {
+        return false; // Zero-length line segments never collide, like in PolygonUtils::polygonCollidesWithLineSegment.
+    }
+    const auto [segment_min_x, segment_max_x] = std::minmax(from.X, to.X);
+    const auto [segment_min_y, segment_max_y] = std::minmax(from.Y, to.Y);
+    const coord_t low = std::max(segment_min_y - SEGMENT_ROUNDING_MARGIN, min_y_);
+    const coord_t high = std::min(segment_max_y + SEGMENT_ROUNDING_MARGIN, max_y_);
+    if (low > high)
+    {
+        return false;
+    }
+
+    const PointMatrix transformation_matrix(to - from);
+    const Point2LL transformed_from = transformation_matrix.apply(from);
+    const Point2LL transformed_to = transformation_matrix.apply(to);
+    for (size_t edge_idx = slab_starts_[getSlab(low)]; edge_idx < slab_starts_[getSlab(high) + 1]; edge_idx++)
+    {
+        const Edge& edge = edges_[edge_idx];
+        if (std::max(edge.from_.X, edge.to_.X) < segment_min_x - SEGMENT_ROUNDING_MARGIN || std::min(edge.from_.X, edge.to_.X) > segment_max_x + SEGMENT_ROUNDING_MARGIN
+            || std::max(edge.from_.Y, edge.to_.Y) < low || std::min(edge.from_.Y, edge.to_.Y) > high)
+        {
+            continue;
+        }
+        if (LinearAlg2D::lineSegmentsCollide(transformed_from, transformed_to, transformation_matrix.apply(edge.from_), transformation_matrix.apply(edge.to_)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace cura
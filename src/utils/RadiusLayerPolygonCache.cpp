@@ -0,0 +1,251 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "utils/RadiusLayerPolygonCache.h"
+
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+namespace cura
+{
+
+RadiusLayerPolygonCache::ChunkDirectory::ChunkDirectory(const size_t size)
+    : size{ size }
+    , chunks{ std::make_unique<std::atomic<Chunk*>[]>(size) }
+{
+    for (size_t chunk_idx = 0; chunk_idx < size; ++chunk_idx)
+    {
+        chunks[chunk_idx].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+RadiusLayerPolygonCache::RadiusEntry::RadiusEntry(const coord_t radius, RadiusEntry* next)
+    : radius{ radius }
+    , next{ next }
+{
+}
+
+RadiusLayerPolygonCache::RadiusLayerPolygonCache(std::string name)
+    : name_{ std::move(name) }
+{
+}
+
+RadiusLayerPolygonCache::~RadiusLayerPolygonCache()
+{
+    for (const auto& chunk : owned_chunks_)
+    {
+        for (auto& slot : chunk->slots)
+        {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+std::optional<std::reference_wrapper<const Polygons>> RadiusLayerPolygonCache::get(const coord_t radius, const LayerIndex layer_idx) const
+{
+    const std::atomic<const Polygons*>* slot = findSlot(radius, layer_idx);
+    const Polygons* area = slot ? slot->load(std::memory_order_acquire) : nullptr;
+    if (area == nullptr)
+    {
+        localCounters().misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    localCounters().hits.fetch_add(1, std::memory_order_relaxed);
+    return std::cref(*area);
+}
+
+bool RadiusLayerPolygonCache::contains(const coord_t radius, const LayerIndex layer_idx) const
+{
+    const std::atomic<const Polygons*>* slot = findSlot(radius, layer_idx);
+    return slot && slot->load(std::memory_order_acquire) != nullptr;
+}
+
+bool RadiusLayerPolygonCache::insert(const coord_t radius, const LayerIndex layer_idx, Polygons area)
+{
+    if (layer_idx < 0)
+    {
+        return false;
+    }
+    std::atomic<const Polygons*>& slot = getOrCreateSlot(radius, layer_idx);
+    if (slot.load(std::memory_order_acquire) != nullptr)
+    {
+        return false; // Write-once: The first value stays.
+    }
+
+    auto value = std::make_unique<const Polygons>(std::move(area));
+    const Polygons* expected = nullptr;
+    if (! slot.compare_exchange_strong(expected, value.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+        return false; // Another thread published a value for this slot in the meantime.
+    }
+    value.release(); // Now owned by the slot, deleted in the destructor.
+    inserts_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+LayerIndex RadiusLayerPolygonCache::getMaxCalculatedLayer(const coord_t radius) const
+{
+    LayerIndex max_layer = -1;
+
+    // Layer 0 may never be calculated for some caches (for example the placeable areas), while layer 1 is.
+    if (contains(radius, 1))
+    {
+        max_layer = 1;
+    }
+
+    while (contains(radius, max_layer + 1))
+    {
+        max_layer++;
+    }
+    return max_layer;
+}
+
+void RadiusLayerPolygonCache::visit(const std::function<void(const coord_t radius, const LayerIndex layer_idx, const Polygons& area)>& visitor) const
+{
+    for (const RadiusEntry* entry = radii_.load(std::memory_order_acquire); entry != nullptr; entry = entry->next)
+    {
+        const ChunkDirectory* directory = entry->directory.load(std::memory_order_acquire);
+        if (directory == nullptr)
+        {
+            continue;
+        }
+        for (size_t chunk_idx = 0; chunk_idx < directory->size; ++chunk_idx)
+        {
+            const Chunk* chunk = directory->chunks[chunk_idx].load(std::memory_order_acquire);
+            if (chunk == nullptr)
+            {
+                continue;
+            }
+            for (size_t slot_idx = 0; slot_idx < LAYERS_PER_CHUNK; ++slot_idx)
+            {
+                if (const Polygons* area = chunk->slots[slot_idx].load(std::memory_order_acquire))
+                {
+                    visitor(entry->radius, LayerIndex(chunk_idx * LAYERS_PER_CHUNK + slot_idx), *area);
+                }
+            }
+        }
+    }
+}
+
+RadiusLayerPolygonCache::Statistics RadiusLayerPolygonCache::getStatistics() const
+{
+    Statistics result;
+    for (const CounterShard& shard : counters_)
+    {
+        result.hits += shard.hits.load(std::memory_order_relaxed);
+        result.misses += shard.misses.load(std::memory_order_relaxed);
+    }
+    result.inserts = inserts_.load(std::memory_order_relaxed);
+    result.wait_time = std::chrono::nanoseconds(wait_time_ns_.load(std::memory_order_relaxed));
+    return result;
+}
+
+void RadiusLayerPolygonCache::logStatistics() const
+{
+    const Statistics statistics = getStatistics();
+    const size_t lookups = statistics.hits + statistics.misses;
+    const double hit_rate = lookups == 0 ? 0.0 : 100.0 * static_cast<double>(statistics.hits) / static_cast<double>(lookups);
+    spdlog::debug(
+        "Cache '{}': {} hits, {} misses ({:.1f}% hit rate), {} areas stored, {} ms waiting for the writer lock.",
+        name_,
+        statistics.hits,
+        statistics.misses,
+        hit_rate,
+        statistics.inserts,
+        0.000001 * static_cast<double>(statistics.wait_time.count()));
+}
+
+std::atomic<const Polygons*>* RadiusLayerPolygonCache::findSlot(const coord_t radius, const LayerIndex layer_idx) const
+{
+    if (layer_idx < 0)
+    {
+        return nullptr;
+    }
+    const RadiusEntry* entry = findRadius(radius);
+    if (entry == nullptr)
+    {
+        return nullptr;
+    }
+    const size_t layer = static_cast<size_t>(layer_idx.value);
+    const size_t chunk_idx = layer / LAYERS_PER_CHUNK;
+    const ChunkDirectory* directory = entry->directory.load(std::memory_order_acquire);
+    if (directory == nullptr || chunk_idx >= directory->size)
+    {
+        return nullptr;
+    }
+    Chunk* chunk = directory->chunks[chunk_idx].load(std::memory_order_acquire);
+    if (chunk == nullptr)
+    {
+        return nullptr;
+    }
+    return &chunk->slots[layer % LAYERS_PER_CHUNK];
+}
+
+std::atomic<const Polygons*>& RadiusLayerPolygonCache::getOrCreateSlot(const coord_t radius, const LayerIndex layer_idx)
+{
+    const size_t layer = static_cast<size_t>(layer_idx.value);
+    const size_t chunk_idx = layer / LAYERS_PER_CHUNK;
+
+    // Fast path: Everything this slot needs already exists.
+    if (std::atomic<const Polygons*>* slot = findSlot(radius, layer_idx))
+    {
+        return *slot;
+    }
+
+    const auto wait_start = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> critical_section(writer_mutex_);
+    wait_time_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wait_start).count(), std::memory_order_relaxed);
+
+    RadiusEntry* entry = findRadius(radius);
+    if (entry == nullptr)
+    {
+        owned_radii_.emplace_back(std::make_unique<RadiusEntry>(radius, radii_.load(std::memory_order_relaxed)));
+        entry = owned_radii_.back().get();
+        radii_.store(entry, std::memory_order_release);
+    }
+
+    ChunkDirectory* directory = entry->directory.load(std::memory_order_relaxed);
+    if (directory == nullptr || chunk_idx >= directory->size)
+    {
+        // Grow the directory. The old one stays alive, as concurrent readers might still be looking at it.
+        const size_t old_size = directory ? directory->size : 0;
+        auto grown = std::make_unique<ChunkDirectory>(std::max(chunk_idx + 1, old_size * 2));
+        for (size_t existing_idx = 0; existing_idx < old_size; ++existing_idx)
+        {
+            grown->chunks[existing_idx].store(directory->chunks[existing_idx].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        directory = grown.get();
+        owned_directories_.emplace_back(std::move(grown));
+        entry->directory.store(directory, std::memory_order_release);
+    }
+
+    Chunk* chunk = directory->chunks[chunk_idx].load(std::memory_order_relaxed);
+    if (chunk == nullptr)
+    {
+        owned_chunks_.emplace_back(std::make_unique<Chunk>());
+        chunk = owned_chunks_.back().get();
+        directory->chunks[chunk_idx].store(chunk, std::memory_order_release);
+    }
+    return chunk->slots[layer % LAYERS_PER_CHUNK];
+}
+
+RadiusLayerPolygonCache::RadiusEntry* RadiusLayerPolygonCache::findRadius(const coord_t radius) const
+{
+    for (RadiusEntry* entry = radii_.load(std::memory_order_acquire); entry != nullptr; entry = entry->next)
+    {
+        if (entry->radius == radius)
+        {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+RadiusLayerPolygonCache::CounterShard& RadiusLayerPolygonCache::localCounters() const
+{
+    static thread_local const size_t shard_idx = std::hash<std::thread::id>{}(std::this_thread::get_id()) % COUNTER_SHARDS;
+    return counters_[shard_idx];
+}
+
+} // namespace cura
@@ -0,0 +1,175 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/Trace.h"
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+namespace cura
+{
+
+std::atomic<bool> Trace::enabled_{ false };
+
+namespace
+{
+
+/*!
+ * A zone as recorded by a thread.
+ */
+struct TraceEvent
+{
+    const char* name;
+    int64_t layer_nr;
+    Trace::Clock::time_point start;
+    Trace::Clock::time_point end;
+};
+
+/*!
+ * The zones recorded by a single thread, as a ring buffer.
+ */
+struct ThreadEvents
+{
+    static constexpr size_t capacity = 1 << 16; //!< The number of zones to keep per thread. Older zones are overwritten.
+
+    size_t thread_nr; //!< Sequence number of the thread, in the order in which they first recorded a zone.
+    std::mutex mutex; //!< Only contended while writing the trace.
+    std::vector<TraceEvent> events; //!< Grows up to the capacity, then wraps around.
+    size_t next = 0; //!< Where to record the next zone once the buffer is full.
+    size_t overwritten = 0; //!< The number of zones that were overwritten by newer ones.
+};
+
+/*!
+ * The recording state shared by all threads.
+ */
+struct TraceState
+{
+    std::mutex mutex; //!< Guards the list of threads, not the zones of each thread.
+    std::vector<std::unique_ptr<ThreadEvents>> threads; //!< Kept alive after their thread exits, so that their zones can still be written.
+    std::string output_file;
+    Trace::Clock::time_point start; //!< The time stamps of the trace are relative to this.
+};
+
+TraceState& getState()
+{
+    static TraceState state;
+    return state;
+}
+
+ThreadEvents& getThreadEvents()
+{
+    thread_local ThreadEvents* thread_events = nullptr;
+    if (! thread_events)
+    {
+        TraceState& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.threads.push_back(std::make_unique<ThreadEvents>());
+        thread_events = state.threads.back().get();
+        thread_events->thread_nr = state.threads.size();
+        thread_events->events.reserve(ThreadEvents::capacity);
+    }
+    return *thread_events;
+}
+
+int64_t toMicroseconds(const Trace::Clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+} // namespace
+
+void Trace::enable(const std::string& output_file)
+{
+    TraceState& state = getState();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.output_file = output_file;
+        state.start = Clock::now();
+        for (const std::unique_ptr<ThreadEvents>& thread_events : state.threads)
+        {
+            std::lock_guard<std::mutex> thread_lock(thread_events->mutex);
+            thread_events->events.clear();
+            thread_events->next = 0;
+            thread_events->overwritten = 0;
+        }
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+    getThreadEvents(); // Let the main thread be the first thread in the trace.
+}
+
+void Trace::disable()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void Trace::record(const char* name, const int64_t layer_nr, const Clock::time_point start, const Clock::time_point end)
+{
+    ThreadEvents& thread_events = getThreadEvents();
+    std::lock_guard<std::mutex> lock(thread_events.mutex);
+    if (thread_events.events.size() < ThreadEvents::capacity)
+    {
+        thread_events.events.push_back(TraceEvent{ name, layer_nr, start, end });
+        return;
+    }
+    thread_events.events[thread_events.next] = TraceEvent{ name, layer_nr, start, end };
+    thread_events.next = (thread_events.next + 1) % ThreadEvents::capacity;
+    thread_events.overwritten++;
+}
+
+void Trace::write()
+{
+    TraceState& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::ofstream file(state.output_file);
+    if (! file)
+    {
+        spdlog::error("Couldn't open {} to write the trace to.", state.output_file);
+        return;
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    size_t overwritten = 0;
+    for (const std::unique_ptr<ThreadEvents>& thread_events : state.threads)
+    {
+        std::lock_guard<std::mutex> thread_lock(thread_events->mutex);
+        const std::string thread_name = thread_events->thread_nr == 1 ? "main" : fmt::format("worker {}", thread_events->thread_nr - 1);
+        file << (first ? "" : ",\n")
+             << fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})", thread_events->thread_nr, thread_name);
+        first = false;
+
+        // Oldest first, starting after the most recently overwritten zone.
+        const std::vector<TraceEvent>& events = thread_events->events;
+        for (size_t event_idx = 0; event_idx < events.size(); event_idx++)
+        {
+            const TraceEvent& event = events[(thread_events->next + event_idx) % events.size()];
+            file << ",\n"
+                 << fmt::format(
+                        R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{},"dur":{})",
+                        event.name,
+                        thread_events->thread_nr,
+                        toMicroseconds(event.start - state.start),
+                        toMicroseconds(event.end - event.start));
+            if (event.layer_nr >= 0)
+            {
+                file << fmt::format(R"(,"args":{{"layer":{}}})", event.layer_nr);
+            }
+            file << "}";
+        }
+        overwritten += thread_events->overwritten;
+    }
+    file << "\n]}\n";
+
+    if (overwritten > 0)
+    {
+        spdlog::warn("The trace is missing the {} oldest zones, because they didn't fit in the buffer of their thread.", overwritten);
+    }
+    spdlog::info("Wrote trace to {}", state.output_file);
+}
+
+} // namespace cura
@@ -0,0 +1,171 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/VoxelGrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <numeric>
+
+#include "utils/ThreadPool.h"
+
+namespace cura
+{
+
+namespace
+{
+
+/*!
+ * Get a word of a row of cells, after shifting the row by some cells.
+ *
+ * \param row The words of the row.
+ * \param words_per_row The number of words in the row.
+ * \param word_idx The word of the shifted row to get.
+ * \param shift The number of cells to shift towards higher X coordinates.
+ * Negative to shift towards lower X coordinates.
+ */
+uint64_t getShiftedWord(const uint64_t* row, const size_t words_per_row, const size_t word_idx, const coord_t shift)
+{
+    const size_t word_shift = static_cast<size_t>(std::abs(shift)) / 64;
+    const size_t bit_shift = static_cast<size_t>(std::abs(shift)) % 64;
+    uint64_t result = 0;
+    if (shift >= 0)
+    {
+        if (word_idx >= word_shift)
+        {
+            result |= row[word_idx - word_shift] << bit_shift;
+            if (bit_shift != 0 && word_idx >= word_shift + 1)
+            {
+                result |= row[word_idx - word_shift - 1] >> (64 - bit_shift);
+            }
+        }
+    }
+    else
+    {
+        if (word_idx + word_shift < words_per_row)
+        {
+            result |= row[word_idx + word_shift] >> bit_shift;
+            if (bit_shift != 0 && word_idx + word_shift + 1 < words_per_row)
+            {
+                result |= row[word_idx + word_shift + 1] << (64 - bit_shift);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+VoxelGrid::VoxelGrid(const AABB3D& bounds)
+{
+    if (bounds.max_.x_ < bounds.min_.x_ || bounds.max_.y_ < bounds.min_.y_ || bounds.max_.z_ < bounds.min_.z_)
+    {
+        return; // Empty bounds.
+    }
+    min_ = bounds.min_;
+    size_ = bounds.max_ - bounds.min_ + GridPoint3(1, 1, 1);
+    words_per_row_ = (static_cast<size_t>(size_.x_) + 63) / 64;
+    words_.resize(words_per_row_ * static_cast<size_t>(size_.y_) * static_cast<size_t>(size_.z_), 0);
+}
+
+VoxelGrid VoxelGrid::dilate(const DilationKernel& kernel) const
+{
+    VoxelGrid result;
+    result.min_ = min_;
+    result.size_ = size_;
+    result.words_per_row_ = words_per_row_;
+    result.words_.resize(words_.size(), 0);
+    if (words_.empty())
+    {
+        return result;
+    }
+
+    // Gather the offsets along X for each offset row, so that each source row is read once per output row.
+    std::map<std::pair<coord_t, coord_t>, std::vector<coord_t>> x_offsets_per_row;
+    for (const GridPoint3& rel : kernel.relative_cells_)
+    {
+        x_offsets_per_row[{ rel.y_, rel.z_ }].push_back(rel.x_);
+    }
+
+    const uint64_t last_word_mask = (size_.x_ % 64 == 0) ? ~uint64_t(0) : (uint64_t(1) << (size_.x_ % 64)) - 1;
+
+    // Each z-slice only writes to its own rows, so they can be dilated in parallel.
+    cura::parallel_for<coord_t>(
+        0,
+        size_.z_,
+        [&](const coord_t z)
+        {
+            for (coord_t y = 0; y < size_.y_; y++)
+            {
+                uint64_t* result_row = &result.words_[getWordIndex(y, z)];
+                for (const auto& [row_offset, x_offsets] : x_offsets_per_row)
+                {
+                    const coord_t source_y = y - row_offset.first;
+                    const coord_t source_z = z - row_offset.second;
+                    if (source_y < 0 || source_y >= size_.y_ || source_z < 0 || source_z >= size_.z_)
+                    {
+                        continue;
+                    }
+                    const uint64_t* source_row = &words_[getWordIndex(source_y, source_z)];
+                    if (std::all_of(source_row, source_row + words_per_row_, [](const uint64_t word) { return word == 0; }))
+                    {
+                        continue;
+                    }
+                    for (const coord_t x_offset : x_offsets)
+                    {
+                        for (size_t word_idx = 0; word_idx < words_per_row_; word_idx++)
+                        {
+                            result_row[word_idx] |= getShiftedWord(source_row, words_per_row_, word_idx, x_offset);
+                        }
+                    }
+                }
+                result_row[words_per_row_ - 1] &= last_word_mask; // Cells shifted beyond the end of the row are out of bounds.
+            }
+        });
+    return result;
+}
+
+void VoxelGrid::intersect(const VoxelGrid& other)
+{
+    assert(min_ == other.min_ && size_ == other.size_ && "Only grids with the same bounds can be combined.");
+    for (size_t word_idx = 0; word_idx < words_.size(); word_idx++)
+    {
+        words_[word_idx] &= other.words_[word_idx];
+    }
+}
+
+void VoxelGrid::subtract(const VoxelGrid& other)
+{
+    assert(min_ == other.min_ && size_ == other.size_ && "Only grids with the same bounds can be combined.");
+    for (size_t word_idx = 0; word_idx < words_.size(); word_idx++)
+    {
+        words_[word_idx] &= ~other.words_[word_idx];
+    }
+}
+
+size_t VoxelGrid::size() const
+{
+    return std::accumulate(
+        words_.begin(),
+        words_.end(),
+        size_t(0),
+        [](const size_t total, const uint64_t word)
+        {
+            return total + static_cast<size_t>(std::popcount(word));
+        });
+}
+
+bool VoxelGrid::empty() const
+{
+    return std::all_of(
+        words_.begin(),
+        words_.end(),
+        [](const uint64_t word)
+        {
+            return word == 0;
+        });
+}
+
+} // namespace cura
@@ -3,7 +3,9 @@
 
 #include "utils/polygon.h"
 
+#include <optional>
 #include <unordered_set>
+#include <utility>
 
 #include <boost/geometry/geometries/point_xy.hpp>
 #include <boost/geometry/geometries/polygon.hpp>
@@ -17,8 +19,10 @@
 #include <range/v3/view/transform.hpp>
 #include <range/v3/view/zip.hpp>
 
+#include "utils/ClipperStatistics.h"
 #include "utils/ListPolyIt.h"
 #include "utils/PolylineStitcher.h"
+#include "utils/ThreadPool.h"
 #include "utils/linearAlg2D.h" // pointLiesOnTheRightOfLine
 
 namespace cura
@@ -284,15 +288,215 @@ size_t Polygons::findInside(Point2LL p, bool border_result)
     return ret;
 }
 
+namespace
+{
+/*!
+ * Lends the engine of the current thread to a single polygon operation.
+ *
+ * Constructing an engine is cheap, but it grows buffers while sweeping, which
+ * a reused engine keeps. The engine is cleared when it is given back, so only
+ * the buffers remain, not the paths of the operation. If the engine of the
+ * thread is already lent out, a new one is used instead.
+ */
+template<typename Engine>
+class ReusedEngine
+{
+public:
+    ReusedEngine()
+    {
+        if (std::exchange(lent_, true))
+        {
+            engine_ = &fallback_.emplace();
+        }
+        else
+        {
+            engine_ = &thread_engine_;
+        }
+    }
+
+    ReusedEngine(const ReusedEngine&) = delete;
+    ReusedEngine& operator=(const ReusedEngine&) = delete;
+
+    ~ReusedEngine()
+    {
+        if (engine_ == &thread_engine_)
+        {
+            thread_engine_.Clear();
+            lent_ = false;
+        }
+    }
+
+    Engine* operator->()
+    {
+        return engine_;
+    }
+
+private:
+    inline static thread_local Engine thread_engine_;
+    inline static thread_local bool lent_ = false;
+    Engine* engine_;
+    std::optional<Engine> fallback_;
+};
+
+/*!
+ * Do a boolean operation on two polygons and count it for the statistics.
+ *
+ * The operands are copied into the engine first, so the result may be one of
+ * the operands, to reuse its memory.
+ * \param operation The operation to count it as.
+ * \param clip_type The boolean operation. For a union, both operands are
+ * subjects.
+ */
+void executeBoolean(
+    const ClipperStatistics::Operation operation,
+    const ClipperLib::ClipType clip_type,
+    const Polygons& subject,
+    const Polygons& clip,
+    Polygons& result,
+    const ClipperLib::PolyFillType fill_type)
+{
+    const ClipperOperationCounter counter(operation);
+    const size_t input_vertices = counter.isEnabled() ? subject.pointCount() + clip.pointCount() : 0;
+    {
+        ReusedEngine<ClipperLib::Clipper> clipper;
+        clipper->AddPaths(subject.paths, ClipperLib::ptSubject, true);
+        clipper->AddPaths(clip.paths, clip_type == ClipperLib::ctUnion ? ClipperLib::ptSubject : ClipperLib::ptClip, true);
+        clipper->Execute(clip_type, result.paths, fill_type, fill_type);
+    }
+    if (counter.isEnabled())
+    {
+        counter.finish(input_vertices, result.pointCount());
+    }
+}
+
+/*!
+ * Union polygons, then offset them, and count it for the statistics.
+ *
+ * The result may be the input, to reuse its memory.
+ */
+void executeOffset(const Polygons& input, Polygons& result, const coord_t distance, const ClipperLib::JoinType join_type, const double miter_limit)
+{
+    const ClipperOperationCounter counter(ClipperStatistics::Operation::OFFSET);
+    const size_t input_vertices = counter.isEnabled() ? input.pointCount() : 0;
+    {
+        ReusedEngine<ClipperLib::Clipper> clipper;
+        clipper->AddPaths(input.paths, ClipperLib::ptSubject, true);
+        clipper->Execute(ClipperLib::ctUnion, result.paths, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    }
+    {
+        ReusedEngine<ClipperLib::ClipperOffset> clipper;
+        clipper->MiterLimit = miter_limit;
+        clipper->ArcTolerance = 10.0;
+        clipper->AddPaths(result.paths, join_type, ClipperLib::etClosedPolygon);
+        clipper->Execute(result.paths, distance);
+    }
+    if (counter.isEnabled())
+    {
+        counter.finish(input_vertices, result.pointCount());
+    }
+}
+} // namespace
+
+Polygons Polygons::difference(const Polygons& other) const&
+{
+    Polygons ret;
+    executeBoolean(ClipperStatistics::Operation::DIFFERENCE, ClipperLib::ctDifference, *this, other, ret, ClipperLib::pftEvenOdd);
+    return ret;
+}
+
+Polygons Polygons::difference(const Polygons& other) &&
+{
+    executeBoolean(ClipperStatistics::Operation::DIFFERENCE, ClipperLib::ctDifference, *this, other, *this, ClipperLib::pftEvenOdd);
+    return std::move(*this);
+}
+
+Polygons Polygons::unionPolygons(const Polygons& other, ClipperLib::PolyFillType fill_type) const&
+{
+    Polygons ret;
+    executeBoolean(ClipperStatistics::Operation::UNION, ClipperLib::ctUnion, *this, other, ret, fill_type);
+    return ret;
+}
+
+Polygons Polygons::unionPolygons(const Polygons& other, ClipperLib::PolyFillType fill_type) &&
+{
+    executeBoolean(ClipperStatistics::Operation::UNION, ClipperLib::ctUnion, *this, other, *this, fill_type);
+    return std::move(*this);
+}
+
+Polygons Polygons::unionAll(const std::vector<Polygons>& inputs, ClipperLib::PolyFillType fill_type)
+{
+    const ClipperOperationCounter counter(ClipperStatistics::Operation::UNION);
+    Polygons ret;
+    ReusedEngine<ClipperLib::Clipper> clipper;
+    for (const Polygons& input : inputs)
+    {
+        clipper->AddPaths(input.paths, ClipperLib::ptSubject, true);
+    }
+    clipper->Execute(ClipperLib::ctUnion, ret.paths, fill_type, fill_type);
+    if (counter.isEnabled())
+    {
+        size_t input_vertices = 0;
+        for (const Polygons& input : inputs)
+        {
+            input_vertices += input.pointCount();
+        }
+        counter.finish(input_vertices, ret.pointCount());
+    }
+    return ret;
+}
+
+Polygons Polygons::unionAllParallel(std::vector<Polygons> inputs, const size_t group_size)
+{
+    assert(group_size >= 2);
+    while (inputs.size() > group_size)
+    {
+        std::vector<Polygons> group_unions(round_up_divide(inputs.size(), group_size));
+        cura::parallel_for<size_t>(
+            0,
+            group_unions.size(),
+            [&](const size_t group_idx)
+            {
+                const auto group_begin = inputs.begin() + group_idx * group_size;
+                const auto group_end = inputs.begin() + std::min((group_idx + 1) * group_size, inputs.size());
+                group_unions[group_idx] = unionAll(std::vector<Polygons>(std::make_move_iterator(group_begin), std::make_move_iterator(group_end)));
+            });
+        inputs = std::move(group_unions);
+    }
+    return unionAll(inputs);
+}
+
+Polygons Polygons::intersection(const Polygons& other) const&
+{
+    Polygons ret;
+    executeBoolean(ClipperStatistics::Operation::INTERSECTION, ClipperLib::ctIntersection, *this, other, ret, ClipperLib::pftEvenOdd);
+    return ret;
+}
+
+Polygons Polygons::intersection(const Polygons& other) &&
+{
+    executeBoolean(ClipperStatistics::Operation::INTERSECTION, ClipperLib::ctIntersection, *this, other, *this, ClipperLib::pftEvenOdd);
+    return std::move(*this);
+}
+
+Polygons Polygons::xorPolygons(const Polygons& other, ClipperLib::PolyFillType pft) const
+{
+    Polygons ret;
+    executeBoolean(ClipperStatistics::Operation::XOR, ClipperLib::ctXor, *this, other, ret, pft);
+    return ret;
+}
+
 Polygons Polygons::intersectionPolyLines(const Polygons& polylines, bool restitch, const coord_t max_stitch_distance) const
 {
+    const ClipperOperationCounter counter(ClipperStatistics::Operation::INTERSECTION_POLYLINES);
     Polygons split_polylines = polylines.splitPolylinesIntoSegments();
 
     ClipperLib::PolyTree result;
-    ClipperLib::Clipper clipper(clipper_init);
-    clipper.AddPaths(split_polylines.paths, ClipperLib::ptSubject, false);
-    clipper.AddPaths(paths, ClipperLib::ptClip, true);
-    clipper.Execute(ClipperLib::ctIntersection, result);
+    {
+        ReusedEngine<ClipperLib::Clipper> clipper;
+        clipper->AddPaths(split_polylines.paths, ClipperLib::ptSubject, false);
+        clipper->AddPaths(paths, ClipperLib::ptClip, true);
+        clipper->Execute(ClipperLib::ctIntersection, result);
+    }
     Polygons ret;
     ClipperLib::OpenPathsFromPolyTree(result, ret.paths);
 
@@ -315,6 +519,10 @@ Polygons Polygons::intersectionPolyLines(const Polygons& polylines, bool restitc
         }
     }
 
+    if (counter.isEnabled())
+    {
+        counter.finish(pointCount() + polylines.pointCount(), ret.pointCount());
+    }
     return ret;
 }
 
@@ -366,20 +574,26 @@ coord_t Polygons::polyLineLength() const
     return length;
 }
 
-Polygons Polygons::offset(coord_t distance, ClipperLib::JoinType join_type, double miter_limit) const
+Polygons Polygons::offset(coord_t distance, ClipperLib::JoinType join_type, double miter_limit) const&
 {
     if (distance == 0)
     {
         return *this;
     }
     Polygons ret;
-    ClipperLib::ClipperOffset clipper(miter_limit, 10.0);
-    clipper.AddPaths(unionPolygons().paths, join_type, ClipperLib::etClosedPolygon);
-    clipper.MiterLimit = miter_limit;
-    clipper.Execute(ret.paths, distance);
+    executeOffset(*this, ret, distance, join_type, miter_limit);
     return ret;
 }
 
+Polygons Polygons::offset(coord_t distance, ClipperLib::JoinType join_type, double miter_limit) &&
+{
+    if (distance != 0)
+    {
+        executeOffset(*this, *this, distance, join_type, miter_limit);
+    }
+    return std::move(*this);
+}
+
 Polygons Polygons::offset(const std::vector<coord_t>& offset_dists) const
 {
     // we need as many offset-dists as points
@@ -437,10 +651,11 @@ Polygons ConstPolygonRef::offset(int distance, ClipperLib::JoinType join_type, d
         return ret;
     }
     Polygons ret;
-    ClipperLib::ClipperOffset clipper(miter_limit, 10.0);
-    clipper.AddPath(*path, join_type, ClipperLib::etClosedPolygon);
-    clipper.MiterLimit = miter_limit;
-    clipper.Execute(ret.paths, distance);
+    ReusedEngine<ClipperLib::ClipperOffset> clipper;
+    clipper->MiterLimit = miter_limit;
+    clipper->ArcTolerance = 10.0;
+    clipper->AddPath(*path, join_type, ClipperLib::etClosedPolygon);
+    clipper->Execute(ret.paths, distance);
     return ret;
 }
 
@@ -1533,19 +1533,19 @@ void PolygonUtils::fixSelfIntersections(const coord_t epsilon, Polygons& thiss)
 
 Polygons PolygonUtils::unionManySmall(const Polygons& p)
 {
-    if (p.paths.size() < 8)
+    constexpr size_t group_size = 8;
+    if (p.paths.size() < group_size)
     {
         return p.unionPolygons();
     }
 
-    Polygons a, b;
-    a.paths.reserve(p.paths.size() / 2);
-    b.paths.reserve(a.paths.size() + 1);
+    // Consecutive paths are mostly close to each other, so unioning them in groups removes most of the overlap in small sweeps.
+    std::vector<Polygons> groups(round_up_divide(p.paths.size(), group_size));
     for (const auto& [i, path] : p.paths | ranges::views::enumerate)
     {
-        (i % 2 == 0 ? b : a).paths.push_back(path);
+        groups[i / group_size].paths.push_back(path);
     }
-    return unionManySmall(a).unionPolygons(unionManySmall(b));
+    return Polygons::unionAllParallel(std::move(groups));
 }
 
 Polygons PolygonUtils::clipPolygonWithAABB(const Polygons& src, const AABB& aabb)
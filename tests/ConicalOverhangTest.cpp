@@ -0,0 +1,186 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "ConicalOverhang.h" //The unit under test.
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "Application.h" //To start the thread pool.
+#include "ReadTestPolygons.h" //To make the layers.
+#include "settings/Settings.h"
+#include "settings/types/Angle.h"
+#include "slicer.h"
+#include "utils/Simplify.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class ConicalOverhangTest : public testing::Test
+{
+public:
+    Settings settings;
+
+    void SetUp() override
+    {
+        Application::getInstance().startThreadPool();
+        settings.add("conical_overhang_angle", "50");
+        settings.add("conical_overhang_hole_size", "10");
+        settings.add("layer_height", "0.1");
+    }
+
+    /*!
+     * Conical overhang as it was computed before, one layer after another
+     * from the top down.
+     */
+    static void applyInSequence(std::vector<SlicerLayer>& layers, const Settings& settings)
+    {
+        const AngleRadians angle = settings.get<AngleRadians>("conical_overhang_angle");
+        const double maxHoleArea = settings.get<double>("conical_overhang_hole_size");
+        const double tan_angle = tan(angle);
+        const coord_t layer_thickness = settings.get<coord_t>("layer_height");
+        coord_t max_dist_from_lower_layer = std::llround(tan_angle * static_cast<double>(layer_thickness));
+
+        for (int layer_nr = static_cast<int>(layers.size()) - 2; layer_nr >= 0; layer_nr--)
+        {
+            SlicerLayer& layer = layers[layer_nr];
+            SlicerLayer& layer_above = layers[layer_nr + 1];
+            if (std::abs(max_dist_from_lower_layer) < 5)
+            {
+                constexpr coord_t safe_dist = 20;
+                Polygons diff = layer_above.polygons.difference(layer.polygons.offset(-safe_dist));
+                layer.polygons = layer.polygons.unionPolygons(diff);
+                layer.polygons = layer.polygons.smooth(safe_dist);
+                layer.polygons = Simplify(safe_dist, safe_dist / 2, 0).polygon(layer.polygons);
+            }
+            else
+            {
+                std::vector<PolygonsPart> layerParts = layer.polygons.splitIntoParts();
+                Polygons above = layer_above.polygons;
+                for (const PolygonsPart& part : layerParts)
+                {
+                    for (unsigned int hole_nr = 1; hole_nr < part.size(); ++hole_nr)
+                    {
+                        Polygons holePoly;
+                        holePoly.add(part[hole_nr]);
+                        if (maxHoleArea > 0.0 && INT2MM2(std::abs(holePoly.area())) < maxHoleArea)
+                        {
+                            Polygons holeWithAbove = holePoly.intersection(above);
+                            if (! holeWithAbove.empty() && holePoly.xorPolygons(holeWithAbove).empty())
+                            {
+                                above = above.difference(holePoly);
+                            }
+                        }
+                    }
+                }
+                layer.polygons = layer.polygons.unionPolygons(above.offset(-max_dist_from_lower_layer));
+            }
+        }
+    }
+
+    /*!
+     * A model with holes that start and end at random heights, some of which
+     * contain an island with a hole of its own, and parts that hang over.
+     */
+    static std::vector<SlicerLayer> makeLayers(const unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<coord_t> position(-15000, 15000);
+        std::uniform_int_distribution<size_t> height(0, 60);
+
+        constexpr size_t layer_count = 80;
+        std::vector<SlicerLayer> layers(layer_count);
+        for (SlicerLayer& layer : layers)
+        {
+            layer.polygons = makeSquare(Point2LL(0, 0), 40000);
+        }
+        for (size_t hole_idx = 0; hole_idx < 12; hole_idx++)
+        {
+            const Point2LL center(position(generator), position(generator));
+            const size_t bottom = height(generator);
+            const size_t top = bottom + height(generator) / 2;
+            const bool with_island = hole_idx % 3 == 0;
+            for (size_t layer_nr = bottom; layer_nr < std::min(top, layer_count); layer_nr++)
+            {
+                layers[layer_nr].polygons = layers[layer_nr].polygons.difference(makeSquare(center, 3000));
+                if (with_island)
+                {
+                    layers[layer_nr].polygons.add(makeSquare(center, 2000));
+                    layers[layer_nr].polygons.add(makeSquare(center, 1000, true));
+                }
+            }
+        }
+        for (size_t overhang_idx = 0; overhang_idx < 3; overhang_idx++)
+        {
+            const Point2LL center(position(generator) * 3, position(generator) * 3);
+            for (size_t layer_nr = height(generator); layer_nr < layer_count; layer_nr++)
+            {
+                layers[layer_nr].polygons = layers[layer_nr].polygons.unionPolygons(makeSquare(center, 10000));
+            }
+        }
+        return layers;
+    }
+
+    static void expectSameLayers(const std::vector<SlicerLayer>& expected, const std::vector<SlicerLayer>& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t layer_nr = 0; layer_nr < expected.size(); layer_nr++)
+        {
+            EXPECT_TRUE(expected[layer_nr].polygons.xorPolygons(actual[layer_nr].polygons).empty()) << "Layer " << layer_nr << " differs from the sequential result.";
+            EXPECT_EQ(expected[layer_nr].polygons.area(), actual[layer_nr].polygons.area()) << "Layer " << layer_nr;
+        }
+    }
+};
+
+TEST_F(ConicalOverhangTest, SameAsSequential)
+{
+    for (unsigned int seed = 0; seed < 5; seed++)
+    {
+        std::vector<SlicerLayer> expected = makeLayers(seed);
+        std::vector<SlicerLayer> actual = expected;
+        applyInSequence(expected, settings);
+        ConicalOverhang::apply(actual, settings);
+        expectSameLayers(expected, actual);
+    }
+}
+
+TEST_F(ConicalOverhangTest, SameAsSequentialWithoutHoleRemoval)
+{
+    settings.add("conical_overhang_hole_size", "0");
+    std::vector<SlicerLayer> expected = makeLayers(0);
+    std::vector<SlicerLayer> actual = expected;
+    applyInSequence(expected, settings);
+    ConicalOverhang::apply(actual, settings);
+    expectSameLayers(expected, actual);
+}
+
+TEST_F(ConicalOverhangTest, SameAsSequentialSmallAngle)
+{
+    settings.add("conical_overhang_angle", "1"); // So small that the overhang can't be offset by it.
+    std::vector<SlicerLayer> expected = makeLayers(0);
+    std::vector<SlicerLayer> actual = expected;
+    applyInSequence(expected, settings);
+    ConicalOverhang::apply(actual, settings);
+    expectSameLayers(expected, actual);
+}
+
+TEST_F(ConicalOverhangTest, IslandInCoveredHole)
+{
+    // A hole with an island in it that has a hole of its own, all covered by the layer above.
+    // Once the inner hole is removed from the layer above, that no longer covers the outer hole.
+    std::vector<SlicerLayer> layers(2);
+    layers[0].polygons = makeSquare(Point2LL(0, 0), 40000);
+    layers[0].polygons.add(makeSquare(Point2LL(0, 0), 3000, true));
+    layers[0].polygons.add(makeSquare(Point2LL(0, 0), 2000));
+    layers[0].polygons.add(makeSquare(Point2LL(0, 0), 1000, true));
+    layers[1].polygons = makeSquare(Point2LL(0, 0), 40000);
+    std::vector<SlicerLayer> expected = layers;
+    applyInSequence(expected, settings);
+    ConicalOverhang::apply(layers, settings);
+    expectSameLayers(expected, layers);
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
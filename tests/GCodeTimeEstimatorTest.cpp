@@ -0,0 +1,98 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "GCodeTimeEstimator.h" //The unit under test.
+
+#include <numeric>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "PrintFeature.h"
+#include "settings/types/Duration.h"
+#include "timeEstimate.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+#define EPSILON 0.00001 // Allowed error in comparing floating point values.
+
+TEST(GCodeTimeEstimatorTest, SameAsCalculator)
+{
+    std::istringstream gcode(
+        "G0 F6000 X10 Y10\n"
+        ";TYPE:WALL-OUTER\n"
+        "G1 F1800 X20 Y10 E1\n"
+        "G1 X20 Y20 E2 ; A comment after a command.\n"
+        "G1 F2400 E1\n"
+        "G0 F6000 X0 Y0\n");
+    GCodeTimeEstimator estimator;
+    estimator.process(gcode);
+    const std::vector<Duration> result = estimator.calculate();
+
+    TimeEstimateCalculator calculator;
+    calculator.setPosition(TimeEstimateCalculator::Position(0, 0, 0, 0));
+    calculator.plan(TimeEstimateCalculator::Position(10, 10, 0, 0), 100.0, PrintFeatureType::MoveCombing);
+    calculator.plan(TimeEstimateCalculator::Position(20, 10, 0, 1), 30.0, PrintFeatureType::OuterWall);
+    calculator.plan(TimeEstimateCalculator::Position(20, 20, 0, 2), 30.0, PrintFeatureType::OuterWall);
+    calculator.plan(TimeEstimateCalculator::Position(20, 20, 0, 1), 40.0, PrintFeatureType::MoveRetraction);
+    calculator.plan(TimeEstimateCalculator::Position(0, 0, 0, 1), 100.0, PrintFeatureType::MoveRetraction); // Travels while retracted count as retraction.
+    const std::vector<Duration> expected = calculator.calculate();
+
+    ASSERT_EQ(result.size(), expected.size());
+    for (size_t feature_idx = 0; feature_idx < expected.size(); feature_idx++)
+    {
+        EXPECT_NEAR(result[feature_idx], expected[feature_idx], EPSILON) << "Feature " << feature_idx;
+    }
+    EXPECT_GT(result[static_cast<size_t>(PrintFeatureType::OuterWall)], 0.0);
+    EXPECT_GT(result[static_cast<size_t>(PrintFeatureType::MoveRetraction)], 0.0);
+}
+
+TEST(GCodeTimeEstimatorTest, LayerTimes)
+{
+    std::istringstream gcode(
+        "G28\n"
+        ";LAYER:0\n"
+        ";TYPE:FILL\n"
+        "G1 F3000 X50 E5\n"
+        ";LAYER:1\n"
+        "G1 Z0.2\n"
+        "G1 X0 E10\n"
+        "G4 P2000\n");
+    GCodeTimeEstimator estimator;
+    estimator.process(gcode);
+    const std::vector<Duration> result = estimator.calculate();
+
+    const std::vector<Duration>& layer_times = estimator.getLayerTimes();
+    ASSERT_EQ(layer_times.size(), 2);
+    EXPECT_GT(layer_times[0], 1.0) << "50mm at 50mm/s takes at least a second.";
+    EXPECT_GT(layer_times[1], layer_times[0]) << "The second layer also waits 2 seconds.";
+    EXPECT_NEAR(result[static_cast<size_t>(PrintFeatureType::NoneType)], 2.0, EPSILON) << "Dwelling counts as extra time.";
+    EXPECT_NEAR(std::accumulate(result.begin(), result.end(), Duration(0.0)), layer_times[0] + layer_times[1], EPSILON);
+}
+
+TEST(GCodeTimeEstimatorTest, RelativeExtrusion)
+{
+    std::istringstream absolute_gcode(
+        ";TYPE:SKIN\n"
+        "G1 F1200 X10 E1\n"
+        "G92 E0\n"
+        "G1 X20 E1\n");
+    std::istringstream relative_gcode(
+        ";TYPE:SKIN\n"
+        "M83\n"
+        "G1 F1200 X10 E1\n"
+        "G1 X20 E1\n");
+    GCodeTimeEstimator absolute_estimator;
+    absolute_estimator.process(absolute_gcode);
+    GCodeTimeEstimator relative_estimator;
+    relative_estimator.process(relative_gcode);
+
+    const Duration absolute_time = absolute_estimator.calculate()[static_cast<size_t>(PrintFeatureType::Skin)];
+    EXPECT_GT(absolute_time, 0.0);
+    EXPECT_NEAR(absolute_time, relative_estimator.calculate()[static_cast<size_t>(PrintFeatureType::Skin)], EPSILON);
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
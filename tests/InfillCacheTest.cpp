@@ -0,0 +1,133 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "infill/InfillCache.h" //The unit under test.
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include <scripta/logger.h>
+
+#include "ReadTestPolygons.h" //To make the outline.
+#include "infill.h"
+#include "slicer.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class InfillCacheTest : public testing::Test
+{
+public:
+    void TearDown() override
+    {
+        InfillCache::getInstance().reset(0); // Some tests enable the cache of the whole process, which must not stay enabled for other tests.
+    }
+
+    static std::string makeKey(const size_t key)
+    {
+        return std::to_string(key);
+    }
+
+    static InfillCache::Result makeResult(const coord_t line_length)
+    {
+        InfillCache::Result result;
+        result.result_lines.addLine(Point2LL(0, 0), Point2LL(line_length, 0));
+        return result;
+    }
+};
+
+TEST_F(InfillCacheTest, FindAfterInsert)
+{
+    InfillCache cache(1024 * 1024);
+    EXPECT_TRUE(cache.isEnabled());
+    EXPECT_EQ(cache.find("key"), nullptr);
+
+    cache.insert("key", makeResult(500));
+    const std::shared_ptr<const InfillCache::Result> found = cache.find("key");
+    ASSERT_NE(found, nullptr);
+    ASSERT_EQ(found->result_lines.size(), 1);
+    EXPECT_EQ(found->result_lines[0][1], Point2LL(500, 0));
+
+    EXPECT_EQ(cache.find("key2"), nullptr);
+    EXPECT_EQ(cache.find("ke"), nullptr) << "Only the exact key may be found.";
+    EXPECT_EQ(cache.getStatistics().hits, 1);
+    EXPECT_EQ(cache.getStatistics().misses, 3);
+}
+
+TEST_F(InfillCacheTest, Disabled)
+{
+    InfillCache cache(0);
+    EXPECT_FALSE(cache.isEnabled());
+    cache.insert("key", makeResult(500));
+    EXPECT_EQ(cache.find("key"), nullptr);
+}
+
+TEST_F(InfillCacheTest, EvictLeastRecentlyUsed)
+{
+    InfillCache cache(1);
+    cache.insert(makeKey(0), makeResult(500));
+    EXPECT_EQ(cache.find(makeKey(0)), nullptr) << "A result larger than the maximum size must not be stored.";
+
+    constexpr size_t entry_count = 20;
+    cache.reset(2048);
+    for (size_t key = 0; key < entry_count; key++)
+    {
+        cache.insert(makeKey(key), makeResult(500));
+    }
+
+    // The oldest entries must have been evicted, the newest kept. Looking them up from old to new keeps them in the same order of use.
+    size_t first_kept = 0;
+    while (first_kept < entry_count && cache.find(makeKey(first_kept)) == nullptr)
+    {
+        first_kept++;
+    }
+    ASSERT_GT(first_kept, 0) << "The cache must be too small for all entries.";
+    ASSERT_LT(first_kept + 2, entry_count) << "The cache must be large enough for more than two entries.";
+    for (size_t key = first_kept + 1; key < entry_count; key++)
+    {
+        EXPECT_NE(cache.find(makeKey(key)), nullptr);
+    }
+
+    // Use the oldest entry, so that the second oldest is evicted by a new entry instead.
+    ASSERT_NE(cache.find(makeKey(first_kept)), nullptr);
+    cache.insert(makeKey(entry_count), makeResult(500));
+    EXPECT_NE(cache.find(makeKey(first_kept)), nullptr);
+    EXPECT_EQ(cache.find(makeKey(first_kept + 1)), nullptr);
+    EXPECT_NE(cache.find(makeKey(entry_count)), nullptr);
+    EXPECT_GT(cache.getStatistics().evictions, 0);
+}
+
+TEST_F(InfillCacheTest, GenerateReusesResultAcrossLayers)
+{
+    auto layers = std::vector<SlicerLayer>(200, SlicerLayer{});
+    scripta::setAll(layers);
+    const Polygons outline = makeSquare(Point2LL(MM2INT(10), MM2INT(10)), MM2INT(20));
+    const Settings settings;
+    const auto generate = [&outline, &settings](const coord_t z, Polygons& result_lines)
+    {
+        Infill infill(EFillMethod::LINES, false, false, outline, 400, 800, 0, 1, AngleDegrees(45), z, 0, 10, 5);
+        std::vector<VariableWidthLines> toolpaths;
+        Polygons result_polygons;
+        infill.generate(toolpaths, result_polygons, result_lines, settings, 0, SectionType::INFILL);
+    };
+
+    Polygons uncached_lines;
+    generate(100, uncached_lines);
+    ASSERT_FALSE(uncached_lines.empty());
+
+    InfillCache::getInstance().reset(1024 * 1024 * 16);
+    Polygons first_lines;
+    generate(100, first_lines);
+    EXPECT_EQ(InfillCache::getInstance().getStatistics().hits, 0);
+    EXPECT_EQ(InfillCache::getInstance().getStatistics().misses, 1);
+    Polygons second_lines;
+    generate(200, second_lines); // Lines infill doesn't depend on the height, so this is the same result.
+    EXPECT_EQ(InfillCache::getInstance().getStatistics().hits, 1) << "The second layer must reuse the result of the first.";
+
+    EXPECT_EQ(first_lines.paths, uncached_lines.paths);
+    EXPECT_EQ(second_lines.paths, uncached_lines.paths);
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
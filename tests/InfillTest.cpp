@@ -6,7 +6,11 @@
 #include "slicer.h"
 #include "utils/Coord_t.h"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <filesystem>
+#include <random>
+#include <tuple>
+#include <unordered_set>
 #include <utility>
 #include <fmt/format.h>
 
@@ -225,6 +229,155 @@ std::vector<InfillTestParameters> generateInfillTests()
 
 class InfillTest : public testing::TestWithParam<InfillTestParameters>
 {
+public:
+    /*!
+     * Generate the lines of a pattern with lines in multiple directions, as the infill does: all directions at once.
+     */
+    static void generateAllDirections(Infill& infill, Polygons& result_lines)
+    {
+        infill.inner_contour_ = infill.outer_contour_;
+        switch (infill.pattern_)
+        {
+        case EFillMethod::GRID:
+            infill.generateGridInfill(result_lines);
+            break;
+        case EFillMethod::TRIANGLES:
+            infill.generateTriangleInfill(result_lines);
+            break;
+        case EFillMethod::TRIHEXAGON:
+            infill.generateTrihexagonInfill(result_lines);
+            break;
+        case EFillMethod::CUBIC:
+            infill.generateCubicInfill(result_lines);
+            break;
+        case EFillMethod::TETRAHEDRAL:
+            infill.generateTetrahedralInfill(result_lines);
+            break;
+        case EFillMethod::QUARTER_CUBIC:
+            infill.generateQuarterCubicInfill(result_lines);
+            break;
+        default:
+            FAIL() << "Pattern " << static_cast<int>(infill.pattern_) << " doesn't consist of lines in multiple directions.";
+        }
+    }
+
+    /*!
+     * Generate the lines of a pattern with lines in multiple directions as it was done before: one direction after another.
+     */
+    static void generateEachDirection(Infill& infill, Polygons& result_lines)
+    {
+        infill.inner_contour_ = infill.outer_contour_;
+        const auto generate_half_tetrahedral = [&infill, &result_lines](const double pattern_z_shift, const int angle_shift)
+        {
+            const coord_t period = infill.line_distance_ * 2;
+            coord_t shift = coord_t(Infill::one_over_sqrt_2 * (infill.z_ + pattern_z_shift * period * 2)) % period;
+            shift = std::min(shift, period - shift);
+            shift = std::min(shift, period / 2 - infill.infill_line_width_ / 2);
+            shift = std::max(shift, infill.infill_line_width_ / 2);
+            infill.generateLineInfill(result_lines, period, infill.fill_angle_ + angle_shift, shift);
+            infill.generateLineInfill(result_lines, period, infill.fill_angle_ + angle_shift, -shift);
+        };
+        const coord_t line_distance = infill.line_distance_;
+        const AngleDegrees fill_angle = infill.fill_angle_;
+        switch (infill.pattern_)
+        {
+        case EFillMethod::GRID:
+            infill.generateLineInfill(result_lines, line_distance, fill_angle, 0);
+            infill.generateLineInfill(result_lines, line_distance, fill_angle + 90, 0);
+            break;
+        case EFillMethod::TRIANGLES:
+            infill.generateLineInfill(result_lines, line_distance, fill_angle, 0);
+            infill.generateLineInfill(result_lines, line_distance, fill_angle + 60, 0);
+            infill.generateLineInfill(result_lines, line_distance, fill_angle + 120, 0);
+            break;
+        case EFillMethod::TRIHEXAGON:
+            infill.generateLineInfill(result_lines, line_distance, fill_angle, 0);
+            infill.generateLineInfill(result_lines, line_distance, fill_angle + 60, 0);
+            infill.generateLineInfill(result_lines, line_distance, fill_angle + 120, line_distance / 2);
+            break;
+        case EFillMethod::CUBIC:
+        {
+            const coord_t shift = Infill::one_over_sqrt_2 * infill.z_;
+            infill.generateLineInfill(result_lines, line_distance, fill_angle, shift);
+            infill.generateLineInfill(result_lines, line_distance, fill_angle + 120, shift);
+            infill.generateLineInfill(result_lines, line_distance, fill_angle + 240, shift);
+            break;
+        }
+        case EFillMethod::TETRAHEDRAL:
+            generate_half_tetrahedral(0.0, 0);
+            generate_half_tetrahedral(0.0, 90);
+            break;
+        case EFillMethod::QUARTER_CUBIC:
+            generate_half_tetrahedral(0.0, 0);
+            generate_half_tetrahedral(0.5, 90);
+            break;
+        default:
+            FAIL() << "Pattern " << static_cast<int>(infill.pattern_) << " doesn't consist of lines in multiple directions.";
+        }
+    }
+
+    /*!
+     * Check that two infills generated exactly the same lines, and the same infill line segments for \ref Infill::connectLines.
+     */
+    static void expectSameLines(const Infill& expected, const Polygons& expected_lines, const Infill& actual, const Polygons& actual_lines, const std::string& description)
+    {
+        EXPECT_EQ(actual_lines.paths, expected_lines.paths) << description;
+        const bool has_segments = std::any_of(
+            expected.crossings_on_line_.begin(),
+            expected.crossings_on_line_.end(),
+            [](const std::vector<std::vector<Infill::InfillLineSegment*>>& crossings_on_polygon)
+            {
+                return std::any_of(
+                    crossings_on_polygon.begin(),
+                    crossings_on_polygon.end(),
+                    [](const std::vector<Infill::InfillLineSegment*>& crossings)
+                    {
+                        return ! crossings.empty();
+                    });
+            });
+        EXPECT_TRUE(! expected_lines.empty() || has_segments) << description << " generated no lines at all, so it checks nothing.";
+        ASSERT_EQ(actual.crossings_on_line_.size(), expected.crossings_on_line_.size()) << description;
+        for (size_t poly_idx = 0; poly_idx < expected.crossings_on_line_.size(); poly_idx++)
+        {
+            ASSERT_EQ(actual.crossings_on_line_[poly_idx].size(), expected.crossings_on_line_[poly_idx].size()) << description << ", polygon " << poly_idx;
+            for (size_t vertex_idx = 0; vertex_idx < expected.crossings_on_line_[poly_idx].size(); vertex_idx++)
+            {
+                const std::vector<Infill::InfillLineSegment*>& expected_segments = expected.crossings_on_line_[poly_idx][vertex_idx];
+                const std::vector<Infill::InfillLineSegment*>& actual_segments = actual.crossings_on_line_[poly_idx][vertex_idx];
+                ASSERT_EQ(actual_segments.size(), expected_segments.size()) << description << ", polygon " << poly_idx << ", vertex " << vertex_idx;
+                for (size_t segment_idx = 0; segment_idx < expected_segments.size(); segment_idx++)
+                {
+                    const Infill::InfillLineSegment& expected_segment = *expected_segments[segment_idx];
+                    const Infill::InfillLineSegment& actual_segment = *actual_segments[segment_idx];
+                    EXPECT_TRUE(
+                        actual_segment.start_ == expected_segment.start_ && actual_segment.end_ == expected_segment.end_
+                        && actual_segment.start_segment_ == expected_segment.start_segment_ && actual_segment.start_polygon_ == expected_segment.start_polygon_
+                        && actual_segment.end_segment_ == expected_segment.end_segment_ && actual_segment.end_polygon_ == expected_segment.end_polygon_)
+                        << description << ", polygon " << poly_idx << ", vertex " << vertex_idx << ", segment " << segment_idx;
+                }
+            }
+        }
+    }
+
+    /*!
+     * Free the infill line segments, which are normally freed by \ref Infill::connectLines.
+     */
+    static void deleteCrossings(Infill& infill)
+    {
+        std::unordered_set<Infill::InfillLineSegment*> segments; // Each segment is stored for both polygon line segments that it crosses.
+        for (const std::vector<std::vector<Infill::InfillLineSegment*>>& crossings_on_polygon : infill.crossings_on_line_)
+        {
+            for (const std::vector<Infill::InfillLineSegment*>& crossings : crossings_on_polygon)
+            {
+                segments.insert(crossings.begin(), crossings.end());
+            }
+        }
+        for (Infill::InfillLineSegment* segment : segments)
+        {
+            delete segment;
+        }
+        infill.crossings_on_line_.clear();
+    }
 };
 
 INSTANTIATE_TEST_SUITE_P(InfillTestcases, InfillTest, testing::ValuesIn(generateInfillTests()), [](const testing::TestParamInfo<InfillTestParameters>& info) { return info.param.name; });
@@ -269,5 +422,103 @@ TEST_P(InfillTest, TestInfillSanity)
     ASSERT_LE(std::abs(padded_shape_outline.intersectionPolyLines(result_polygon_lines, restitch).polyLineLength() - result_polygon_lines.polyLineLength()), maximum_error) << "Infill (lines) should not be outside target polygon.";
 }
 
+class InfillLineDirectionsTest : public testing::TestWithParam<std::tuple<EFillMethod, bool>>
+{
+public:
+    /*!
+     * Outlines with edges at all sorts of angles and lengths, so that the scanlines cross them in many different places.
+     */
+    static std::vector<Polygons> makeStars()
+    {
+        std::vector<Polygons> stars;
+        std::mt19937 generator(12345);
+        std::uniform_int_distribution<coord_t> center_distribution(-MM2INT(200), MM2INT(200));
+        std::uniform_int_distribution<coord_t> radius_distribution(MM2INT(1), MM2INT(30));
+        std::uniform_int_distribution<size_t> point_count_distribution(3, 60);
+        for (size_t star_idx = 0; star_idx < 20; star_idx++)
+        {
+            const Point2LL center(center_distribution(generator), center_distribution(generator));
+            const size_t point_count = point_count_distribution(generator);
+            Polygons star;
+            PolygonRef outline = star.newPoly();
+            for (size_t point_idx = 0; point_idx < point_count; point_idx++)
+            {
+                const double angle = 2 * std::numbers::pi * static_cast<double>(point_idx) / static_cast<double>(point_count);
+                const double radius = static_cast<double>(radius_distribution(generator));
+                outline.emplace_back(center + Point2LL(std::llrint(radius * std::cos(angle)), std::llrint(radius * std::sin(angle))));
+            }
+            stars.push_back(star);
+        }
+        return stars;
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    InfillLineDirectionsTestcases,
+    InfillLineDirectionsTest,
+    testing::Combine(
+        testing::Values(EFillMethod::GRID, EFillMethod::TRIANGLES, EFillMethod::TRIHEXAGON, EFillMethod::CUBIC, EFillMethod::TETRAHEDRAL, EFillMethod::QUARTER_CUBIC),
+        testing::Bool()),
+    [](const testing::TestParamInfo<std::tuple<EFillMethod, bool>>& info)
+    {
+        return fmt::format("P{:d}_Z{:d}", static_cast<int>(std::get<0>(info.param)), std::get<1>(info.param));
+    });
+
+TEST_P(InfillLineDirectionsTest, SameAsEachDirectionInTurn)
+{
+    const EFillMethod pattern = std::get<0>(GetParam());
+    const bool zig_zaggify = std::get<1>(GetParam());
+    std::vector<Polygons> shapes;
+    ASSERT_TRUE(readTestPolygons(POLYGON_FILENAMES, shapes));
+    const std::vector<Polygons> stars = makeStars();
+    shapes.insert(shapes.end(), stars.begin(), stars.end());
+
+    const std::vector<std::pair<coord_t, Point2LL>> heights_and_origins = { { Z, Point2LL(0, 0) }, { 1337, Point2LL(1234, -567) } };
+    for (size_t shape_idx = 0; shape_idx < shapes.size(); shape_idx++)
+    {
+        for (const coord_t line_distance : { 350, 1200 })
+        {
+            for (const double fill_angle : { 0.0, 22.5, 73.0 })
+            {
+                for (const auto& [z, infill_origin] : heights_and_origins)
+                {
+                    const auto make_infill = [&, z = z, infill_origin = infill_origin]()
+                    {
+                        return Infill(
+                            pattern,
+                            zig_zaggify,
+                            false,
+                            shapes[shape_idx],
+                            INFILL_LINE_WIDTH,
+                            line_distance,
+                            INFILL_OVERLAP,
+                            INFILL_MULTIPLIER,
+                            AngleDegrees(fill_angle),
+                            z,
+                            SHIFT,
+                            MAX_RESOLUTION,
+                            MAX_DEVIATION,
+                            0,
+                            0,
+                            infill_origin,
+                            false);
+                    };
+                    Infill each_direction = make_infill();
+                    Polygons each_direction_lines;
+                    InfillTest::generateEachDirection(each_direction, each_direction_lines);
+                    Infill all_directions = make_infill();
+                    Polygons all_directions_lines;
+                    InfillTest::generateAllDirections(all_directions, all_directions_lines);
+
+                    const std::string description = fmt::format("Shape {}, line distance {}, angle {}, z {}", shape_idx, line_distance, fill_angle, z);
+                    InfillTest::expectSameLines(each_direction, each_direction_lines, all_directions, all_directions_lines, description);
+                    InfillTest::deleteCrossings(each_direction);
+                    InfillTest::deleteCrossings(all_directions);
+                }
+            }
+        }
+    }
+}
+
 } // namespace cura
 // NOLINTEND(*-magic-numbers)
\ No newline at end of file
@@ -0,0 +1,105 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "infill/LightningTreeNode.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class LightningTreeNodePoolTest : public testing::Test
+{
+public:
+    LightningTreeNodePool nodes;
+
+    std::vector<LightningTreeNodeIdx> visit(const LightningTreeNodeIdx root) const
+    {
+        std::vector<LightningTreeNodeIdx> result;
+        nodes.visitNodes(
+            root,
+            [&result](const LightningTreeNodeIdx node)
+            {
+                result.push_back(node);
+            });
+        return result;
+    }
+};
+
+TEST_F(LightningTreeNodePoolTest, AddChild)
+{
+    const LightningTreeNodeIdx root = nodes.create(Point2LL(0, 0), Point2LL(0, 0));
+    const LightningTreeNodeIdx a = nodes.addChild(root, Point2LL(100, 0));
+    const LightningTreeNodeIdx b = nodes.addChild(root, Point2LL(0, 100));
+    const LightningTreeNodeIdx c = nodes.addChild(a, Point2LL(200, 0));
+
+    EXPECT_TRUE(nodes.isRoot(root));
+    EXPECT_FALSE(nodes.isRoot(a));
+    EXPECT_EQ(visit(root), (std::vector<LightningTreeNodeIdx>{ root, a, c, b })) << "Nodes must be visited depth-first, children in insertion order.";
+    EXPECT_TRUE(nodes.hasOffspring(root, c));
+    EXPECT_TRUE(nodes.hasOffspring(a, a));
+    EXPECT_FALSE(nodes.hasOffspring(b, c));
+    EXPECT_EQ(nodes.closestNode(root, Point2LL(190, 10)), c);
+    EXPECT_EQ(nodes.getLastGroundingLocation(root), Point2LL(0, 0));
+    EXPECT_FALSE(nodes.getLastGroundingLocation(a));
+}
+
+TEST_F(LightningTreeNodePoolTest, Reroot)
+{
+    const LightningTreeNodeIdx root = nodes.create(Point2LL(0, 0));
+    const LightningTreeNodeIdx a = nodes.addChild(root, Point2LL(100, 0));
+    const LightningTreeNodeIdx b = nodes.addChild(root, Point2LL(0, 100));
+    const LightningTreeNodeIdx c = nodes.addChild(a, Point2LL(200, 0));
+
+    nodes.reroot(c);
+
+    EXPECT_TRUE(nodes.isRoot(c));
+    EXPECT_FALSE(nodes.isRoot(root));
+    EXPECT_EQ(visit(c), (std::vector<LightningTreeNodeIdx>{ c, a, root, b })) << "The path to the old root must be reversed.";
+    EXPECT_TRUE(nodes.hasOffspring(c, b));
+    EXPECT_FALSE(nodes.hasOffspring(root, a));
+}
+
+TEST_F(LightningTreeNodePoolTest, CopyAndAppend)
+{
+    const LightningTreeNodeIdx root = nodes.create(Point2LL(0, 0));
+    const LightningTreeNodeIdx a = nodes.addChild(root, Point2LL(100, 0));
+    nodes.addChild(a, Point2LL(200, 0));
+    nodes.addChild(root, Point2LL(0, 100));
+
+    LightningTreeNodePool copy;
+    copy.create(Point2LL(-100, -100)); // Another tree, so the copy doesn't start at index 0.
+    const LightningTreeNodeIdx root_copy = nodes.copyTree(root, copy);
+    ASSERT_EQ(copy.size(), 5);
+
+    LightningTreeNodePool target;
+    target.create(Point2LL(-200, -200));
+    const LightningTreeNodeIdx offset = target.append(std::move(copy));
+    ASSERT_EQ(offset, 1);
+    ASSERT_EQ(target.size(), 6);
+
+    std::vector<Point2LL> original_locations;
+    std::vector<Point2LL> appended_locations;
+    nodes.visitBranches(
+        root,
+        [&original_locations](const Point2LL& a, const Point2LL& b)
+        {
+            original_locations.push_back(a);
+            original_locations.push_back(b);
+        });
+    target.visitBranches(
+        root_copy + offset,
+        [&appended_locations](const Point2LL& a, const Point2LL& b)
+        {
+            appended_locations.push_back(a);
+            appended_locations.push_back(b);
+        });
+    EXPECT_EQ(original_locations, appended_locations) << "Links must still be valid after copying and appending.";
+    EXPECT_TRUE(target.isRoot(root_copy + offset));
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -0,0 +1,100 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "Mold.h" //The unit under test.
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "Application.h" //To start the thread pool.
+#include "ReadTestPolygons.h" //To make the mold parts.
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class MoldTest : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        Application::getInstance().startThreadPool();
+    }
+
+    /*!
+     * The outlines of a mold as computed one layer after another.
+     */
+    static std::vector<Polygons> accumulateInSequence(const std::vector<Polygons>& mold_parts, const coord_t inset)
+    {
+        std::vector<Polygons> outlines(mold_parts.size());
+        Polygons outline_above;
+        for (size_t layer_nr = mold_parts.size(); layer_nr-- > 0;)
+        {
+            outlines[layer_nr] = outline_above.offset(-inset).unionPolygons(mold_parts[layer_nr]);
+            outline_above = outlines[layer_nr];
+        }
+        return outlines;
+    }
+
+    static void expectSameOutlines(const std::vector<Polygons>& expected, const std::vector<Polygons>& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t layer_nr = 0; layer_nr < expected.size(); layer_nr++)
+        {
+            const Polygons difference = expected[layer_nr].xorPolygons(actual[layer_nr]);
+            EXPECT_TRUE(difference.offset(-Mold::convergence_tolerance).empty()) << "Layer " << layer_nr << " differs from the outline computed in sequence.";
+            EXPECT_NEAR(expected[layer_nr].area(), actual[layer_nr].area(), 0.001 * std::abs(expected[layer_nr].area()) + 1.0) << "Layer " << layer_nr;
+        }
+    }
+};
+
+TEST_F(MoldTest, AccumulateOutlinesEmpty)
+{
+    EXPECT_TRUE(Mold::accumulateOutlines({}, 100).empty());
+}
+
+TEST_F(MoldTest, AccumulateOutlinesOverhang)
+{
+    // A model that gets wider towards the top, so that the outline of the top layers reaches down through all blocks.
+    constexpr size_t layer_count = 300;
+    constexpr coord_t inset = 50;
+    std::vector<Polygons> mold_parts;
+    for (size_t layer_nr = 0; layer_nr < layer_count; layer_nr++)
+    {
+        mold_parts.push_back(makeSquare(Point2LL(0, 0), 10000 + layer_nr * 200));
+    }
+
+    expectSameOutlines(accumulateInSequence(mold_parts, inset), Mold::accumulateOutlines(mold_parts, inset));
+}
+
+TEST_F(MoldTest, AccumulateOutlinesRandom)
+{
+    // Separate parts that move around and come and go, so that the outline above sometimes reaches into a block and sometimes doesn't.
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<coord_t> position(-20000, 20000);
+    std::uniform_int_distribution<coord_t> size(1000, 15000);
+    std::uniform_int_distribution<int> part_count(0, 3);
+    for (const coord_t inset : { 20, 200, 2000 })
+    {
+        std::vector<Polygons> mold_parts(250);
+        Point2LL center(0, 0);
+        for (Polygons& mold_part : mold_parts)
+        {
+            const int parts_here = part_count(generator);
+            for (int part_idx = 0; part_idx < parts_here; part_idx++)
+            {
+                mold_part.add(makeSquare(center + Point2LL(position(generator), position(generator)) / 10, size(generator)));
+            }
+            if (generator() % 20 == 0)
+            {
+                center = Point2LL(position(generator), position(generator));
+            }
+        }
+
+        expectSameOutlines(accumulateInSequence(mold_parts, inset), Mold::accumulateOutlines(mold_parts, inset));
+    }
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
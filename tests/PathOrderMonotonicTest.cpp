@@ -11,7 +11,9 @@
 #include <gtest/gtest.h>
 #include <filesystem>
 #include <polyclipping/clipper.hpp>
+#include <random>
 #include <string>
+#include <unordered_map>
 
 #include <scripta/logger.h>
 
@@ -210,6 +212,84 @@ TEST_P(PathOrderMonotonicTest, SectionsTest)
     }
 }
 
+/*!
+ * Order many parallel lines that are chopped up at random, like the infill of
+ * a large area with many small holes. This makes for lots of short lines with
+ * lots of junctions between them.
+ *
+ * Each pair of lines on adjacent scanlines that overlap must be printed in
+ * monotonic order.
+ */
+TEST(PathOrderMonotonicRandomTest, ChoppedLines)
+{
+    for (unsigned int seed = 0; seed < 8; seed++)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> angle_distribution(0.0, 2.0 * std::numbers::pi);
+        std::uniform_int_distribution<coord_t> piece_length(200, 20000);
+        std::uniform_int_distribution<coord_t> gap_length(100, 3000);
+
+        const double angle = angle_distribution(generator);
+        const Point2LL direction(std::llrint(std::cos(angle) * 1000), std::llrint(std::sin(angle) * 1000));
+        const Point2LL perpendicular = turn90CCW(direction); // The monotonic direction.
+
+        Polygons polylines;
+        std::vector<std::vector<std::pair<coord_t, coord_t>>> scanlines; // For each scanline, the range of each line along the scanline.
+        for (coord_t across = 0; across < 100000; across += line_distance)
+        {
+            scanlines.emplace_back();
+            for (coord_t along = gap_length(generator); along < 100000; along += gap_length(generator))
+            {
+                const coord_t end = std::min(along + piece_length(generator), coord_t(100000));
+                PolygonRef line = polylines.newPoly();
+                line.add((direction * along + perpendicular * across) / 1000);
+                line.add((direction * end + perpendicular * across) / 1000);
+                scanlines.back().emplace_back(along, end);
+                along = end;
+            }
+        }
+        ASSERT_GT(polylines.size(), 1000) << "The lines should be chopped up into many pieces.";
+
+        constexpr coord_t max_adjacent_distance = line_distance + 1;
+        // The monotonic direction rotates clockwise, so this makes the monotonic vector point along the perpendicular.
+        PathOrderMonotonic<ConstPolygonPointer> object_under_test(AngleRadians(0.5 * std::numbers::pi - angle), max_adjacent_distance, perpendicular * -1000);
+        for (const auto& polyline : polylines)
+        {
+            object_under_test.addPolyline(ConstPolygonPointer(polyline));
+        }
+        object_under_test.optimize();
+
+        ASSERT_EQ(object_under_test.paths_.size(), polylines.size()) << "Each line must be printed once.";
+        std::unordered_map<ConstPolygonPointer, size_t> print_order;
+        for (const auto& path : object_under_test.paths_)
+        {
+            EXPECT_TRUE(print_order.emplace(path.vertices_, print_order.size()).second) << "Each line must be printed once.";
+        }
+
+        size_t scanline_start = 0; // Index of the first line of the current scanline in the polylines.
+        for (size_t scanline_idx = 0; scanline_idx + 1 < scanlines.size(); scanline_idx++)
+        {
+            const size_t next_scanline_start = scanline_start + scanlines[scanline_idx].size();
+            for (size_t line_idx = 0; line_idx < scanlines[scanline_idx].size(); line_idx++)
+            {
+                for (size_t next_line_idx = 0; next_line_idx < scanlines[scanline_idx + 1].size(); next_line_idx++)
+                {
+                    const std::pair<coord_t, coord_t>& range = scanlines[scanline_idx][line_idx];
+                    const std::pair<coord_t, coord_t>& next_range = scanlines[scanline_idx + 1][next_line_idx];
+                    if (range.first < next_range.second && next_range.first < range.second)
+                    {
+                        EXPECT_LT(
+                            print_order[ConstPolygonPointer(polylines[scanline_start + line_idx])],
+                            print_order[ConstPolygonPointer(polylines[next_scanline_start + next_line_idx])])
+                            << "Overlapping lines on adjacent scanlines must be printed in monotonic order.";
+                    }
+                }
+            }
+            scanline_start = next_scanline_start;
+        }
+    }
+}
+
 const std::vector<std::string> polygon_filenames = {
     std::filesystem::path(__FILE__).parent_path().append("resources/polygon_concave.txt").string(),   std::filesystem::path(__FILE__).parent_path().append("resources/polygon_concave_hole.txt").string(),
     std::filesystem::path(__FILE__).parent_path().append("resources/polygon_square.txt").string(),    std::filesystem::path(__FILE__).parent_path().append("resources/polygon_square_hole.txt").string(),
@@ -84,4 +84,21 @@ bool readTestPolygons(const std::string& filename, std::vector<Polygons>& polygo
 
     return true;
 }
+
+// Make a square, for tests that need a simple shape.
+Polygons makeSquare(const Point2LL& center, const coord_t size, const bool hole)
+{
+    Polygons square;
+    PolygonRef outline = square.newPoly();
+    outline.emplace_back(center + Point2LL(-size / 2, -size / 2));
+    outline.emplace_back(center + Point2LL(size / 2, -size / 2));
+    outline.emplace_back(center + Point2LL(size / 2, size / 2));
+    outline.emplace_back(center + Point2LL(-size / 2, size / 2));
+    if (hole)
+    {
+        outline.reverse();
+    }
+    return square;
+}
+
 } // namespace cura
@@ -36,6 +36,14 @@ namespace cura
 {
 bool readTestPolygons(const std::vector<std::string>& filenames, std::vector<Polygons>& polygons_out);
 bool readTestPolygons(const std::string& filename, std::vector<Polygons>& polygons_out);
+
+/*!
+ * Make an axis-aligned square, for tests that need a simple shape.
+ * \param center The center of the square.
+ * \param size The length of the sides of the square.
+ * \param hole Whether to orient the square clockwise, as a hole.
+ */
+Polygons makeSquare(const Point2LL& center, const coord_t size, const bool hole = false);
 } // namespace cura
 
 #endif // READ_TEST_POLYGONS_H
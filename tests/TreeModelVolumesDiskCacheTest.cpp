@@ -0,0 +1,101 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "TreeModelVolumesDiskCache.h" // The class under test.
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "ReadTestPolygons.h" //To make the cached areas.
+#include "utils/RadiusLayerPolygonCache.h"
+#include "utils/polygon.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class TreeModelVolumesDiskCacheTest : public testing::Test
+{
+public:
+    std::filesystem::path directory;
+
+    void SetUp() override
+    {
+        directory = std::filesystem::temp_directory_path() / fmt::format("tree_model_volumes_disk_cache_test_{}", testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::vector<std::filesystem::path> getFiles() const
+    {
+        std::vector<std::filesystem::path> files;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+        {
+            files.push_back(entry.path());
+        }
+        return files;
+    }
+};
+
+TEST_F(TreeModelVolumesDiskCacheTest, StoreAndLoad)
+{
+    const TreeModelVolumesDiskCache disk_cache(directory, 1024 * 1024);
+    RadiusLayerPolygonCache stored{ "stored" };
+    stored.insert(100, 0, makeSquare(Point2LL(0, 0), 1000));
+    stored.insert(200, 3, makeSquare(Point2LL(0, 0), 2000));
+    disk_cache.store("inputs", { &stored });
+
+    RadiusLayerPolygonCache loaded{ "loaded" };
+    ASSERT_TRUE(disk_cache.load("inputs", { &loaded }));
+    ASSERT_TRUE(loaded.get(100, 0));
+    EXPECT_EQ(loaded.get(100, 0)->get().paths, makeSquare(Point2LL(0, 0), 1000).paths);
+    ASSERT_TRUE(loaded.get(200, 3));
+    EXPECT_EQ(loaded.get(200, 3)->get().paths, makeSquare(Point2LL(0, 0), 2000).paths);
+}
+
+TEST_F(TreeModelVolumesDiskCacheTest, OtherInputsMiss)
+{
+    const TreeModelVolumesDiskCache disk_cache(directory, 1024 * 1024);
+    RadiusLayerPolygonCache stored{ "stored" };
+    stored.insert(100, 0, makeSquare(Point2LL(0, 0), 1000));
+    disk_cache.store("inputs", { &stored });
+
+    RadiusLayerPolygonCache loaded{ "loaded" };
+    EXPECT_FALSE(disk_cache.load("other inputs", { &loaded }));
+    EXPECT_FALSE(loaded.get(100, 0));
+}
+
+TEST_F(TreeModelVolumesDiskCacheTest, SameFileNameOtherInputsMiss)
+{
+    // Files are named after a hash of their inputs. Simulate a collision of those hashes by swapping the names of two files.
+    const TreeModelVolumesDiskCache disk_cache(directory, 1024 * 1024);
+    RadiusLayerPolygonCache stored_a{ "stored_a" };
+    stored_a.insert(100, 0, makeSquare(Point2LL(0, 0), 1000));
+    disk_cache.store("inputs a", { &stored_a });
+    RadiusLayerPolygonCache stored_b{ "stored_b" };
+    stored_b.insert(100, 0, makeSquare(Point2LL(0, 0), 2000));
+    disk_cache.store("inputs b", { &stored_b });
+
+    const std::vector<std::filesystem::path> files = getFiles();
+    ASSERT_EQ(files.size(), 2);
+    const std::filesystem::path temporary = directory / "swap";
+    std::filesystem::rename(files[0], temporary);
+    std::filesystem::rename(files[1], files[0]);
+    std::filesystem::rename(temporary, files[1]);
+
+    RadiusLayerPolygonCache loaded{ "loaded" };
+    EXPECT_FALSE(disk_cache.load("inputs a", { &loaded }));
+    EXPECT_FALSE(disk_cache.load("inputs b", { &loaded }));
+    EXPECT_FALSE(loaded.get(100, 0));
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
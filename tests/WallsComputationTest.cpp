@@ -7,8 +7,10 @@
 #include "sliceDataStorage.h" //Sl
 #include "slicer.h"
 #include "utils/polygon.h" //To create example polygons.
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <range/v3/view/join.hpp>
+#include <set>
 #include <unordered_set>
 
 #include <scripta/logger.h>
@@ -221,5 +223,59 @@ TEST_F(WallsComputationTest, WallToolPathsGetWeakOrder)
     EXPECT_EQ(has_order_info.size(), n_paths) << "Every path should have order information.";
 }
 
+/*!
+ * Tests the order constraints of walls around holes, where each wall gets
+ * ordered from the outline or the hole that it is closest to.
+ */
+TEST_F(WallsComputationTest, RegionOrderPerHole)
+{
+    // Square walls, counter-clockwise (positive area) around holes and clockwise along the outline.
+    const auto make_wall = [](const Point2LL& center, const coord_t half_size, const size_t inset_idx, const bool around_hole)
+    {
+        std::vector<Point2LL> corners{ center + Point2LL(-half_size, -half_size),
+                                       center + Point2LL(half_size, -half_size),
+                                       center + Point2LL(half_size, half_size),
+                                       center + Point2LL(-half_size, half_size) };
+        if (! around_hole)
+        {
+            std::reverse(corners.begin(), corners.end());
+        }
+        ExtrusionLine wall(inset_idx, false, true);
+        for (const Point2LL& corner : corners)
+        {
+            wall.emplace_back(corner, MM2INT(0.4), inset_idx);
+        }
+        return wall;
+    };
+
+    std::vector<ExtrusionLine> walls;
+    for (size_t inset_idx = 0; inset_idx < 3; inset_idx++) // Outline with 3 walls.
+    {
+        walls.push_back(make_wall(Point2LL(0, 0), MM2INT(20) - inset_idx * MM2INT(0.4), inset_idx, false));
+    }
+    for (size_t inset_idx = 0; inset_idx < 3; inset_idx++) // Hole with 3 walls.
+    {
+        walls.push_back(make_wall(Point2LL(MM2INT(-10), 0), MM2INT(2) + inset_idx * MM2INT(0.4), inset_idx, true));
+    }
+    walls.push_back(make_wall(Point2LL(MM2INT(10), 0), MM2INT(1.5), 0, true)); // Hole with 1 wall.
+
+    const auto order = InsetOrderOptimizer::getRegionOrder(walls, true);
+
+    // The innermost outline wall is closer to the second hole than to the outline.
+    // The outermost wall of the first hole is as close to the second hole as to its own hole, but it goes with its own hole since it encloses it.
+    const std::set<std::pair<const ExtrusionLine*, const ExtrusionLine*>> expected{
+        { &walls[0], &walls[1] },
+        { &walls[6], &walls[2] },
+        { &walls[3], &walls[4] },
+        { &walls[4], &walls[5] },
+    };
+    std::set<std::pair<const ExtrusionLine*, const ExtrusionLine*>> result;
+    for (const auto& constraint : order)
+    {
+        EXPECT_TRUE(result.insert(constraint).second) << "Each constraint must only be given once.";
+    }
+    EXPECT_EQ(result, expected);
+}
+
 } // namespace cura
 // NOLINTEND(*-magic-numbers)
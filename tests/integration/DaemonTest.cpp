@@ -0,0 +1,191 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "Application.h" // To run the daemon and the slice command.
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace cura
+{
+#ifndef _WIN32 // Every run of the engine needs a process of its own, which is created with fork.
+
+/*
+ * Integration test of the daemon command. Jobs sliced by one daemon should
+ * give the same g-code as slicing each of them in a new process, regardless of
+ * what was sliced before them.
+ */
+class DaemonTest : public testing::Test
+{
+public:
+    std::filesystem::path output_path;
+
+    void SetUp() override
+    {
+        output_path = std::filesystem::temp_directory_path() / fmt::format("daemon_test_{}", getpid());
+        std::filesystem::create_directories(output_path);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(output_path);
+    }
+
+    /*!
+     * Get the arguments of the slice command to slice a model.
+     *
+     * The settings in the resources of the integration tests are complete
+     * enough for a full slice, so those are used as defaults.
+     * \param model The model to slice, relative to the tests directory.
+     * \param settings The settings that differ from the defaults.
+     * \param gcode_file Where to write the g-code to.
+     */
+    static std::vector<std::string> getSliceArguments(const std::string& model, const std::map<std::string, std::string>& settings, const std::filesystem::path& gcode_file)
+    {
+        const std::filesystem::path tests_path = std::filesystem::path(__FILE__).parent_path().parent_path();
+        std::map<std::string, std::string> all_settings;
+        std::ifstream settings_file{ tests_path / "integration" / "resources" / "default.settings" };
+        std::string line;
+        while (std::getline(settings_file, line))
+        {
+            const size_t value_position = line.find('=');
+            if (value_position != std::string::npos)
+            {
+                all_settings[line.substr(0, value_position)] = line.substr(value_position + 1);
+            }
+        }
+        for (const auto& [key, value] : settings)
+        {
+            all_settings[key] = value;
+        }
+
+        std::vector<std::string> arguments;
+        for (const auto& [key, value] : all_settings)
+        {
+            arguments.emplace_back("-s");
+            arguments.push_back(fmt::format("{}={}", key, value));
+        }
+        arguments.insert(arguments.end(), { "-e0", "-l", (tests_path / model).string(), "-o", gcode_file.string() });
+        return arguments;
+    }
+
+    /*!
+     * Run the engine in a child process, the same way as the command line would.
+     * \param arguments The arguments after the name of the executable.
+     * \param stdin_file A file to use as stdin of the engine, if any.
+     * \return Whether the engine exited successfully.
+     */
+    static bool runEngine(std::vector<std::string> arguments, const std::filesystem::path& stdin_file = {})
+    {
+        const pid_t pid = fork();
+        if (pid == -1)
+        {
+            return false;
+        }
+        if (pid == 0)
+        {
+            std::freopen("/dev/null", "w", stdout);
+            std::freopen("/dev/null", "w", stderr);
+            if (! stdin_file.empty())
+            {
+                std::freopen(stdin_file.c_str(), "r", stdin);
+            }
+
+            arguments.insert(arguments.begin(), "CuraEngine");
+            std::vector<char*> argv;
+            for (std::string& argument : arguments)
+            {
+                argv.push_back(argument.data());
+            }
+            argv.push_back(nullptr);
+            Application::getInstance().run(arguments.size(), argv.data());
+            std::exit(EXIT_SUCCESS);
+        }
+
+        int status;
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    }
+
+    /*!
+     * Read the lines of a g-code file, except those that differ between processes.
+     */
+    static std::vector<std::string> readGCode(const std::filesystem::path& gcode_file)
+    {
+        std::vector<std::string> lines;
+        std::ifstream file{ gcode_file };
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (! line.starts_with(";SLICE_UUID:")) // Generated for every process.
+            {
+                lines.push_back(line);
+            }
+        }
+        return lines;
+    }
+};
+
+TEST_F(DaemonTest, JobsGiveSameOutputAsSeparateSlices)
+{
+    // Two jobs that differ in everything that the g-code writer remembers: the objects, their position, the adhesion, and the extruder state at the end.
+    struct Job
+    {
+        std::string name;
+        std::string model;
+        std::map<std::string, std::string> settings;
+    };
+    const std::vector<Job> jobs{
+        Job{ "cylinder", "integration/resources/cylinder1000.stl", { { "adhesion_type", "brim" }, { "infill_pattern", "gyroid" }, { "layer_height", "0.15" } } },
+        Job{ "cube", "integration/resources/cube.stl", { { "adhesion_type", "skirt" }, { "mesh_position_x", "30" }, { "retraction_enable", "False" } } },
+        Job{ "cylinder_again", "integration/resources/cylinder1000.stl", { { "adhesion_type", "brim" }, { "infill_pattern", "gyroid" }, { "layer_height", "0.15" } } },
+    };
+
+    const std::filesystem::path jobs_file = output_path / "jobs.txt";
+    {
+        std::ofstream jobs_stream{ jobs_file };
+        for (const Job& job : jobs)
+        {
+            for (const std::string& argument : getSliceArguments(job.model, job.settings, output_path / fmt::format("{}.daemon.gcode", job.name)))
+            {
+                jobs_stream << '"' << argument << "\" ";
+            }
+            jobs_stream << '\n';
+        }
+    }
+    ASSERT_TRUE(runEngine({ "daemon" }, jobs_file));
+
+    for (const Job& job : jobs)
+    {
+        const std::filesystem::path slice_file = output_path / fmt::format("{}.slice.gcode", job.name);
+        std::vector<std::string> arguments{ "slice" };
+        const std::vector<std::string> slice_arguments = getSliceArguments(job.model, job.settings, slice_file);
+        arguments.insert(arguments.end(), slice_arguments.begin(), slice_arguments.end());
+        ASSERT_TRUE(runEngine(arguments));
+
+        const std::vector<std::string> daemon_gcode = readGCode(output_path / fmt::format("{}.daemon.gcode", job.name));
+        const std::vector<std::string> slice_gcode = readGCode(slice_file);
+        ASSERT_FALSE(slice_gcode.empty()) << job.name;
+        const auto [daemon_line, slice_line] = std::mismatch(daemon_gcode.begin(), daemon_gcode.end(), slice_gcode.begin(), slice_gcode.end());
+        EXPECT_TRUE(daemon_line == daemon_gcode.end() && slice_line == slice_gcode.end())
+            << job.name << " differs at line " << std::distance(daemon_gcode.begin(), daemon_line) + 1 << ": '" << (daemon_line == daemon_gcode.end() ? "<end>" : *daemon_line)
+            << "' from the daemon, '" << (slice_line == slice_gcode.end() ? "<end>" : *slice_line) << "' from a separate slice.";
+    }
+}
+
+#endif // _WIN32
+} // namespace cura
@@ -0,0 +1,167 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <gtest/gtest.h>
+
+#include "utils/polygon.h" // The class under test.
+#include "utils/polygonUtils.h"
+
+namespace
+{
+/*!
+ * The number of allocations made by this test executable so far, counted by
+ * the replaced global operator new below.
+ */
+std::atomic<size_t> allocation_count{ 0 };
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class PolygonAllocationTest : public testing::Test
+{
+public:
+    Polygons circles;
+    Polygons half_square; //!< Covers about half of the circles.
+
+    void SetUp() override
+    {
+        circles.clear();
+        for (coord_t i = 0; i < 100; i++)
+        {
+            circles.add(PolygonUtils::makeCircle(Point2LL((i % 10) * 300, (i / 10) * 300), 200));
+        }
+        half_square.clear();
+        PolygonRef square = half_square.newPoly();
+        square.emplace_back(-500, -500);
+        square.emplace_back(1350, -500);
+        square.emplace_back(1350, 3500);
+        square.emplace_back(-500, 3500);
+
+        // Let the engines of this thread grow their buffers, like they would have for earlier operations during a slice.
+        static_cast<void>(circles.difference(half_square));
+        static_cast<void>(circles.offset(10));
+    }
+
+    /*!
+     * Count how many allocations a function makes.
+     */
+    template<typename F>
+    static size_t countAllocations(F&& function)
+    {
+        const size_t before = allocation_count.load(std::memory_order_relaxed);
+        function();
+        return allocation_count.load(std::memory_order_relaxed) - before;
+    }
+};
+
+TEST_F(PolygonAllocationTest, ReusedEngineAllocatesLess)
+{
+    constexpr size_t repeats = 10;
+    Polygons reused_result;
+    const size_t reused_allocations = countAllocations(
+        [&]()
+        {
+            for (size_t i = 0; i < repeats; i++)
+            {
+                reused_result = circles.difference(half_square);
+            }
+        });
+
+    // The same operation as it was done before the engines were reused: with a new engine every time.
+    Polygons fresh_result;
+    const size_t fresh_allocations = countAllocations(
+        [&]()
+        {
+            for (size_t i = 0; i < repeats; i++)
+            {
+                Polygons result;
+                ClipperLib::Clipper clipper(clipper_init);
+                clipper.AddPaths(circles.paths, ClipperLib::ptSubject, true);
+                clipper.AddPaths(half_square.paths, ClipperLib::ptClip, true);
+                clipper.Execute(ClipperLib::ctDifference, result.paths);
+                fresh_result = std::move(result);
+            }
+        });
+
+    EXPECT_EQ(reused_result.paths, fresh_result.paths);
+    EXPECT_LT(reused_allocations, fresh_allocations) << "Reused: " << reused_allocations << " allocations, new engines: " << fresh_allocations << " allocations.";
+}
+
+TEST_F(PolygonAllocationTest, RvalueOperationReusesMemory)
+{
+    Polygons lvalue_operand = circles;
+    Polygons lvalue_result;
+    const size_t lvalue_allocations = countAllocations(
+        [&]()
+        {
+            lvalue_result = lvalue_operand.difference(half_square);
+        });
+
+    Polygons rvalue_operand = circles;
+    Polygons rvalue_result;
+    const size_t rvalue_allocations = countAllocations(
+        [&]()
+        {
+            rvalue_result = std::move(rvalue_operand).difference(half_square);
+        });
+
+    EXPECT_EQ(rvalue_result.paths, lvalue_result.paths);
+    EXPECT_LT(rvalue_allocations, lvalue_allocations) << "Rvalue: " << rvalue_allocations << " allocations, lvalue: " << lvalue_allocations << " allocations.";
+}
+
+TEST_F(PolygonAllocationTest, RvalueZeroOffsetDoesNotAllocate)
+{
+    Polygons operand = circles;
+    Polygons result;
+    const size_t allocations = countAllocations(
+        [&]()
+        {
+            result = std::move(operand).offset(0);
+        });
+    EXPECT_EQ(allocations, 0);
+    EXPECT_EQ(result.paths, circles.paths);
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
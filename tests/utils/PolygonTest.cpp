@@ -2,6 +2,7 @@
 // CuraEngine is released under the terms of the AGPLv3 or higher.
 
 #include "utils/polygon.h" // The class under test.
+#include "Application.h" // To start the thread pool for unionAllParallel.
 #include "utils/Coord_t.h"
 #include "utils/SVG.h" // helper functions
 #include "utils/polygonUtils.h" // helper functions
@@ -556,5 +557,52 @@ TEST_F(PolygonTest, removeSmallAreas_complex)
     act_polygons.removeSmallAreas(1e-3, true);
     twoPolygonsAreEqual(act_polygons, exp_polygons);
 }
+
+TEST_F(PolygonTest, unionAllSameAsUnionOneAtATime)
+{
+    std::vector<Polygons> inputs;
+    for (coord_t i = 0; i < 40; i++)
+    {
+        Polygons square;
+        square.add(test_square);
+        square.translate(Point2LL((i % 7) * 60, (i / 7) * 70));
+        inputs.push_back(square);
+    }
+    inputs.push_back(clockwise_donut); // Overlaps some squares, and has a hole that some other squares fill.
+
+    Polygons one_at_a_time;
+    for (const Polygons& input : inputs)
+    {
+        one_at_a_time = one_at_a_time.unionPolygons(input);
+    }
+    const Polygons all = Polygons::unionAll(inputs);
+
+    EXPECT_EQ(all.size(), one_at_a_time.size());
+    EXPECT_DOUBLE_EQ(all.area(), one_at_a_time.area());
+    EXPECT_EQ(all.xorPolygons(one_at_a_time).area(), 0.0);
+    EXPECT_TRUE(Polygons::unionAll({}).empty());
+}
+
+TEST_F(PolygonTest, unionAllParallelSameAsUnionAll)
+{
+    Application::getInstance().startThreadPool();
+    std::vector<Polygons> inputs;
+    for (coord_t i = 0; i < 200; i++)
+    {
+        Polygons square;
+        square.add(test_square);
+        square.translate(Point2LL((i % 20) * 80, (i / 20) * 90));
+        inputs.push_back(square);
+    }
+    const Polygons all = Polygons::unionAll(inputs);
+
+    for (const size_t group_size : { 2, 3, 16, 1000 })
+    {
+        const Polygons parallel = Polygons::unionAllParallel(inputs, group_size);
+        EXPECT_EQ(parallel.size(), all.size()) << "Group size " << group_size;
+        EXPECT_DOUBLE_EQ(parallel.area(), all.area()) << "Group size " << group_size;
+        EXPECT_EQ(parallel.xorPolygons(all).area(), 0.0) << "Group size " << group_size;
+    }
+}
 } // namespace cura
 // NOLINTEND(*-magic-numbers)
@@ -0,0 +1,191 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/PreparedPolygons.h" // The class under test.
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/Coord_t.h"
+#include "utils/polygon.h"
+#include "utils/polygonUtils.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+// NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+class PreparedPolygonsTest : public testing::Test
+{
+public:
+    Polygons polygons;
+
+    void SetUp() override
+    {
+        // A square with a square hole.
+        Polygon outer;
+        outer.emplace_back(0, 0);
+        outer.emplace_back(1000, 0);
+        outer.emplace_back(1000, 1000);
+        outer.emplace_back(0, 1000);
+        polygons.add(outer);
+        Polygon hole;
+        hole.emplace_back(250, 250);
+        hole.emplace_back(250, 750);
+        hole.emplace_back(750, 750);
+        hole.emplace_back(750, 250);
+        polygons.add(hole);
+
+        // A star with many edges at all sorts of angles, including some spikes through the square.
+        Polygon star;
+        constexpr size_t star_points = 40;
+        for (size_t point_idx = 0; point_idx < star_points; point_idx++)
+        {
+            const double angle = 2 * std::numbers::pi * static_cast<double>(point_idx) / static_cast<double>(star_points);
+            const double radius = (point_idx % 2 == 0) ? 900 : 300;
+            star.emplace_back(1500 + std::llrint(radius * std::cos(angle)), 500 + std::llrint(radius * std::sin(angle)));
+        }
+        polygons.add(star);
+
+        // A degenerate line, which has no area but can be collided with.
+        Polygon line;
+        line.emplace_back(-500, 1200);
+        line.emplace_back(2500, 1300);
+        polygons.add(line);
+    }
+
+    static Polygons makeLine(const Point2LL& from, const Point2LL& to)
+    {
+        Polygons result;
+        PolygonRef line = result.newPoly();
+        line.add(from);
+        line.add(to);
+        return result;
+    }
+};
+// NOLINTEND(misc-non-private-member-variables-in-classes)
+
+TEST_F(PreparedPolygonsTest, InsideSimple)
+{
+    const PreparedPolygons prepared(polygons);
+    EXPECT_TRUE(prepared.inside(Point2LL(100, 100)));
+    EXPECT_FALSE(prepared.inside(Point2LL(500, 500))) << "The point is in the hole.";
+    EXPECT_FALSE(prepared.inside(Point2LL(-100, 500)));
+    EXPECT_FALSE(prepared.inside(Point2LL(500, -100))) << "The point is below the bounding box.";
+    EXPECT_FALSE(prepared.inside(Point2LL(500, 5000))) << "The point is above the bounding box.";
+    EXPECT_TRUE(prepared.inside(Point2LL(1000, 500), true)) << "The border result must be returned for points on the border.";
+    EXPECT_FALSE(prepared.inside(Point2LL(1000, 500), false)) << "The border result must be returned for points on the border.";
+    EXPECT_TRUE(prepared.inside(Point2LL(0, 0), true)) << "The border result must be returned for vertices.";
+}
+
+TEST_F(PreparedPolygonsTest, InsideSameAsPolygons)
+{
+    const PreparedPolygons prepared(polygons);
+    std::mt19937 generator(12345);
+    std::uniform_int_distribution<coord_t> x_distribution(-600, 2600);
+    std::uniform_int_distribution<coord_t> y_distribution(-600, 1600);
+    std::vector<Point2LL> points;
+    for (size_t point_idx = 0; point_idx < 10000; point_idx++)
+    {
+        points.emplace_back(x_distribution(generator), y_distribution(generator));
+    }
+    // Also test the vertices themselves and points on the same scanline as vertices, where most of the edge cases are.
+    for (ConstPolygonRef polygon : polygons)
+    {
+        for (const Point2LL& vertex : polygon)
+        {
+            points.push_back(vertex);
+            points.emplace_back(vertex.X - 10, vertex.Y);
+            points.emplace_back(vertex.X + 10, vertex.Y);
+        }
+    }
+
+    for (const bool border_result : { false, true })
+    {
+        const std::vector<bool> batch = prepared.inside(points, border_result);
+        ASSERT_EQ(batch.size(), points.size());
+        for (size_t point_idx = 0; point_idx < points.size(); point_idx++)
+        {
+            const Point2LL& p = points[point_idx];
+            const bool expected = polygons.inside(p, border_result);
+            EXPECT_EQ(prepared.inside(p, border_result), expected) << "Point " << p.X << ", " << p.Y << " with border result " << border_result;
+            EXPECT_EQ(batch[point_idx], expected) << "Batched point " << p.X << ", " << p.Y << " with border result " << border_result;
+        }
+    }
+}
+
+TEST_F(PreparedPolygonsTest, IntersectsSegmentSameAsPolygons)
+{
+    const PreparedPolygons prepared(polygons);
+    std::mt19937 generator(54321);
+    std::uniform_int_distribution<coord_t> x_distribution(-600, 2600);
+    std::uniform_int_distribution<coord_t> y_distribution(-600, 1600);
+    std::uniform_int_distribution<coord_t> length_distribution(-300, 300);
+    for (size_t segment_idx = 0; segment_idx < 5000; segment_idx++)
+    {
+        const Point2LL from(x_distribution(generator), y_distribution(generator));
+        const Point2LL to = from + Point2LL(length_distribution(generator), length_distribution(generator));
+        EXPECT_EQ(prepared.intersectsSegment(from, to), PolygonUtils::polygonCollidesWithLineSegment(polygons, from, to))
+            << "Segment " << from.X << ", " << from.Y << " to " << to.X << ", " << to.Y;
+    }
+    EXPECT_TRUE(prepared.intersectsSegment(Point2LL(1000, 1250), Point2LL(1000, 1350))) << "The segment crosses the degenerate line.";
+    EXPECT_FALSE(prepared.intersectsSegment(Point2LL(100, 100), Point2LL(100, 100))) << "Zero-length line segments never collide.";
+}
+
+TEST_F(PreparedPolygonsTest, IntersectsSegmentRoundingSameAsPolygons)
+{
+    // Due to rounding, this edge collides with the segment while it's 2 units beyond its end, the most that it can be.
+    const Polygons edge = makeLine(Point2LL(930, 482), Point2LL(930, 909));
+    const PreparedPolygons prepared_edge(edge);
+    const Point2LL from(932, 485);
+    const Point2LL to(1010, 460);
+    ASSERT_TRUE(PolygonUtils::polygonCollidesWithLineSegment(edge, from, to));
+    EXPECT_TRUE(prepared_edge.intersectsSegment(from, to));
+    EXPECT_TRUE(prepared_edge.intersectsSegment(to, from));
+
+    // Edges near the ends and sides of segments of any direction and length, where rounding decides whether they collide.
+    std::mt19937 generator(12345);
+    std::uniform_int_distribution<coord_t> length_distribution(-2000, 2000);
+    std::uniform_int_distribution<coord_t> offset_distribution(-4, 4);
+    std::uniform_int_distribution<coord_t> edge_length_distribution(-500, 500);
+    for (size_t segment_idx = 0; segment_idx < 20000; segment_idx++)
+    {
+        const Point2LL segment_from(0, 0);
+        const Point2LL segment_to(length_distribution(generator), length_distribution(generator));
+        const Point2LL near = (segment_idx % 2 == 0 ? segment_from : segment_to) + Point2LL(offset_distribution(generator), offset_distribution(generator));
+        const Polygons near_edge = makeLine(near, near + Point2LL(edge_length_distribution(generator), edge_length_distribution(generator)));
+        const PreparedPolygons prepared(near_edge);
+        EXPECT_EQ(prepared.intersectsSegment(segment_from, segment_to), PolygonUtils::polygonCollidesWithLineSegment(near_edge, segment_from, segment_to))
+            << "Segment 0, 0 to " << segment_to.X << ", " << segment_to.Y << " and edge " << near_edge[0][0].X << ", " << near_edge[0][0].Y << " to " << near_edge[0][1].X << ", "
+            << near_edge[0][1].Y;
+    }
+}
+
+TEST_F(PreparedPolygonsTest, IntersectsSegmentZeroLength)
+{
+    const PreparedPolygons prepared(polygons);
+    for (const Point2LL& point : { Point2LL(100, 100), Point2LL(0, 500), Point2LL(0, 0), Point2LL(250, 500), Point2LL(1000, 1300) })
+    {
+        // Also on the edges and vertices, where PolygonUtils::polygonCollidesWithLineSegment doesn't collide either.
+        EXPECT_EQ(prepared.intersectsSegment(point, point), PolygonUtils::polygonCollidesWithLineSegment(polygons, point, point)) << "Point " << point.X << ", " << point.Y;
+        EXPECT_FALSE(prepared.intersectsSegment(point, point)) << "Point " << point.X << ", " << point.Y;
+    }
+}
+
+TEST_F(PreparedPolygonsTest, Empty)
+{
+    const PreparedPolygons prepared{ Polygons() };
+    EXPECT_TRUE(prepared.empty());
+    EXPECT_FALSE(prepared.inside(Point2LL(0, 0), true));
+    EXPECT_EQ(prepared.inside(std::vector<Point2LL>{ Point2LL(0, 0) }, true), std::vector<bool>{ false });
+    EXPECT_FALSE(prepared.intersectsSegment(Point2LL(0, 0), Point2LL(100, 100)));
+
+    const PreparedPolygons default_prepared;
+    EXPECT_TRUE(default_prepared.empty());
+    EXPECT_FALSE(default_prepared.inside(Point2LL(0, 0)));
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -0,0 +1,116 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/RadiusLayerPolygonCache.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../ReadTestPolygons.h" //To make the cached areas.
+
+namespace cura
+{
+
+class RadiusLayerPolygonCacheTest : public testing::Test
+{
+public:
+    RadiusLayerPolygonCache cache{ "test" };
+};
+
+TEST_F(RadiusLayerPolygonCacheTest, GetMissing)
+{
+    EXPECT_FALSE(cache.get(100, 0)) << "Nothing was inserted yet.";
+    EXPECT_FALSE(cache.get(100, -1)) << "Negative layers never exist.";
+    EXPECT_EQ(cache.getStatistics().misses, 2);
+    EXPECT_EQ(cache.getStatistics().hits, 0);
+}
+
+TEST_F(RadiusLayerPolygonCacheTest, InsertAndGet)
+{
+    ASSERT_TRUE(cache.insert(100, 3, makeSquare(Point2LL(0, 0), 10)));
+    ASSERT_TRUE(cache.insert(200, 3, makeSquare(Point2LL(0, 0), 20)));
+
+    const auto result_100 = cache.get(100, 3);
+    const auto result_200 = cache.get(200, 3);
+    ASSERT_TRUE(result_100);
+    ASSERT_TRUE(result_200);
+    EXPECT_EQ(result_100.value().get().area(), 10 * 10);
+    EXPECT_EQ(result_200.value().get().area(), 20 * 20);
+    EXPECT_FALSE(cache.get(100, 2)) << "Only the inserted layer must be present.";
+    EXPECT_FALSE(cache.get(300, 3)) << "Only the inserted radius must be present.";
+    EXPECT_EQ(cache.getStatistics().hits, 2);
+    EXPECT_EQ(cache.getStatistics().misses, 2);
+    EXPECT_EQ(cache.getStatistics().inserts, 2);
+}
+
+TEST_F(RadiusLayerPolygonCacheTest, WriteOnce)
+{
+    ASSERT_TRUE(cache.insert(100, 0, makeSquare(Point2LL(0, 0), 10)));
+    const Polygons* first = &cache.get(100, 0).value().get();
+
+    EXPECT_FALSE(cache.insert(100, 0, makeSquare(Point2LL(0, 0), 20))) << "A second insert of the same key must be ignored.";
+    EXPECT_EQ(&cache.get(100, 0).value().get(), first) << "References must stay valid.";
+    EXPECT_EQ(cache.get(100, 0).value().get().area(), 10 * 10) << "The first value must be kept.";
+}
+
+TEST_F(RadiusLayerPolygonCacheTest, ReferencesStayValidWhenGrowing)
+{
+    ASSERT_TRUE(cache.insert(100, 0, makeSquare(Point2LL(0, 0), 10)));
+    const Polygons* first = &cache.get(100, 0).value().get();
+
+    for (LayerIndex layer_idx = 1; layer_idx < 5000; ++layer_idx)
+    {
+        cache.insert(100, layer_idx, makeSquare(Point2LL(0, 0), 10));
+    }
+    EXPECT_EQ(&cache.get(100, 0).value().get(), first);
+    EXPECT_TRUE(cache.get(100, 4999));
+}
+
+TEST_F(RadiusLayerPolygonCacheTest, MaxCalculatedLayer)
+{
+    EXPECT_EQ(cache.getMaxCalculatedLayer(100), -1);
+
+    cache.insert(100, 1, makeSquare(Point2LL(0, 0), 10));
+    cache.insert(100, 2, makeSquare(Point2LL(0, 0), 10));
+    cache.insert(100, 4, makeSquare(Point2LL(0, 0), 10));
+    EXPECT_EQ(cache.getMaxCalculatedLayer(100), 2) << "Layer 0 may be skipped, but the run must stop at the first gap.";
+
+    cache.insert(100, 0, makeSquare(Point2LL(0, 0), 10));
+    cache.insert(100, 3, makeSquare(Point2LL(0, 0), 10));
+    EXPECT_EQ(cache.getMaxCalculatedLayer(100), 4);
+}
+
+TEST_F(RadiusLayerPolygonCacheTest, ConcurrentInsertAndGet)
+{
+    constexpr size_t thread_count = 8;
+    constexpr coord_t layer_count = 1000;
+    std::vector<std::thread> threads;
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx)
+    {
+        threads.emplace_back(
+            [this, thread_idx, layer_count]()
+            {
+                const coord_t radius = 100 * (1 + thread_idx % 3); // Several threads share each radius.
+                for (LayerIndex layer_idx = 0; layer_idx < layer_count; ++layer_idx)
+                {
+                    cache.insert(radius, layer_idx, makeSquare(Point2LL(0, 0), radius));
+                    ASSERT_TRUE(cache.get(radius, layer_idx));
+                }
+            });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const coord_t radius : { 100, 200, 300 })
+    {
+        EXPECT_EQ(cache.getMaxCalculatedLayer(radius), layer_count - 1);
+        EXPECT_EQ(cache.get(radius, 500).value().get().area(), radius * radius);
+    }
+    EXPECT_EQ(cache.getStatistics().inserts, 3 * layer_count) << "Every slot must be written exactly once.";
+}
+
+} // namespace cura
@@ -0,0 +1,173 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/Trace.h" // The class under test.
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+
+#include "Application.h" // To start the thread pool.
+#include "utils/ThreadPool.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class TraceTest : public testing::Test
+{
+public:
+    std::filesystem::path trace_file;
+    static constexpr int64_t rounding = 1; //!< The start and duration of zones are each rounded down to whole microseconds.
+
+    void SetUp() override
+    {
+        Application::getInstance().startThreadPool(4);
+        trace_file = std::filesystem::temp_directory_path() / fmt::format("trace_test_{}.json", testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove(trace_file);
+    }
+
+    void TearDown() override
+    {
+        Trace::disable();
+        std::filesystem::remove(trace_file);
+    }
+
+    /*!
+     * A zone as read back from the trace file.
+     */
+    struct Zone
+    {
+        std::string name;
+        int64_t thread;
+        int64_t start;
+        int64_t duration;
+        int64_t layer_nr;
+    };
+
+    /*!
+     * Parse the trace file and check that every zone is on a named thread.
+     * \param[out] zones The zones of the trace.
+     */
+    void readTrace(std::vector<Zone>& zones) const
+    {
+        std::ifstream file(trace_file);
+        ASSERT_TRUE(file) << "The trace must have been written.";
+        std::stringstream contents;
+        contents << file.rdbuf();
+        rapidjson::Document document;
+        document.Parse(contents.str().c_str());
+        ASSERT_FALSE(document.HasParseError()) << rapidjson::GetParseError_En(document.GetParseError()) << " at " << document.GetErrorOffset();
+        ASSERT_TRUE(document.IsObject());
+        ASSERT_TRUE(document.HasMember("traceEvents"));
+        ASSERT_TRUE(document["traceEvents"].IsArray());
+
+        std::map<int64_t, std::string> thread_names;
+        for (const rapidjson::Value& event : document["traceEvents"].GetArray())
+        {
+            ASSERT_TRUE(event.IsObject());
+            const std::string phase = event["ph"].GetString();
+            if (phase == "M")
+            {
+                thread_names[event["tid"].GetInt64()] = event["args"]["name"].GetString();
+                continue;
+            }
+            ASSERT_EQ(phase, "X") << "Zones must be complete events.";
+            const int64_t layer_nr = event.HasMember("args") ? event["args"]["layer"].GetInt64() : -1;
+            zones.push_back(Zone{ event["name"].GetString(), event["tid"].GetInt64(), event["ts"].GetInt64(), event["dur"].GetInt64(), layer_nr });
+        }
+        for (const Zone& zone : zones)
+        {
+            EXPECT_TRUE(thread_names.contains(zone.thread)) << "Zone " << zone.name << " is on a thread without a name.";
+        }
+        ASSERT_FALSE(thread_names.empty());
+        EXPECT_EQ(thread_names.begin()->second, "main") << "The thread that enabled the trace must come first.";
+    }
+};
+
+TEST_F(TraceTest, DisabledRecordsNothing)
+{
+    EXPECT_FALSE(Trace::isEnabled());
+    {
+        const TraceZone zone("disabled");
+    }
+    Trace::enable(trace_file.string());
+    Trace::write();
+
+    std::vector<Zone> zones;
+    readTrace(zones);
+    EXPECT_TRUE(zones.empty()) << "Zones from before the trace was enabled must not be written.";
+}
+
+TEST_F(TraceTest, NestedZonesOnThreads)
+{
+    constexpr size_t item_count = 64;
+    Trace::enable(trace_file.string());
+    EXPECT_TRUE(Trace::isEnabled());
+    {
+        const TraceZone outer("outer");
+        {
+            const TraceZone inner("inner", 3);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        cura::parallel_for<size_t>(
+            0,
+            item_count,
+            [](const size_t item_nr)
+            {
+                const TraceZone item("item", static_cast<int64_t>(item_nr));
+                std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Long enough for the workers to take part.
+            });
+    }
+    Trace::disable();
+    EXPECT_FALSE(Trace::isEnabled());
+    {
+        const TraceZone zone("after_disable");
+    }
+    Trace::write();
+
+    std::vector<Zone> zones;
+    readTrace(zones);
+    std::map<std::string, std::vector<Zone>> zones_by_name;
+    for (const Zone& zone : zones)
+    {
+        zones_by_name[zone.name].push_back(zone);
+    }
+    EXPECT_FALSE(zones_by_name.contains("after_disable")) << "Zones after the trace was disabled must not be recorded.";
+    ASSERT_EQ(zones_by_name["outer"].size(), 1);
+    ASSERT_EQ(zones_by_name["inner"].size(), 1);
+    ASSERT_EQ(zones_by_name["item"].size(), item_count);
+
+    const Zone& outer = zones_by_name["outer"][0];
+    const Zone& inner = zones_by_name["inner"][0];
+    EXPECT_EQ(outer.layer_nr, -1);
+    EXPECT_EQ(inner.layer_nr, 3);
+    EXPECT_EQ(inner.thread, outer.thread) << "Both zones were recorded on the main thread.";
+    EXPECT_GE(inner.start, outer.start) << "The inner zone must be nested in the outer one.";
+    EXPECT_LE(inner.start + inner.duration, outer.start + outer.duration + rounding) << "The inner zone must be nested in the outer one.";
+
+    std::set<int64_t> item_layers;
+    std::set<int64_t> item_threads;
+    for (const Zone& item : zones_by_name["item"])
+    {
+        item_layers.insert(item.layer_nr);
+        item_threads.insert(item.thread);
+        EXPECT_GE(item.start, outer.start) << "Every item must be within the outer zone.";
+        EXPECT_LE(item.start + item.duration, outer.start + outer.duration + rounding) << "Every item must be within the outer zone.";
+    }
+    EXPECT_EQ(item_layers.size(), item_count) << "Every item must be recorded once.";
+    EXPECT_GT(item_threads.size(), 1) << "The items must be recorded on the threads that ran them.";
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -0,0 +1,138 @@
+// Copyright (c) 2023 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/VoxelGrid.h" //The unit under test.
+
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/AABB3D.h"
+#include "utils/VoxelUtils.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class VoxelGridTest : public testing::Test
+{
+public:
+    AABB3D bounds{ Point3LL(-70, -5, 3), Point3LL(80, 10, 12) }; // More than two words per row, with a partial last word.
+
+    /*!
+     * Fill a grid with random cells, and also return them as a set.
+     */
+    std::unordered_set<GridPoint3> addRandomCells(VoxelGrid& grid, const size_t count, const unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<coord_t> x(bounds.min_.x_, bounds.max_.x_);
+        std::uniform_int_distribution<coord_t> y(bounds.min_.y_, bounds.max_.y_);
+        std::uniform_int_distribution<coord_t> z(bounds.min_.z_, bounds.max_.z_);
+        std::unordered_set<GridPoint3> cells;
+        for (size_t i = 0; i < count; i++)
+        {
+            const GridPoint3 cell(x(generator), y(generator), z(generator));
+            grid.insert(cell);
+            cells.insert(cell);
+        }
+        return cells;
+    }
+
+    /*!
+     * Get all cells in a grid as a set.
+     */
+    static std::unordered_set<GridPoint3> getCells(const VoxelGrid& grid)
+    {
+        std::unordered_set<GridPoint3> cells;
+        grid.forEach(
+            [&cells](const GridPoint3& cell)
+            {
+                EXPECT_TRUE(cells.insert(cell).second) << "Each cell must be processed once.";
+            });
+        return cells;
+    }
+};
+
+TEST_F(VoxelGridTest, InsertContains)
+{
+    VoxelGrid grid(bounds);
+    EXPECT_TRUE(grid.empty());
+
+    const std::unordered_set<GridPoint3> cells = addRandomCells(grid, 200, 0);
+    EXPECT_EQ(grid.size(), cells.size());
+    EXPECT_EQ(getCells(grid), cells);
+    for (const GridPoint3& cell : cells)
+    {
+        EXPECT_TRUE(grid.contains(cell));
+    }
+
+    grid.insert(GridPoint3(81, 0, 5));
+    EXPECT_FALSE(grid.contains(GridPoint3(81, 0, 5))) << "Cells outside of the bounds are ignored.";
+    EXPECT_EQ(grid.size(), cells.size());
+}
+
+TEST_F(VoxelGridTest, Empty)
+{
+    VoxelGrid grid(AABB3D{});
+    grid.insert(GridPoint3(0, 0, 0));
+    EXPECT_TRUE(grid.empty());
+    EXPECT_TRUE(grid.dilate(DilationKernel(GridPoint3(2, 2, 2), DilationKernel::Type::CUBE)).empty());
+}
+
+TEST_F(VoxelGridTest, DilateSameAsVoxelUtils)
+{
+    const VoxelUtils vu(Point3LL(10, 10, 10));
+    for (const DilationKernel& kernel : { DilationKernel(GridPoint3(2, 2, 2), DilationKernel::Type::PRISM),
+                                          DilationKernel(GridPoint3(3, 3, 3), DilationKernel::Type::DIAMOND),
+                                          DilationKernel(GridPoint3(4, 4, 4), DilationKernel::Type::CUBE) })
+    {
+        VoxelGrid grid(bounds);
+        const std::unordered_set<GridPoint3> cells = addRandomCells(grid, 100, 1);
+
+        std::unordered_set<GridPoint3> expected;
+        const auto add_cell = [&grid, &expected](const GridPoint3& cell)
+        {
+            if (grid.inBounds(cell))
+            {
+                expected.insert(cell);
+            }
+            return true;
+        };
+        const auto dilated_add_cell = vu.dilate(kernel, add_cell);
+        for (const GridPoint3& cell : cells)
+        {
+            dilated_add_cell(cell);
+        }
+
+        EXPECT_EQ(getCells(grid.dilate(kernel)), expected);
+    }
+}
+
+TEST_F(VoxelGridTest, IntersectSubtract)
+{
+    VoxelGrid a(bounds);
+    const std::unordered_set<GridPoint3> cells_a = addRandomCells(a, 500, 2);
+    VoxelGrid b(bounds);
+    const std::unordered_set<GridPoint3> cells_b = addRandomCells(b, 500, 3);
+
+    std::unordered_set<GridPoint3> expected_intersection;
+    std::unordered_set<GridPoint3> expected_difference;
+    for (const GridPoint3& cell : cells_a)
+    {
+        (cells_b.contains(cell) ? expected_intersection : expected_difference).insert(cell);
+    }
+    ASSERT_FALSE(expected_intersection.empty()) << "The test needs overlapping cells.";
+
+    VoxelGrid intersection = a;
+    intersection.intersect(b);
+    EXPECT_EQ(getCells(intersection), expected_intersection);
+
+    VoxelGrid difference = a;
+    difference.subtract(b);
+    EXPECT_EQ(getCells(difference), expected_difference);
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)